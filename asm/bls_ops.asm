@@ -3,14 +3,18 @@ global bls_verify_batch_avx2
 global bls_pairing_optimized
 global bls_g1_multiexp_avx2
 
-; BLS-12-381 параметры
+; BLS-12-381 параметры. Арифметика Fp на MULX/ADCX/ADOX, которую
+; использует сборка, находится в src/security/bls.cpp.
 section .data
 align 32
+; Модуль базового поля p (381 бит)
 bls_prime:
-    dq 0xffffffff00000001, 0x53bda402fffe5bfe, 0x3339d80809a1d805, 0x73eda753299d7d48
+    dq 0xb9feffffffffaaab, 0x1eabfffeb153ffff, 0x6730d2a0f6b0f624
+    dq 0x64774b84f38512bf, 0x4b1ba7b6434bacd7, 0x1a0111ea397fe69a
 
-bls_r_inv:
-    dq 0xfffffffeffffffff, 0x53bda402fffe5bfe, 0x3339d80809a1d805, 0x73eda753299d7d48
+; Порядок подгрупп r (255 бит)
+bls_r:
+    dq 0xffffffff00000001, 0x53bda402fffe5bfe, 0x3339d80809a1d805, 0x73eda753299d7d48
 
 ; void bls_verify_batch_avx2(const uint8_t** public_keys, const uint8_t** messages, 
 ;                           const uint8_t** signatures, size_t count, bool* results)
@@ -187,6 +191,7 @@ bls_g1_multiexp_avx2:
     
     ; Оптимизированное мультиэкспоненцирование с использованием AVX2
     ; Pippenger's algorithm implementation
+    ; Рабочая реализация - bls_g1_multiexp в src/security/bls.cpp
     
     ; 1. Разбиение скаляров на окна
     call scalar_decomposition_avx2
@@ -23,6 +23,46 @@ type Config struct {
     DatabasePath     string  `json:"database_path"`
     LogLevel         string  `json:"log_level"`
     LogPath          string  `json:"log_path"`
+    WorkerThreads    uint32  `json:"-"` // performance.worker_threads из network_config.json
+    PartialQueueSize uint32  `json:"partial_queue_size"`
+
+    DuplicateWindowMinutes uint32 `json:"duplicate_window_minutes"`
+    DuplicateIndexCapacity uint32 `json:"duplicate_index_capacity"`
+    PartialsPerMinute      uint32 `json:"partials_per_minute"`
+    ValidationStages       string `json:"validation_stages"`
+    PartialScheduling      string `json:"partial_scheduling"`
+
+    JournalDirectory        string `json:"journal_directory"`
+    JournalSyncIntervalMs   uint32 `json:"journal_sync_interval_ms"`
+    JournalSyncRecords      uint32 `json:"journal_sync_records"`
+    JournalRetentionSeconds uint32 `json:"journal_retention_seconds"`
+}
+
+// NetworkConfig - используемая пулом часть network_config.json
+type NetworkConfig struct {
+    Performance struct {
+        WorkerThreads uint32 `json:"worker_threads"` // 0 - по числу ядер
+    } `json:"performance"`
+}
+
+// LoadNetworkConfig загружает network_config.json
+func LoadNetworkConfig(filename string) (*NetworkConfig, error) {
+    data, err := ioutil.ReadFile(filename)
+    if err != nil {
+        return nil, fmt.Errorf("failed to read network config file: %v", err)
+    }
+
+    var network NetworkConfig
+    if err := json.Unmarshal(data, &network); err != nil {
+        return nil, fmt.Errorf("failed to parse network config file: %v", err)
+    }
+
+    return &network, nil
+}
+
+// ApplyNetworkConfig переносит параметры network_config.json в конфигурацию пула
+func ApplyNetworkConfig(config *Config, network *NetworkConfig) {
+    config.WorkerThreads = network.Performance.WorkerThreads
 }
 
 // LoadConfig загружает конфигурацию из файла
@@ -71,6 +111,19 @@ func DefaultConfig() *Config {
         DatabasePath:     "/var/lib/chiapool/pool.db",
         LogLevel:         "info",
         LogPath:          "/var/log/chiapool/pool.log",
+        WorkerThreads:    0,
+        PartialQueueSize: 10000,
+
+        DuplicateWindowMinutes: 10,
+        DuplicateIndexCapacity: 65536,
+        PartialsPerMinute:      10,
+        ValidationStages:       "",
+        PartialScheduling:      "fifo",
+
+        JournalDirectory:        "/var/lib/chiapool/journal",
+        JournalSyncIntervalMs:   10,
+        JournalSyncRecords:      1024,
+        JournalRetentionSeconds: 86400,
     }
 }
 
@@ -94,6 +147,10 @@ func ValidateConfig(config *Config) error {
     if config.NodeRPCPort < 1 || config.NodeRPCPort > 65535 {
         return fmt.Errorf("invalid node_rpc_port: %d", config.NodeRPCPort)
     }
+    if config.PartialScheduling != "" && config.PartialScheduling != "fifo" &&
+        config.PartialScheduling != "edf" && config.PartialScheduling != "fair" {
+        return fmt.Errorf("invalid partial_scheduling: %s", config.PartialScheduling)
+    }
     return nil
 }
 
@@ -112,6 +169,8 @@ func PrintConfig(config *Config) {
     fmt.Printf("  Node RPC Cert Path: %s\n", config.NodeRPCCertPath)
     fmt.Printf("  Node RPC Key Path: %s\n", config.NodeRPCKeyPath)
     fmt.Printf("  Database Path: %s\n", config.DatabasePath)
+    fmt.Printf("  Journal Directory: %s\n", config.JournalDirectory)
+    fmt.Printf("  Worker Threads: %d\n", config.WorkerThreads)
     fmt.Printf("  Log Level: %s\n", config.LogLevel)
     fmt.Printf("  Log Path: %s\n", config.LogPath)
 }
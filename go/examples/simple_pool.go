@@ -21,6 +21,14 @@ func main() {
         config = DefaultConfig()
     }
 
+    // Параметры производительности из network_config.json
+    network, err := LoadNetworkConfig("config/network_config.json")
+    if err != nil {
+        log.Printf("Failed to load network config, using defaults: %v", err)
+    } else {
+        ApplyNetworkConfig(config, network)
+    }
+
     // Валидация конфигурации
     if err := ValidateConfig(config); err != nil {
         log.Fatalf("Invalid config: %v", err)
@@ -36,6 +44,12 @@ func main() {
     }
     defer bridge.Cleanup()
 
+    // Запуск пула с воркерами валидации partials
+    if err := bridge.StartPool(config.WorkerThreads); err != nil {
+        log.Fatalf("Failed to start pool: %v", err)
+    }
+    defer bridge.StopPool()
+
     // Инициализация менеджеров
     farmerManager := core.NewFarmerManager(bridge)
     paymentProcessor := core.NewPaymentProcessor(bridge, core.PPLNS, config.MinPayout, config.PoolFee)
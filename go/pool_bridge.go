@@ -64,6 +64,34 @@ func (pb *PoolBridge) Initialize() error {
     return nil
 }
 
+// StartPool запускает пул; workerThreads - performance.worker_threads
+// из network_config.json, 0 - по числу ядер
+func (pb *PoolBridge) StartPool(workerThreads uint32) error {
+    pb.mu.Lock()
+    defer pb.mu.Unlock()
+
+    if !pb.initialized {
+        return fmt.Errorf("bridge not initialized")
+    }
+
+    settings := C.PoolSettings{worker_threads: C.uint32_t(workerThreads)}
+    if !C.go_bridge_start_pool(&settings) {
+        return fmt.Errorf("failed to start pool with %d worker threads", workerThreads)
+    }
+    return nil
+}
+
+// StopPool останавливает пул и дожидается воркеров
+func (pb *PoolBridge) StopPool() error {
+    pb.mu.Lock()
+    defer pb.mu.Unlock()
+
+    if !C.go_bridge_stop_pool() {
+        return fmt.Errorf("failed to stop pool")
+    }
+    return nil
+}
+
 // Cleanup очищает ресурсы C библиотеки
 func (pb *PoolBridge) Cleanup() error {
     pb.mu.Lock()
@@ -194,6 +222,150 @@ func (pb *PoolBridge) ValidatePartial(partial PartialRequest) (bool, error) {
     return bool(success), nil
 }
 
+// partialFields поля декодированного partial для записи в слот очереди
+type partialFields struct {
+    launcherID             []byte
+    challenge              []byte
+    signature              []byte
+    proof                  []byte
+    poolContractPuzzleHash []byte
+    plotPublicKey          []byte
+    timestamp              int64
+    difficulty             uint64
+    plotSize               uint8
+}
+
+// check проверяет длины полей. Доказательство занимает ровно
+// pos_proof_size(k) = 8*k байт и должно помещаться в partial_t.proof.
+func (f *partialFields) check() error {
+    if len(f.launcherID) != 32 || len(f.challenge) != 32 || len(f.signature) != 96 ||
+        len(f.poolContractPuzzleHash) != 32 || len(f.plotPublicKey) != 48 {
+        return fmt.Errorf("invalid partial field length")
+    }
+    if f.plotSize < C.POS_MIN_K || f.plotSize > C.POS_MAX_K {
+        return fmt.Errorf("invalid plot size %d", f.plotSize)
+    }
+    proofSize := int(C.pos_proof_size(C.uint32_t(f.plotSize)))
+    if proofSize > C.POS_MAX_PROOF_SIZE || len(f.proof) != proofSize {
+        return fmt.Errorf("invalid proof length %d for k%d", len(f.proof), f.plotSize)
+    }
+    return nil
+}
+
+// enqueue резервирует слот очереди, записывает в него поля и передает
+// резервирование в commit. Возвращает false, если очередь не приняла partial.
+func (f *partialFields) enqueue(commit func(reservation *C.partial_queue_reservation_t) bool) bool {
+    reservation := (*C.partial_queue_reservation_t)(C.malloc(C.sizeof_partial_queue_reservation_t))
+    defer C.free(unsafe.Pointer(reservation))
+
+    partial := C.go_bridge_partial_reserve(reservation)
+    if partial == nil {
+        return false
+    }
+    // Неподтвержденный слот остановил бы очередь: при любом выходе до
+    // commit резервирование отменяется
+    committed := false
+    defer func() {
+        if !committed {
+            C.go_bridge_partial_abort(reservation)
+        }
+    }()
+
+    C.memset(unsafe.Pointer(partial), 0, C.sizeof_partial_t)
+    C.memcpy(unsafe.Pointer(&partial.launcher_id[0]), unsafe.Pointer(&f.launcherID[0]), 32)
+    C.memcpy(unsafe.Pointer(&partial.challenge[0]), unsafe.Pointer(&f.challenge[0]), 32)
+    C.memcpy(unsafe.Pointer(&partial.signature[0]), unsafe.Pointer(&f.signature[0]), 96)
+    C.memcpy(unsafe.Pointer(&partial.proof[0]), unsafe.Pointer(&f.proof[0]), C.size_t(len(f.proof)))
+    partial.timestamp = C.uint64_t(f.timestamp)
+    partial.difficulty = C.uint64_t(f.difficulty)
+    partial.plot_size = C.uint8_t(f.plotSize)
+    C.memcpy(unsafe.Pointer(&partial.pool_contract_puzzle_hash[0]), unsafe.Pointer(&f.poolContractPuzzleHash[0]), 32)
+    C.memcpy(unsafe.Pointer(&partial.plot_public_key[0]), unsafe.Pointer(&f.plotPublicKey[0]), 48)
+
+    committed = true
+    return commit(reservation)
+}
+
+// SubmitPartialBinary ставит уже декодированный partial в очередь валидации.
+// Поля записываются прямо в слот очереди C, hex разбор на стороне C не нужен.
+func (pb *PoolBridge) SubmitPartialBinary(launcherID, challenge, signature, proof,
+    poolContractPuzzleHash, plotPublicKey []byte, timestamp int64, difficulty uint64, plotSize uint8) (bool, error) {
+    pb.mu.RLock()
+    defer pb.mu.RUnlock()
+
+    if !pb.initialized {
+        return false, fmt.Errorf("bridge not initialized")
+    }
+    fields := partialFields{launcherID, challenge, signature, proof,
+        poolContractPuzzleHash, plotPublicKey, timestamp, difficulty, plotSize}
+    if err := fields.check(); err != nil {
+        return false, err
+    }
+
+    return fields.enqueue(func(reservation *C.partial_queue_reservation_t) bool {
+        return bool(C.go_bridge_partial_commit(reservation))
+    }), nil
+}
+
+// PartialCompletion результат асинхронной валидации partial
+type PartialCompletion struct {
+    Ticket     uint64
+    LauncherID []byte
+    Points     uint64
+    Result     int
+}
+
+// SubmitPartialAsync ставит partial в очередь и сразу возвращает номер.
+// Результат забирается через PollCompletions. Номер 0 означает отказ
+// (пул не запущен или очередь заполнена).
+func (pb *PoolBridge) SubmitPartialAsync(launcherID, challenge, signature, proof,
+    poolContractPuzzleHash, plotPublicKey []byte, timestamp int64, difficulty uint64, plotSize uint8) (uint64, error) {
+    pb.mu.RLock()
+    defer pb.mu.RUnlock()
+
+    if !pb.initialized {
+        return 0, fmt.Errorf("bridge not initialized")
+    }
+    fields := partialFields{launcherID, challenge, signature, proof,
+        poolContractPuzzleHash, plotPublicKey, timestamp, difficulty, plotSize}
+    if err := fields.check(); err != nil {
+        return 0, err
+    }
+
+    var ticket C.uint64_t
+    if !fields.enqueue(func(reservation *C.partial_queue_reservation_t) bool {
+        return bool(C.go_bridge_partial_commit_async(reservation, &ticket))
+    }) {
+        return 0, nil
+    }
+    return uint64(ticket), nil
+}
+
+// PollCompletions забирает до max завершений, ожидая не дольше timeoutMs.
+// Один вызов cgo возвращает всю пачку.
+func (pb *PoolBridge) PollCompletions(max int, timeoutMs uint32) ([]PartialCompletion, error) {
+    if max <= 0 {
+        return nil, nil
+    }
+
+    buffer := (*C.partial_completion_t)(C.malloc(C.size_t(max) * C.sizeof_partial_completion_t))
+    defer C.free(unsafe.Pointer(buffer))
+
+    count := int(C.go_bridge_poll_completions(buffer, C.size_t(max), C.uint32_t(timeoutMs)))
+    raw := (*[1 << 20]C.partial_completion_t)(unsafe.Pointer(buffer))[:count:count]
+
+    completions := make([]PartialCompletion, count)
+    for i := 0; i < count; i++ {
+        completions[i] = PartialCompletion{
+            Ticket:     uint64(raw[i].ticket),
+            LauncherID: C.GoBytes(unsafe.Pointer(&raw[i].launcher_id[0]), 32),
+            Points:     uint64(raw[i].points),
+            Result:     int(raw[i].result),
+        }
+    }
+    return completions, nil
+}
+
 // GetPoolInfo возвращает информацию о пуле
 func (pb *PoolBridge) GetPoolInfo() (PoolInfo, error) {
     pb.mu.RLock()
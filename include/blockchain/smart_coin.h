@@ -40,6 +40,8 @@ bool smart_coin_parse(const uint8_t* coin_data, size_t data_size, smart_coin_t*
 // Создание транзакций
 absorb_transaction_t* smart_coin_create_absorb_transaction(const uint8_t* launcher_id, uint64_t amount);
 bool smart_coin_sign_absorb_transaction(absorb_transaction_t* transaction, const uint8_t* private_key);
+// Подпись пакета транзакций ключом пула из auth_init (поглощение по многим синглтонам)
+bool smart_coin_sign_absorb_transactions(absorb_transaction_t* const* transactions, size_t count);
 
 // Валидация условий
 bool smart_coin_validate_conditions(const smart_coin_t* coin, const coin_conditions_t* conditions);
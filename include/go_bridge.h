@@ -4,6 +4,10 @@
 #include <stdint.h>
 #include <stdbool.h>
 
+#include "pool_core.h"
+#include "protocol/partials.h"
+#include "protocol/partial_completions.h"
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -36,10 +40,21 @@ typedef struct {
     uint64_t min_payout;
 } PoolInfo;
 
+// Параметры запуска пула из конфигов Go; остальное - pool_load_default_config
+typedef struct {
+    uint32_t worker_threads;     // performance.worker_threads (0 - по числу ядер)
+} PoolSettings;
+
 // Инициализация Go бриджа
 bool go_bridge_init(void);
 bool go_bridge_cleanup(void);
 
+// Запуск и остановка пула: воркеры валидации нужны бинарной и
+// асинхронной постановке partials
+bool go_bridge_load_pool_config(const PoolSettings* settings, pool_config_t* config);
+bool go_bridge_start_pool(const PoolSettings* settings);
+bool go_bridge_stop_pool(void);
+
 // Управление фермерами
 bool go_bridge_add_farmer(const FarmerInfo* farmer);
 bool go_bridge_update_farmer(const FarmerInfo* farmer);
@@ -49,6 +64,27 @@ bool go_bridge_remove_farmer(const char* launcher_id);
 bool go_bridge_process_partial(const PartialRequest* partial);
 bool go_bridge_validate_partial(const PartialRequest* partial);
 
+// Бинарная постановка partial без hex разбора. Go заполняет partial_t
+// в памяти C: submit копирует его в очередь один раз, а пара
+// reserve/commit дает записать partial прямо в слот очереди. reserve
+// возвращает NULL, если пул не запущен или очередь заполнена; после
+// успешного reserve обязателен commit или abort. reservation должна
+// лежать в памяти C (C.malloc), так как хранит указатель на саму себя.
+bool go_bridge_submit_partial(const partial_t* partial);
+partial_t* go_bridge_partial_reserve(partial_queue_reservation_t* reservation);
+bool go_bridge_partial_commit(partial_queue_reservation_t* reservation);
+void go_bridge_partial_abort(partial_queue_reservation_t* reservation);
+
+// Асинхронная постановка: возвращается сразу после постановки в очередь
+// с номером в *ticket. Результаты валидации приходят пачками в callback,
+// зарегистрированный через go_bridge_register_completion_callback, либо
+// забираются опросом go_bridge_poll_completions. Требует запущенного пула.
+bool go_bridge_process_partial_async(const PartialRequest* partial, uint64_t* ticket);
+bool go_bridge_submit_partial_async(const partial_t* partial, uint64_t* ticket);
+bool go_bridge_partial_commit_async(partial_queue_reservation_t* reservation, uint64_t* ticket);
+size_t go_bridge_poll_completions(partial_completion_t* completions, size_t max_count,
+                                  uint32_t timeout_ms);
+
 // Получение информации о пуле
 bool go_bridge_get_pool_info(PoolInfo* pool_info);
 
@@ -70,11 +106,14 @@ void go_bridge_log_fatal(const char* message);
 typedef void (*GoLogCallback)(const char* message, int level);
 typedef void (*GoPartialCallback)(const PartialRequest* partial);
 typedef void (*GoPayoutCallback)(const char* launcher_id, uint64_t amount);
+typedef void (*GoCompletionCallback)(const partial_completion_t* completions, size_t count);
 
 // Регистрация callback функций
 bool go_bridge_register_log_callback(GoLogCallback callback);
 bool go_bridge_register_partial_callback(GoPartialCallback callback);
 bool go_bridge_register_payout_callback(GoPayoutCallback callback);
+// NULL отключает callback: завершения снова копятся в кольце для опроса
+bool go_bridge_register_completion_callback(GoCompletionCallback callback);
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,86 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Размер строки кеша: каждый шард занимает отдельную строку
+#define METRICS_CACHE_LINE 64
+
+// Число шардов. Поток получает шард при первом обращении по кругу,
+// при числе потоков больше числа шардов шарды разделяются.
+#define METRICS_SHARD_COUNT 16
+
+// Гистограмма в стиле HDR: значения до 2^METRICS_HISTOGRAM_SUB_BITS хранятся
+// точно, далее каждая степень двойки делится на 2^METRICS_HISTOGRAM_SUB_BITS
+// линейных корзин (относительная ошибка не больше 1/16).
+#define METRICS_HISTOGRAM_SUB_BITS 4
+#define METRICS_HISTOGRAM_SUB_COUNT (1 << METRICS_HISTOGRAM_SUB_BITS)
+#define METRICS_HISTOGRAM_MAX_EXPONENT 36 // Значения от 2^36 нс (~68 с) в последней корзине
+#define METRICS_HISTOGRAM_BUCKETS \
+    ((METRICS_HISTOGRAM_MAX_EXPONENT - METRICS_HISTOGRAM_SUB_BITS + 2) * METRICS_HISTOGRAM_SUB_COUNT)
+
+typedef struct {
+    uint64_t value;
+} __attribute__((aligned(METRICS_CACHE_LINE))) metrics_counter_shard_t;
+
+// Шардированный счетчик. Инкремент - атомарное сложение в шард потока
+// без разделения строки кеша, чтение суммирует шарды без блокировок.
+// Нулевая инициализация (static или memset) дает готовый счетчик.
+typedef struct {
+    metrics_counter_shard_t shards[METRICS_SHARD_COUNT];
+} metrics_counter_t;
+
+typedef struct {
+    uint64_t buckets[METRICS_HISTOGRAM_BUCKETS];
+    uint64_t count;
+    uint64_t sum;
+    uint64_t max;
+} __attribute__((aligned(METRICS_CACHE_LINE))) metrics_histogram_shard_t;
+
+// Шардированная гистограмма задержек в наносекундах
+typedef struct {
+    metrics_histogram_shard_t shards[METRICS_SHARD_COUNT];
+} metrics_histogram_t;
+
+// Сводка гистограммы. Перцентили - нижние границы корзин.
+typedef struct {
+    uint64_t count;
+    uint64_t mean_ns;
+    uint64_t p50_ns;
+    uint64_t p90_ns;
+    uint64_t p99_ns;
+    uint64_t p999_ns;
+    uint64_t max_ns;
+} metrics_latency_summary_t;
+
+// Шард текущего потока
+uint32_t metrics_shard_index(void);
+
+void metrics_counter_add(metrics_counter_t* counter, uint64_t value);
+uint64_t metrics_counter_read(const metrics_counter_t* counter);
+void metrics_counter_reset(metrics_counter_t* counter);
+
+// Запись count одинаковых значений (например, время пакета на каждый partial)
+void metrics_histogram_record(metrics_histogram_t* histogram, uint64_t value_ns, uint64_t count);
+void metrics_histogram_summarize(const metrics_histogram_t* histogram,
+                                 metrics_latency_summary_t* summary);
+void metrics_histogram_reset(metrics_histogram_t* histogram);
+
+// Отображение значения в корзину и нижняя граница корзины
+uint32_t metrics_histogram_bucket(uint64_t value_ns);
+uint64_t metrics_histogram_bucket_floor(uint32_t bucket);
+
+// Монотонное время в наносекундах
+uint64_t metrics_now_ns(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // METRICS_H
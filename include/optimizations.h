@@ -10,7 +10,9 @@ typedef enum {
     CACHE_TYPE_PROOF_VERIFICATION,
     CACHE_TYPE_SIGNATURE_VERIFICATION,
     CACHE_TYPE_SINGLETON_STATE,
-    CACHE_TYPE_DIFFICULTY_CALCULATION
+    CACHE_TYPE_DIFFICULTY_CALCULATION,
+    CACHE_TYPE_PROOF_NEGATIVE,           // Отклоненные доказательства (короткий TTL)
+    CACHE_TYPE_COUNT
 } cache_type_t;
 
 // Статистика кеша
@@ -30,6 +32,8 @@ typedef struct {
     bool enable_asm_optimizations;
     size_t max_cache_memory;
     uint32_t cache_ttl_seconds;
+    uint32_t proof_negative_ttl_seconds; // TTL отклоненных доказательств
+    uint32_t signature_cache_keys;       // Публичных ключей в кеше подписей (по числу фермеров)
 } optimizations_config_t;
 
 // Инициализация оптимизаций
@@ -48,12 +52,20 @@ void vector_sha256(const uint8_t** inputs, const size_t* input_lens,
 void vector_bls_verify(const uint8_t** public_keys, const uint8_t** messages,
                       const size_t* message_lens, const uint8_t** signatures,
                       bool* results, size_t count);
+// Декодирование 2 * byte_count hex символов (любой регистр) в байты.
+// 32 символа за итерацию на AVX2, 16 на SSE2, хвост скалярно.
+// Возвращает false на первом блоке с не-hex символом.
+bool vector_hex_decode(const char* hex, size_t byte_count, uint8_t* out);
 
 // Предварительные вычисления
 bool optimizations_precompute_proof_verification(uint32_t k_size);
 bool optimizations_precompute_difficulty_params(void);
 
-// Мониторинг производительности
+// Мониторинг производительности. Для CACHE_TYPE_PROOF_VERIFICATION и
+// CACHE_TYPE_PROOF_NEGATIVE возвращается статистика кеша доказательств
+// (security/proof_cache.h), в который пишет proof_verify_space, для
+// CACHE_TYPE_SIGNATURE_VERIFICATION - кеша распакованных публичных
+// ключей (security/bls_key_cache.h).
 cache_stats_t cache_get_stats(cache_type_t type);
 void optimizations_log_performance_stats(void);
 
@@ -5,6 +5,8 @@
 #include <stdbool.h>
 #include <pthread.h>
 
+#include "protocol/partial_workers.h"
+
 // Состояния пула
 typedef enum {
     POOL_STATE_INIT,
@@ -26,6 +28,17 @@ typedef struct {
     uint16_t node_rpc_port;
     char node_rpc_cert_path[512];
     char node_rpc_key_path[512];
+    uint32_t worker_threads;   // Потоки валидации partials (0 - по числу ядер)
+    uint32_t partial_queue_size;// Емкость очереди partials
+    partial_queue_mode_t partial_queue_mode; // Дисциплина очереди (FIFO, EDF или FAIR)
+    uint32_t duplicate_window_minutes; // Окно поиска дубликатов (0 - отключено)
+    uint32_t duplicate_index_capacity; // Слотов индекса дубликатов на минуту
+    uint32_t partials_per_minute;  // Лимит partials в минуту на фермера (0 - без лимита)
+    char validation_stages[256];   // Порядок этапов валидации ("" - по стоимости)
+    char journal_directory[512];   // Журнал принятых partials ("" - отключен)
+    uint32_t journal_sync_interval_ms; // Интервал group commit журнала
+    uint32_t journal_sync_records;     // Записей до внеочередного group commit
+    uint32_t journal_retention_seconds;// Окно PPLNS, хранимое в журнале
 } pool_config_t;
 
 // Статистика пула
@@ -38,6 +51,8 @@ typedef struct {
     double total_netspace;     // В TiB
     uint64_t total_points;
     uint64_t current_difficulty;
+    uint64_t partial_latency_p50_ns; // Время валидации принятых partials
+    uint64_t partial_latency_p99_ns;
 } pool_stats_t;
 
 // Основной контекст пула
@@ -48,7 +63,7 @@ typedef struct {
     
     // Потоки
     pthread_t main_thread;
-    pthread_t partial_processor_thread;
+    partial_workers_t partial_workers; // Пул потоков валидации partials
     pthread_t blockchain_sync_thread;
     pthread_t payment_processor_thread;
     
@@ -73,9 +88,14 @@ bool pool_start(void);
 bool pool_stop(void);
 bool pool_cleanup(void);
 
+// Прием partials: постановка в очередь воркеров валидации без блокировки.
+// При переполнении очереди возвращает VALIDATION_RATE_LIMITED.
+partial_validation_result_t pool_submit_partial(const partial_t* partial);
+
 // Утилиты
 pool_context_t* pool_get_context(void);
 const char* pool_state_to_string(pool_state_t state);
+void pool_update_statistics(void);
 void pool_log_statistics(void);
 
 // Обработчики ошибок
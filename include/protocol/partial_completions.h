@@ -0,0 +1,65 @@
+#ifndef PARTIAL_COMPLETIONS_H
+#define PARTIAL_COMPLETIONS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "protocol/partials.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Результат асинхронной валидации partial
+typedef struct {
+    uint64_t ticket;               // Номер, выданный при постановке
+    uint8_t launcher_id[32];
+    uint64_t points;
+    partial_validation_result_t result;
+} partial_completion_t;
+
+typedef struct {
+    uint64_t issued;               // Выдано номеров
+    uint64_t published;            // Завершено валидаций
+    uint64_t delivered_callback;   // Передано через callback
+    uint64_t delivered_poll;       // Забрано опросом кольца
+    uint64_t dropped;              // Потеряно из-за переполнения кольца
+    uint32_t pending;              // Ожидают опроса в кольце
+    uint32_t capacity;
+} partial_completion_stats_t;
+
+// Callback получает завершения пачкой из потока воркера. Должен быть
+// коротким: воркер не берет новые partials, пока callback не вернется.
+typedef void (*partial_completion_fn)(const partial_completion_t* completions, size_t count,
+                                      void* user);
+
+// Кольцо завершений для опроса. Если зарегистрирован callback,
+// завершения передаются ему и в кольцо не попадают.
+bool partial_completions_init(uint32_t capacity);
+void partial_completions_cleanup(void);
+// Будит ожидающих в partial_completions_poll, новые завершения
+// при этом еще принимаются
+void partial_completions_close(void);
+
+// Регистрация не зависит от init/cleanup. NULL - вернуться к опросу.
+void partial_completions_set_callback(partial_completion_fn callback, void* user);
+
+// Новый номер асинхронной отправки (всегда > 0)
+uint64_t partial_completions_next_ticket(void);
+
+// Публикация пачки завершений: один захват мьютекса или один вызов callback
+void partial_completions_publish(const partial_completion_t* completions, size_t count);
+
+// Забирает до max_count завершений. При пустом кольце ждет до timeout_ms
+// (0 - без ожидания). Возвращает число забранных завершений.
+size_t partial_completions_poll(partial_completion_t* completions, size_t max_count,
+                                uint32_t timeout_ms);
+
+void partial_completions_get_stats(partial_completion_stats_t* stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PARTIAL_COMPLETIONS_H
@@ -0,0 +1,64 @@
+#ifndef PARTIAL_DEDUP_H
+#define PARTIAL_DEDUP_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Параметры по умолчанию (pool_config.json: partials.duplicate_window_minutes)
+#define PARTIAL_DEDUP_DEFAULT_WINDOW_MINUTES 10
+#define PARTIAL_DEDUP_DEFAULT_CAPACITY 65536   // Слотов в поколении (на минуту)
+#define PARTIAL_DEDUP_MAX_PROBES 32            // Длина линейного пробирования
+#define PARTIAL_DEDUP_HASH_SIZE 32             // SHA256 от proof
+
+// Запись, занятая partial при проверке. Если последующая валидация
+// не прошла, запись освобождается через partial_dedup_release.
+typedef struct {
+    uint64_t slot;                 // Индекс слота (UINT64_MAX - не занят)
+    uint64_t value;                // Записанное значение слота
+} partial_dedup_claim_t;
+
+// Статистика индекса дубликатов
+typedef struct {
+    uint64_t lookups;              // Проверено partials
+    uint64_t duplicates;           // Найдено дубликатов
+    uint64_t inserts;              // Зарегистрировано новых partials
+    uint64_t overflows;            // Не хватило слотов в поколении
+    uint64_t releases;             // Освобождено записей невалидных partials
+    double hit_rate;               // duplicates / lookups
+    uint64_t memory_bytes;         // Память всех поколений
+    uint32_t window_minutes;
+    uint32_t capacity;
+} partial_dedup_stats_t;
+
+// Индекс состоит из window_minutes + 1 поколений - по одной таблице
+// с открытой адресацией на каждую минуту. Устаревшее поколение целиком
+// переиспользуется при наступлении новой минуты без очистки и блокировок.
+// Инициализация и очистка не должны выполняться параллельно с проверками.
+bool partial_dedup_init(uint32_t window_minutes, uint32_t capacity);
+void partial_dedup_cleanup(void);
+bool partial_dedup_is_enabled(void);
+
+// Хэш доказательства, входящий в ключ (launcher_id, hash(proof)):
+// SHA256 от plot_size и первых pos_proof_size(plot_size) байт proof
+void partial_dedup_hash_proof(const uint8_t* proof, size_t proof_len, uint8_t plot_size,
+                              uint8_t* hash);
+
+// Атомарная проверка и регистрация partial. Возвращает true, если такой
+// (launcher_id, proof_hash) уже встречался в окне. Без блокировок, O(1).
+bool partial_dedup_check_and_insert(const uint8_t* launcher_id, const uint8_t* proof_hash,
+                                    uint64_t timestamp, uint64_t now,
+                                    partial_dedup_claim_t* claim);
+void partial_dedup_release(const partial_dedup_claim_t* claim);
+
+void partial_dedup_get_stats(partial_dedup_stats_t* stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PARTIAL_DEDUP_H
@@ -0,0 +1,98 @@
+#ifndef PARTIAL_EDF_QUEUE_H
+#define PARTIAL_EDF_QUEUE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <pthread.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct partial_t partial_t;
+
+// Число секундных корзин календаря. Должно покрывать дедлайн partial
+// с запасом, чтобы в одной корзине не смешивались живые дедлайны.
+#define PARTIAL_EDF_BUCKET_COUNT 64
+
+// Начальная оценка времени обработки одного partial
+#define PARTIAL_EDF_DEFAULT_SERVICE_US 1000
+
+#define PARTIAL_EDF_NIL UINT32_MAX
+
+// Завершений отброшенных асинхронных partials, публикуемых за раз
+#define PARTIAL_EDF_SHED_BATCH 32
+
+// Узел календаря в предвыделенном пуле
+typedef struct {
+    uint64_t deadline;             // timestamp + дедлайн, секунды
+    uint64_t enqueue_us;           // Время постановки в очередь
+    uint32_t ahead;                // Размер очереди на момент постановки
+    uint32_t next;                 // Следующий узел корзины или free-list
+} partial_edf_node_t;
+
+// Календарная очередь с порядком earliest-deadline-first. Корзина
+// соответствует секунде дедлайна (deadline % PARTIAL_EDF_BUCKET_COUNT),
+// внутри корзины порядок поступления. Partials, которые уже не успеют
+// до дедлайна, отбрасываются при извлечении без валидации.
+typedef struct partial_edf_queue_t {
+    partial_edf_node_t* nodes;
+    partial_t* storage;            // Данные partials, индекс совпадает с узлом
+    uint32_t capacity;
+    uint32_t size;
+    uint32_t free_head;
+    uint32_t deadline_seconds;
+
+    uint32_t bucket_head[PARTIAL_EDF_BUCKET_COUNT];
+    uint32_t bucket_tail[PARTIAL_EDF_BUCKET_COUNT];
+    uint64_t cursor;               // Самая ранняя секунда, где могут быть узлы
+
+    pthread_mutex_t mutex;
+    pthread_cond_t not_empty;
+    bool closed;
+
+    uint64_t service_estimate_us;  // EWMA времени обработки одного partial
+    uint32_t parallelism;          // Число потоков, обслуживающих очередь
+    uint64_t enqueued;
+    uint64_t dequeued;
+    uint64_t shed;                 // Отброшено как просроченные
+    uint64_t saved;                // Успели бы просрочиться в FIFO
+} partial_edf_queue_t;
+
+// Статистика EDF очереди
+typedef struct {
+    uint64_t enqueued;
+    uint64_t dequeued;
+    uint64_t shed;
+    uint64_t saved;
+    uint64_t service_estimate_us;
+    uint32_t size;
+} partial_edf_stats_t;
+
+bool partial_edf_queue_init(partial_edf_queue_t* queue, uint32_t capacity,
+                            uint32_t deadline_seconds);
+void partial_edf_queue_cleanup(partial_edf_queue_t* queue);
+
+size_t partial_edf_queue_push_batch(partial_edf_queue_t* queue, const partial_t* partials,
+                                    size_t count);
+// Блокирующее извлечение: ждет хотя бы один partial, который еще
+// успевает к дедлайну. Возвращает 0 только для закрытой пустой очереди.
+size_t partial_edf_queue_pop_batch(partial_edf_queue_t* queue, partial_t* partials,
+                                   size_t max_count);
+size_t partial_edf_queue_try_pop_batch(partial_edf_queue_t* queue, partial_t* partials,
+                                       size_t max_count);
+uint32_t partial_edf_queue_size(partial_edf_queue_t* queue);
+void partial_edf_queue_close(partial_edf_queue_t* queue);
+
+// Учет фактического времени обработки одного partial для оценки
+// выполнимости дедлайна. parallelism - число потоков-обработчиков.
+void partial_edf_queue_record_service(partial_edf_queue_t* queue, uint64_t service_us,
+                                      uint32_t parallelism);
+void partial_edf_queue_get_stats(partial_edf_queue_t* queue, partial_edf_stats_t* stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PARTIAL_EDF_QUEUE_H
@@ -0,0 +1,108 @@
+#ifndef PARTIAL_FAIR_QUEUE_H
+#define PARTIAL_FAIR_QUEUE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <pthread.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct partial_t partial_t;
+
+// Емкость подочереди одного фермера по умолчанию
+#define PARTIAL_FAIR_DEFAULT_FLOW_CAPACITY 64
+
+// Верхняя граница веса фермера: ограничивает число partials,
+// выдаваемых одному фермеру за раунд
+#define PARTIAL_FAIR_MAX_WEIGHT 1024
+
+#define PARTIAL_FAIR_NIL UINT32_MAX
+
+// Подочередь фермера. Узлы подочереди связаны через общий пул узлов
+typedef struct {
+    uint8_t launcher_id[32];
+    uint32_t head;                 // Первый узел подочереди
+    uint32_t tail;                 // Последний узел подочереди
+    uint32_t count;                // Partials в подочереди
+    uint32_t weight;               // Квант раунда в partials
+    uint64_t deficit;              // Неизрасходованный квант
+    uint32_t next_active;          // Следующий поток в кольце обслуживания
+    uint32_t table_slot;           // Слот в хэш-таблице потоков
+    bool in_service;               // Квант текущего визита уже начислен
+} partial_fair_flow_t;
+
+// Справедливая очередь deficit round robin по launcher_id. Каждый фермер
+// получает подочередь ограниченной емкости, диспетчер обходит активные
+// подочереди по кругу и выдает за визит до weight partials. Вес берется
+// из сложности фермера, поэтому пропускная способность пропорциональна
+// ожидаемым очкам, а не числу отправок. Вся память выделяется при
+// инициализации, push и pop не выделяют память.
+typedef struct partial_fair_queue_t {
+    partial_t* storage;            // Данные partials, индекс совпадает с узлом
+    uint32_t* node_next;           // Следующий узел подочереди или free-list
+    uint32_t capacity;
+    uint32_t size;
+    uint32_t free_node;
+
+    partial_fair_flow_t* flows;    // Пул потоков, не больше capacity активных
+    uint32_t free_flow;
+    uint32_t* table;               // Открытая адресация: индекс потока или NIL
+    uint32_t table_mask;
+    uint32_t flow_capacity;        // Емкость подочереди фермера
+
+    uint32_t active_head;          // Кольцо активных потоков
+    uint32_t active_tail;
+    uint32_t active_flows;
+
+    pthread_mutex_t mutex;
+    pthread_cond_t not_empty;
+    bool closed;
+
+    uint64_t enqueued;
+    uint64_t dequeued;
+    uint64_t flow_rejected;        // Отказы из-за переполнения подочереди
+    uint64_t rounds;               // Визиты диспетчера к потокам
+    uint32_t max_active_flows;
+} partial_fair_queue_t;
+
+// Статистика справедливой очереди
+typedef struct {
+    uint64_t enqueued;
+    uint64_t dequeued;
+    uint64_t flow_rejected;
+    uint64_t rounds;
+    uint32_t active_flows;
+    uint32_t max_active_flows;
+    uint32_t size;
+} partial_fair_stats_t;
+
+// flow_capacity = 0 - PARTIAL_FAIR_DEFAULT_FLOW_CAPACITY
+bool partial_fair_queue_init(partial_fair_queue_t* queue, uint32_t capacity,
+                             uint32_t flow_capacity);
+void partial_fair_queue_cleanup(partial_fair_queue_t* queue);
+
+// Возвращает число поставленных partials. Постановка останавливается на
+// первом partial, чья подочередь или общая очередь заполнены.
+size_t partial_fair_queue_push_batch(partial_fair_queue_t* queue, const partial_t* partials,
+                                     size_t count);
+// Блокирующее извлечение, 0 только для закрытой пустой очереди
+size_t partial_fair_queue_pop_batch(partial_fair_queue_t* queue, partial_t* partials,
+                                    size_t max_count);
+size_t partial_fair_queue_try_pop_batch(partial_fair_queue_t* queue, partial_t* partials,
+                                        size_t max_count);
+uint32_t partial_fair_queue_size(partial_fair_queue_t* queue);
+void partial_fair_queue_close(partial_fair_queue_t* queue);
+
+// Вес фермера по сложности: partials с большей сложностью стоят больше
+// очков, поэтому такой фермер получает пропорционально больше за раунд
+uint32_t partial_fair_weight(uint64_t difficulty);
+void partial_fair_queue_get_stats(partial_fair_queue_t* queue, partial_fair_stats_t* stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PARTIAL_FAIR_QUEUE_H
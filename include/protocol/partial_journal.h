@@ -0,0 +1,80 @@
+#ifndef PARTIAL_JOURNAL_H
+#define PARTIAL_JOURNAL_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Параметры по умолчанию (pool_config.json: partials.journal_*)
+#define PARTIAL_JOURNAL_DEFAULT_SEGMENT_RECORDS 262144 // 32 МБ на сегмент
+#define PARTIAL_JOURNAL_DEFAULT_SYNC_INTERVAL_MS 10
+#define PARTIAL_JOURNAL_DEFAULT_SYNC_RECORDS 1024
+#define PARTIAL_JOURNAL_DEFAULT_RETENTION_SECONDS 86400
+
+// Размер записи журнала на диске
+#define PARTIAL_JOURNAL_RECORD_SIZE 128
+
+// Принятый partial в журнале
+typedef struct {
+    uint64_t sequence;             // Номер записи, назначается журналом
+    uint64_t timestamp;            // Временная метка partial
+    uint64_t difficulty;
+    uint64_t points;
+    uint8_t launcher_id[32];
+    uint8_t proof_hash[32];        // SHA256 доказательства (индекс дубликатов)
+} partial_journal_entry_t;
+
+typedef struct {
+    const char* directory;         // Каталог сегментов, создается при открытии
+    uint32_t segment_records;      // Записей в сегменте (0 - по умолчанию)
+    uint32_t sync_interval_ms;     // Максимальная задержка group commit
+    uint32_t sync_records;         // Число записей, запускающее group commit
+    uint32_t retention_seconds;    // Окно PPLNS: более старые сегменты удаляются
+} partial_journal_config_t;
+
+typedef struct {
+    uint64_t appended;             // Записей добавлено с момента открытия
+    uint64_t appended_points;
+    uint64_t replayed;             // Записей восстановлено при открытии
+    uint64_t replayed_points;
+    uint64_t replay_ns;            // Время восстановления
+    uint64_t syncs;                // Выполненных group commit
+    uint64_t durable_sequence;     // Последняя запись, гарантированно на диске
+    uint64_t segments_truncated;
+    uint32_t segments;             // Сегментов на диске
+} partial_journal_stats_t;
+
+// Вызывается при открытии для каждой записи в окне хранения,
+// в порядке номеров записей
+typedef void (*partial_journal_replay_fn)(const partial_journal_entry_t* entry, void* user);
+
+// Журнал - append-only набор сегментов фиксированного размера, отображенных
+// в память (mmap). Запись копируется в сегмент под коротким мьютексом,
+// сброс на диск (msync) выполняет фоновый поток пачками: по интервалу или
+// по числу записей, поэтому потоки валидации не ждут fsync. Каждая запись
+// защищена CRC32C, оборванный хвост сегмента отбрасывается при восстановлении.
+bool partial_journal_open(const partial_journal_config_t* config,
+                          partial_journal_replay_fn replay, void* user);
+void partial_journal_close(void);
+bool partial_journal_is_enabled(void);
+
+bool partial_journal_append(const partial_journal_entry_t* entry, uint64_t* sequence);
+// Ожидание, пока запись sequence попадет на диск. timeout_ms = 0 - без ожидания.
+bool partial_journal_wait_durable(uint64_t sequence, uint32_t timeout_ms);
+// Синхронный group commit всех добавленных записей
+bool partial_journal_sync(void);
+// Удаление закрытых сегментов, все записи которых старше now - retention.
+// Фоновый поток вызывает ее сам; возвращает число удаленных сегментов.
+size_t partial_journal_truncate(uint64_t now);
+
+void partial_journal_get_stats(partial_journal_stats_t* stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PARTIAL_JOURNAL_H
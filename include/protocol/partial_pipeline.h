@@ -0,0 +1,62 @@
+#ifndef PARTIAL_PIPELINE_H
+#define PARTIAL_PIPELINE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "protocol/partials.h"
+#include "metrics.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Этапы валидации partial
+typedef enum {
+    PARTIAL_STAGE_DEADLINE,        // Дедлайн по временной метке
+    PARTIAL_STAGE_CHALLENGE,       // Совпадение challenge с точкой сигнейджа
+    PARTIAL_STAGE_DUPLICATE,       // Индекс дубликатов
+    PARTIAL_STAGE_RATE_LIMIT,      // Ограничение partials в минуту на фермера
+    PARTIAL_STAGE_PROOF,           // Доказательство пространства
+    PARTIAL_STAGE_SINGLETON,       // Синглтон и членство в пуле
+    PARTIAL_STAGE_SIGNATURE,       // BLS подпись
+    PARTIAL_STAGE_COUNT
+} partial_stage_id_t;
+
+// Статистика этапа
+typedef struct {
+    const char* name;
+    uint32_t position;             // Позиция в текущем порядке
+    uint64_t estimated_cost_ns;    // Оценка стоимости этапа на один partial
+    uint64_t executions;           // Partials, дошедших до этапа
+    uint64_t rejections;           // Partials, отклоненных этапом
+    uint64_t time_ns;              // Суммарное время этапа
+    metrics_latency_summary_t latency; // Распределение времени этапа на partial
+} partial_stage_stats_t;
+
+// Настройка конвейера. order - список имен этапов через запятую
+// (например "deadline,challenge,dedup"). Перечисленные этапы выполняются
+// первыми в заданном порядке, остальные добавляются после них по
+// возрастанию оценки стоимости. NULL или пустая строка - порядок по стоимости.
+// partials_per_minute = 0 отключает ограничение частоты.
+// Настройка не должна выполняться параллельно с валидацией.
+bool partial_pipeline_configure(const char* order, uint32_t deadline_seconds,
+                                uint32_t partials_per_minute);
+size_t partial_pipeline_get_order(partial_stage_id_t* order, size_t max_count);
+
+// Прогон partial через этапы до первого отказа. Возвращает VALIDATION_SUCCESS,
+// если пройдены все этапы, иначе результат отклонившего этапа.
+partial_validation_result_t partial_pipeline_run(partial_validation_context_t* ctx);
+void partial_pipeline_run_batch(partial_validation_context_t* contexts, size_t count,
+                                partial_validation_result_t* results);
+
+const char* partial_stage_to_string(partial_stage_id_t stage);
+bool partial_pipeline_get_stage_stats(partial_stage_id_t stage, partial_stage_stats_t* stats);
+void partial_pipeline_reset_stats(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PARTIAL_PIPELINE_H
@@ -0,0 +1,48 @@
+#ifndef PARTIAL_POINTS_H
+#define PARTIAL_POINTS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Статистика очков в окне PPLNS
+typedef struct {
+    uint64_t total_points;         // Сумма очков всех фермеров в окне
+    uint64_t credited_points;      // Начислено с момента инициализации
+    uint64_t expired_points;       // Вышло из окна
+    uint64_t stale_credits;        // Начисления старше окна (пропущены)
+    uint32_t launchers;            // Фермеров с очками в окне
+    uint32_t window_seconds;
+} partial_points_stats_t;
+
+// Очки фермеров хранятся по launcher_id и по минутам начисления:
+// корзина минуты, вышедшей из окна, целиком вычитается из сумм.
+// Окно совпадает с окном хранения журнала, поэтому после перезапуска
+// восстановление журнала воспроизводит те же суммы.
+// Инициализация и очистка не должны выполняться параллельно с начислением.
+bool partial_points_init(uint32_t window_seconds);
+void partial_points_cleanup(void);
+bool partial_points_is_enabled(void);
+
+// Начисление очков фермеру за partial с меткой времени timestamp.
+// В launcher_points возвращается сумма очков фермера в окне.
+bool partial_points_credit(const uint8_t* launcher_id, uint64_t points,
+                           uint64_t timestamp, uint64_t now, uint64_t* launcher_points);
+
+// Вычитание корзин, вышедших из окна к моменту now. Возвращает число вычтенных очков.
+uint64_t partial_points_expire(uint64_t now);
+
+// Сумма очков фермера в окне (0, если фермер неизвестен)
+uint64_t partial_points_get(const uint8_t* launcher_id);
+
+void partial_points_get_stats(partial_points_stats_t* stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PARTIAL_POINTS_H
@@ -0,0 +1,74 @@
+#ifndef PARTIAL_WORKERS_H
+#define PARTIAL_WORKERS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <pthread.h>
+
+#include "protocol/partials.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Максимальное число partials, забираемых воркером из очереди за раз
+#define PARTIAL_WORKERS_BATCH_SIZE 32
+
+// Пул потоков валидации partials. Производители (Go/cgo потоки) только
+// кладут partial в очередь, валидацию выполняют воркеры.
+typedef struct {
+    partial_queue_t queue;         // Очередь входящих partials
+    pthread_t* threads;            // Потоки воркеров
+    uint32_t thread_count;         // Количество запущенных воркеров
+    bool running;                  // Пул запущен (доступ через __atomic_*)
+    uint32_t inflight;             // Отправители внутри submit/reserve..commit (__atomic_*)
+    uint64_t processed;            // Обработано partials (доступ через __atomic_*)
+    uint64_t rejected;             // Отклонено из-за переполнения очереди
+} partial_workers_t;
+
+// Запуск и остановка пула. Остановка сначала закрывает прием, затем ждет
+// отправителей, уже вошедших в submit или держащих резервирование, и
+// только после этого закрывает и освобождает очередь.
+bool partial_workers_start(partial_workers_t* workers, uint32_t thread_count,
+                           uint32_t queue_size);
+// Запуск с выбором дисциплины очереди. В режиме PARTIAL_QUEUE_EDF воркеры
+// забирают partials в порядке дедлайна (timestamp + deadline_seconds)
+// и отбрасывают не успевающие без валидации. В режиме PARTIAL_QUEUE_FAIR
+// каждый launcher_id получает подочередь, обслуживаемую по кругу.
+bool partial_workers_start_mode(partial_workers_t* workers, uint32_t thread_count,
+                                uint32_t queue_size, partial_queue_mode_t mode,
+                                uint32_t deadline_seconds);
+void partial_workers_stop(partial_workers_t* workers);
+bool partial_workers_is_running(const partial_workers_t* workers);
+
+// Постановка partial в очередь без блокировки. При переполнении очереди
+// возвращает VALIDATION_RATE_LIMITED, при успехе - VALIDATION_SUCCESS.
+partial_validation_result_t partial_workers_submit(partial_workers_t* workers,
+                                                   const partial_t* partial);
+
+// Zero-copy постановка: partial записывается прямо в память очереди.
+// reserve возвращает NULL, если пул остановлен или очередь заполнена
+// (учитывается в rejected). Каждый успешный reserve требует commit либо
+// abort, если partial не будет поставлен.
+partial_t* partial_workers_reserve(partial_workers_t* workers,
+                                   partial_queue_reservation_t* reservation);
+partial_validation_result_t partial_workers_commit(partial_workers_t* workers,
+                                                   partial_queue_reservation_t* reservation);
+void partial_workers_abort(partial_workers_t* workers, partial_queue_reservation_t* reservation);
+
+// Асинхронная постановка: номер выдается сразу после постановки в очередь,
+// результат валидации воркер публикует пачкой через partial_completions
+// (callback или опрос кольца). При отказе *ticket = 0 и завершения не будет.
+partial_validation_result_t partial_workers_submit_async(partial_workers_t* workers,
+                                                         const partial_t* partial,
+                                                         uint64_t* ticket);
+partial_validation_result_t partial_workers_commit_async(partial_workers_t* workers,
+                                                         partial_queue_reservation_t* reservation,
+                                                         uint64_t* ticket);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PARTIAL_WORKERS_H
@@ -6,17 +6,31 @@
 #include <stddef.h>
 #include <pthread.h>
 
+#include "protocol/singleton.h"
+#include "protocol/partial_dedup.h"
+#include "protocol/partial_edf_queue.h"
+#include "protocol/partial_fair_queue.h"
+#include "blockchain/chia_operations.h"
+#include "security/proof_verification.h"
+#include "security/pos_verifier.h"
+#include "metrics.h"
+
 #ifdef __cplusplus
 extern "C" {
 #endif
 
 // Forward declarations
 typedef struct partial_t partial_t;
-typedef struct partial_queue_node_t partial_queue_node_t;
+
+// Размер строки кеша для выравнивания разделяемых счетчиков
+#define PARTIAL_QUEUE_CACHE_LINE 64
+
+// Размер очереди по умолчанию (partials.max_queue_size в pool_config.json)
+#define PARTIAL_QUEUE_DEFAULT_SIZE 10000
 
 // Структура частичного решения
 struct partial_t {
-    uint8_t proof[264];           // Доказательство пространства
+    uint8_t proof[POS_MAX_PROOF_SIZE]; // Доказательство пространства (pos_proof_size байт)
     uint8_t farmer_id[48];        // ID фермера (BLS публичный ключ)
     uint8_t launcher_id[32];      // Launcher ID синглтона
     uint64_t timestamp;           // Временная метка
@@ -25,13 +39,21 @@ struct partial_t {
     uint8_t signature[96];        // BLS подпись
     uint8_t challenge[32];        // Вызов
     uint8_t plot_size;            // Размер плота
+    uint8_t pool_contract_puzzle_hash[32]; // Пазл пула, на который сделан плот
+    uint8_t plot_public_key[48];  // Публичный ключ плота
+    uint64_t ticket;              // Номер асинхронной отправки (0 - без уведомления)
 };
 
-// Структура узла очереди
-struct partial_queue_node_t {
+// Слот кольцевого буфера очереди. Номер последовательности определяет,
+// кто владеет слотом: sequence == pos - слот свободен для производителя
+// позиции pos, sequence == pos + 1 - данные готовы для потребителя.
+// Слот, отмененный partial_queue_abort, публикуется с skipped: потребитель
+// пропускает его, не передавая partial дальше.
+typedef struct {
+    uint64_t sequence;
+    bool skipped;
     partial_t partial;
-    partial_queue_node_t* next;
-};
+} __attribute__((aligned(PARTIAL_QUEUE_CACHE_LINE))) partial_queue_slot_t;
 
 // Результат валидации
 typedef enum {
@@ -48,15 +70,72 @@ typedef enum {
     VALIDATION_TOO_LATE
 } partial_validation_result_t;
 
-// Структура очереди
+#define PARTIAL_RESULT_COUNT (VALIDATION_TOO_LATE + 1)
+
+// Режим планирования очереди
+typedef enum {
+    PARTIAL_QUEUE_FIFO,            // Lock-free кольцо, порядок поступления
+    PARTIAL_QUEUE_EDF,             // Календарная очередь, ранний дедлайн первым
+    PARTIAL_QUEUE_FAIR             // Deficit round robin по фермерам
+} partial_queue_mode_t;
+
+// Структура очереди: ограниченный lock-free MPMC кольцевой буфер
+// с предвыделенными слотами. Позиции производителей и потребителей
+// разнесены по разным строкам кеша, чтобы не было ложного разделения.
+// Все поля, кроме slots и max_size, изменяются только через __atomic_*.
 typedef struct {
-    partial_queue_node_t* head;    // Голова очереди
-    partial_queue_node_t* tail;    // Хвост очереди
-    uint32_t max_size;             // Максимальный размер
-    uint32_t size;                 // Текущий размер
-    pthread_mutex_t mutex;         // Мьютекс для синхронизации
-    pthread_cond_t cond;           // Условная переменная
-} partial_queue_t;
+    partial_queue_slot_t* slots;   // Предвыделенные слоты
+    uint32_t max_size;             // Максимальный размер (емкость кольца)
+    uint8_t pad0[PARTIAL_QUEUE_CACHE_LINE - sizeof(void*) - sizeof(uint32_t)];
+    uint64_t enqueue_pos;          // Следующая позиция производителя
+    uint8_t pad1[PARTIAL_QUEUE_CACHE_LINE - sizeof(uint64_t)];
+    uint64_t dequeue_pos;          // Следующая позиция потребителя
+    uint8_t pad2[PARTIAL_QUEUE_CACHE_LINE - sizeof(uint64_t)];
+    uint32_t wake_seq;             // Слово futex для пробуждения потребителей
+    uint32_t idle_consumers;       // Число потребителей, ожидающих на futex
+    uint32_t closed;               // Очередь закрыта, потребители не блокируются
+    partial_edf_queue_t* edf;      // Не NULL в режиме EDF: кольцо не используется
+    partial_fair_queue_t* fair;    // Не NULL в режиме FAIR: кольцо не используется
+} __attribute__((aligned(PARTIAL_QUEUE_CACHE_LINE))) partial_queue_t;
+
+// Резервирование места в очереди для записи partial на месте. В режиме
+// FIFO partial указывает прямо в слот кольца, в режимах EDF и FAIR - на
+// staging, который копируется в очередь при подтверждении.
+typedef struct {
+    partial_t* partial;            // Куда вызывающий записывает partial
+    uint64_t position;             // Позиция слота в кольце
+    partial_t staging;
+} partial_queue_reservation_t;
+
+// Размер сообщения, подписываемого фермером
+#define PARTIAL_SIGNATURE_MESSAGE_SIZE 128
+
+// Контекст валидации одного partial. Создается в начале обработки и
+// проходит через все этапы: внешнее состояние (синглтон, точка сигнейджа)
+// запрашивается не более одного раза, промежуточные хэши и разобранное
+// доказательство вычисляются один раз и переиспользуются.
+typedef struct {
+    const partial_t* partial;
+    uint64_t current_time;         // Время начала обработки
+    
+    singleton_t singleton;         // Синглтон фермера
+    bool singleton_resolved;       // Синглтон уже запрашивался
+    bool singleton_found;          // singleton_init завершился успешно
+    
+    signage_point_t signage_point; // Текущая точка сигнейджа
+    bool signage_point_resolved;
+    
+    uint8_t proof_hash[PARTIAL_DEDUP_HASH_SIZE];
+    bool proof_hash_ready;
+    
+    uint8_t signature_message[PARTIAL_SIGNATURE_MESSAGE_SIZE];
+    bool signature_message_ready;
+    
+    proof_metadata_t proof_metadata; // Разобранное доказательство
+    bool proof_verified;
+    
+    partial_dedup_claim_t dedup_claim; // Запись в индексе дубликатов
+} partial_validation_context_t;
 
 // Совместимость со старым кодом
 #define PARTIAL_VALID VALIDATION_SUCCESS
@@ -70,8 +149,27 @@ typedef struct {
 
 // Функции очереди
 bool partial_queue_init(partial_queue_t* queue, uint32_t capacity);
+bool partial_queue_init_edf(partial_queue_t* queue, uint32_t capacity, uint32_t deadline_seconds);
+bool partial_queue_init_fair(partial_queue_t* queue, uint32_t capacity, uint32_t flow_capacity);
+partial_queue_mode_t partial_queue_get_mode(const partial_queue_t* queue);
 bool partial_queue_push(partial_queue_t* queue, const partial_t* partial);
 bool partial_queue_pop(partial_queue_t* queue, partial_t* partial);
+bool partial_queue_try_pop(partial_queue_t* queue, partial_t* partial);
+size_t partial_queue_push_batch(partial_queue_t* queue, const partial_t* partials, size_t count);
+// Zero-copy постановка: reserve возвращает память под partial (NULL, если
+// кольцо заполнено), commit публикует ее потребителям. Зарезервированный
+// в кольце слот должен быть подтвержден или отменен: до этого потребители не видят
+// ни его, ни следующие за ним partials. В режимах EDF и FAIR commit может
+// вернуть false, если очередь заполнилась.
+partial_t* partial_queue_reserve(partial_queue_t* queue, partial_queue_reservation_t* reservation);
+bool partial_queue_commit(partial_queue_t* queue, partial_queue_reservation_t* reservation);
+// Отмена резервирования, если partial не будет подтвержден (ошибка
+// разбора, ранний выход). Слот кольца публикуется как пропуск, иначе
+// потребители навсегда остановились бы перед ним.
+void partial_queue_abort(partial_queue_t* queue, partial_queue_reservation_t* reservation);
+size_t partial_queue_pop_batch(partial_queue_t* queue, partial_t* partials, size_t max_count);
+uint32_t partial_queue_size(const partial_queue_t* queue);
+void partial_queue_close(partial_queue_t* queue);
 void partial_queue_cleanup(partial_queue_t* queue);
 
 // Функции валидации
@@ -80,15 +178,51 @@ bool partial_verify_proof(const partial_t* partial);
 bool partial_verify_signature(const partial_t* partial);
 bool partial_verify_challenge(const uint8_t* challenge);
 
+// Контекст валидации. Данные, общие для пачки, передаются через set_*,
+// остальное запрашивается лениво при первом обращении.
+void partial_context_init(partial_validation_context_t* ctx, const partial_t* partial);
+void partial_context_set_signage_point(partial_validation_context_t* ctx,
+                                       const signage_point_t* signage_point);
+void partial_context_set_singleton(partial_validation_context_t* ctx,
+                                   const singleton_t* singleton, bool found);
+const singleton_t* partial_context_get_singleton(partial_validation_context_t* ctx);
+const signage_point_t* partial_context_get_signage_point(partial_validation_context_t* ctx);
+const uint8_t* partial_context_get_proof_hash(partial_validation_context_t* ctx);
+const uint8_t* partial_context_get_signature_message(partial_validation_context_t* ctx);
+
+// Варианты функций валидации, работающие с контекстом
+partial_validation_result_t partial_validate_ctx(partial_validation_context_t* ctx);
+bool partial_verify_proof_ctx(partial_validation_context_t* ctx);
+bool partial_verify_signature_ctx(partial_validation_context_t* ctx);
+bool partial_verify_challenge_ctx(partial_validation_context_t* ctx);
+
+// Пакетная проверка доказательств контекстов indices[0..count) одним
+// вызовом proof_verify_space_batch. results[j] - для indices[j].
+void partial_verify_proof_batch_ctx(partial_validation_context_t* contexts, const size_t* indices,
+                                    size_t count, partial_validation_result_t* results);
+
+// Пакетная валидация: точка сигнейджа запрашивается один раз на пачку,
+// синглтон - один раз на уникальный launcher_id, подписи и доказательства
+// проверяются одним пакетным проходом. results[i] - результат для partials[i].
+// Возвращает количество валидных partials.
+size_t partial_validate_batch(const partial_t* const* partials, size_t count,
+                              partial_validation_result_t* results);
+
 // Основные функции
 bool partials_init(void);
 bool partials_add(const partial_t* partial);
-bool partials_process(const partial_t* partial);
+bool partial_process(const partial_t* partial);
+size_t partial_process_batch(const partial_t* const* partials, size_t count,
+                             partial_validation_result_t* results);
 
 // Вспомогательные функции
+const char* partial_result_to_string(partial_validation_result_t result);
 void partial_log_validation_result(partial_validation_result_t result, 
                                    const uint8_t* launcher_id);
 void partials_get_stats(uint64_t* valid, uint64_t* invalid, uint64_t* total);
+// Распределение времени валидации partials с данным результатом
+bool partials_get_latency(partial_validation_result_t result, metrics_latency_summary_t* summary);
+void partials_reset_stats(void);
 
 #ifdef __cplusplus
 }
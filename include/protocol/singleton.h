@@ -34,9 +34,16 @@ bool singleton_init(const uint8_t* launcher_id, singleton_t* singleton);
 bool singleton_validate_ownership(const singleton_t* singleton, const uint8_t* signature);
 bool singleton_verify_pool_membership(const singleton_t* singleton);
 
+// Смена ключа владельца: прежний ключ удаляется из кеша распакованных
+// публичных ключей BLS
+bool singleton_set_owner_public_key(singleton_t* singleton, const uint8_t* owner_public_key);
+
 // Управление состоянием
 bool singleton_update_state(singleton_t* singleton);
 bool singleton_absorb_rewards(singleton_t* singleton);
+// Поглощение по многим синглтонам: транзакции подписываются ключом пула
+// одним пакетом, баланс обнуляется у синглтонов с отправленной транзакцией
+bool singleton_absorb_rewards_batch(singleton_t* const* singletons, size_t count);
 
 // Работа с блокчейном
 bool singleton_sync_with_blockchain(singleton_t* singleton);
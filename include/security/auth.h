@@ -49,6 +49,11 @@ bool auth_bls_verify_signature(const uint8_t* public_key, const uint8_t* message
                               size_t message_len, const uint8_t* signature);
 bool auth_bls_sign_message(const uint8_t* private_key, const uint8_t* message, 
                           size_t message_len, uint8_t* signature);
+// Пакетная подпись count сообщений ключом пула из auth_init (выплаты,
+// поглощения): signatures - count * 96 байт, подписи совпадают с
+// auth_bls_sign_message по приватному ключу пула
+bool auth_bls_sign_messages(const uint8_t* const* messages, const size_t* message_lens,
+                           size_t count, uint8_t* signatures);
 
 // Управление сессиями
 auth_session_t* auth_create_session(const uint8_t* farmer_id);
@@ -0,0 +1,134 @@
+#ifndef BLS_H
+#define BLS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Сжатые точки BLS12-381 в формате ZCash: G1 - 48 байт, G2 - 96 байт
+#define BLS_PUBLIC_KEY_SIZE 48
+#define BLS_SIGNATURE_SIZE 96
+
+// Тег домена схемы AugSchemeMPL, которую использует протокол пула:
+// подписывается public_key || message
+#define BLS_AUG_DST "BLS_SIG_BLS12381G2_XMD:SHA-256_SSWU_RO_AUG_"
+
+// Публичный ключ: сжатая точка G1 на кривой, в подгруппе порядка r, не
+// бесконечность
+bool bls_public_key_is_valid(const uint8_t* public_key);
+
+// Подпись: сжатая точка G2 на кривой и в подгруппе порядка r
+bool bls_signature_is_valid(const uint8_t* signature);
+
+// Распакованный публичный ключ: аффинная точка G1 в форме Монтгомери,
+// прошедшая проверку кривой и подгруппы. Спаривание использует ее без
+// преобразований, поэтому это все, что нужно проверке от ключа.
+typedef struct {
+    uint64_t x[6];
+    uint64_t y[6];
+} bls_public_key_t;
+
+// Распаковка с проверками bls_public_key_is_valid, без кеша ключей
+bool bls_public_key_decode(const uint8_t* public_key, bls_public_key_t* decoded);
+
+// hash_to_curve BLS12381G2_XMD:SHA-256_SSWU_RO_ с тегом dst (до 255
+// байт). Результат - сжатая точка G2 (BLS_SIGNATURE_SIZE байт).
+bool bls_hash_to_g2(const uint8_t* message, size_t message_len, const uint8_t* dst,
+                    size_t dst_len, uint8_t* out);
+
+// hash_to_curve для count сообщений с общим тегом: expand_message_xmd
+// считается многобуферным SHA256 по восемь сообщений на AVX2. out -
+// count * BLS_SIGNATURE_SIZE байт, результат совпадает с bls_hash_to_g2.
+bool bls_hash_to_g2_batch(const uint8_t* const* messages, const size_t* message_lens,
+                          size_t count, const uint8_t* dst, size_t dst_len, uint8_t* out);
+
+// Проверка подписи AugSchemeMPL: e(pk, H(pk || message)) == e(g1, signature)
+bool bls_verify(const uint8_t* public_key, const uint8_t* message, size_t message_len,
+                const uint8_t* signature);
+
+// Пакетная проверка count независимых подписей AugSchemeMPL. Подписи
+// умножаются на случайные 64-битные множители r_i и проверяются одним
+// равенством prod e(r_i pk_i, H_i) == e(g1, sum r_i sig_i): общий цикл
+// Миллера по всем парам и одна финальная экспонента. Если пачка не
+// проходит, она делится пополам до отдельных подписей. Хэши pk_i || m_i
+// считаются пачкой, как в bls_hash_to_g2_batch. results[i] совпадает с
+// bls_verify для i-й подписи.
+void bls_verify_batch(const uint8_t* const* public_keys, const uint8_t* const* messages,
+                      const size_t* message_lens, const uint8_t* const* signatures,
+                      size_t count, bool* results);
+
+// Ключ подписи AugSchemeMPL с предвычислениями. База подписи H(pk || m)
+// своя у каждого сообщения, постоянен скаляр: на G2 psi = [x], поэтому
+// секретный ключ раскладывается по основанию |x| на четыре 64-битные
+// цифры, и [sk] H считается гребенкой по H, psi(H), psi^2(H), psi^3(H) -
+// 64 удвоения и 64 сложения вместо 255 удвоений и около 128 сложений.
+// Цифры знаковые: бит столбца выбирает +B_i или -B_i, поэтому нулевых
+// столбцов нет, а точка столбца выбирается без ветвлений по ключу.
+// comb эквивалентен секретному ключу, структуру нужно обнулять так же.
+#define BLS_SIGN_DIGITS 4
+#define BLS_SIGN_COMB_COLUMNS 64
+#define BLS_SIGN_THREAD_MIN 16          // С этого числа сообщений пакет - в потоках
+
+typedef struct {
+    uint8_t public_key[BLS_PUBLIC_KEY_SIZE];   // [sk] g1, префикс подписываемых сообщений
+    uint8_t comb[BLS_SIGN_COMB_COLUMNS];       // Столбец j: бит i - знак j-го разряда цифры i
+} bls_signer_t;
+
+// private_key - 32 байта big-endian, 0 < sk < r
+bool bls_signer_init(bls_signer_t* signer, const uint8_t* private_key);
+
+// Подпись AugSchemeMPL: [sk] H(pk || message), BLS_SIGNATURE_SIZE байт
+bool bls_sign(const bls_signer_t* signer, const uint8_t* message, size_t message_len,
+              uint8_t* signature);
+
+// Пакетная подпись count сообщений одним ключом: expand_message_xmd
+// пачкой на многобуферном SHA256, отображение и гребенка от
+// BLS_SIGN_THREAD_MIN сообщений - в потоках по числу CPU, аффинные
+// координаты всех подписей - одной инверсией. signatures - count *
+// BLS_SIGNATURE_SIZE байт, результат совпадает с bls_sign.
+bool bls_sign_batch(const bls_signer_t* signer, const uint8_t* const* messages,
+                    const size_t* message_lens, size_t count, uint8_t* signatures);
+
+// Мультискалярное умножение sum [scalars_i] points_i в G1 (алгоритм
+// Пиппенджера), например по ключам пакетной проверки со случайными
+// множителями. Скаляр i - scalar_words слов little-endian с адреса
+// scalars + i * scalar_words, от 1 до 4 слов (64 и 128 бит для пакетной
+// проверки). Окно выбирается по count, цифры окон знаковые, корзины
+// складываются в аффинных координатах с общей инверсией на уровень, от
+// 4096 точек окна считаются в потоках по числу CPU. out - сжатая точка
+// G1 (BLS_PUBLIC_KEY_SIZE байт), при count = 0 - бесконечность.
+bool bls_g1_multiexp(const bls_public_key_t* points, const uint64_t* scalars,
+                     size_t scalar_words, size_t count, uint8_t* out);
+
+// Реализация арифметики Fp: портативная на unsigned __int128 или ядра
+// MULX/ADCX/ADOX (BMI2 и ADX). По умолчанию при первом обращении
+// выбирается лучшая для процессора. set_impl возвращает false, если
+// реализация не поддерживается (используется тестами и бенчмарками).
+typedef enum {
+    BLS_FP_PORTABLE,
+    BLS_FP_MULX
+} bls_fp_impl_t;
+
+bls_fp_impl_t bls_fp_get_impl(void);
+bls_fp_impl_t bls_fp_best_impl(void);
+bool bls_fp_set_impl(bls_fp_impl_t impl);
+const char* bls_fp_impl_name(bls_fp_impl_t impl);
+
+// Ядра поля текущей реализации для дифференциальных тестов. Элемент Fp -
+// 6 слов little-endian в форме Монтгомери (R = 2^384), меньше p; элемент
+// Fp2 - 12 слов (c0, c1). Вход редукции t - 12 слов, меньше p * R.
+void bls_fp_mont_mul(uint64_t* r, const uint64_t* a, const uint64_t* b);
+void bls_fp_mont_sqr(uint64_t* r, const uint64_t* a);
+void bls_fp_mont_redc(uint64_t* r, const uint64_t* t);
+void bls_fp2_mont_mul(uint64_t* r, const uint64_t* a, const uint64_t* b);
+void bls_fp2_mont_sqr(uint64_t* r, const uint64_t* a);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // BLS_H
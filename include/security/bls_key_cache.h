@@ -0,0 +1,43 @@
+#ifndef BLS_KEY_CACHE_H
+#define BLS_KEY_CACHE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "security/bls.h"
+#include "optimizations.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define BLS_KEY_CACHE_WAYS 4                    // Записей в наборе
+#define BLS_KEY_CACHE_DEFAULT_CAPACITY 100000   // Фермеров по умолчанию
+
+// Кеш распакованных публичных ключей: сжатый ключ G1 -> точка, прошедшая
+// проверку кривой и подгруппы. Ключ фермера не меняется, поэтому записи
+// не истекают по времени: таблица фиксированного размера на число
+// фермеров, 4-ассоциативная с блокировкой на набор, при нехватке места
+// вытесняется давно не использованная запись. Заполняется лениво из
+// bls_verify и bls_verify_batch. Инициализация и очистка не должны
+// выполняться параллельно с поиском.
+bool bls_key_cache_init(uint32_t capacity);
+void bls_key_cache_cleanup(void);
+bool bls_key_cache_is_enabled(void);
+void bls_key_cache_clear(void);
+
+bool bls_key_cache_lookup(const uint8_t* public_key, bls_public_key_t* decoded);
+void bls_key_cache_store(const uint8_t* public_key, const bls_public_key_t* decoded);
+
+// Удаление ключа, например прежнего ключа владельца синглтона
+void bls_key_cache_invalidate(const uint8_t* public_key);
+
+// Статистика для cache_get_stats(CACHE_TYPE_SIGNATURE_VERIFICATION)
+bool bls_key_cache_get_stats(cache_stats_t* stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // BLS_KEY_CACHE_H
@@ -0,0 +1,110 @@
+#ifndef POS_VERIFIER_H
+#define POS_VERIFIER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Допустимые размеры плота для алгоритма chiapos (политика пула
+// проверяется отдельно в proof_validate_k_size)
+#define POS_MIN_K 18
+#define POS_MAX_K 50
+
+// Доказательство - 64 значения x по k бит, упакованные big-endian
+#define POS_PROOF_X_COUNT 64
+#define POS_MAX_PROOF_SIZE (POS_MAX_K * 8)
+
+#define POS_PLOT_ID_SIZE 32
+#define POS_CHALLENGE_SIZE 32
+#define POS_QUALITY_STRING_SIZE 32
+
+// Набор инструкций для ChaCha8 и BLAKE3
+typedef enum {
+    POS_ISA_SCALAR,
+    POS_ISA_AVX2,
+    POS_ISA_AVX512
+} pos_isa_t;
+
+// Размер доказательства в байтах для плота k (8 * k)
+size_t pos_proof_size(uint32_t k);
+
+// Доказательство, читаемое по месту без копирования: значения x
+// извлекаются из упакованных данных инструкциями BMI2, если процессор их
+// поддерживает и выбран не скалярный набор, иначе сдвигами. Данные должны
+// жить, пока используется представление.
+typedef struct {
+    const uint8_t* data;
+    size_t length;                     // pos_proof_size(k)
+    uint32_t k;
+} pos_proof_view_t;
+
+// false, если k вне диапазона или длина не соответствует k
+bool pos_proof_view_init(pos_proof_view_t* view, const uint8_t* proof, size_t proof_length,
+                         uint32_t k);
+uint64_t pos_proof_view_x(const pos_proof_view_t* view, uint32_t index);
+// Все POS_PROOF_X_COUNT значений x в порядке доказательства
+void pos_proof_view_xs(const pos_proof_view_t* view, uint64_t* xs);
+
+// Проверка доказательства пространства по алгоритму chiapos: f1 на
+// ChaCha8, сопоставление и свертка таблиц f2..f7 на BLAKE3, сравнение
+// выхода f7 с challenge. При успехе записывает строку качества
+// SHA256(challenge || x[qi] || x[qi+1]) в quality_string (может быть NULL).
+bool pos_verify_proof(const uint8_t* plot_id, uint32_t k, const uint8_t* challenge,
+                      const uint8_t* proof, size_t proof_length, uint8_t* quality_string);
+
+// Предварительные вычисления для размера k: константы верификатора и
+// запись в таблице выбора. Для k32..k35 выбирается реализация,
+// специализированная при компиляции, для остальных - обобщенная. До
+// вызова pos_verify_proof для этого k считает константы на каждый вызов.
+bool pos_verifier_precompute(uint32_t k);
+bool pos_verifier_is_specialized(uint32_t k);
+
+// Обобщенная реализация в обход таблицы выбора (для дифференциальных
+// тестов и бенчмарков)
+bool pos_verify_proof_generic(const uint8_t* plot_id, uint32_t k, const uint8_t* challenge,
+                              const uint8_t* proof, size_t proof_length,
+                              uint8_t* quality_string);
+
+// Диагностика отклоненного доказательства: сколько таблиц из 1..7
+// сопоставилось (1 - не сопоставилась уже таблица 2), POS_VERIFY_DEPTH_VALID -
+// выход f7 совпал с challenge. 0 - невалидные аргументы. generic выбирает
+// обобщенную реализацию в обход таблицы выбора.
+#define POS_VERIFY_DEPTH_VALID 8
+uint32_t pos_verify_proof_depth(const uint8_t* plot_id, uint32_t k, const uint8_t* challenge,
+                                const uint8_t* proof, size_t proof_length, bool generic);
+
+// Пакетная проверка count доказательств: таблицы 2..7 всех доказательств
+// пачки хэшируются общими вызовами ядра BLAKE3, поэтому векторные ядра
+// заполнены и на последних таблицах. results[i] и quality_strings[i]
+// (может быть NULL) совпадают с результатом pos_verify_proof для i-го.
+void pos_verify_proofs_batch(const uint8_t* const* plot_ids, const uint32_t* ks,
+                             const uint8_t* const* challenges, const uint8_t* const* proofs,
+                             const size_t* proof_lengths, size_t count,
+                             uint8_t (*quality_strings)[POS_QUALITY_STRING_SIZE], bool* results);
+
+// Выбор реализации ядер. По умолчанию при первом обращении выбирается
+// лучший набор инструкций процессора. set_isa возвращает false, если
+// набор не поддерживается (используется тестами и бенчмарками).
+pos_isa_t pos_verifier_get_isa(void);
+pos_isa_t pos_verifier_best_isa(void);
+bool pos_verifier_set_isa(pos_isa_t isa);
+const char* pos_isa_name(pos_isa_t isa);
+
+// Ядра, доступные для дифференциальных тестов. ChaCha8 пишет 64 байта
+// ключевого потока на каждый номер блока. BLAKE3 хэширует count входов
+// одинаковой длины (не больше 64 байт), расположенных с шагом stride,
+// по 32 байта результата на вход.
+void pos_chacha8_blocks(const uint8_t* key, const uint64_t* counters, size_t count,
+                        uint8_t* out);
+void pos_blake3_blocks(const uint8_t* inputs, size_t stride, size_t length, size_t count,
+                       uint8_t* out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // POS_VERIFIER_H
@@ -0,0 +1,51 @@
+#ifndef PROOF_CACHE_H
+#define PROOF_CACHE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "security/proof_verification.h"
+#include "optimizations.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define PROOF_CACHE_DIGEST_SIZE 32
+#define PROOF_CACHE_WAYS 4                     // Записей в наборе
+#define PROOF_CACHE_DEFAULT_NEGATIVE_TTL 30    // Секунд для отклоненных доказательств
+
+// Кеш результатов верификации доказательств. Две таблицы фиксированного
+// размера: принятые доказательства хранятся ttl_seconds, отклоненные -
+// negative_ttl_seconds. Ключ - дайджест (plot_id, challenge, sp, k, proof),
+// таблицы 4-ассоциативные с блокировкой на набор. Инициализация и
+// очистка не должны выполняться параллельно с поиском.
+bool proof_cache_init(uint32_t capacity, uint32_t ttl_seconds,
+                      uint32_t negative_capacity, uint32_t negative_ttl_seconds);
+void proof_cache_cleanup(void);
+bool proof_cache_is_enabled(void);
+void proof_cache_clear(void);
+
+// SHA256 от plot_id || challenge_hash || sp_hash || k_size || proof;
+// sp_hash NULL - challenge_hash
+void proof_cache_digest(const uint8_t* proof_data, size_t proof_length,
+                        const proof_verification_params_t* params, uint8_t* digest);
+
+// Поиск сначала среди принятых, затем среди отклоненных. При попадании
+// в принятые *result = PROOF_VALID и в metadata заполняются plot_id,
+// quality_string, quality и proof_size; iterations зависят от сложности
+// и вычисляются вызывающим.
+bool proof_cache_lookup(const uint8_t* digest, proof_metadata_t* metadata,
+                        proof_verification_result_t* result);
+void proof_cache_store(const uint8_t* digest, const proof_metadata_t* metadata);
+void proof_cache_store_negative(const uint8_t* digest, proof_verification_result_t result);
+
+// Статистика для cache_get_stats: negative выбирает таблицу отклоненных
+bool proof_cache_get_stats(bool negative, cache_stats_t* stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PROOF_CACHE_H
@@ -5,6 +5,17 @@
 #include <stdint.h>
 #include <stdbool.h>
 
+// Размеры плота, принимаемые пулом
+#define PROOF_MIN_K_SIZE 25
+#define PROOF_MAX_K_SIZE 50
+
+// Консенсусные константы расчета итераций (mainnet)
+#define PROOF_DIFFICULTY_CONSTANT_FACTOR ((unsigned __int128)1 << 67)
+#define PROOF_NUM_SPS_SUB_SLOT 64
+
+// Фильтр плотов: число нулевых старших бит входа фильтра (mainnet)
+#define PROOF_PLOT_FILTER_PREFIX_BITS 9
+
 // Параметры верификации Proof of Space
 typedef struct {
     uint64_t challenge;
@@ -12,6 +23,10 @@ typedef struct {
     uint64_t sub_slot_iters;      // 37.6 миллиардов для пула
     uint32_t difficulty;
     uint64_t required_iterations;
+    const uint8_t* plot_id;        // 32 байта: SHA256(pool_contract_puzzle_hash || plot_public_key)
+    const uint8_t* challenge_hash; // 32 байта: challenge_hash сабслота, вход фильтра плотов
+    const uint8_t* sp_hash;        // 32 байта: cc_sp_output_hash (NULL - challenge_hash,
+                                   // как для точки сигнейджа 0)
 } proof_verification_params_t;
 
 // Результат верификации
@@ -31,7 +46,8 @@ typedef struct {
     uint8_t plot_public_key[48];
     uint8_t farmer_public_key[48];
     uint8_t pool_public_key[48];
-    uint64_t quality;
+    uint8_t quality_string[32];
+    uint64_t quality;              // Старшие 8 байт quality_string (big-endian)
     uint64_t iterations;
     uint32_t proof_size;
 } proof_metadata_t;
@@ -46,13 +62,59 @@ proof_verification_result_t proof_verify_space(const uint8_t* proof_data,
                                               const proof_verification_params_t* params,
                                               proof_metadata_t* metadata);
 
-// Валидация качества
-bool proof_validate_quality(const uint8_t* proof_data, uint32_t k_size, 
-                           uint64_t challenge, uint64_t* quality);
+// challenge доказательства: pos_challenge = SHA256(filter_input), где
+// filter_input = SHA256(plot_id || challenge_hash || sp_hash). Возвращает
+// true, если плот проходит фильтр: первые PROOF_PLOT_FILTER_PREFIX_BITS бит
+// filter_input нулевые. sp_hash NULL - challenge_hash.
+bool proof_calculate_pos_challenge(const uint8_t* plot_id, const uint8_t* challenge_hash,
+                                   const uint8_t* sp_hash, uint8_t* pos_challenge);
+
+// Валидация качества: фильтр плотов, полная проверка доказательства
+// (pos_verify_proof) для pos_challenge и вычисление строки качества.
+// quality_string может быть NULL.
+bool proof_validate_quality(const uint8_t* proof_data, size_t proof_length,
+                           const proof_verification_params_t* params,
+                           uint8_t* quality_string, uint64_t* quality);
+
+// Пакетная верификация count доказательств. results[i] и metadata[i] те же,
+// что у proof_verify_space для i-го: доказательства без результата в кеше
+// проверяются pos_verify_proofs_batch (ядра BLAKE3/ChaCha8 выбираются один
+// раз по CPUID), итерации - calculate_iterations_quality_batch.
+void proof_verify_space_batch(const uint8_t* const* proofs, const size_t* proof_lengths,
+                              const proof_verification_params_t* params, size_t count,
+                              proof_metadata_t* metadata, proof_verification_result_t* results);
+
+// Проверка доказательства и вычисление качества без расчета итераций.
+// proof_verify_space = proof_verify_space_quality + proof_validate_iterations;
+// пакетный путь считает итерации всей пачки calculate_iterations_quality_batch.
+proof_verification_result_t proof_verify_space_quality(const uint8_t* proof_data,
+                                                      size_t proof_length,
+                                                      const proof_verification_params_t* params,
+                                                      proof_metadata_t* metadata);
+
+// Требуемые итерации по консенсусной формуле:
+// difficulty * difficulty_constant_factor * SHA256(quality_string || sp_hash)
+//     / (2^256 * (2k + 1) * 2^(k - 1)),
+// не меньше 1, с насыщением до UINT64_MAX. Вычисляется точно на 64x64->128
+// битных произведениях и без ветвлений.
+uint64_t calculate_iterations_quality(unsigned __int128 difficulty_constant_factor,
+                                      const uint8_t* quality_string, uint32_t k_size,
+                                      uint64_t difficulty, const uint8_t* sp_hash);
+
+// То же для count качеств за один проход: хэши считаются по 8 на AVX2,
+// результат побитово совпадает со скалярной версией. k_sizes и
+// difficulties - по значению на элемент.
+void calculate_iterations_quality_batch(unsigned __int128 difficulty_constant_factor,
+                                        const uint8_t (*quality_strings)[32],
+                                        const uint8_t (*sp_hashes)[32],
+                                        const uint32_t* k_sizes, const uint64_t* difficulties,
+                                        size_t count, uint64_t* iterations);
 
-// Валидация итераций
-bool proof_validate_iterations(uint64_t quality, uint64_t difficulty, 
-                              uint64_t sub_slot_iters, uint64_t* iterations);
+// Валидация итераций: доказательство годится, если требуемые итерации
+// меньше интервала точки сигнейджа sub_slot_iters / PROOF_NUM_SPS_SUB_SLOT
+bool proof_validate_iterations(const uint8_t* quality_string, const uint8_t* sp_hash,
+                               uint32_t k_size, uint64_t difficulty,
+                               uint64_t sub_slot_iters, uint64_t* iterations);
 
 // Проверка размера плота
 bool proof_validate_k_size(uint32_t k_size);
@@ -62,8 +124,9 @@ void proof_log_verification_result(proof_verification_result_t result,
                                   const uint8_t* plot_id);
 bool proof_calculate_points(uint64_t quality, uint64_t difficulty, uint64_t* points);
 
-// Оптимизированные версии (для ASM)
-bool proof_verify_space_optimized(const uint8_t* proof_data, uint32_t k_size,
-                                 uint64_t challenge, uint64_t* quality);
+// Оптимизированные версии (ядра ChaCha8/BLAKE3 выбираются по CPU)
+bool proof_verify_space_optimized(const uint8_t* proof_data, size_t proof_length,
+                                 const proof_verification_params_t* params,
+                                 uint64_t* quality);
 
 #endif // PROOF_VERIFICATION_H
@@ -85,6 +85,23 @@ absorb_transaction_t* smart_coin_create_absorb_transaction(const uint8_t* launch
     return transaction;
 }
 
+#define SMART_COIN_ABSORB_MESSAGE_SIZE 44
+
+// Сообщение для подписи: launcher_id || amount || fee
+static void smart_coin_absorb_message(const absorb_transaction_t* transaction, uint8_t* message) {
+    memcpy(message, transaction->launcher_id, 32);
+    memcpy(message + 32, &transaction->amount, sizeof(uint64_t));
+    memcpy(message + 40, &transaction->fee, sizeof(uint32_t));
+}
+
+// Создаем сырые байты транзакции (упрощенно)
+// В реальной реализации здесь будет создание полной транзакции Chia
+static void smart_coin_absorb_finish(absorb_transaction_t* transaction, const uint8_t* message) {
+    memcpy(transaction->transaction_bytes, message, SMART_COIN_ABSORB_MESSAGE_SIZE);
+    memcpy(transaction->transaction_bytes + SMART_COIN_ABSORB_MESSAGE_SIZE, transaction->signature, 96);
+    transaction->transaction_size = SMART_COIN_ABSORB_MESSAGE_SIZE + 96;
+}
+
 bool smart_coin_sign_absorb_transaction(absorb_transaction_t* transaction, const uint8_t* private_key) {
     if (!transaction || !private_key) {
         smart_coin_log("ERROR", "Невалидные параметры для подписи транзакции");
@@ -92,27 +109,71 @@ bool smart_coin_sign_absorb_transaction(absorb_transaction_t* transaction, const
     }
     
     // Создаем сообщение для подписи
-    uint8_t message[64];
-    memcpy(message, transaction->launcher_id, 32);
-    memcpy(message + 32, &transaction->amount, sizeof(uint64_t));
-    memcpy(message + 40, &transaction->fee, sizeof(uint32_t));
+    uint8_t message[SMART_COIN_ABSORB_MESSAGE_SIZE];
+    smart_coin_absorb_message(transaction, message);
     
     // Подписываем сообщение BLS подписью
-    if (!auth_bls_sign_message(private_key, message, 44, transaction->signature)) {
+    if (!auth_bls_sign_message(private_key, message, SMART_COIN_ABSORB_MESSAGE_SIZE, transaction->signature)) {
         smart_coin_log("ERROR", "Не удалось подписать транзакцию поглощения");
         return false;
     }
     
-    // Создаем сырые байты транзакции (упрощенно)
-    // В реальной реализации здесь будет создание полной транзакции Chia
-    memcpy(transaction->transaction_bytes, message, 44);
-    memcpy(transaction->transaction_bytes + 44, transaction->signature, 96);
-    transaction->transaction_size = 140;
+    smart_coin_absorb_finish(transaction, message);
     
     smart_coin_log("DEBUG", "Транзакция поглощения успешно подписана");
     return true;
 }
 
+bool smart_coin_sign_absorb_transactions(absorb_transaction_t* const* transactions, size_t count) {
+    if (count > 0 && !transactions) {
+        smart_coin_log("ERROR", "Невалидные параметры для подписи транзакций");
+        return false;
+    }
+    if (count == 0) {
+        return true;
+    }
+    
+    uint8_t* messages = (uint8_t*)malloc(count * SMART_COIN_ABSORB_MESSAGE_SIZE);
+    const uint8_t** message_ptrs = (const uint8_t**)malloc(count * sizeof(uint8_t*));
+    size_t* message_lens = (size_t*)malloc(count * sizeof(size_t));
+    uint8_t* signatures = (uint8_t*)malloc(count * 96);
+    bool success = messages && message_ptrs && message_lens && signatures;
+    
+    for (size_t i = 0; success && i < count; i++) {
+        if (!transactions[i]) {
+            smart_coin_log("ERROR", "Транзакция в пакете не может быть NULL");
+            success = false;
+            break;
+        }
+        message_ptrs[i] = messages + i * SMART_COIN_ABSORB_MESSAGE_SIZE;
+        message_lens[i] = SMART_COIN_ABSORB_MESSAGE_SIZE;
+        smart_coin_absorb_message(transactions[i], messages + i * SMART_COIN_ABSORB_MESSAGE_SIZE);
+    }
+    
+    // Весь пакет подписывает ключ пула: хеширование пачкой, готовая гребенка
+    if (success && !auth_bls_sign_messages(message_ptrs, message_lens, count, signatures)) {
+        smart_coin_log("ERROR", "Не удалось подписать пакет транзакций поглощения");
+        success = false;
+    }
+    
+    for (size_t i = 0; success && i < count; i++) {
+        memcpy(transactions[i]->signature, signatures + i * 96, 96);
+        smart_coin_absorb_finish(transactions[i], message_ptrs[i]);
+    }
+    
+    free(messages);
+    free(message_ptrs);
+    free(message_lens);
+    free(signatures);
+    
+    if (success) {
+        char log_msg[128];
+        snprintf(log_msg, sizeof(log_msg), "Подписано транзакций поглощения: %zu", count);
+        smart_coin_log("DEBUG", log_msg);
+    }
+    return success;
+}
+
 bool smart_coin_validate_conditions(const smart_coin_t* coin, const coin_conditions_t* conditions) {
     if (!coin || !conditions) {
         smart_coin_log("ERROR", "Невалидные параметры для проверки условий");
@@ -4,6 +4,7 @@
 #include "protocol/singleton.h"
 #include "security/auth.h"
 #include "math_operations.h"
+#include "optimizations.h"
 
 #include <stdio.h>
 #include <string.h>
@@ -14,6 +15,7 @@
 static GoLogCallback g_log_callback = NULL;
 static GoPartialCallback g_partial_callback = NULL;
 static GoPayoutCallback g_payout_callback = NULL;
+static GoCompletionCallback g_completion_callback = NULL;
 
 static void go_bridge_log(const char* level, const char* message) {
     time_t now = time(NULL);
@@ -50,11 +52,54 @@ bool go_bridge_cleanup(void) {
     g_log_callback = NULL;
     g_partial_callback = NULL;
     g_payout_callback = NULL;
+    g_completion_callback = NULL;
+    partial_completions_set_callback(NULL, NULL);
     
     go_bridge_log("INFO", "Go бридж очищен");
     return true;
 }
 
+bool go_bridge_load_pool_config(const PoolSettings* settings, pool_config_t* config) {
+    if (!settings || !config) {
+        return false;
+    }
+    
+    pool_load_default_config(config);
+    config->worker_threads = settings->worker_threads;
+    return true;
+}
+
+bool go_bridge_start_pool(const PoolSettings* settings) {
+    if (!settings) {
+        go_bridge_log("ERROR", "Параметры запуска пула не могут быть NULL");
+        return false;
+    }
+    
+    pool_config_t config;
+    go_bridge_load_pool_config(settings, &config);
+    
+    char log_msg[128];
+    snprintf(log_msg, sizeof(log_msg), "Запуск пула: воркеров валидации %u%s",
+             config.worker_threads, config.worker_threads == 0 ? " (по числу ядер)" : "");
+    go_bridge_log("INFO", log_msg);
+    
+    if (!pool_init(&config)) {
+        go_bridge_log("ERROR", "Не удалось инициализировать пул");
+        return false;
+    }
+    if (!pool_start()) {
+        go_bridge_log("ERROR", "Не удалось запустить пул");
+        pool_cleanup();
+        return false;
+    }
+    return true;
+}
+
+bool go_bridge_stop_pool(void) {
+    bool stopped = pool_stop();
+    return pool_cleanup() && stopped;
+}
+
 bool go_bridge_add_farmer(const FarmerInfo* farmer) {
     if (!farmer) {
         go_bridge_log("ERROR", "FarmerInfo не может быть NULL");
@@ -70,8 +115,9 @@ bool go_bridge_add_farmer(const FarmerInfo* farmer) {
         return false;
     }
     
-    for (int i = 0; i < 32; i++) {
-        sscanf(farmer->launcher_id + i * 2, "%02hhx", &launcher_id[i]);
+    if (!vector_hex_decode(farmer->launcher_id, 32, launcher_id)) {
+        go_bridge_log("ERROR", "launcher_id содержит не-hex символы");
+        return false;
     }
     
     // Создаем синглтон для фермера
@@ -129,52 +175,64 @@ bool go_bridge_remove_farmer(const char* launcher_id) {
     return true;
 }
 
-bool go_bridge_process_partial(const PartialRequest* partial) {
-    if (!partial) {
-        go_bridge_log("ERROR", "PartialRequest не может быть NULL");
-        return false;
-    }
+// Декодирование hex полей PartialRequest прямо в partial_t
+static bool go_bridge_decode_partial(const PartialRequest* partial, partial_t* partial_data) {
+    memset(partial_data, 0, sizeof(partial_t));
     
-    go_bridge_log("DEBUG", "Обработка partial решения через Go бридж...");
-    
-    // Конвертируем hex строки в бинарные данные
-    uint8_t challenge[32];
-    uint8_t launcher_id[32];
-    uint8_t signature[96];
-    
-    if (strlen(partial->challenge) != 64) {
+    if (strnlen(partial->challenge, sizeof(partial->challenge)) != 64) {
         go_bridge_log("ERROR", "Невалидная длина challenge");
         return false;
     }
-    if (strlen(partial->launcher_id) != 64) {
+    if (strnlen(partial->launcher_id, sizeof(partial->launcher_id)) != 64) {
         go_bridge_log("ERROR", "Невалидная длина launcher_id");
         return false;
     }
-    if (strlen(partial->signature) != 192) {
+    if (strnlen(partial->signature, sizeof(partial->signature)) != 192) {
         go_bridge_log("ERROR", "Невалидная длина signature");
         return false;
     }
     
-    for (int i = 0; i < 32; i++) {
-        sscanf(partial->challenge + i * 2, "%02hhx", &challenge[i]);
-        sscanf(partial->launcher_id + i * 2, "%02hhx", &launcher_id[i]);
+    if (!vector_hex_decode(partial->challenge, 32, partial_data->challenge) ||
+        !vector_hex_decode(partial->launcher_id, 32, partial_data->launcher_id) ||
+        !vector_hex_decode(partial->signature, 96, partial_data->signature)) {
+        go_bridge_log("ERROR", "PartialRequest содержит не-hex символы");
+        return false;
     }
-    for (int i = 0; i < 96; i++) {
-        sscanf(partial->signature + i * 2, "%02hhx", &signature[i]);
+    
+    partial_data->timestamp = partial->timestamp;
+    partial_data->difficulty = partial->difficulty;
+    return true;
+}
+
+bool go_bridge_process_partial(const PartialRequest* partial) {
+    if (!partial) {
+        go_bridge_log("ERROR", "PartialRequest не может быть NULL");
+        return false;
     }
     
-    // Создаем структуру partial для обработки
+    go_bridge_log("DEBUG", "Обработка partial решения через Go бридж...");
+    
     partial_t partial_data;
-    memset(&partial_data, 0, sizeof(partial_t));
+    if (!go_bridge_decode_partial(partial, &partial_data)) {
+        return false;
+    }
     
-    memcpy(partial_data.challenge, challenge, 32);
-    memcpy(partial_data.launcher_id, launcher_id, 32);
-    memcpy(partial_data.signature, signature, 96);
-    partial_data.timestamp = partial->timestamp;
-    partial_data.difficulty = partial->difficulty;
+    // Если пул запущен, отдаем partial воркерам валидации и не блокируем
+    // поток Go на RPC и криптографии
+    pool_context_t* context = pool_get_context();
+    if (partial_workers_is_running(&context->partial_workers)) {
+        partial_validation_result_t result = pool_submit_partial(&partial_data);
+        if (result != VALIDATION_SUCCESS) {
+            partial_log_validation_result(result, partial_data.launcher_id);
+            return false;
+        }
+        
+        go_bridge_log("DEBUG", "Partial решение поставлено в очередь валидации");
+        return true;
+    }
     
-    // Обрабатываем partial решение
-    if (!partials_process(&partial_data)) {
+    // Обрабатываем partial решение синхронно
+    if (!partial_process(&partial_data)) {
         go_bridge_log("ERROR", "Не удалось обработать partial решение");
         return false;
     }
@@ -188,35 +246,108 @@ bool go_bridge_process_partial(const PartialRequest* partial) {
     return true;
 }
 
-bool go_bridge_validate_partial(const PartialRequest* partial) {
+bool go_bridge_submit_partial(const partial_t* partial) {
     if (!partial) {
-        go_bridge_log("ERROR", "PartialRequest не может быть NULL");
+        go_bridge_log("ERROR", "Partial не может быть NULL");
         return false;
     }
     
-    go_bridge_log("DEBUG", "Валидация partial решения через Go бридж...");
-    
-    // Конвертируем hex строки в бинарные данные (аналогично process_partial)
-    uint8_t challenge[32];
-    uint8_t launcher_id[32];
-    uint8_t signature[96];
+    pool_context_t* context = pool_get_context();
+    if (partial_workers_is_running(&context->partial_workers)) {
+        partial_validation_result_t result = pool_submit_partial(partial);
+        if (result != VALIDATION_SUCCESS) {
+            partial_log_validation_result(result, partial->launcher_id);
+            return false;
+        }
+        return true;
+    }
     
-    for (int i = 0; i < 32; i++) {
-        sscanf(partial->challenge + i * 2, "%02hhx", &challenge[i]);
-        sscanf(partial->launcher_id + i * 2, "%02hhx", &launcher_id[i]);
+    return partial_process(partial);
+}
+
+partial_t* go_bridge_partial_reserve(partial_queue_reservation_t* reservation) {
+    pool_context_t* context = pool_get_context();
+    return partial_workers_reserve(&context->partial_workers, reservation);
+}
+
+bool go_bridge_partial_commit(partial_queue_reservation_t* reservation) {
+    pool_context_t* context = pool_get_context();
+    partial_validation_result_t result = partial_workers_commit(&context->partial_workers,
+                                                                reservation);
+    if (result != VALIDATION_SUCCESS) {
+        partial_log_validation_result(result, NULL);
+        return false;
     }
-    for (int i = 0; i < 96; i++) {
-        sscanf(partial->signature + i * 2, "%02hhx", &signature[i]);
+    return true;
+}
+
+void go_bridge_partial_abort(partial_queue_reservation_t* reservation) {
+    pool_context_t* context = pool_get_context();
+    partial_workers_abort(&context->partial_workers, reservation);
+}
+
+bool go_bridge_process_partial_async(const PartialRequest* partial, uint64_t* ticket) {
+    if (!partial || !ticket) {
+        go_bridge_log("ERROR", "PartialRequest и ticket не могут быть NULL");
+        return false;
     }
     
-    // Создаем временную структуру partial для валидации
+    *ticket = 0;
+    
     partial_t partial_data;
-    memset(&partial_data, 0, sizeof(partial_t));
+    if (!go_bridge_decode_partial(partial, &partial_data)) {
+        return false;
+    }
+    
+    return go_bridge_submit_partial_async(&partial_data, ticket);
+}
+
+bool go_bridge_submit_partial_async(const partial_t* partial, uint64_t* ticket) {
+    if (!partial || !ticket) {
+        go_bridge_log("ERROR", "Partial и ticket не могут быть NULL");
+        return false;
+    }
+    
+    // Синхронного запасного пути нет: без воркеров некому опубликовать
+    // завершение, отправитель получает отказ сразу
+    pool_context_t* context = pool_get_context();
+    partial_validation_result_t result = partial_workers_submit_async(&context->partial_workers,
+                                                                      partial, ticket);
+    if (result != VALIDATION_SUCCESS) {
+        partial_log_validation_result(result, partial->launcher_id);
+        return false;
+    }
+    return true;
+}
+
+bool go_bridge_partial_commit_async(partial_queue_reservation_t* reservation, uint64_t* ticket) {
+    pool_context_t* context = pool_get_context();
+    partial_validation_result_t result = partial_workers_commit_async(&context->partial_workers,
+                                                                      reservation, ticket);
+    if (result != VALIDATION_SUCCESS) {
+        partial_log_validation_result(result, NULL);
+        return false;
+    }
+    return true;
+}
+
+size_t go_bridge_poll_completions(partial_completion_t* completions, size_t max_count,
+                                  uint32_t timeout_ms) {
+    return partial_completions_poll(completions, max_count, timeout_ms);
+}
+
+bool go_bridge_validate_partial(const PartialRequest* partial) {
+    if (!partial) {
+        go_bridge_log("ERROR", "PartialRequest не может быть NULL");
+        return false;
+    }
     
-    memcpy(partial_data.challenge, challenge, 32);
-    memcpy(partial_data.launcher_id, launcher_id, 32);
-    memcpy(partial_data.signature, signature, 96);
-    partial_data.timestamp = partial->timestamp;
+    go_bridge_log("DEBUG", "Валидация partial решения через Go бридж...");
+    
+    partial_t partial_data;
+    if (!go_bridge_decode_partial(partial, &partial_data)) {
+        return false;
+    }
     
     // Валидируем partial решение
     partial_validation_result_t result = partial_validate(&partial_data);
@@ -313,10 +444,14 @@ bool go_bridge_get_statistics(uint64_t* total_farmers, uint64_t* total_partials,
         return false;
     }
     
+    pool_update_statistics();
+    
+    pthread_mutex_lock(&context->stats_mutex);
     *total_farmers = context->stats.total_farmers;
     *total_partials = context->stats.total_partials;
     *valid_partials = context->stats.valid_partials;
     *total_points = context->stats.total_points;
+    pthread_mutex_unlock(&context->stats_mutex);
     
     char log_msg[256];
     snprintf(log_msg, sizeof(log_msg),
@@ -363,3 +498,21 @@ bool go_bridge_register_payout_callback(GoPayoutCallback callback) {
     go_bridge_log("INFO", "Callback для выплат зарегистрирован");
     return true;
 }
+
+static void go_bridge_deliver_completions(const partial_completion_t* completions, size_t count,
+                                          void* user) {
+    (void)user;
+    GoCompletionCallback callback = g_completion_callback;
+    if (callback) {
+        callback(completions, count);
+    }
+}
+
+bool go_bridge_register_completion_callback(GoCompletionCallback callback) {
+    g_completion_callback = callback;
+    partial_completions_set_callback(callback ? go_bridge_deliver_completions : NULL, NULL);
+    
+    go_bridge_log("INFO", callback ? "Callback завершений partials зарегистрирован"
+                                   : "Завершения partials переключены на опрос");
+    return true;
+}
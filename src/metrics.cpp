@@ -0,0 +1,168 @@
+#include "metrics.h"
+
+#include <string.h>
+#include <time.h>
+
+static uint32_t g_next_shard = 0;
+static __thread uint32_t t_metrics_shard = UINT32_MAX;
+
+uint32_t metrics_shard_index(void) {
+    if (t_metrics_shard == UINT32_MAX) {
+        t_metrics_shard = __atomic_fetch_add(&g_next_shard, 1, __ATOMIC_RELAXED) % METRICS_SHARD_COUNT;
+    }
+    return t_metrics_shard;
+}
+
+uint64_t metrics_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+void metrics_counter_add(metrics_counter_t* counter, uint64_t value) {
+    if (!counter) {
+        return;
+    }
+    
+    // Шард обычно принадлежит одному потоку, атомарность нужна только
+    // на случай разделения шарда при большом числе потоков
+    __atomic_fetch_add(&counter->shards[metrics_shard_index()].value, value, __ATOMIC_RELAXED);
+}
+
+uint64_t metrics_counter_read(const metrics_counter_t* counter) {
+    if (!counter) {
+        return 0;
+    }
+    
+    uint64_t total = 0;
+    for (int i = 0; i < METRICS_SHARD_COUNT; i++) {
+        total += __atomic_load_n(&counter->shards[i].value, __ATOMIC_RELAXED);
+    }
+    return total;
+}
+
+void metrics_counter_reset(metrics_counter_t* counter) {
+    if (!counter) {
+        return;
+    }
+    
+    for (int i = 0; i < METRICS_SHARD_COUNT; i++) {
+        __atomic_store_n(&counter->shards[i].value, 0, __ATOMIC_RELAXED);
+    }
+}
+
+uint32_t metrics_histogram_bucket(uint64_t value_ns) {
+    if (value_ns < METRICS_HISTOGRAM_SUB_COUNT) {
+        return (uint32_t)value_ns;
+    }
+    
+    uint32_t exponent = 63 - __builtin_clzll(value_ns);
+    if (exponent > METRICS_HISTOGRAM_MAX_EXPONENT) {
+        return METRICS_HISTOGRAM_BUCKETS - 1;
+    }
+    
+    uint32_t sub = (uint32_t)(value_ns >> (exponent - METRICS_HISTOGRAM_SUB_BITS)) &
+                   (METRICS_HISTOGRAM_SUB_COUNT - 1);
+    return (exponent - METRICS_HISTOGRAM_SUB_BITS + 1) * METRICS_HISTOGRAM_SUB_COUNT + sub;
+}
+
+uint64_t metrics_histogram_bucket_floor(uint32_t bucket) {
+    if (bucket < METRICS_HISTOGRAM_SUB_COUNT) {
+        return bucket;
+    }
+    
+    uint32_t exponent = bucket / METRICS_HISTOGRAM_SUB_COUNT + METRICS_HISTOGRAM_SUB_BITS - 1;
+    uint64_t sub = bucket % METRICS_HISTOGRAM_SUB_COUNT;
+    return (METRICS_HISTOGRAM_SUB_COUNT + sub) << (exponent - METRICS_HISTOGRAM_SUB_BITS);
+}
+
+void metrics_histogram_record(metrics_histogram_t* histogram, uint64_t value_ns, uint64_t count) {
+    if (!histogram || count == 0) {
+        return;
+    }
+    
+    metrics_histogram_shard_t* shard = &histogram->shards[metrics_shard_index()];
+    __atomic_fetch_add(&shard->buckets[metrics_histogram_bucket(value_ns)], count, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&shard->count, count, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&shard->sum, value_ns * count, __ATOMIC_RELAXED);
+    
+    uint64_t max = __atomic_load_n(&shard->max, __ATOMIC_RELAXED);
+    while (value_ns > max &&
+           !__atomic_compare_exchange_n(&shard->max, &max, value_ns, true,
+                                        __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+    }
+}
+
+// Нижняя граница корзины, в которую попадает значение с рангом rank
+static uint64_t metrics_histogram_rank(const uint64_t* buckets, uint64_t rank) {
+    uint64_t seen = 0;
+    for (uint32_t i = 0; i < METRICS_HISTOGRAM_BUCKETS; i++) {
+        seen += buckets[i];
+        if (seen >= rank) {
+            return metrics_histogram_bucket_floor(i);
+        }
+    }
+    return metrics_histogram_bucket_floor(METRICS_HISTOGRAM_BUCKETS - 1);
+}
+
+void metrics_histogram_summarize(const metrics_histogram_t* histogram,
+                                 metrics_latency_summary_t* summary) {
+    if (!summary) {
+        return;
+    }
+    
+    memset(summary, 0, sizeof(metrics_latency_summary_t));
+    if (!histogram) {
+        return;
+    }
+    
+    // Снимок без блокировок: записи, идущие параллельно, могут попасть
+    // в снимок частично, что допустимо для мониторинга
+    uint64_t buckets[METRICS_HISTOGRAM_BUCKETS];
+    memset(buckets, 0, sizeof(buckets));
+    uint64_t sum = 0;
+    
+    for (int s = 0; s < METRICS_SHARD_COUNT; s++) {
+        const metrics_histogram_shard_t* shard = &histogram->shards[s];
+        for (uint32_t i = 0; i < METRICS_HISTOGRAM_BUCKETS; i++) {
+            buckets[i] += __atomic_load_n(&shard->buckets[i], __ATOMIC_RELAXED);
+        }
+        sum += __atomic_load_n(&shard->sum, __ATOMIC_RELAXED);
+        
+        uint64_t max = __atomic_load_n(&shard->max, __ATOMIC_RELAXED);
+        if (max > summary->max_ns) {
+            summary->max_ns = max;
+        }
+    }
+    
+    uint64_t count = 0;
+    for (uint32_t i = 0; i < METRICS_HISTOGRAM_BUCKETS; i++) {
+        count += buckets[i];
+    }
+    if (count == 0) {
+        return;
+    }
+    
+    summary->count = count;
+    summary->mean_ns = sum / count;
+    summary->p50_ns = metrics_histogram_rank(buckets, (count * 500 + 999) / 1000);
+    summary->p90_ns = metrics_histogram_rank(buckets, (count * 900 + 999) / 1000);
+    summary->p99_ns = metrics_histogram_rank(buckets, (count * 990 + 999) / 1000);
+    summary->p999_ns = metrics_histogram_rank(buckets, (count * 999 + 999) / 1000);
+}
+
+void metrics_histogram_reset(metrics_histogram_t* histogram) {
+    if (!histogram) {
+        return;
+    }
+    
+    for (int s = 0; s < METRICS_SHARD_COUNT; s++) {
+        metrics_histogram_shard_t* shard = &histogram->shards[s];
+        for (uint32_t i = 0; i < METRICS_HISTOGRAM_BUCKETS; i++) {
+            __atomic_store_n(&shard->buckets[i], 0, __ATOMIC_RELAXED);
+        }
+        __atomic_store_n(&shard->count, 0, __ATOMIC_RELAXED);
+        __atomic_store_n(&shard->sum, 0, __ATOMIC_RELAXED);
+        __atomic_store_n(&shard->max, 0, __ATOMIC_RELAXED);
+    }
+}
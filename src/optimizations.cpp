@@ -1,8 +1,14 @@
 #include "optimizations.h"
 #include "security/proof_verification.h"
+#include "security/proof_cache.h"
+#include "security/pos_verifier.h"
 #include "security/auth.h"
+#include "security/bls.h"
+#include "security/bls_key_cache.h"
 #include "protocol/partials.h"
 
+#include <immintrin.h>
+
 #include <stdio.h>
 #include <string.h>
 #include <stdlib.h>
@@ -20,8 +26,8 @@ typedef struct {
 } cache_entry_t;
 
 static optimizations_config_t g_optim_config;
-static std::map<std::string, cache_entry_t*> g_caches[4]; // По одному для каждого типа кеша
-static cache_stats_t g_cache_stats[4];
+static std::map<std::string, cache_entry_t*> g_caches[CACHE_TYPE_COUNT]; // По одному для каждого типа кеша
+static cache_stats_t g_cache_stats[CACHE_TYPE_COUNT];
 static pthread_mutex_t g_cache_mutex = PTHREAD_MUTEX_INITIALIZER;
 
 static void optimizations_log(const char* level, const char* message) {
@@ -59,11 +65,32 @@ bool optimizations_init(const optimizations_config_t* config) {
     memcpy(&g_optim_config, config, sizeof(optimizations_config_t));
     
     // Инициализация статистики кешей
-    for (int i = 0; i < 4; i++) {
+    for (int i = 0; i < CACHE_TYPE_COUNT; i++) {
         memset(&g_cache_stats[i], 0, sizeof(cache_stats_t));
         g_cache_stats[i].max_memory = config->max_cache_memory / 4; // Равномерное распределение
     }
     
+    // Кеш доказательств получает свою четверть памяти в виде таблицы
+    // фиксированного размера; отклоненным отводится четверть записей
+    if (config->enable_proof_cache) {
+        uint32_t entries = (uint32_t)(config->max_cache_memory / 4 / 128);
+        uint32_t negative_ttl = config->proof_negative_ttl_seconds ?
+                                config->proof_negative_ttl_seconds :
+                                PROOF_CACHE_DEFAULT_NEGATIVE_TTL;
+        if (!proof_cache_init(entries, config->cache_ttl_seconds, entries / 4, negative_ttl)) {
+            optimizations_log("WARNING", "Кеш доказательств не инициализирован");
+        }
+    }
+    
+    // Ключи фермеров не меняются: таблица на число фермеров без TTL
+    if (config->enable_signature_cache) {
+        uint32_t keys = config->signature_cache_keys ? config->signature_cache_keys :
+                                                       BLS_KEY_CACHE_DEFAULT_CAPACITY;
+        if (!bls_key_cache_init(keys)) {
+            optimizations_log("WARNING", "Кеш публичных ключей BLS не инициализирован");
+        }
+    }
+    
     optimizations_log("INFO", "Оптимизации успешно инициализированы");
     return true;
 }
@@ -74,7 +101,7 @@ bool optimizations_cleanup(void) {
     pthread_mutex_lock(&g_cache_mutex);
     
     // Очистка всех кешей
-    for (int i = 0; i < 4; i++) {
+    for (int i = 0; i < CACHE_TYPE_COUNT; i++) {
         for (auto& pair : g_caches[i]) {
             free(pair.second->data);
             free(pair.second);
@@ -84,6 +111,9 @@ bool optimizations_cleanup(void) {
     
     pthread_mutex_unlock(&g_cache_mutex);
     
+    proof_cache_cleanup();
+    bls_key_cache_cleanup();
+    
     optimizations_log("INFO", "Оптимизации очищены");
     return true;
 }
@@ -95,7 +125,7 @@ bool cache_put(cache_type_t type, const uint8_t* key, size_t key_len,
         return false;
     }
     
-    if (type < 0 || type > 3) {
+    if (type < 0 || type >= CACHE_TYPE_COUNT) {
         optimizations_log("ERROR", "Невалидный тип кеша");
         return false;
     }
@@ -152,7 +182,7 @@ void* cache_get(cache_type_t type, const uint8_t* key, size_t key_len) {
         return NULL;
     }
     
-    if (type < 0 || type > 3) {
+    if (type < 0 || type >= CACHE_TYPE_COUNT) {
         optimizations_log("ERROR", "Невалидный тип кеша");
         return NULL;
     }
@@ -270,39 +300,137 @@ void vector_bls_verify(const uint8_t** public_keys, const uint8_t** messages,
     
     optimizations_log("DEBUG", "Выполнение векторной BLS верификации...");
     
-    // В реальной реализации здесь будут батч-оптимизации для BLS верификации
-    // Сейчас используем последовательную обработку
+    // Общий цикл Миллера и одна финальная экспонента на пачку; записи с
+    // NULL указателями отклоняются внутри bls_verify_batch
+    bls_verify_batch(public_keys, messages, message_lens, signatures, count, results);
     
+    size_t valid = 0;
     for (size_t i = 0; i < count; i++) {
-        if (!public_keys[i] || !messages[i] || !signatures[i]) {
-            results[i] = false;
-            continue;
+        if (results[i]) {
+            valid++;
         }
-        
-        // Используем существующую функцию верификации
-        results[i] = auth_bls_verify_signature(public_keys[i], messages[i], 
-                                              message_lens[i], signatures[i]);
     }
     
-    char log_msg[128];
+    char log_msg[256];
     snprintf(log_msg, sizeof(log_msg), 
-             "Векторная BLS верификация завершена: обработано %zu подписей", count);
+             "Векторная BLS верификация завершена: обработано %zu подписей, валидных %zu",
+             count, valid);
     optimizations_log("DEBUG", log_msg);
 }
 
-bool optimizations_precompute_proof_verification(uint32_t k_size) {
-    char log_msg[128];
-    snprintf(log_msg, sizeof(log_msg), 
-             "Предварительные вычисления для верификации proof с k-size: %u", k_size);
-    optimizations_log("INFO", log_msg);
+// Значение hex символа или -1 для не-hex символа
+static int hex_nibble(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+static bool hex_decode_scalar(const char* hex, size_t byte_count, uint8_t* out) {
+    for (size_t i = 0; i < byte_count; i++) {
+        int hi = hex_nibble(hex[i * 2]);
+        int lo = hex_nibble(hex[i * 2 + 1]);
+        if (hi < 0 || lo < 0) {
+            return false;
+        }
+        out[i] = (uint8_t)((hi << 4) | lo);
+    }
+    return true;
+}
+
+// 16 символов -> 8 байт. Цифры: c - '0' <= 9, буквы: (c | 0x20) - 'a' <= 5
+// (беззнаковое сравнение через min_epu8). Пара ниблов собирается сдвигами
+// внутри 16-битного слова, упаковка с насыщением отбрасывает старшие байты.
+static bool hex_decode_sse2(const char* hex, size_t byte_count, uint8_t* out) {
+    const __m128i zero_char = _mm_set1_epi8('0');
+    const __m128i lower_a = _mm_set1_epi8('a');
+    const __m128i case_bit = _mm_set1_epi8(0x20);
+    const __m128i nine = _mm_set1_epi8(9);
+    const __m128i five = _mm_set1_epi8(5);
+    const __m128i ten = _mm_set1_epi8(10);
+    const __m128i low_byte = _mm_set1_epi16(0x00FF);
+    
+    size_t i = 0;
+    for (; i + 8 <= byte_count; i += 8) {
+        __m128i chars = _mm_loadu_si128((const __m128i*)(hex + i * 2));
+        __m128i digit = _mm_sub_epi8(chars, zero_char);
+        __m128i alpha = _mm_sub_epi8(_mm_or_si128(chars, case_bit), lower_a);
+        __m128i is_digit = _mm_cmpeq_epi8(_mm_min_epu8(digit, nine), digit);
+        __m128i is_alpha = _mm_cmpeq_epi8(_mm_min_epu8(alpha, five), alpha);
+        if (_mm_movemask_epi8(_mm_or_si128(is_digit, is_alpha)) != 0xFFFF) {
+            return false;
+        }
+        
+        __m128i nibbles = _mm_or_si128(_mm_and_si128(is_digit, digit),
+                                       _mm_andnot_si128(is_digit, _mm_add_epi8(alpha, ten)));
+        __m128i bytes = _mm_or_si128(_mm_and_si128(_mm_slli_epi16(nibbles, 4), low_byte),
+                                     _mm_srli_epi16(nibbles, 8));
+        _mm_storel_epi64((__m128i*)(out + i), _mm_packus_epi16(bytes, bytes));
+    }
     
-    // В реальной реализации здесь будут предварительные вычисления
-    // для ускорения верификации proof указанного размера
+    return hex_decode_scalar(hex + i * 2, byte_count - i, out + i);
+}
+
+// То же для 32 символов -> 16 байт
+__attribute__((target("avx2")))
+static bool hex_decode_avx2(const char* hex, size_t byte_count, uint8_t* out) {
+    const __m256i zero_char = _mm256_set1_epi8('0');
+    const __m256i lower_a = _mm256_set1_epi8('a');
+    const __m256i case_bit = _mm256_set1_epi8(0x20);
+    const __m256i nine = _mm256_set1_epi8(9);
+    const __m256i five = _mm256_set1_epi8(5);
+    const __m256i ten = _mm256_set1_epi8(10);
+    const __m256i low_byte = _mm256_set1_epi16(0x00FF);
+    
+    size_t i = 0;
+    for (; i + 16 <= byte_count; i += 16) {
+        __m256i chars = _mm256_loadu_si256((const __m256i*)(hex + i * 2));
+        __m256i digit = _mm256_sub_epi8(chars, zero_char);
+        __m256i alpha = _mm256_sub_epi8(_mm256_or_si256(chars, case_bit), lower_a);
+        __m256i is_digit = _mm256_cmpeq_epi8(_mm256_min_epu8(digit, nine), digit);
+        __m256i is_alpha = _mm256_cmpeq_epi8(_mm256_min_epu8(alpha, five), alpha);
+        if ((uint32_t)_mm256_movemask_epi8(_mm256_or_si256(is_digit, is_alpha)) != 0xFFFFFFFFU) {
+            return false;
+        }
+        
+        __m256i nibbles = _mm256_blendv_epi8(_mm256_add_epi8(alpha, ten), digit, is_digit);
+        __m256i bytes = _mm256_or_si256(_mm256_and_si256(_mm256_slli_epi16(nibbles, 4), low_byte),
+                                        _mm256_srli_epi16(nibbles, 8));
+        // packus работает внутри 128-битных половин: собираем qword 0 и 2
+        __m256i packed = _mm256_permute4x64_epi64(_mm256_packus_epi16(bytes, bytes), 0x08);
+        _mm_storeu_si128((__m128i*)(out + i), _mm256_castsi256_si128(packed));
+    }
+    
+    return hex_decode_sse2(hex + i * 2, byte_count - i, out + i);
+}
+
+bool vector_hex_decode(const char* hex, size_t byte_count, uint8_t* out) {
+    if (!hex || !out) {
+        return false;
+    }
+    
+    if (__builtin_cpu_supports("avx2")) {
+        return hex_decode_avx2(hex, byte_count, out);
+    }
+    return hex_decode_sse2(hex, byte_count, out);
+}
+
+bool optimizations_precompute_proof_verification(uint32_t k_size) {
+    if (!proof_validate_k_size(k_size)) {
+        return false;
+    }
     
-    // Например, предварительное вычисление таблиц для определенного k-size
-    // или компиляция оптимизированных функций под конкретный размер
+    // Константы верификатора и выбор реализации для k: специализированной
+    // при компиляции (k32..k35) или обобщенной
+    if (!pos_verifier_precompute(k_size)) {
+        return false;
+    }
     
-    optimizations_log("DEBUG", "Предварительные вычисления для proof завершены");
+    char log_msg[256];
+    snprintf(log_msg, sizeof(log_msg),
+             "Предварительные вычисления для верификации proof с k-size %u: реализация %s",
+             k_size, pos_verifier_is_specialized(k_size) ? "специализированная" : "обобщенная");
+    optimizations_log("DEBUG", log_msg);
     return true;
 }
 
@@ -317,39 +445,56 @@ bool optimizations_precompute_difficulty_params(void) {
 }
 
 cache_stats_t cache_get_stats(cache_type_t type) {
-    if (type < 0 || type > 3) {
+    if (type < 0 || type >= CACHE_TYPE_COUNT) {
         cache_stats_t empty = {0, 0, 0, 0, 0}; // Явная инициализация всех полей
         return empty;
     }
     
+    if ((type == CACHE_TYPE_PROOF_VERIFICATION || type == CACHE_TYPE_PROOF_NEGATIVE) &&
+        proof_cache_is_enabled()) {
+        cache_stats_t stats;
+        proof_cache_get_stats(type == CACHE_TYPE_PROOF_NEGATIVE, &stats);
+        return stats;
+    }
+    
+    if (type == CACHE_TYPE_SIGNATURE_VERIFICATION && bls_key_cache_is_enabled()) {
+        cache_stats_t stats;
+        bls_key_cache_get_stats(&stats);
+        return stats;
+    }
+    
     return g_cache_stats[type];
 }
 
 void optimizations_log_performance_stats(void) {
     optimizations_log("INFO", "Статистика производительности оптимизаций:");
     
-    for (int i = 0; i < 4; i++) {
+    for (int i = 0; i < CACHE_TYPE_COUNT; i++) {
         const char* cache_name = "";
         switch (i) {
             case CACHE_TYPE_PROOF_VERIFICATION: cache_name = "PROOF_VERIFICATION"; break;
             case CACHE_TYPE_SIGNATURE_VERIFICATION: cache_name = "SIGNATURE_VERIFICATION"; break;
             case CACHE_TYPE_SINGLETON_STATE: cache_name = "SINGLETON_STATE"; break;
             case CACHE_TYPE_DIFFICULTY_CALCULATION: cache_name = "DIFFICULTY_CALCULATION"; break;
+            case CACHE_TYPE_PROOF_NEGATIVE: cache_name = "PROOF_NEGATIVE"; break;
         }
         
+        cache_stats_t stats = cache_get_stats((cache_type_t)i);
+        double hit_rate = stats.hits + stats.misses > 0 ?
+                          (double)stats.hits / (double)(stats.hits + stats.misses) : 0.0;
+        
         char log_msg[512];
         snprintf(log_msg, sizeof(log_msg),
-                 "Кеш %s: hits=%lu, misses=%lu, evictions=%lu, memory_used=%zu/%zu",
-                 cache_name, g_cache_stats[i].hits, g_cache_stats[i].misses,
-                 g_cache_stats[i].evictions, g_cache_stats[i].memory_used,
-                 g_cache_stats[i].max_memory);
+                 "Кеш %s: hits=%lu, misses=%lu, hit_rate=%.1f%%, evictions=%lu, memory_used=%zu/%zu",
+                 cache_name, stats.hits, stats.misses, hit_rate * 100.0,
+                 stats.evictions, stats.memory_used, stats.max_memory);
         
         optimizations_log("INFO", log_msg);
     }
 }
 
 bool optimizations_set_cache_size(cache_type_t type, size_t max_size) {
-    if (type < 0 || type > 3) {
+    if (type < 0 || type >= CACHE_TYPE_COUNT) {
         optimizations_log("ERROR", "Невалидный тип кеша для установки размера");
         return false;
     }
@@ -367,7 +512,7 @@ bool optimizations_set_cache_size(cache_type_t type, size_t max_size) {
 }
 
 bool optimizations_clear_cache(cache_type_t type) {
-    if (type < 0 || type > 3) {
+    if (type < 0 || type >= CACHE_TYPE_COUNT) {
         optimizations_log("ERROR", "Невалидный тип кеша для очистки");
         return false;
     }
@@ -394,6 +539,14 @@ bool optimizations_clear_cache(cache_type_t type) {
     
     pthread_mutex_unlock(&g_cache_mutex);
     
+    // Обе таблицы кеша доказательств очищаются вместе
+    if (type == CACHE_TYPE_PROOF_VERIFICATION || type == CACHE_TYPE_PROOF_NEGATIVE) {
+        proof_cache_clear();
+    }
+    if (type == CACHE_TYPE_SIGNATURE_VERIFICATION) {
+        bls_key_cache_clear();
+    }
+    
     char log_msg[256];
     snprintf(log_msg, sizeof(log_msg),
              "Кеш типа %d очищен: entries=%zu, memory=%zu bytes",
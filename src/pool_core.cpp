@@ -1,9 +1,16 @@
 #include "pool_core.h"
 #include "protocol/partials.h"
+#include "protocol/partial_completions.h"
+#include "protocol/partial_dedup.h"
+#include "protocol/partial_journal.h"
+#include "protocol/partial_points.h"
+#include "protocol/partial_pipeline.h"
 #include "protocol/singleton.h"
 #include "blockchain/chia_operations.h"
 #include "security/auth.h"
 #include "security/proof_verification.h"
+#include "security/proof_cache.h"
+#include "security/bls_key_cache.h"
 #include "math_operations.h"
 #include "optimizations.h"
 #include "go_bridge.h"
@@ -63,6 +70,21 @@ static void* pool_main_loop(void* arg) {
     return NULL;
 }
 
+// Восстановление из журнала: принятые до перезапуска partials
+// повторно регистрируются в индексе дубликатов, а их очки снова
+// начисляются фермерам в окне PPLNS
+static void pool_journal_replay(const partial_journal_entry_t* entry, void* user) {
+    (void)user;
+    uint64_t now = (uint64_t)time(NULL);
+    if (partial_dedup_is_enabled()) {
+        partial_dedup_check_and_insert(entry->launcher_id, entry->proof_hash,
+                                       entry->timestamp, now, NULL);
+    }
+    if (partial_points_is_enabled()) {
+        partial_points_credit(entry->launcher_id, entry->points, entry->timestamp, now, NULL);
+    }
+}
+
 bool pool_init(const pool_config_t* config) {
     pool_log("INFO", "Инициализация пула...");
     
@@ -129,6 +151,41 @@ bool pool_init(const pool_config_t* config) {
         goto cleanup;
     }
     
+    if (!partial_dedup_init(config->duplicate_window_minutes,
+                            config->duplicate_index_capacity)) {
+        pool_set_error("Не удалось инициализировать индекс дубликатов partials");
+        goto cleanup;
+    }
+    
+    if (!partial_pipeline_configure(config->validation_stages, config->partial_deadline,
+                                    config->partials_per_minute)) {
+        pool_set_error("Невалидный порядок этапов валидации partials");
+        goto cleanup;
+    }
+    
+    // Окно PPLNS совпадает с окном хранения журнала
+    if (!partial_points_init(config->journal_retention_seconds ? config->journal_retention_seconds
+                                                               : PARTIAL_JOURNAL_DEFAULT_RETENTION_SECONDS)) {
+        pool_set_error("Не удалось инициализировать хранилище очков PPLNS");
+        goto cleanup;
+    }
+    
+    // Журнал открывается после индекса дубликатов и хранилища очков:
+    // восстановленные partials снова регистрируются в обоих
+    if (config->journal_directory[0] != '\0') {
+        partial_journal_config_t journal_config;
+        memset(&journal_config, 0, sizeof(journal_config));
+        journal_config.directory = config->journal_directory;
+        journal_config.sync_interval_ms = config->journal_sync_interval_ms;
+        journal_config.sync_records = config->journal_sync_records;
+        journal_config.retention_seconds = config->journal_retention_seconds;
+        
+        if (!partial_journal_open(&journal_config, pool_journal_replay, NULL)) {
+            pool_set_error("Не удалось открыть журнал partials");
+            goto cleanup;
+        }
+    }
+    
     // Инициализация структуры optim_config
     optim_config.enable_proof_cache = true;
     optim_config.enable_signature_cache = true;
@@ -136,11 +193,18 @@ bool pool_init(const pool_config_t* config) {
     optim_config.enable_asm_optimizations = true;
     optim_config.max_cache_memory = 1024 * 1024 * 100; // 100 MB
     optim_config.cache_ttl_seconds = 300;
+    optim_config.proof_negative_ttl_seconds = PROOF_CACHE_DEFAULT_NEGATIVE_TTL;
+    optim_config.signature_cache_keys = BLS_KEY_CACHE_DEFAULT_CAPACITY;
     
     if (!optimizations_init(&optim_config)) {
         pool_log("WARNING", "Не удалось инициализировать оптимизации, продолжаем без них");
     }
     
+    // Таблица выбора верификатора по plot_size для всех допустимых k
+    for (uint32_t k = PROOF_MIN_K_SIZE; k <= PROOF_MAX_K_SIZE; k++) {
+        optimizations_precompute_proof_verification(k);
+    }
+    
     if (!go_bridge_init()) {
         pool_set_error("Не удалось инициализировать Go мост");
         goto cleanup;
@@ -170,10 +234,21 @@ bool pool_start(void) {
     g_pool_context.emergency_stop = false;
     pthread_mutex_unlock(&g_pool_context.state_mutex);
     
+    // Запуск пула воркеров валидации partials
+    if (!partial_workers_start_mode(&g_pool_context.partial_workers,
+                                    g_pool_context.config.worker_threads,
+                                    g_pool_context.config.partial_queue_size,
+                                    g_pool_context.config.partial_queue_mode,
+                                    g_pool_context.config.partial_deadline)) {
+        pool_set_error("Не удалось запустить воркеры валидации partials");
+        return false;
+    }
+    
     // Запуск основного цикла в отдельном потоке
     if (pthread_create(&g_pool_context.main_thread, NULL, 
                       pool_main_loop, &g_pool_context) != 0) {
         pool_set_error("Не удалось создать основной поток");
+        partial_workers_stop(&g_pool_context.partial_workers);
         return false;
     }
     
@@ -194,6 +269,9 @@ bool pool_stop(void) {
         pool_log("ERROR", "Ошибка при ожидании завершения основного потока");
     }
     
+    // Воркеры дорабатывают уже принятые partials и завершаются
+    partial_workers_stop(&g_pool_context.partial_workers);
+    
     pool_log("INFO", "Пул успешно остановлен");
     return true;
 }
@@ -202,6 +280,11 @@ bool pool_cleanup(void) {
     pool_log("INFO", "Очистка ресурсов пула...");
     
     // Остановка всех подсистем
+    partial_workers_stop(&g_pool_context.partial_workers);
+    partial_completions_cleanup();
+    partial_journal_close();
+    partial_points_cleanup();
+    partial_dedup_cleanup();
     go_bridge_cleanup();
     optimizations_cleanup();
     auth_cleanup();
@@ -219,6 +302,15 @@ bool pool_cleanup(void) {
     return true;
 }
 
+partial_validation_result_t pool_submit_partial(const partial_t* partial) {
+    if (!partial) {
+        pool_set_error("Partial решение не может быть NULL");
+        return VALIDATION_INTERNAL_ERROR;
+    }
+    
+    return partial_workers_submit(&g_pool_context.partial_workers, partial);
+}
+
 pool_context_t* pool_get_context(void) {
     return &g_pool_context;
 }
@@ -233,7 +325,35 @@ const char* pool_state_to_string(pool_state_t state) {
     }
 }
 
+// Перенос счетчиков partials в pool_stats_t. Счетчики читаются без
+// блокировок, мьютекс защищает только саму структуру статистики.
+void pool_update_statistics(void) {
+    uint64_t valid = 0, invalid = 0, total = 0;
+    partials_get_stats(&valid, &invalid, &total);
+    
+    metrics_latency_summary_t latency;
+    partials_get_latency(VALIDATION_SUCCESS, &latency);
+    
+    // Очки, вышедшие из окна PPLNS, вычитаются до чтения суммы
+    partial_points_expire((uint64_t)time(NULL));
+    partial_points_stats_t points_stats;
+    partial_points_get_stats(&points_stats);
+    
+    pthread_mutex_lock(&g_pool_context.stats_mutex);
+    if (partial_points_is_enabled()) {
+        g_pool_context.stats.total_points = points_stats.total_points;
+    }
+    g_pool_context.stats.total_partials = total;
+    g_pool_context.stats.valid_partials = valid;
+    g_pool_context.stats.invalid_partials = invalid;
+    g_pool_context.stats.partial_latency_p50_ns = latency.p50_ns;
+    g_pool_context.stats.partial_latency_p99_ns = latency.p99_ns;
+    pthread_mutex_unlock(&g_pool_context.stats_mutex);
+}
+
 void pool_log_statistics(void) {
+    pool_update_statistics();
+    
     pthread_mutex_lock(&g_pool_context.stats_mutex);
     pool_stats_t stats = g_pool_context.stats;
     pthread_mutex_unlock(&g_pool_context.stats_mutex);
@@ -247,6 +367,87 @@ void pool_log_statistics(void) {
              stats.total_points, stats.current_difficulty);
     
     pool_log("INFO", log_msg);
+    
+    for (int result = 0; result < PARTIAL_RESULT_COUNT; result++) {
+        metrics_latency_summary_t latency;
+        partials_get_latency((partial_validation_result_t)result, &latency);
+        if (latency.count == 0) {
+            continue;
+        }
+        
+        snprintf(log_msg, sizeof(log_msg),
+                 "Задержка валидации (%s): partials=%lu, среднее=%.3f мс, "
+                 "p50=%.3f мс, p90=%.3f мс, p99=%.3f мс, p99.9=%.3f мс, максимум=%.3f мс",
+                 partial_result_to_string((partial_validation_result_t)result),
+                 latency.count, latency.mean_ns / 1e6, latency.p50_ns / 1e6,
+                 latency.p90_ns / 1e6, latency.p99_ns / 1e6, latency.p999_ns / 1e6,
+                 latency.max_ns / 1e6);
+        pool_log("INFO", log_msg);
+    }
+    
+    if (partial_dedup_is_enabled()) {
+        partial_dedup_stats_t dedup_stats;
+        partial_dedup_get_stats(&dedup_stats);
+        
+        snprintf(log_msg, sizeof(log_msg),
+                 "Индекс дубликатов: проверок=%lu, дубликатов=%lu (%.2f%%), "
+                 "переполнений=%lu, память=%lu байт",
+                 dedup_stats.lookups, dedup_stats.duplicates, dedup_stats.hit_rate * 100.0,
+                 dedup_stats.overflows, dedup_stats.memory_bytes);
+        pool_log("INFO", log_msg);
+    }
+    
+    if (partial_journal_is_enabled()) {
+        partial_journal_stats_t journal_stats;
+        partial_journal_get_stats(&journal_stats);
+        
+        snprintf(log_msg, sizeof(log_msg),
+                 "Журнал partials: записано=%lu, восстановлено=%lu, на диске до #%lu, "
+                 "group commit=%lu, сегментов=%u, удалено сегментов=%lu",
+                 journal_stats.appended, journal_stats.replayed, journal_stats.durable_sequence,
+                 journal_stats.syncs, journal_stats.segments, journal_stats.segments_truncated);
+        pool_log("INFO", log_msg);
+    }
+    
+    partial_queue_t* queue = &g_pool_context.partial_workers.queue;
+    if (partial_queue_get_mode(queue) == PARTIAL_QUEUE_EDF) {
+        partial_edf_stats_t edf_stats;
+        partial_edf_queue_get_stats(queue->edf, &edf_stats);
+        
+        snprintf(log_msg, sizeof(log_msg),
+                 "EDF очередь: принято=%lu, выдано=%lu, спасено=%lu, отброшено=%lu, "
+                 "оценка обработки=%lu мкс, в очереди=%u",
+                 edf_stats.enqueued, edf_stats.dequeued, edf_stats.saved, edf_stats.shed,
+                 edf_stats.service_estimate_us, edf_stats.size);
+        pool_log("INFO", log_msg);
+    } else if (partial_queue_get_mode(queue) == PARTIAL_QUEUE_FAIR) {
+        partial_fair_stats_t fair_stats;
+        partial_fair_queue_get_stats(queue->fair, &fair_stats);
+        
+        snprintf(log_msg, sizeof(log_msg),
+                 "Справедливая очередь: принято=%lu, выдано=%lu, активных фермеров=%u "
+                 "(максимум %u), отказов подочереди=%lu, в очереди=%u",
+                 fair_stats.enqueued, fair_stats.dequeued, fair_stats.active_flows,
+                 fair_stats.max_active_flows, fair_stats.flow_rejected, fair_stats.size);
+        pool_log("INFO", log_msg);
+    }
+    
+    partial_stage_id_t order[PARTIAL_STAGE_COUNT];
+    size_t stage_count = partial_pipeline_get_order(order, PARTIAL_STAGE_COUNT);
+    for (size_t i = 0; i < stage_count; i++) {
+        partial_stage_stats_t stage_stats;
+        if (!partial_pipeline_get_stage_stats(order[i], &stage_stats)) {
+            continue;
+        }
+        
+        snprintf(log_msg, sizeof(log_msg),
+                 "Этап валидации %u (%s): выполнений=%lu, отклонено=%lu, время=%.3f мс, "
+                 "p50=%.3f мкс, p99=%.3f мкс",
+                 stage_stats.position, stage_stats.name, stage_stats.executions,
+                 stage_stats.rejections, stage_stats.time_ns / 1000000.0,
+                 stage_stats.latency.p50_ns / 1e3, stage_stats.latency.p99_ns / 1e3);
+        pool_log("INFO", log_msg);
+    }
 }
 
 void pool_set_error(const char* error_msg) {
@@ -310,6 +511,17 @@ bool pool_load_default_config(pool_config_t* config) {
     config->node_rpc_port = 8555;
     strcpy(config->node_rpc_cert_path, "/root/.chia/mainnet/config/ssl/full_node/private_full_node.crt");
     strcpy(config->node_rpc_key_path, "/root/.chia/mainnet/config/ssl/full_node/private_full_node.key");
+    config->worker_threads = 0; // performance.worker_threads, 0 - по числу ядер
+    config->partial_queue_size = PARTIAL_QUEUE_DEFAULT_SIZE; // partials.max_queue_size
+    config->partial_queue_mode = PARTIAL_QUEUE_FIFO; // partials.scheduling
+    config->duplicate_window_minutes = PARTIAL_DEDUP_DEFAULT_WINDOW_MINUTES; // partials.duplicate_window_minutes
+    config->duplicate_index_capacity = PARTIAL_DEDUP_DEFAULT_CAPACITY;
+    config->partials_per_minute = 10; // security.rate_limiting.partials_per_minute
+    config->validation_stages[0] = '\0'; // Порядок по оценке стоимости
+    config->journal_directory[0] = '\0'; // partials.journal_directory
+    config->journal_sync_interval_ms = PARTIAL_JOURNAL_DEFAULT_SYNC_INTERVAL_MS; // partials.journal_sync_interval_ms
+    config->journal_sync_records = PARTIAL_JOURNAL_DEFAULT_SYNC_RECORDS;
+    config->journal_retention_seconds = PARTIAL_JOURNAL_DEFAULT_RETENTION_SECONDS;
     
     pool_log("INFO", "Загружена конфигурация по умолчанию");
     return true;
@@ -0,0 +1,200 @@
+#include "protocol/partial_completions.h"
+
+#include <pthread.h>
+#include <errno.h>
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define PARTIAL_COMPLETIONS_MIN_CAPACITY 64
+
+// Мьютекс и условная переменная не уничтожаются: опрашивающий поток
+// может ждать на них во время cleanup
+static pthread_mutex_t g_completions_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t g_completions_ready = PTHREAD_COND_INITIALIZER;
+
+static partial_completion_t* g_completions_ring = NULL;
+static uint32_t g_completions_capacity = 0;   // Степень двойки
+static uint64_t g_completions_head = 0;       // Следующее для чтения
+static uint64_t g_completions_tail = 0;       // Следующее для записи
+static bool g_completions_closed = false;
+
+static partial_completion_fn g_completions_callback = NULL;
+static void* g_completions_user = NULL;
+
+static uint64_t g_completions_next_ticket = 0;
+static uint64_t g_completions_published = 0;
+static uint64_t g_completions_delivered_callback = 0;
+static uint64_t g_completions_delivered_poll = 0;
+static uint64_t g_completions_dropped = 0;
+
+static void partial_completions_log(const char* level, const char* message) {
+    time_t now = time(NULL);
+    struct tm* tm_info = localtime(&now);
+    char timestamp[20];
+    strftime(timestamp, sizeof(timestamp), "%Y-%m-%d %H:%M:%S", tm_info);
+    
+    printf("[%s] [PARTIAL_COMPLETIONS] [%s] %s\n", timestamp, level, message);
+    fflush(stdout);
+}
+
+bool partial_completions_init(uint32_t capacity) {
+    uint32_t ring_capacity = PARTIAL_COMPLETIONS_MIN_CAPACITY;
+    while (ring_capacity < capacity && ring_capacity < (1U << 30)) {
+        ring_capacity <<= 1;
+    }
+    
+    partial_completion_t* ring =
+        (partial_completion_t*)malloc((size_t)ring_capacity * sizeof(partial_completion_t));
+    if (!ring) {
+        partial_completions_log("ERROR", "Не удалось выделить память для кольца завершений");
+        return false;
+    }
+    
+    pthread_mutex_lock(&g_completions_mutex);
+    free(g_completions_ring);
+    g_completions_ring = ring;
+    g_completions_capacity = ring_capacity;
+    g_completions_head = 0;
+    g_completions_tail = 0;
+    g_completions_closed = false;
+    pthread_mutex_unlock(&g_completions_mutex);
+    
+    return true;
+}
+
+void partial_completions_close(void) {
+    pthread_mutex_lock(&g_completions_mutex);
+    g_completions_closed = true;
+    pthread_cond_broadcast(&g_completions_ready);
+    pthread_mutex_unlock(&g_completions_mutex);
+}
+
+void partial_completions_cleanup(void) {
+    pthread_mutex_lock(&g_completions_mutex);
+    
+    uint64_t pending = g_completions_tail - g_completions_head;
+    if (pending > 0) {
+        char log_msg[128];
+        snprintf(log_msg, sizeof(log_msg), "Не забрано %lu завершений асинхронных partials",
+                 pending);
+        partial_completions_log("WARNING", log_msg);
+    }
+    
+    free(g_completions_ring);
+    g_completions_ring = NULL;
+    g_completions_capacity = 0;
+    g_completions_head = 0;
+    g_completions_tail = 0;
+    g_completions_closed = true;
+    pthread_cond_broadcast(&g_completions_ready);
+    pthread_mutex_unlock(&g_completions_mutex);
+}
+
+void partial_completions_set_callback(partial_completion_fn callback, void* user) {
+    pthread_mutex_lock(&g_completions_mutex);
+    g_completions_callback = callback;
+    g_completions_user = user;
+    pthread_mutex_unlock(&g_completions_mutex);
+}
+
+uint64_t partial_completions_next_ticket(void) {
+    return __atomic_add_fetch(&g_completions_next_ticket, 1, __ATOMIC_RELAXED);
+}
+
+void partial_completions_publish(const partial_completion_t* completions, size_t count) {
+    if (!completions || count == 0) {
+        return;
+    }
+    
+    pthread_mutex_lock(&g_completions_mutex);
+    g_completions_published += count;
+    
+    partial_completion_fn callback = g_completions_callback;
+    void* user = g_completions_user;
+    if (callback) {
+        g_completions_delivered_callback += count;
+        pthread_mutex_unlock(&g_completions_mutex);
+        
+        // Callback вызывается вне блокировки: он может сам опрашивать
+        // статистику или ставить новые partials
+        callback(completions, count, user);
+        return;
+    }
+    
+    size_t stored = 0;
+    if (g_completions_ring) {
+        uint64_t free_slots = g_completions_capacity - (g_completions_tail - g_completions_head);
+        stored = count < free_slots ? count : (size_t)free_slots;
+        for (size_t i = 0; i < stored; i++) {
+            g_completions_ring[(g_completions_tail + i) & (g_completions_capacity - 1)] = completions[i];
+        }
+        g_completions_tail += stored;
+    }
+    
+    // Переполнение означает, что опрос отстает от воркеров: номера
+    // этих partials не будут завершены, отправитель ориентируется на таймаут
+    bool overflow = stored < count;
+    g_completions_dropped += count - stored;
+    
+    if (stored > 0) {
+        pthread_cond_broadcast(&g_completions_ready);
+    }
+    pthread_mutex_unlock(&g_completions_mutex);
+    
+    if (overflow) {
+        partial_completions_log("WARNING", "Кольцо завершений переполнено, завершения потеряны");
+    }
+}
+
+size_t partial_completions_poll(partial_completion_t* completions, size_t max_count,
+                                uint32_t timeout_ms) {
+    if (!completions || max_count == 0) {
+        return 0;
+    }
+    
+    struct timespec deadline;
+    clock_gettime(CLOCK_REALTIME, &deadline);
+    deadline.tv_sec += timeout_ms / 1000;
+    deadline.tv_nsec += (long)(timeout_ms % 1000) * 1000000L;
+    if (deadline.tv_nsec >= 1000000000L) {
+        deadline.tv_sec++;
+        deadline.tv_nsec -= 1000000000L;
+    }
+    
+    pthread_mutex_lock(&g_completions_mutex);
+    while (g_completions_tail == g_completions_head && !g_completions_closed && timeout_ms > 0) {
+        if (pthread_cond_timedwait(&g_completions_ready, &g_completions_mutex, &deadline) == ETIMEDOUT) {
+            break;
+        }
+    }
+    
+    uint64_t available = g_completions_tail - g_completions_head;
+    size_t taken = available < max_count ? (size_t)available : max_count;
+    for (size_t i = 0; i < taken; i++) {
+        completions[i] = g_completions_ring[(g_completions_head + i) & (g_completions_capacity - 1)];
+    }
+    g_completions_head += taken;
+    g_completions_delivered_poll += taken;
+    pthread_mutex_unlock(&g_completions_mutex);
+    
+    return taken;
+}
+
+void partial_completions_get_stats(partial_completion_stats_t* stats) {
+    if (!stats) {
+        return;
+    }
+    
+    pthread_mutex_lock(&g_completions_mutex);
+    stats->issued = __atomic_load_n(&g_completions_next_ticket, __ATOMIC_RELAXED);
+    stats->published = g_completions_published;
+    stats->delivered_callback = g_completions_delivered_callback;
+    stats->delivered_poll = g_completions_delivered_poll;
+    stats->dropped = g_completions_dropped;
+    stats->pending = (uint32_t)(g_completions_tail - g_completions_head);
+    stats->capacity = g_completions_capacity;
+    pthread_mutex_unlock(&g_completions_mutex);
+}
@@ -0,0 +1,286 @@
+#include "protocol/partial_dedup.h"
+#include "security/pos_verifier.h"
+
+#include <openssl/sha.h>
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <time.h>
+
+// Слот хранит 48-битный отпечаток ключа и 16-битный тег минуты поколения.
+// Слот с чужим тегом считается свободным: так устаревшее поколение
+// "удаляется" целиком без прохода по таблице.
+#define PARTIAL_DEDUP_TAG_BITS 16
+#define PARTIAL_DEDUP_TAG_MASK 0xFFFFULL
+#define PARTIAL_DEDUP_MAX_WINDOW_MINUTES 1440
+#define PARTIAL_DEDUP_MIN_CAPACITY 64
+
+static uint64_t* g_dedup_slots = NULL;
+static uint32_t g_dedup_capacity = 0;
+static uint32_t g_dedup_generations = 0;
+static uint32_t g_dedup_window_minutes = 0;
+
+static uint64_t g_dedup_lookups = 0;
+static uint64_t g_dedup_duplicates = 0;
+static uint64_t g_dedup_inserts = 0;
+static uint64_t g_dedup_overflows = 0;
+static uint64_t g_dedup_releases = 0;
+
+static void partial_dedup_log(const char* level, const char* message) {
+    time_t now = time(NULL);
+    struct tm* tm_info = localtime(&now);
+    char timestamp[20];
+    strftime(timestamp, sizeof(timestamp), "%Y-%m-%d %H:%M:%S", tm_info);
+    
+    printf("[%s] [PARTIAL_DEDUP] [%s] %s\n", timestamp, level, message);
+    fflush(stdout);
+}
+
+static uint64_t partial_dedup_mix(uint64_t x) {
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9ULL;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebULL;
+    x ^= x >> 31;
+    return x;
+}
+
+static uint64_t partial_dedup_key_hash(const uint8_t* launcher_id, const uint8_t* proof_hash) {
+    uint64_t hash = 0;
+    uint64_t word;
+    
+    for (int i = 0; i < 4; i++) {
+        memcpy(&word, launcher_id + i * 8, sizeof(word));
+        hash = partial_dedup_mix(hash ^ word);
+    }
+    
+    for (int i = 0; i < 4; i++) {
+        memcpy(&word, proof_hash + i * 8, sizeof(word));
+        hash = partial_dedup_mix(hash ^ word);
+    }
+    
+    return hash;
+}
+
+static uint64_t partial_dedup_tag(uint64_t minute) {
+    return minute % PARTIAL_DEDUP_TAG_MASK + 1; // Тег 0 зарезервирован за пустыми слотами
+}
+
+static uint64_t* partial_dedup_generation(uint64_t minute) {
+    return g_dedup_slots + (minute % g_dedup_generations) * (uint64_t)g_dedup_capacity;
+}
+
+// Поиск в поколении: цепочка пробирования заканчивается на первом
+// слоте без тега этой минуты
+static bool partial_dedup_find(uint64_t minute, uint64_t fingerprint, uint64_t home) {
+    uint64_t* slots = partial_dedup_generation(minute);
+    uint64_t tag = partial_dedup_tag(minute);
+    uint64_t value = (fingerprint << PARTIAL_DEDUP_TAG_BITS) | tag;
+    uint64_t mask = g_dedup_capacity - 1;
+    
+    for (uint32_t probe = 0; probe < PARTIAL_DEDUP_MAX_PROBES; probe++) {
+        uint64_t current = __atomic_load_n(&slots[(home + probe) & mask], __ATOMIC_ACQUIRE);
+        if (current == value) {
+            return true;
+        }
+        
+        if ((current & PARTIAL_DEDUP_TAG_MASK) != tag) {
+            return false;
+        }
+    }
+    
+    return false;
+}
+
+bool partial_dedup_init(uint32_t window_minutes, uint32_t capacity) {
+    partial_dedup_cleanup();
+    
+    if (window_minutes == 0) {
+        partial_dedup_log("INFO", "Индекс дубликатов отключен (окно 0 минут)");
+        return true;
+    }
+    
+    if (window_minutes > PARTIAL_DEDUP_MAX_WINDOW_MINUTES) {
+        partial_dedup_log("ERROR", "Окно индекса дубликатов не может превышать сутки");
+        return false;
+    }
+    
+    if (capacity == 0) {
+        capacity = PARTIAL_DEDUP_DEFAULT_CAPACITY;
+    }
+    
+    // Емкость поколения округляется вверх до степени двойки
+    uint32_t rounded = PARTIAL_DEDUP_MIN_CAPACITY;
+    while (rounded < capacity && rounded < (1U << 31)) {
+        rounded <<= 1;
+    }
+    
+    uint32_t generations = window_minutes + 1;
+    uint64_t* slots = (uint64_t*)calloc((size_t)generations * rounded, sizeof(uint64_t));
+    if (!slots) {
+        partial_dedup_log("ERROR", "Не удалось выделить память для индекса дубликатов");
+        return false;
+    }
+    
+    g_dedup_slots = slots;
+    g_dedup_capacity = rounded;
+    g_dedup_generations = generations;
+    g_dedup_window_minutes = window_minutes;
+    
+    char log_msg[256];
+    snprintf(log_msg, sizeof(log_msg),
+             "Индекс дубликатов инициализирован: окно=%u мин, слотов на минуту=%u, память=%lu байт",
+             window_minutes, rounded, (uint64_t)generations * rounded * sizeof(uint64_t));
+    partial_dedup_log("INFO", log_msg);
+    return true;
+}
+
+void partial_dedup_cleanup(void) {
+    free(g_dedup_slots);
+    g_dedup_slots = NULL;
+    g_dedup_capacity = 0;
+    g_dedup_generations = 0;
+    g_dedup_window_minutes = 0;
+    
+    __atomic_store_n(&g_dedup_lookups, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&g_dedup_duplicates, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&g_dedup_inserts, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&g_dedup_overflows, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&g_dedup_releases, 0, __ATOMIC_RELAXED);
+}
+
+bool partial_dedup_is_enabled(void) {
+    return g_dedup_slots != NULL;
+}
+
+void partial_dedup_hash_proof(const uint8_t* proof, size_t proof_len, uint8_t plot_size,
+                              uint8_t* hash) {
+    if (!proof || !hash) {
+        return;
+    }
+    
+    // Байты после pos_proof_size(k) не входят в доказательство: иначе
+    // тот же proof с другим выравниванием не считался бы дубликатом
+    size_t length = pos_proof_size(plot_size);
+    if (length > proof_len) {
+        length = proof_len;
+    }
+    if (length > POS_MAX_PROOF_SIZE) {
+        length = POS_MAX_PROOF_SIZE;
+    }
+    
+    uint8_t input[1 + POS_MAX_PROOF_SIZE];
+    input[0] = plot_size;
+    memcpy(input + 1, proof, length);
+    SHA256(input, 1 + length, hash);
+}
+
+bool partial_dedup_check_and_insert(const uint8_t* launcher_id, const uint8_t* proof_hash,
+                                    uint64_t timestamp, uint64_t now,
+                                    partial_dedup_claim_t* claim) {
+    if (claim) {
+        claim->slot = UINT64_MAX;
+        claim->value = 0;
+    }
+    
+    if (!g_dedup_slots || !launcher_id || !proof_hash) {
+        return false;
+    }
+    
+    __atomic_fetch_add(&g_dedup_lookups, 1, __ATOMIC_RELAXED);
+    
+    uint64_t hash = partial_dedup_key_hash(launcher_id, proof_hash);
+    uint64_t fingerprint = hash >> PARTIAL_DEDUP_TAG_BITS;
+    if (fingerprint == 0) {
+        fingerprint = 1; // Нулевой отпечаток занят под освобожденные записи
+    }
+    uint64_t home = hash & (g_dedup_capacity - 1);
+    
+    // Поколение выбирается по минуте partial: повторная отправка того же
+    // partial попадает в ту же таблицу и ту же цепочку пробирования
+    uint64_t now_minute = now / 60;
+    uint64_t partial_minute = timestamp / 60;
+    uint64_t oldest_minute = now_minute >= g_dedup_window_minutes ?
+                             now_minute - g_dedup_window_minutes : 0;
+    if (partial_minute > now_minute || partial_minute < oldest_minute) {
+        partial_minute = now_minute;
+    }
+    
+    for (uint64_t minute = oldest_minute; minute <= now_minute; minute++) {
+        if (minute != partial_minute && partial_dedup_find(minute, fingerprint, home)) {
+            __atomic_fetch_add(&g_dedup_duplicates, 1, __ATOMIC_RELAXED);
+            return true;
+        }
+    }
+    
+    // Вставка через CAS: из двух одновременных одинаковых partials
+    // слот займет только один, второй увидит его значение
+    uint64_t* slots = partial_dedup_generation(partial_minute);
+    uint64_t tag = partial_dedup_tag(partial_minute);
+    uint64_t value = (fingerprint << PARTIAL_DEDUP_TAG_BITS) | tag;
+    uint64_t mask = g_dedup_capacity - 1;
+    
+    for (uint32_t probe = 0; probe < PARTIAL_DEDUP_MAX_PROBES; probe++) {
+        uint64_t index = (home + probe) & mask;
+        uint64_t current = __atomic_load_n(&slots[index], __ATOMIC_ACQUIRE);
+        
+        for (;;) {
+            if (current == value) {
+                __atomic_fetch_add(&g_dedup_duplicates, 1, __ATOMIC_RELAXED);
+                return true;
+            }
+            
+            if ((current & PARTIAL_DEDUP_TAG_MASK) == tag) {
+                break; // Слот занят другим partial этой минуты
+            }
+            
+            if (__atomic_compare_exchange_n(&slots[index], &current, value, false,
+                                            __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+                __atomic_fetch_add(&g_dedup_inserts, 1, __ATOMIC_RELAXED);
+                if (claim) {
+                    claim->slot = (uint64_t)(slots - g_dedup_slots) + index;
+                    claim->value = value;
+                }
+                return false;
+            }
+        }
+    }
+    
+    // Поколение переполнено: partial пропускается без регистрации
+    __atomic_fetch_add(&g_dedup_overflows, 1, __ATOMIC_RELAXED);
+    return false;
+}
+
+void partial_dedup_release(const partial_dedup_claim_t* claim) {
+    if (!claim || claim->slot == UINT64_MAX || claim->value == 0 || !g_dedup_slots) {
+        return;
+    }
+    
+    // Запись заменяется на "надгробие" с тегом минуты, чтобы не рвать
+    // цепочки пробирования. Если поколение уже переиспользовано, CAS не пройдет.
+    uint64_t expected = claim->value;
+    uint64_t tombstone = claim->value & PARTIAL_DEDUP_TAG_MASK;
+    if (__atomic_compare_exchange_n(&g_dedup_slots[claim->slot], &expected, tombstone, false,
+                                    __ATOMIC_ACQ_REL, __ATOMIC_RELAXED)) {
+        __atomic_fetch_add(&g_dedup_releases, 1, __ATOMIC_RELAXED);
+    }
+}
+
+void partial_dedup_get_stats(partial_dedup_stats_t* stats) {
+    if (!stats) {
+        return;
+    }
+    
+    memset(stats, 0, sizeof(partial_dedup_stats_t));
+    stats->lookups = __atomic_load_n(&g_dedup_lookups, __ATOMIC_RELAXED);
+    stats->duplicates = __atomic_load_n(&g_dedup_duplicates, __ATOMIC_RELAXED);
+    stats->inserts = __atomic_load_n(&g_dedup_inserts, __ATOMIC_RELAXED);
+    stats->overflows = __atomic_load_n(&g_dedup_overflows, __ATOMIC_RELAXED);
+    stats->releases = __atomic_load_n(&g_dedup_releases, __ATOMIC_RELAXED);
+    stats->hit_rate = stats->lookups > 0 ?
+                      (double)stats->duplicates / (double)stats->lookups : 0.0;
+    stats->memory_bytes = (uint64_t)g_dedup_generations * g_dedup_capacity * sizeof(uint64_t);
+    stats->window_minutes = g_dedup_window_minutes;
+    stats->capacity = g_dedup_capacity;
+}
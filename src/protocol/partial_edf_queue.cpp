@@ -0,0 +1,317 @@
+#include "protocol/partial_edf_queue.h"
+#include "protocol/partials.h"
+#include "protocol/partial_completions.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <time.h>
+
+static void partial_edf_log(const char* level, const char* message) {
+    time_t now = time(NULL);
+    struct tm* tm_info = localtime(&now);
+    char timestamp[20];
+    strftime(timestamp, sizeof(timestamp), "%Y-%m-%d %H:%M:%S", tm_info);
+    
+    printf("[%s] [PARTIAL_EDF] [%s] %s\n", timestamp, level, message);
+    fflush(stdout);
+}
+
+// Дедлайны partial заданы в секундах unix-времени
+static uint64_t partial_edf_now_us(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return (uint64_t)ts.tv_sec * 1000000ULL + (uint64_t)ts.tv_nsec / 1000ULL;
+}
+
+bool partial_edf_queue_init(partial_edf_queue_t* queue, uint32_t capacity,
+                            uint32_t deadline_seconds) {
+    if (!queue || capacity == 0) {
+        partial_edf_log("ERROR", "Невалидные параметры для инициализации EDF очереди");
+        return false;
+    }
+    
+    memset(queue, 0, sizeof(partial_edf_queue_t));
+    
+    queue->nodes = (partial_edf_node_t*)calloc(capacity, sizeof(partial_edf_node_t));
+    queue->storage = (partial_t*)malloc((size_t)capacity * sizeof(partial_t));
+    if (!queue->nodes || !queue->storage) {
+        partial_edf_log("ERROR", "Не удалось выделить память для EDF очереди");
+        free(queue->nodes);
+        free(queue->storage);
+        queue->nodes = NULL;
+        queue->storage = NULL;
+        return false;
+    }
+    
+    // Все узлы изначально в free-list
+    for (uint32_t i = 0; i < capacity; i++) {
+        queue->nodes[i].next = i + 1 < capacity ? i + 1 : PARTIAL_EDF_NIL;
+    }
+    for (int b = 0; b < PARTIAL_EDF_BUCKET_COUNT; b++) {
+        queue->bucket_head[b] = PARTIAL_EDF_NIL;
+        queue->bucket_tail[b] = PARTIAL_EDF_NIL;
+    }
+    
+    queue->capacity = capacity;
+    queue->free_head = 0;
+    queue->deadline_seconds = deadline_seconds;
+    queue->service_estimate_us = PARTIAL_EDF_DEFAULT_SERVICE_US;
+    queue->parallelism = 1;
+    
+    pthread_mutex_init(&queue->mutex, NULL);
+    pthread_cond_init(&queue->not_empty, NULL);
+    
+    char log_msg[128];
+    snprintf(log_msg, sizeof(log_msg),
+             "EDF очередь инициализирована: емкость=%u, дедлайн=%u сек",
+             capacity, deadline_seconds);
+    partial_edf_log("INFO", log_msg);
+    return true;
+}
+
+void partial_edf_queue_cleanup(partial_edf_queue_t* queue) {
+    if (!queue || !queue->nodes) {
+        return;
+    }
+    
+    pthread_mutex_destroy(&queue->mutex);
+    pthread_cond_destroy(&queue->not_empty);
+    free(queue->nodes);
+    free(queue->storage);
+    queue->nodes = NULL;
+    queue->storage = NULL;
+    queue->size = 0;
+}
+
+size_t partial_edf_queue_push_batch(partial_edf_queue_t* queue, const partial_t* partials,
+                                    size_t count) {
+    if (!queue || !queue->nodes || !partials) {
+        partial_edf_log("ERROR", "Невалидные параметры для добавления в EDF очередь");
+        return 0;
+    }
+    
+    uint64_t now_us = partial_edf_now_us();
+    uint64_t now_sec = now_us / 1000000ULL;
+    size_t pushed = 0;
+    
+    pthread_mutex_lock(&queue->mutex);
+    
+    for (; pushed < count && queue->free_head != PARTIAL_EDF_NIL; pushed++) {
+        const partial_t* partial = &partials[pushed];
+        uint32_t index = queue->free_head;
+        partial_edf_node_t* node = &queue->nodes[index];
+        queue->free_head = node->next;
+        
+        memcpy(&queue->storage[index], partial, sizeof(partial_t));
+        node->deadline = partial->timestamp + queue->deadline_seconds;
+        node->enqueue_us = now_us;
+        node->ahead = queue->size;
+        node->next = PARTIAL_EDF_NIL;
+        
+        // Просроченные попадают в текущую секунду и отбрасываются при
+        // извлечении, дедлайны из будущего ограничиваются горизонтом календаря
+        uint64_t second = node->deadline;
+        if (second < now_sec) {
+            second = now_sec;
+        } else if (second >= now_sec + PARTIAL_EDF_BUCKET_COUNT) {
+            second = now_sec + PARTIAL_EDF_BUCKET_COUNT - 1;
+        }
+        
+        uint32_t bucket = (uint32_t)(second % PARTIAL_EDF_BUCKET_COUNT);
+        if (queue->bucket_tail[bucket] == PARTIAL_EDF_NIL) {
+            queue->bucket_head[bucket] = index;
+        } else {
+            queue->nodes[queue->bucket_tail[bucket]].next = index;
+        }
+        queue->bucket_tail[bucket] = index;
+        
+        if (queue->size == 0 || second < queue->cursor) {
+            queue->cursor = second;
+        }
+        queue->size++;
+        queue->enqueued++;
+    }
+    
+    pthread_mutex_unlock(&queue->mutex);
+    
+    if (pushed == 1) {
+        pthread_cond_signal(&queue->not_empty);
+    } else if (pushed > 1) {
+        pthread_cond_broadcast(&queue->not_empty);
+    }
+    return pushed;
+}
+
+// Извлечение под мьютексом: корзины просматриваются от самой ранней
+// секунды, partials, не успевающие к дедлайну, возвращаются в free-list.
+// Для отброшенных асинхронных partials в shed копятся завершения
+// VALIDATION_TOO_LATE; при заполнении буфера извлечение прерывается,
+// чтобы вызывающий опубликовал их после снятия блокировки.
+static size_t partial_edf_queue_take(partial_edf_queue_t* queue, partial_t* partials,
+                                     size_t max_count, partial_completion_t* shed,
+                                     size_t* shed_count) {
+    uint64_t now_us = partial_edf_now_us();
+    uint64_t latency_us = queue->service_estimate_us;
+    size_t taken = 0;
+    
+    *shed_count = 0;
+    while (taken < max_count && queue->size > 0 && *shed_count < PARTIAL_EDF_SHED_BATCH) {
+        uint32_t bucket = (uint32_t)(queue->cursor % PARTIAL_EDF_BUCKET_COUNT);
+        uint32_t index = queue->bucket_head[bucket];
+        if (index == PARTIAL_EDF_NIL) {
+            queue->cursor++;
+            continue;
+        }
+        
+        partial_edf_node_t* node = &queue->nodes[index];
+        queue->bucket_head[bucket] = node->next;
+        if (node->next == PARTIAL_EDF_NIL) {
+            queue->bucket_tail[bucket] = PARTIAL_EDF_NIL;
+        }
+        queue->size--;
+        
+        // Partial валиден, пока now - timestamp <= дедлайн, то есть до
+        // конца секунды deadline
+        uint64_t deadline_end_us = (node->deadline + 1) * 1000000ULL;
+        if (now_us + latency_us >= deadline_end_us) {
+            queue->shed++;
+            
+            const partial_t* partial = &queue->storage[index];
+            if (partial->ticket != 0) {
+                partial_completion_t* completion = &shed[(*shed_count)++];
+                completion->ticket = partial->ticket;
+                memcpy(completion->launcher_id, partial->launcher_id, sizeof(completion->launcher_id));
+                completion->points = 0;
+                completion->result = VALIDATION_TOO_LATE;
+            }
+        } else {
+            memcpy(&partials[taken++], &queue->storage[index], sizeof(partial_t));
+            queue->dequeued++;
+            
+            // В FIFO partial ждал бы всех, кто был в очереди до него
+            uint64_t fifo_finish_us = node->enqueue_us +
+                                      (uint64_t)node->ahead * latency_us / queue->parallelism +
+                                      latency_us;
+            if (fifo_finish_us >= deadline_end_us) {
+                queue->saved++;
+            }
+        }
+        
+        node->next = queue->free_head;
+        queue->free_head = index;
+    }
+    
+    return taken;
+}
+
+size_t partial_edf_queue_try_pop_batch(partial_edf_queue_t* queue, partial_t* partials,
+                                       size_t max_count) {
+    if (!queue || !queue->nodes || !partials || max_count == 0) {
+        partial_edf_log("ERROR", "Невалидные параметры для извлечения из EDF очереди");
+        return 0;
+    }
+    
+    partial_completion_t shed[PARTIAL_EDF_SHED_BATCH];
+    size_t shed_count = 0;
+    
+    pthread_mutex_lock(&queue->mutex);
+    size_t taken = partial_edf_queue_take(queue, partials, max_count, shed, &shed_count);
+    pthread_mutex_unlock(&queue->mutex);
+    
+    partial_completions_publish(shed, shed_count);
+    return taken;
+}
+
+size_t partial_edf_queue_pop_batch(partial_edf_queue_t* queue, partial_t* partials,
+                                   size_t max_count) {
+    if (!queue || !queue->nodes || !partials || max_count == 0) {
+        partial_edf_log("ERROR", "Невалидные параметры для извлечения из EDF очереди");
+        return 0;
+    }
+    
+    partial_completion_t shed[PARTIAL_EDF_SHED_BATCH];
+    size_t shed_count = 0;
+    
+    pthread_mutex_lock(&queue->mutex);
+    
+    size_t taken = 0;
+    for (;;) {
+        taken = partial_edf_queue_take(queue, partials, max_count, shed, &shed_count);
+        if (shed_count > 0) {
+            // Callback завершений может ставить новые partials в эту же
+            // очередь, поэтому публикация идет без блокировки
+            pthread_mutex_unlock(&queue->mutex);
+            partial_completions_publish(shed, shed_count);
+            pthread_mutex_lock(&queue->mutex);
+            if (taken > 0) {
+                break;
+            }
+            continue;
+        }
+        if (taken > 0 || (queue->size == 0 && queue->closed)) {
+            break;
+        }
+        if (queue->size == 0) {
+            pthread_cond_wait(&queue->not_empty, &queue->mutex);
+        }
+    }
+    
+    pthread_mutex_unlock(&queue->mutex);
+    return taken;
+}
+
+uint32_t partial_edf_queue_size(partial_edf_queue_t* queue) {
+    if (!queue || !queue->nodes) {
+        return 0;
+    }
+    
+    pthread_mutex_lock(&queue->mutex);
+    uint32_t size = queue->size;
+    pthread_mutex_unlock(&queue->mutex);
+    return size;
+}
+
+void partial_edf_queue_close(partial_edf_queue_t* queue) {
+    if (!queue || !queue->nodes) {
+        return;
+    }
+    
+    pthread_mutex_lock(&queue->mutex);
+    queue->closed = true;
+    pthread_mutex_unlock(&queue->mutex);
+    pthread_cond_broadcast(&queue->not_empty);
+}
+
+void partial_edf_queue_record_service(partial_edf_queue_t* queue, uint64_t service_us,
+                                      uint32_t parallelism) {
+    if (!queue || !queue->nodes) {
+        return;
+    }
+    
+    pthread_mutex_lock(&queue->mutex);
+    // EWMA с весом 1/8 для нового замера
+    queue->service_estimate_us = (queue->service_estimate_us * 7 + service_us) / 8;
+    queue->parallelism = parallelism > 0 ? parallelism : 1;
+    pthread_mutex_unlock(&queue->mutex);
+}
+
+void partial_edf_queue_get_stats(partial_edf_queue_t* queue, partial_edf_stats_t* stats) {
+    if (!stats) {
+        return;
+    }
+    
+    memset(stats, 0, sizeof(partial_edf_stats_t));
+    if (!queue || !queue->nodes) {
+        return;
+    }
+    
+    pthread_mutex_lock(&queue->mutex);
+    stats->enqueued = queue->enqueued;
+    stats->dequeued = queue->dequeued;
+    stats->shed = queue->shed;
+    stats->saved = queue->saved;
+    stats->service_estimate_us = queue->service_estimate_us;
+    stats->size = queue->size;
+    pthread_mutex_unlock(&queue->mutex);
+}
@@ -0,0 +1,359 @@
+#include "protocol/partial_fair_queue.h"
+#include "protocol/partials.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <time.h>
+
+static void partial_fair_log(const char* level, const char* message) {
+    time_t now = time(NULL);
+    struct tm* tm_info = localtime(&now);
+    char timestamp[20];
+    strftime(timestamp, sizeof(timestamp), "%Y-%m-%d %H:%M:%S", tm_info);
+    
+    printf("[%s] [PARTIAL_FAIR] [%s] %s\n", timestamp, level, message);
+    fflush(stdout);
+}
+
+static uint32_t partial_fair_hash(const uint8_t* launcher_id) {
+    uint64_t word;
+    memcpy(&word, launcher_id, sizeof(word));
+    word ^= word >> 33;
+    word *= 0xff51afd7ed558ccdULL;
+    word ^= word >> 33;
+    return (uint32_t)word;
+}
+
+uint32_t partial_fair_weight(uint64_t difficulty) {
+    if (difficulty == 0) {
+        return 1;
+    }
+    return difficulty > PARTIAL_FAIR_MAX_WEIGHT ? PARTIAL_FAIR_MAX_WEIGHT : (uint32_t)difficulty;
+}
+
+bool partial_fair_queue_init(partial_fair_queue_t* queue, uint32_t capacity,
+                             uint32_t flow_capacity) {
+    if (!queue || capacity == 0) {
+        partial_fair_log("ERROR", "Невалидные параметры для инициализации справедливой очереди");
+        return false;
+    }
+    
+    memset(queue, 0, sizeof(partial_fair_queue_t));
+    
+    // Активных потоков не больше, чем partials, таблица заполнена не более чем наполовину
+    uint32_t table_size = 16;
+    while (table_size < capacity * 2ULL && table_size < (1U << 31)) {
+        table_size <<= 1;
+    }
+    
+    queue->storage = (partial_t*)malloc((size_t)capacity * sizeof(partial_t));
+    queue->node_next = (uint32_t*)malloc((size_t)capacity * sizeof(uint32_t));
+    queue->flows = (partial_fair_flow_t*)calloc(capacity, sizeof(partial_fair_flow_t));
+    queue->table = (uint32_t*)malloc((size_t)table_size * sizeof(uint32_t));
+    if (!queue->storage || !queue->node_next || !queue->flows || !queue->table) {
+        partial_fair_log("ERROR", "Не удалось выделить память для справедливой очереди");
+        free(queue->storage);
+        free(queue->node_next);
+        free(queue->flows);
+        free(queue->table);
+        memset(queue, 0, sizeof(partial_fair_queue_t));
+        return false;
+    }
+    
+    for (uint32_t i = 0; i < capacity; i++) {
+        queue->node_next[i] = i + 1 < capacity ? i + 1 : PARTIAL_FAIR_NIL;
+        queue->flows[i].next_active = i + 1 < capacity ? i + 1 : PARTIAL_FAIR_NIL;
+    }
+    memset(queue->table, 0xFF, (size_t)table_size * sizeof(uint32_t));
+    
+    queue->capacity = capacity;
+    queue->free_node = 0;
+    queue->free_flow = 0;
+    queue->table_mask = table_size - 1;
+    queue->flow_capacity = flow_capacity ? flow_capacity : PARTIAL_FAIR_DEFAULT_FLOW_CAPACITY;
+    queue->active_head = PARTIAL_FAIR_NIL;
+    queue->active_tail = PARTIAL_FAIR_NIL;
+    
+    pthread_mutex_init(&queue->mutex, NULL);
+    pthread_cond_init(&queue->not_empty, NULL);
+    
+    char log_msg[128];
+    snprintf(log_msg, sizeof(log_msg),
+             "Справедливая очередь инициализирована: емкость=%u, подочередь=%u",
+             capacity, queue->flow_capacity);
+    partial_fair_log("INFO", log_msg);
+    return true;
+}
+
+void partial_fair_queue_cleanup(partial_fair_queue_t* queue) {
+    if (!queue || !queue->storage) {
+        return;
+    }
+    
+    pthread_mutex_destroy(&queue->mutex);
+    pthread_cond_destroy(&queue->not_empty);
+    free(queue->storage);
+    free(queue->node_next);
+    free(queue->flows);
+    free(queue->table);
+    memset(queue, 0, sizeof(partial_fair_queue_t));
+}
+
+// Поиск потока фермера; при create = true создает поток в свободном слоте
+static uint32_t partial_fair_find_flow(partial_fair_queue_t* queue, const uint8_t* launcher_id,
+                                       bool create) {
+    uint32_t slot = partial_fair_hash(launcher_id) & queue->table_mask;
+    
+    for (;;) {
+        uint32_t index = queue->table[slot];
+        if (index == PARTIAL_FAIR_NIL) {
+            break;
+        }
+        if (memcmp(queue->flows[index].launcher_id, launcher_id, 32) == 0) {
+            return index;
+        }
+        slot = (slot + 1) & queue->table_mask;
+    }
+    
+    if (!create || queue->free_flow == PARTIAL_FAIR_NIL) {
+        return PARTIAL_FAIR_NIL;
+    }
+    
+    uint32_t index = queue->free_flow;
+    partial_fair_flow_t* flow = &queue->flows[index];
+    queue->free_flow = flow->next_active;
+    
+    memcpy(flow->launcher_id, launcher_id, 32);
+    flow->head = PARTIAL_FAIR_NIL;
+    flow->tail = PARTIAL_FAIR_NIL;
+    flow->count = 0;
+    flow->deficit = 0;
+    flow->in_service = false;
+    flow->table_slot = slot;
+    queue->table[slot] = index;
+    
+    // Новый поток встает в конец кольца обслуживания
+    flow->next_active = PARTIAL_FAIR_NIL;
+    if (queue->active_tail == PARTIAL_FAIR_NIL) {
+        queue->active_head = index;
+    } else {
+        queue->flows[queue->active_tail].next_active = index;
+    }
+    queue->active_tail = index;
+    queue->active_flows++;
+    if (queue->active_flows > queue->max_active_flows) {
+        queue->max_active_flows = queue->active_flows;
+    }
+    
+    return index;
+}
+
+// Удаление опустевшего потока из головы кольца и из таблицы. Таблица
+// с линейным пробированием: последующие записи цепочки сдвигаются назад.
+static void partial_fair_release_head(partial_fair_queue_t* queue) {
+    uint32_t index = queue->active_head;
+    partial_fair_flow_t* flow = &queue->flows[index];
+    
+    queue->active_head = flow->next_active;
+    if (queue->active_head == PARTIAL_FAIR_NIL) {
+        queue->active_tail = PARTIAL_FAIR_NIL;
+    }
+    queue->active_flows--;
+    
+    uint32_t hole = flow->table_slot;
+    uint32_t slot = hole;
+    queue->table[hole] = PARTIAL_FAIR_NIL;
+    for (;;) {
+        slot = (slot + 1) & queue->table_mask;
+        uint32_t moved = queue->table[slot];
+        if (moved == PARTIAL_FAIR_NIL) {
+            break;
+        }
+        
+        uint32_t home = partial_fair_hash(queue->flows[moved].launcher_id) & queue->table_mask;
+        // Запись остается на месте, если ее домашний слот лежит циклически в (hole, slot]
+        bool stays = hole <= slot ? (home > hole && home <= slot) : (home > hole || home <= slot);
+        if (!stays) {
+            queue->table[hole] = moved;
+            queue->flows[moved].table_slot = hole;
+            queue->table[slot] = PARTIAL_FAIR_NIL;
+            hole = slot;
+        }
+    }
+    
+    flow->next_active = queue->free_flow;
+    queue->free_flow = index;
+}
+
+size_t partial_fair_queue_push_batch(partial_fair_queue_t* queue, const partial_t* partials,
+                                     size_t count) {
+    if (!queue || !queue->storage || !partials) {
+        partial_fair_log("ERROR", "Невалидные параметры для добавления в справедливую очередь");
+        return 0;
+    }
+    
+    size_t pushed = 0;
+    
+    pthread_mutex_lock(&queue->mutex);
+    
+    for (; pushed < count && queue->free_node != PARTIAL_FAIR_NIL; pushed++) {
+        const partial_t* partial = &partials[pushed];
+        uint32_t flow_index = partial_fair_find_flow(queue, partial->launcher_id, true);
+        partial_fair_flow_t* flow = &queue->flows[flow_index];
+        if (flow->count >= queue->flow_capacity) {
+            queue->flow_rejected++;
+            break;
+        }
+        
+        uint32_t node = queue->free_node;
+        queue->free_node = queue->node_next[node];
+        memcpy(&queue->storage[node], partial, sizeof(partial_t));
+        queue->node_next[node] = PARTIAL_FAIR_NIL;
+        
+        if (flow->tail == PARTIAL_FAIR_NIL) {
+            flow->head = node;
+        } else {
+            queue->node_next[flow->tail] = node;
+        }
+        flow->tail = node;
+        flow->count++;
+        
+        // Вес следует за текущей сложностью фермера
+        flow->weight = partial_fair_weight(partial->difficulty);
+        
+        queue->size++;
+        queue->enqueued++;
+    }
+    
+    pthread_mutex_unlock(&queue->mutex);
+    
+    if (pushed == 1) {
+        pthread_cond_signal(&queue->not_empty);
+    } else if (pushed > 1) {
+        pthread_cond_broadcast(&queue->not_empty);
+    }
+    return pushed;
+}
+
+// Обход deficit round robin под мьютексом. Визит к потоку начисляет квант
+// weight, поток отдает partials, пока хватает дефицита, и уходит в конец
+// кольца. Опустевший поток удаляется и теряет накопленный дефицит.
+static size_t partial_fair_queue_take(partial_fair_queue_t* queue, partial_t* partials,
+                                      size_t max_count) {
+    size_t taken = 0;
+    
+    while (taken < max_count && queue->active_head != PARTIAL_FAIR_NIL) {
+        uint32_t index = queue->active_head;
+        partial_fair_flow_t* flow = &queue->flows[index];
+        
+        if (!flow->in_service) {
+            flow->deficit += flow->weight;
+            flow->in_service = true;
+            queue->rounds++;
+        }
+        
+        while (taken < max_count && flow->count > 0 && flow->deficit > 0) {
+            uint32_t node = flow->head;
+            flow->head = queue->node_next[node];
+            if (flow->head == PARTIAL_FAIR_NIL) {
+                flow->tail = PARTIAL_FAIR_NIL;
+            }
+            flow->count--;
+            flow->deficit--;
+            
+            memcpy(&partials[taken++], &queue->storage[node], sizeof(partial_t));
+            queue->node_next[node] = queue->free_node;
+            queue->free_node = node;
+            queue->size--;
+            queue->dequeued++;
+        }
+        
+        if (flow->count == 0) {
+            partial_fair_release_head(queue);
+        } else if (flow->deficit == 0) {
+            // Квант израсходован: поток переходит в конец кольца
+            flow->in_service = false;
+            if (flow->next_active != PARTIAL_FAIR_NIL) {
+                queue->active_head = flow->next_active;
+                flow->next_active = PARTIAL_FAIR_NIL;
+                queue->flows[queue->active_tail].next_active = index;
+                queue->active_tail = index;
+            }
+        }
+    }
+    
+    return taken;
+}
+
+size_t partial_fair_queue_try_pop_batch(partial_fair_queue_t* queue, partial_t* partials,
+                                        size_t max_count) {
+    if (!queue || !queue->storage || !partials || max_count == 0) {
+        partial_fair_log("ERROR", "Невалидные параметры для извлечения из справедливой очереди");
+        return 0;
+    }
+    
+    pthread_mutex_lock(&queue->mutex);
+    size_t taken = partial_fair_queue_take(queue, partials, max_count);
+    pthread_mutex_unlock(&queue->mutex);
+    return taken;
+}
+
+size_t partial_fair_queue_pop_batch(partial_fair_queue_t* queue, partial_t* partials,
+                                    size_t max_count) {
+    if (!queue || !queue->storage || !partials || max_count == 0) {
+        partial_fair_log("ERROR", "Невалидные параметры для извлечения из справедливой очереди");
+        return 0;
+    }
+    
+    pthread_mutex_lock(&queue->mutex);
+    while (queue->size == 0 && !queue->closed) {
+        pthread_cond_wait(&queue->not_empty, &queue->mutex);
+    }
+    size_t taken = partial_fair_queue_take(queue, partials, max_count);
+    pthread_mutex_unlock(&queue->mutex);
+    return taken;
+}
+
+uint32_t partial_fair_queue_size(partial_fair_queue_t* queue) {
+    if (!queue || !queue->storage) {
+        return 0;
+    }
+    
+    pthread_mutex_lock(&queue->mutex);
+    uint32_t size = queue->size;
+    pthread_mutex_unlock(&queue->mutex);
+    return size;
+}
+
+void partial_fair_queue_close(partial_fair_queue_t* queue) {
+    if (!queue || !queue->storage) {
+        return;
+    }
+    
+    pthread_mutex_lock(&queue->mutex);
+    queue->closed = true;
+    pthread_mutex_unlock(&queue->mutex);
+    pthread_cond_broadcast(&queue->not_empty);
+}
+
+void partial_fair_queue_get_stats(partial_fair_queue_t* queue, partial_fair_stats_t* stats) {
+    if (!stats) {
+        return;
+    }
+    
+    memset(stats, 0, sizeof(partial_fair_stats_t));
+    if (!queue || !queue->storage) {
+        return;
+    }
+    
+    pthread_mutex_lock(&queue->mutex);
+    stats->enqueued = queue->enqueued;
+    stats->dequeued = queue->dequeued;
+    stats->flow_rejected = queue->flow_rejected;
+    stats->rounds = queue->rounds;
+    stats->active_flows = queue->active_flows;
+    stats->max_active_flows = queue->max_active_flows;
+    stats->size = queue->size;
+    pthread_mutex_unlock(&queue->mutex);
+}
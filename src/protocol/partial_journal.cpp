@@ -0,0 +1,829 @@
+#include "protocol/partial_journal.h"
+#include "metrics.h"
+
+#include <pthread.h>
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <immintrin.h>
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include <algorithm>
+#include <vector>
+
+#define PARTIAL_JOURNAL_SEGMENT_MAGIC 0x47534A50U // "PJSG"
+#define PARTIAL_JOURNAL_RECORD_MAGIC 0x52434A50U  // "PJCR"
+#define PARTIAL_JOURNAL_VERSION 1
+#define PARTIAL_JOURNAL_MIN_SEGMENT_RECORDS 64
+#define PARTIAL_JOURNAL_TRUNCATE_INTERVAL_NS (60ULL * 1000000000ULL)
+
+// Заголовок сегмента занимает первый слот записи
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t segment_id;
+    uint32_t record_capacity;
+    uint32_t crc;                  // CRC32C предыдущих полей
+    uint8_t reserved[104];
+} partial_journal_header_t;
+
+typedef struct {
+    uint32_t magic;
+    uint32_t crc;                  // CRC32C от entry и reserved
+    partial_journal_entry_t entry;
+    uint8_t reserved[24];
+} partial_journal_record_t;
+
+static_assert(sizeof(partial_journal_header_t) == PARTIAL_JOURNAL_RECORD_SIZE,
+              "Заголовок сегмента должен занимать один слот");
+static_assert(sizeof(partial_journal_record_t) == PARTIAL_JOURNAL_RECORD_SIZE,
+              "Неверный размер записи журнала");
+
+// Отображенный в память сегмент
+typedef struct partial_journal_segment {
+    uint64_t id;
+    int fd;
+    uint8_t* base;
+    size_t size;
+    uint32_t count;                // Записано записей
+    uint32_t synced;               // Записей, сброшенных на диск
+    uint64_t max_timestamp;
+    struct partial_journal_segment* next; // Список закрытых сегментов для сброса
+} partial_journal_segment_t;
+
+// Закрытый сегмент на диске, кандидат на удаление по окну хранения
+typedef struct {
+    uint64_t id;
+    uint64_t max_timestamp;
+} partial_journal_segment_info_t;
+
+static pthread_mutex_t g_journal_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t g_journal_flush_cond = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t g_journal_durable_cond = PTHREAD_COND_INITIALIZER;
+static pthread_t g_journal_flusher;
+
+static bool g_journal_active = false;
+static bool g_journal_stop = false;
+static bool g_journal_sync_requested = false;
+static char g_journal_directory[512];
+static partial_journal_config_t g_journal_config;
+
+static partial_journal_segment_t* g_journal_current = NULL;
+static partial_journal_segment_t* g_journal_spare = NULL;  // Заранее созданный следующий сегмент
+static partial_journal_segment_t* g_journal_sealed = NULL; // Закрытые, ожидают сброса
+static partial_journal_segment_info_t* g_journal_segments = NULL;
+static size_t g_journal_segment_count = 0;
+static size_t g_journal_segment_capacity = 0;
+
+static uint64_t g_journal_next_segment_id = 1;
+static uint64_t g_journal_next_sequence = 1;
+static uint32_t g_journal_pending = 0;
+
+static partial_journal_stats_t g_journal_stats;
+
+static uint32_t g_crc32c_table[256];
+static bool g_crc32c_hardware = false;
+
+static void partial_journal_log(const char* level, const char* message) {
+    time_t now = time(NULL);
+    struct tm* tm_info = localtime(&now);
+    char timestamp[20];
+    strftime(timestamp, sizeof(timestamp), "%Y-%m-%d %H:%M:%S", tm_info);
+    
+    printf("[%s] [PARTIAL_JOURNAL] [%s] %s\n", timestamp, level, message);
+    fflush(stdout);
+}
+
+static void partial_journal_crc32c_init(void) {
+    for (uint32_t i = 0; i < 256; i++) {
+        uint32_t crc = i;
+        for (int bit = 0; bit < 8; bit++) {
+            crc = (crc >> 1) ^ (0x82F63B78U & (0U - (crc & 1)));
+        }
+        g_crc32c_table[i] = crc;
+    }
+    g_crc32c_hardware = __builtin_cpu_supports("sse4.2");
+}
+
+__attribute__((target("sse4.2")))
+static uint32_t partial_journal_crc32c_sse42(const uint8_t* data, size_t length) {
+    uint64_t crc = 0xFFFFFFFFU;
+    size_t i = 0;
+    for (; i + 8 <= length; i += 8) {
+        uint64_t word;
+        memcpy(&word, data + i, sizeof(word));
+        crc = _mm_crc32_u64(crc, word);
+    }
+    for (; i < length; i++) {
+        crc = _mm_crc32_u8((uint32_t)crc, data[i]);
+    }
+    return (uint32_t)crc ^ 0xFFFFFFFFU;
+}
+
+// CRC32C (Castagnoli): инструкция crc32 SSE4.2, иначе табличный вариант
+static uint32_t partial_journal_crc32c(const uint8_t* data, size_t length) {
+    if (g_crc32c_hardware) {
+        return partial_journal_crc32c_sse42(data, length);
+    }
+    
+    uint32_t crc = 0xFFFFFFFFU;
+    for (size_t i = 0; i < length; i++) {
+        crc = g_crc32c_table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+    }
+    return crc ^ 0xFFFFFFFFU;
+}
+
+static uint32_t partial_journal_record_crc(const partial_journal_record_t* record) {
+    const uint8_t* bytes = (const uint8_t*)record;
+    return partial_journal_crc32c(bytes + offsetof(partial_journal_record_t, entry),
+                                  sizeof(partial_journal_record_t) -
+                                  offsetof(partial_journal_record_t, entry));
+}
+
+static uint32_t partial_journal_header_crc(const partial_journal_header_t* header) {
+    return partial_journal_crc32c((const uint8_t*)header, offsetof(partial_journal_header_t, crc));
+}
+
+static void partial_journal_segment_path(uint64_t id, char* path, size_t path_size) {
+    snprintf(path, path_size, "%s/partials-%016llx.wal", g_journal_directory,
+             (unsigned long long)id);
+}
+
+static bool partial_journal_parse_segment_name(const char* name, uint64_t* id) {
+    unsigned long long value = 0;
+    char tail[8];
+    if (strlen(name) != strlen("partials-0000000000000000.wal") ||
+        sscanf(name, "partials-%16llx.%3s", &value, tail) != 2 || strcmp(tail, "wal") != 0) {
+        return false;
+    }
+    *id = value;
+    return true;
+}
+
+static size_t partial_journal_segment_size(uint32_t records) {
+    return (size_t)(records + 1) * PARTIAL_JOURNAL_RECORD_SIZE;
+}
+
+static void partial_journal_sync_directory(void) {
+    int fd = open(g_journal_directory, O_RDONLY | O_DIRECTORY);
+    if (fd >= 0) {
+        fsync(fd);
+        close(fd);
+    }
+}
+
+static void partial_journal_segment_destroy(partial_journal_segment_t* segment) {
+    if (!segment) {
+        return;
+    }
+    
+    if (segment->base) {
+        munmap(segment->base, segment->size);
+    }
+    if (segment->fd >= 0) {
+        close(segment->fd);
+    }
+    free(segment);
+}
+
+// Создание сегмента: файл выделяется целиком, заголовок записывается
+// и сбрасывается сразу, чтобы сегмент был валиден до первой записи
+static partial_journal_segment_t* partial_journal_segment_create(uint64_t id) {
+    char path[600];
+    partial_journal_segment_path(id, path, sizeof(path));
+    
+    partial_journal_segment_t* segment =
+        (partial_journal_segment_t*)calloc(1, sizeof(partial_journal_segment_t));
+    if (!segment) {
+        return NULL;
+    }
+    segment->id = id;
+    segment->size = partial_journal_segment_size(g_journal_config.segment_records);
+    segment->fd = open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (segment->fd < 0) {
+        char log_msg[700];
+        snprintf(log_msg, sizeof(log_msg), "Не удалось создать сегмент %s: %s", path, strerror(errno));
+        partial_journal_log("ERROR", log_msg);
+        free(segment);
+        return NULL;
+    }
+    
+    if (posix_fallocate(segment->fd, 0, (off_t)segment->size) != 0) {
+        partial_journal_log("ERROR", "Не удалось выделить место под сегмент журнала");
+        partial_journal_segment_destroy(segment);
+        unlink(path);
+        return NULL;
+    }
+    
+    void* base = mmap(NULL, segment->size, PROT_READ | PROT_WRITE, MAP_SHARED, segment->fd, 0);
+    if (base == MAP_FAILED) {
+        partial_journal_log("ERROR", "Не удалось отобразить сегмент журнала в память");
+        partial_journal_segment_destroy(segment);
+        unlink(path);
+        return NULL;
+    }
+    segment->base = (uint8_t*)base;
+    
+    partial_journal_header_t* header = (partial_journal_header_t*)segment->base;
+    header->magic = PARTIAL_JOURNAL_SEGMENT_MAGIC;
+    header->version = PARTIAL_JOURNAL_VERSION;
+    header->segment_id = id;
+    header->record_capacity = g_journal_config.segment_records;
+    header->crc = partial_journal_header_crc(header);
+    
+    if (msync(segment->base, PARTIAL_JOURNAL_RECORD_SIZE, MS_SYNC) != 0) {
+        partial_journal_log("ERROR", "Не удалось сбросить заголовок сегмента журнала");
+        partial_journal_segment_destroy(segment);
+        unlink(path);
+        return NULL;
+    }
+    
+    partial_journal_sync_directory();
+    return segment;
+}
+
+// Удаление сегмента, в который не было записей
+static void partial_journal_segment_discard(partial_journal_segment_t* segment) {
+    char path[600];
+    partial_journal_segment_path(segment->id, path, sizeof(path));
+    partial_journal_segment_destroy(segment);
+    unlink(path);
+}
+
+static void partial_journal_segment_remember(uint64_t id, uint64_t max_timestamp) {
+    if (g_journal_segment_count == g_journal_segment_capacity) {
+        size_t capacity = g_journal_segment_capacity ? g_journal_segment_capacity * 2 : 64;
+        partial_journal_segment_info_t* segments = (partial_journal_segment_info_t*)realloc(
+            g_journal_segments, capacity * sizeof(partial_journal_segment_info_t));
+        if (!segments) {
+            // Сегмент останется на диске до следующего запуска
+            return;
+        }
+        g_journal_segments = segments;
+        g_journal_segment_capacity = capacity;
+    }
+    
+    g_journal_segments[g_journal_segment_count].id = id;
+    g_journal_segments[g_journal_segment_count].max_timestamp = max_timestamp;
+    g_journal_segment_count++;
+}
+
+// Сброс диапазона записей [from, to) сегмента. msync по отображенному
+// файлу эквивалентен fdatasync затронутых страниц.
+static bool partial_journal_segment_flush(partial_journal_segment_t* segment, uint32_t from, uint32_t to) {
+    if (to <= from) {
+        return true;
+    }
+    
+    size_t page = (size_t)sysconf(_SC_PAGESIZE);
+    size_t start = (size_t)(from + 1) * PARTIAL_JOURNAL_RECORD_SIZE;
+    size_t end = (size_t)(to + 1) * PARTIAL_JOURNAL_RECORD_SIZE;
+    start &= ~(page - 1);
+    
+    return msync(segment->base + start, end - start, MS_SYNC) == 0;
+}
+
+static void partial_journal_deadline(struct timespec* deadline, uint32_t timeout_ms) {
+    clock_gettime(CLOCK_REALTIME, deadline);
+    deadline->tv_sec += timeout_ms / 1000;
+    deadline->tv_nsec += (long)(timeout_ms % 1000) * 1000000L;
+    if (deadline->tv_nsec >= 1000000000L) {
+        deadline->tv_sec++;
+        deadline->tv_nsec -= 1000000000L;
+    }
+}
+
+// Group commit: одна пара msync на все записи, накопленные за интервал.
+// Сегменты закрываются и освобождаются только здесь, поэтому указатель
+// на текущий сегмент остается валидным после снятия блокировки.
+static void partial_journal_flush_pending(void) {
+    pthread_mutex_lock(&g_journal_mutex);
+    partial_journal_segment_t* sealed = g_journal_sealed;
+    g_journal_sealed = NULL;
+    partial_journal_segment_t* current = g_journal_current;
+    uint32_t from = current ? current->synced : 0;
+    uint32_t to = current ? current->count : 0;
+    uint64_t target = g_journal_next_sequence - 1;
+    bool idle = !sealed && to == from;
+    g_journal_pending = 0;
+    g_journal_sync_requested = false;
+    pthread_mutex_unlock(&g_journal_mutex);
+    
+    if (idle) {
+        pthread_mutex_lock(&g_journal_mutex);
+        pthread_cond_broadcast(&g_journal_durable_cond);
+        pthread_mutex_unlock(&g_journal_mutex);
+        return;
+    }
+    
+    bool ok = true;
+    while (sealed) {
+        partial_journal_segment_t* next = sealed->next;
+        ok = partial_journal_segment_flush(sealed, sealed->synced, sealed->count) && ok;
+        partial_journal_segment_destroy(sealed);
+        sealed = next;
+    }
+    
+    if (current) {
+        ok = partial_journal_segment_flush(current, from, to) && ok;
+    }
+    
+    if (!ok) {
+        partial_journal_log("ERROR", "Ошибка сброса журнала на диск");
+    }
+    
+    pthread_mutex_lock(&g_journal_mutex);
+    if (ok) {
+        // Если сегмент закрылся во время сброса, он уже в списке sealed
+        // и при следующем сбросе начнется с позиции synced
+        if (current && to > current->synced) {
+            current->synced = to;
+        }
+        if (target > g_journal_stats.durable_sequence) {
+            g_journal_stats.durable_sequence = target;
+        }
+        g_journal_stats.syncs++;
+    }
+    pthread_cond_broadcast(&g_journal_durable_cond);
+    pthread_mutex_unlock(&g_journal_mutex);
+}
+
+static void* partial_journal_flusher_thread(void* arg) {
+    (void)arg;
+    uint64_t last_truncate = metrics_now_ns();
+    
+    pthread_mutex_lock(&g_journal_mutex);
+    while (!g_journal_stop) {
+        if (g_journal_pending < g_journal_config.sync_records && !g_journal_sync_requested) {
+            struct timespec deadline;
+            partial_journal_deadline(&deadline, g_journal_config.sync_interval_ms);
+            pthread_cond_timedwait(&g_journal_flush_cond, &g_journal_mutex, &deadline);
+        }
+        bool need_spare = g_journal_spare == NULL;
+        uint64_t spare_id = need_spare ? g_journal_next_segment_id++ : 0;
+        pthread_mutex_unlock(&g_journal_mutex);
+        
+        partial_journal_flush_pending();
+        
+        // Следующий сегмент создается заранее, чтобы смена сегмента
+        // под блокировкой записи не включала создание файла
+        if (need_spare) {
+            partial_journal_segment_t* spare = partial_journal_segment_create(spare_id);
+            pthread_mutex_lock(&g_journal_mutex);
+            if (spare && !g_journal_spare) {
+                g_journal_spare = spare;
+                spare = NULL;
+            }
+            pthread_mutex_unlock(&g_journal_mutex);
+            if (spare) {
+                partial_journal_segment_discard(spare);
+            }
+        }
+        
+        uint64_t now_ns = metrics_now_ns();
+        if (now_ns - last_truncate >= PARTIAL_JOURNAL_TRUNCATE_INTERVAL_NS) {
+            partial_journal_truncate((uint64_t)time(NULL));
+            last_truncate = now_ns;
+        }
+        
+        pthread_mutex_lock(&g_journal_mutex);
+    }
+    pthread_mutex_unlock(&g_journal_mutex);
+    
+    // Финальный сброс при остановке
+    partial_journal_flush_pending();
+    return NULL;
+}
+
+// Отображенный сегмент при восстановлении
+typedef struct {
+    uint64_t id;
+    uint64_t first_sequence;
+    int fd;
+    uint8_t* base;
+    size_t size;
+    uint32_t capacity;
+} partial_journal_replay_segment_t;
+
+static bool partial_journal_replay_order(const partial_journal_replay_segment_t& a,
+                                         const partial_journal_replay_segment_t& b) {
+    return a.first_sequence < b.first_sequence;
+}
+
+static bool partial_journal_record_valid(const partial_journal_record_t* record) {
+    return record->magic == PARTIAL_JOURNAL_RECORD_MAGIC &&
+           record->crc == partial_journal_record_crc(record);
+}
+
+// Восстановление: сегменты упорядочиваются по номеру первой записи
+// и читаются последовательно до первой оборванной или поврежденной записи
+static bool partial_journal_replay(partial_journal_replay_fn replay, void* user, uint64_t now) {
+    DIR* dir = opendir(g_journal_directory);
+    if (!dir) {
+        partial_journal_log("ERROR", "Не удалось открыть каталог журнала");
+        return false;
+    }
+    
+    std::vector<partial_journal_replay_segment_t> segments;
+    struct dirent* dirent_entry;
+    while ((dirent_entry = readdir(dir)) != NULL) {
+        uint64_t id;
+        if (!partial_journal_parse_segment_name(dirent_entry->d_name, &id)) {
+            continue;
+        }
+        if (id >= g_journal_next_segment_id) {
+            g_journal_next_segment_id = id + 1;
+        }
+        
+        char path[600];
+        partial_journal_segment_path(id, path, sizeof(path));
+        
+        partial_journal_replay_segment_t segment;
+        memset(&segment, 0, sizeof(segment));
+        segment.id = id;
+        segment.fd = open(path, O_RDONLY);
+        if (segment.fd < 0) {
+            continue;
+        }
+        
+        struct stat st;
+        bool usable = fstat(segment.fd, &st) == 0 && st.st_size >= 2 * PARTIAL_JOURNAL_RECORD_SIZE;
+        if (usable) {
+            segment.size = (size_t)st.st_size;
+            void* base = mmap(NULL, segment.size, PROT_READ, MAP_PRIVATE, segment.fd, 0);
+            usable = base != MAP_FAILED;
+            segment.base = usable ? (uint8_t*)base : NULL;
+        }
+        
+        if (usable) {
+            const partial_journal_header_t* header = (const partial_journal_header_t*)segment.base;
+            const partial_journal_record_t* first = (const partial_journal_record_t*)(segment.base + PARTIAL_JOURNAL_RECORD_SIZE);
+            usable = header->magic == PARTIAL_JOURNAL_SEGMENT_MAGIC &&
+                     header->version == PARTIAL_JOURNAL_VERSION &&
+                     header->crc == partial_journal_header_crc(header) &&
+                     partial_journal_segment_size(header->record_capacity) <= segment.size &&
+                     partial_journal_record_valid(first);
+            if (usable) {
+                segment.capacity = header->record_capacity;
+                segment.first_sequence = first->entry.sequence;
+            }
+        }
+        
+        if (!usable) {
+            // Пустой (заранее созданный) или поврежденный сегмент без записей
+            if (segment.base) {
+                munmap(segment.base, segment.size);
+            }
+            close(segment.fd);
+            unlink(path);
+            continue;
+        }
+        
+        madvise(segment.base, segment.size, MADV_SEQUENTIAL);
+        segments.push_back(segment);
+    }
+    closedir(dir);
+    
+    std::sort(segments.begin(), segments.end(), partial_journal_replay_order);
+    
+    uint64_t cutoff = now > g_journal_config.retention_seconds ? now - g_journal_config.retention_seconds : 0;
+    uint64_t last_sequence = 0;
+    uint64_t torn = 0;
+    
+    for (size_t s = 0; s < segments.size(); s++) {
+        partial_journal_replay_segment_t* segment = &segments[s];
+        uint64_t max_timestamp = 0;
+        uint32_t count = 0;
+        
+        for (uint32_t i = 0; i < segment->capacity; i++) {
+            const partial_journal_record_t* record =
+                (const partial_journal_record_t*)(segment->base + (size_t)(i + 1) * PARTIAL_JOURNAL_RECORD_SIZE);
+            if (!partial_journal_record_valid(record) || record->entry.sequence <= last_sequence) {
+                if (record->magic != 0) {
+                    torn++;
+                }
+                break;
+            }
+            
+            last_sequence = record->entry.sequence;
+            if (record->entry.timestamp > max_timestamp) {
+                max_timestamp = record->entry.timestamp;
+            }
+            count++;
+            
+            if (record->entry.timestamp >= cutoff) {
+                if (replay) {
+                    replay(&record->entry, user);
+                }
+                g_journal_stats.replayed++;
+                g_journal_stats.replayed_points += record->entry.points;
+            }
+        }
+        
+        munmap(segment->base, segment->size);
+        close(segment->fd);
+        
+        if (count > 0) {
+            partial_journal_segment_remember(segment->id, max_timestamp);
+        }
+    }
+    
+    g_journal_next_sequence = last_sequence + 1;
+    g_journal_stats.durable_sequence = last_sequence;
+    
+    if (torn > 0) {
+        char log_msg[128];
+        snprintf(log_msg, sizeof(log_msg), "Отброшен оборванный хвост в %llu сегментах журнала",
+                 (unsigned long long)torn);
+        partial_journal_log("WARNING", log_msg);
+    }
+    
+    return true;
+}
+
+bool partial_journal_open(const partial_journal_config_t* config,
+                          partial_journal_replay_fn replay, void* user) {
+    if (!config || !config->directory || config->directory[0] == '\0') {
+        partial_journal_log("ERROR", "Не указан каталог журнала partials");
+        return false;
+    }
+    
+    if (g_journal_active) {
+        partial_journal_log("WARNING", "Журнал partials уже открыт");
+        return true;
+    }
+    
+    if (strlen(config->directory) >= sizeof(g_journal_directory)) {
+        partial_journal_log("ERROR", "Слишком длинный путь каталога журнала");
+        return false;
+    }
+    
+    partial_journal_crc32c_init();
+    
+    strcpy(g_journal_directory, config->directory);
+    g_journal_config = *config;
+    g_journal_config.directory = g_journal_directory;
+    if (g_journal_config.segment_records == 0) {
+        g_journal_config.segment_records = PARTIAL_JOURNAL_DEFAULT_SEGMENT_RECORDS;
+    }
+    if (g_journal_config.segment_records < PARTIAL_JOURNAL_MIN_SEGMENT_RECORDS) {
+        g_journal_config.segment_records = PARTIAL_JOURNAL_MIN_SEGMENT_RECORDS;
+    }
+    if (g_journal_config.sync_interval_ms == 0) {
+        g_journal_config.sync_interval_ms = PARTIAL_JOURNAL_DEFAULT_SYNC_INTERVAL_MS;
+    }
+    if (g_journal_config.sync_records == 0) {
+        g_journal_config.sync_records = PARTIAL_JOURNAL_DEFAULT_SYNC_RECORDS;
+    }
+    if (g_journal_config.retention_seconds == 0) {
+        g_journal_config.retention_seconds = PARTIAL_JOURNAL_DEFAULT_RETENTION_SECONDS;
+    }
+    
+    if (mkdir(g_journal_directory, 0755) != 0 && errno != EEXIST) {
+        char log_msg[700];
+        snprintf(log_msg, sizeof(log_msg), "Не удалось создать каталог журнала %s: %s",
+                 g_journal_directory, strerror(errno));
+        partial_journal_log("ERROR", log_msg);
+        return false;
+    }
+    
+    memset(&g_journal_stats, 0, sizeof(g_journal_stats));
+    g_journal_next_segment_id = 1;
+    g_journal_next_sequence = 1;
+    g_journal_pending = 0;
+    g_journal_stop = false;
+    g_journal_sync_requested = false;
+    
+    uint64_t replay_start = metrics_now_ns();
+    if (!partial_journal_replay(replay, user, (uint64_t)time(NULL))) {
+        return false;
+    }
+    g_journal_stats.replay_ns = metrics_now_ns() - replay_start;
+    
+    // Запись всегда продолжается в новом сегменте
+    g_journal_current = partial_journal_segment_create(g_journal_next_segment_id++);
+    if (!g_journal_current) {
+        free(g_journal_segments);
+        g_journal_segments = NULL;
+        g_journal_segment_count = 0;
+        g_journal_segment_capacity = 0;
+        return false;
+    }
+    
+    g_journal_active = true;
+    if (pthread_create(&g_journal_flusher, NULL, partial_journal_flusher_thread, NULL) != 0) {
+        partial_journal_log("ERROR", "Не удалось запустить поток сброса журнала");
+        g_journal_active = false;
+        partial_journal_segment_destroy(g_journal_current);
+        g_journal_current = NULL;
+        return false;
+    }
+    
+    char log_msg[256];
+    snprintf(log_msg, sizeof(log_msg),
+             "Журнал partials открыт: восстановлено %llu записей (%llu очков) за %.1f мс",
+             (unsigned long long)g_journal_stats.replayed,
+             (unsigned long long)g_journal_stats.replayed_points,
+             g_journal_stats.replay_ns / 1e6);
+    partial_journal_log("INFO", log_msg);
+    return true;
+}
+
+void partial_journal_close(void) {
+    pthread_mutex_lock(&g_journal_mutex);
+    if (!g_journal_active) {
+        pthread_mutex_unlock(&g_journal_mutex);
+        return;
+    }
+    g_journal_stop = true;
+    pthread_cond_signal(&g_journal_flush_cond);
+    pthread_mutex_unlock(&g_journal_mutex);
+    
+    pthread_join(g_journal_flusher, NULL);
+    
+    pthread_mutex_lock(&g_journal_mutex);
+    g_journal_active = false;
+    partial_journal_segment_destroy(g_journal_current);
+    g_journal_current = NULL;
+    
+    if (g_journal_spare) {
+        partial_journal_segment_discard(g_journal_spare);
+        g_journal_spare = NULL;
+    }
+    
+    free(g_journal_segments);
+    g_journal_segments = NULL;
+    g_journal_segment_count = 0;
+    g_journal_segment_capacity = 0;
+    pthread_cond_broadcast(&g_journal_durable_cond);
+    pthread_mutex_unlock(&g_journal_mutex);
+    
+    partial_journal_log("INFO", "Журнал partials закрыт");
+}
+
+bool partial_journal_is_enabled(void) {
+    return __atomic_load_n(&g_journal_active, __ATOMIC_ACQUIRE);
+}
+
+bool partial_journal_append(const partial_journal_entry_t* entry, uint64_t* sequence) {
+    if (!entry) {
+        return false;
+    }
+    
+    pthread_mutex_lock(&g_journal_mutex);
+    if (!g_journal_active || !g_journal_current) {
+        pthread_mutex_unlock(&g_journal_mutex);
+        return false;
+    }
+    
+    partial_journal_segment_t* segment = g_journal_current;
+    while (segment->count == g_journal_config.segment_records) {
+        // Смена сегмента: заполненный передается потоку сброса
+        partial_journal_segment_t* next = g_journal_spare;
+        g_journal_spare = NULL;
+        if (!next) {
+            // Поток сброса не успел подготовить запасной сегмент. Файл
+            // создается без блокировки, чтобы fallocate и fsync каталога
+            // не останавливали остальные записи и сброс.
+            uint64_t id = g_journal_next_segment_id++;
+            pthread_mutex_unlock(&g_journal_mutex);
+            next = partial_journal_segment_create(id);
+            pthread_mutex_lock(&g_journal_mutex);
+            
+            if (!next || !g_journal_active || !g_journal_current) {
+                if (next) {
+                    partial_journal_segment_discard(next);
+                }
+                pthread_mutex_unlock(&g_journal_mutex);
+                return false;
+            }
+            
+            segment = g_journal_current;
+            if (segment->count < g_journal_config.segment_records) {
+                // Сегмент уже сменила другая запись: созданный станет запасным
+                if (!g_journal_spare) {
+                    g_journal_spare = next;
+                } else {
+                    partial_journal_segment_discard(next);
+                }
+                break;
+            }
+        }
+        
+        partial_journal_segment_remember(segment->id, segment->max_timestamp);
+        segment->next = g_journal_sealed;
+        g_journal_sealed = segment;
+        g_journal_current = next;
+        segment = next;
+        pthread_cond_signal(&g_journal_flush_cond);
+    }
+    
+    partial_journal_record_t* record =
+        (partial_journal_record_t*)(segment->base + (size_t)(segment->count + 1) * PARTIAL_JOURNAL_RECORD_SIZE);
+    record->entry = *entry;
+    record->entry.sequence = g_journal_next_sequence++;
+    record->crc = partial_journal_record_crc(record);
+    record->magic = PARTIAL_JOURNAL_RECORD_MAGIC;
+    
+    segment->count++;
+    if (entry->timestamp > segment->max_timestamp) {
+        segment->max_timestamp = entry->timestamp;
+    }
+    
+    g_journal_stats.appended++;
+    g_journal_stats.appended_points += entry->points;
+    if (sequence) {
+        *sequence = record->entry.sequence;
+    }
+    
+    if (++g_journal_pending >= g_journal_config.sync_records) {
+        pthread_cond_signal(&g_journal_flush_cond);
+    }
+    pthread_mutex_unlock(&g_journal_mutex);
+    return true;
+}
+
+bool partial_journal_wait_durable(uint64_t sequence, uint32_t timeout_ms) {
+    struct timespec deadline;
+    partial_journal_deadline(&deadline, timeout_ms);
+    
+    pthread_mutex_lock(&g_journal_mutex);
+    while (g_journal_active && g_journal_stats.durable_sequence < sequence && timeout_ms > 0) {
+        if (pthread_cond_timedwait(&g_journal_durable_cond, &g_journal_mutex, &deadline) == ETIMEDOUT) {
+            break;
+        }
+    }
+    bool durable = g_journal_stats.durable_sequence >= sequence;
+    pthread_mutex_unlock(&g_journal_mutex);
+    return durable;
+}
+
+bool partial_journal_sync(void) {
+    pthread_mutex_lock(&g_journal_mutex);
+    if (!g_journal_active) {
+        pthread_mutex_unlock(&g_journal_mutex);
+        return false;
+    }
+    
+    uint64_t target = g_journal_next_sequence - 1;
+    g_journal_sync_requested = true;
+    pthread_cond_signal(&g_journal_flush_cond);
+    while (g_journal_active && g_journal_stats.durable_sequence < target) {
+        pthread_cond_wait(&g_journal_durable_cond, &g_journal_mutex);
+    }
+    bool durable = g_journal_stats.durable_sequence >= target;
+    pthread_mutex_unlock(&g_journal_mutex);
+    return durable;
+}
+
+size_t partial_journal_truncate(uint64_t now) {
+    uint64_t cutoff = now > g_journal_config.retention_seconds ? now - g_journal_config.retention_seconds : 0;
+    std::vector<uint64_t> expired;
+    
+    pthread_mutex_lock(&g_journal_mutex);
+    size_t kept = 0;
+    for (size_t i = 0; i < g_journal_segment_count; i++) {
+        if (g_journal_segments[i].max_timestamp < cutoff) {
+            expired.push_back(g_journal_segments[i].id);
+        } else {
+            g_journal_segments[kept++] = g_journal_segments[i];
+        }
+    }
+    g_journal_segment_count = kept;
+    g_journal_stats.segments_truncated += expired.size();
+    pthread_mutex_unlock(&g_journal_mutex);
+    
+    // Удаление файлов вне блокировки; закрытый, но еще не сброшенный
+    // сегмент может быть отображен - это допустимо
+    for (size_t i = 0; i < expired.size(); i++) {
+        char path[600];
+        partial_journal_segment_path(expired[i], path, sizeof(path));
+        unlink(path);
+    }
+    
+    if (!expired.empty()) {
+        char log_msg[128];
+        snprintf(log_msg, sizeof(log_msg), "Удалено %zu сегментов журнала вне окна PPLNS", expired.size());
+        partial_journal_log("INFO", log_msg);
+    }
+    
+    return expired.size();
+}
+
+void partial_journal_get_stats(partial_journal_stats_t* stats) {
+    if (!stats) {
+        return;
+    }
+    
+    pthread_mutex_lock(&g_journal_mutex);
+    *stats = g_journal_stats;
+    stats->segments = (uint32_t)g_journal_segment_count + (g_journal_current ? 1 : 0);
+    pthread_mutex_unlock(&g_journal_mutex);
+}
@@ -0,0 +1,460 @@
+#include "protocol/partial_pipeline.h"
+#include "protocol/partial_dedup.h"
+#include "protocol/singleton.h"
+#include "security/auth.h"
+#include "optimizations.h"
+#include "metrics.h"
+
+#include <pthread.h>
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include <algorithm>
+#include <map>
+#include <string>
+#include <vector>
+
+// Дедлайн по умолчанию (partials.deadline_seconds)
+#define PARTIAL_PIPELINE_DEFAULT_DEADLINE 28
+
+typedef partial_validation_result_t (*partial_stage_fn)(partial_validation_context_t* ctx);
+typedef void (*partial_stage_batch_fn)(partial_validation_context_t* contexts,
+                                       const size_t* indices, size_t count,
+                                       partial_validation_result_t* results);
+
+// Описание этапа. Пакетная реализация необязательна: без нее этап
+// вызывается для каждого partial пачки по отдельности.
+typedef struct {
+    const char* name;
+    uint64_t estimated_cost_ns;
+    partial_stage_fn run;
+    partial_stage_batch_fn run_batch;
+} partial_stage_t;
+
+// Счетчики этапа: шардированы по потокам воркеров, чтобы учет не
+// создавал общей строки кеша на горячем пути
+typedef struct {
+    metrics_counter_t executions;
+    metrics_counter_t rejections;
+    metrics_counter_t time_ns;
+    metrics_histogram_t latency;   // Время этапа на один partial
+} partial_stage_counters_t;
+
+static uint32_t g_deadline_seconds = PARTIAL_PIPELINE_DEFAULT_DEADLINE;
+static uint32_t g_partials_per_minute = 0;
+
+static partial_stage_id_t g_order[PARTIAL_STAGE_COUNT];
+static size_t g_order_count = 0;
+static partial_stage_counters_t g_counters[PARTIAL_STAGE_COUNT];
+static pthread_once_t g_order_once = PTHREAD_ONCE_INIT;
+
+static void partial_pipeline_log(const char* level, const char* message) {
+    time_t now = time(NULL);
+    struct tm* tm_info = localtime(&now);
+    char timestamp[20];
+    strftime(timestamp, sizeof(timestamp), "%Y-%m-%d %H:%M:%S", tm_info);
+    
+    printf("[%s] [PARTIAL_PIPELINE] [%s] %s\n", timestamp, level, message);
+    fflush(stdout);
+}
+
+static uint64_t partial_pipeline_now_ns(void) {
+    return metrics_now_ns();
+}
+
+// Этапы
+
+static partial_validation_result_t partial_stage_deadline(partial_validation_context_t* ctx) {
+    if (ctx->current_time - ctx->partial->timestamp > g_deadline_seconds) {
+        return VALIDATION_TOO_LATE;
+    }
+    return VALIDATION_SUCCESS;
+}
+
+static partial_validation_result_t partial_stage_challenge(partial_validation_context_t* ctx) {
+    return partial_verify_challenge_ctx(ctx) ? VALIDATION_SUCCESS : VALIDATION_INVALID_CHALLENGE;
+}
+
+static partial_validation_result_t partial_stage_duplicate(partial_validation_context_t* ctx) {
+    if (!partial_dedup_is_enabled()) {
+        return VALIDATION_SUCCESS;
+    }
+    
+    if (partial_dedup_check_and_insert(ctx->partial->launcher_id,
+                                       partial_context_get_proof_hash(ctx),
+                                       ctx->partial->timestamp, ctx->current_time,
+                                       &ctx->dedup_claim)) {
+        return VALIDATION_DUPLICATE;
+    }
+    return VALIDATION_SUCCESS;
+}
+
+static partial_validation_result_t partial_stage_rate_limit(partial_validation_context_t* ctx) {
+    if (g_partials_per_minute == 0) {
+        return VALIDATION_SUCCESS;
+    }
+    
+    if (!auth_check_rate_limit(ctx->partial->launcher_id, g_partials_per_minute)) {
+        return VALIDATION_RATE_LIMITED;
+    }
+    return VALIDATION_SUCCESS;
+}
+
+static partial_validation_result_t partial_stage_proof(partial_validation_context_t* ctx) {
+    return partial_verify_proof_ctx(ctx) ? VALIDATION_SUCCESS : VALIDATION_INVALID_PROOF;
+}
+
+static partial_validation_result_t partial_stage_singleton(partial_validation_context_t* ctx) {
+    const singleton_t* farmer_singleton = partial_context_get_singleton(ctx);
+    if (!farmer_singleton || !singleton_verify_pool_membership(farmer_singleton)) {
+        return VALIDATION_INVALID_SINGLETON;
+    }
+    
+    // Плот должен быть сделан на пазл пула этого синглтона: иначе
+    // доказательство засчитывалось бы с чужим plot_id
+    if (memcmp(ctx->partial->pool_contract_puzzle_hash, farmer_singleton->p2_singleton_puzzle,
+               sizeof(farmer_singleton->p2_singleton_puzzle)) != 0) {
+        return VALIDATION_INVALID_SINGLETON;
+    }
+    return VALIDATION_SUCCESS;
+}
+
+static partial_validation_result_t partial_stage_signature(partial_validation_context_t* ctx) {
+    if (!partial_context_get_singleton(ctx)) {
+        return VALIDATION_INVALID_SINGLETON;
+    }
+    return partial_verify_signature_ctx(ctx) ? VALIDATION_SUCCESS : VALIDATION_INVALID_SIGNATURE;
+}
+
+// Синглтон запрашивается один раз на уникальный launcher_id пачки,
+// остальные контексты получают копию
+static void partial_pipeline_share_singletons(partial_validation_context_t* contexts,
+                                              const size_t* indices, size_t count) {
+    std::map<std::string, size_t> owners;
+    
+    for (size_t j = 0; j < count; j++) {
+        partial_validation_context_t* ctx = &contexts[indices[j]];
+        if (ctx->singleton_resolved) {
+            continue;
+        }
+        
+        std::string key((const char*)ctx->partial->launcher_id, 32);
+        std::map<std::string, size_t>::iterator it = owners.find(key);
+        if (it == owners.end()) {
+            partial_context_get_singleton(ctx);
+            owners[key] = indices[j];
+        } else {
+            const partial_validation_context_t* owner = &contexts[it->second];
+            partial_context_set_singleton(ctx, &owner->singleton, owner->singleton_found);
+        }
+    }
+}
+
+static void partial_stage_singleton_batch(partial_validation_context_t* contexts,
+                                          const size_t* indices, size_t count,
+                                          partial_validation_result_t* results) {
+    partial_pipeline_share_singletons(contexts, indices, count);
+    
+    for (size_t j = 0; j < count; j++) {
+        results[j] = partial_stage_singleton(&contexts[indices[j]]);
+    }
+}
+
+// Требуемые итерации всех доказательств пачки считаются одним проходом
+static void partial_stage_proof_batch(partial_validation_context_t* contexts,
+                                      const size_t* indices, size_t count,
+                                      partial_validation_result_t* results) {
+    partial_verify_proof_batch_ctx(contexts, indices, count, results);
+}
+
+// Один пакетный вызов BLS верификации для всех подписей пачки
+static void partial_stage_signature_batch(partial_validation_context_t* contexts,
+                                          const size_t* indices, size_t count,
+                                          partial_validation_result_t* results) {
+    partial_pipeline_share_singletons(contexts, indices, count);
+    
+    std::vector<const uint8_t*> public_keys;
+    std::vector<const uint8_t*> messages;
+    std::vector<const uint8_t*> signatures;
+    std::vector<size_t> positions;
+    public_keys.reserve(count);
+    messages.reserve(count);
+    signatures.reserve(count);
+    positions.reserve(count);
+    
+    for (size_t j = 0; j < count; j++) {
+        partial_validation_context_t* ctx = &contexts[indices[j]];
+        if (!ctx->singleton_found) {
+            results[j] = VALIDATION_INVALID_SINGLETON;
+            continue;
+        }
+        
+        public_keys.push_back(ctx->singleton.owner_public_key);
+        messages.push_back(partial_context_get_signature_message(ctx));
+        signatures.push_back(ctx->partial->signature);
+        positions.push_back(j);
+    }
+    
+    size_t sig_count = positions.size();
+    if (sig_count == 0) {
+        return;
+    }
+    
+    std::vector<size_t> message_lens(sig_count, PARTIAL_SIGNATURE_MESSAGE_SIZE);
+    bool* sig_results = new bool[sig_count];
+    
+    vector_bls_verify(&public_keys[0], &messages[0], &message_lens[0],
+                      &signatures[0], sig_results, sig_count);
+    
+    for (size_t k = 0; k < sig_count; k++) {
+        results[positions[k]] = sig_results[k] ? VALIDATION_SUCCESS : VALIDATION_INVALID_SIGNATURE;
+    }
+    delete[] sig_results;
+}
+
+// Декларативное описание этапов. Оценки стоимости - порядок величины
+// на один partial: сравнения памяти, хэш-таблицы, проверка доказательства,
+// RPC к ноде и спаривание BLS.
+static const partial_stage_t g_stages[PARTIAL_STAGE_COUNT] = {
+    { "deadline",   10,      partial_stage_deadline,   NULL },
+    { "challenge",  50,      partial_stage_challenge,  NULL },
+    { "dedup",      300,     partial_stage_duplicate,  NULL },
+    { "rate_limit", 500,     partial_stage_rate_limit, NULL },
+    { "proof",      200000,  partial_stage_proof,      partial_stage_proof_batch },
+    { "singleton",  1000000, partial_stage_singleton,  partial_stage_singleton_batch },
+    { "signature",  2000000, partial_stage_signature,  partial_stage_signature_batch }
+};
+
+static bool partial_stage_cost_less(partial_stage_id_t a, partial_stage_id_t b) {
+    return g_stages[a].estimated_cost_ns < g_stages[b].estimated_cost_ns;
+}
+
+static bool partial_pipeline_find_stage(const char* name, size_t len, partial_stage_id_t* stage) {
+    for (int i = 0; i < PARTIAL_STAGE_COUNT; i++) {
+        if (strlen(g_stages[i].name) == len && strncmp(g_stages[i].name, name, len) == 0) {
+            *stage = (partial_stage_id_t)i;
+            return true;
+        }
+    }
+    return false;
+}
+
+static void partial_pipeline_default_order(void) {
+    if (g_order_count == 0) {
+        partial_pipeline_configure(NULL, g_deadline_seconds, g_partials_per_minute);
+    }
+}
+
+// Порядок по стоимости, если конвейер не был настроен явно
+static void partial_pipeline_ensure_order(void) {
+    pthread_once(&g_order_once, partial_pipeline_default_order);
+}
+
+bool partial_pipeline_configure(const char* order, uint32_t deadline_seconds,
+                                uint32_t partials_per_minute) {
+    partial_stage_id_t new_order[PARTIAL_STAGE_COUNT];
+    bool used[PARTIAL_STAGE_COUNT] = {false};
+    size_t count = 0;
+    
+    // Явно заданный порядок
+    if (order) {
+        const char* cursor = order;
+        while (*cursor) {
+            while (*cursor == ' ' || *cursor == ',') {
+                cursor++;
+            }
+            if (!*cursor) {
+                break;
+            }
+            
+            size_t len = strcspn(cursor, ", ");
+            partial_stage_id_t stage;
+            if (!partial_pipeline_find_stage(cursor, len, &stage)) {
+                char log_msg[128];
+                snprintf(log_msg, sizeof(log_msg), "Неизвестный этап валидации: %.*s",
+                         (int)len, cursor);
+                partial_pipeline_log("ERROR", log_msg);
+                return false;
+            }
+            
+            if (!used[stage]) {
+                used[stage] = true;
+                new_order[count++] = stage;
+            }
+            cursor += len;
+        }
+    }
+    
+    // Остальные этапы - по возрастанию оценки стоимости
+    size_t explicit_count = count;
+    for (int i = 0; i < PARTIAL_STAGE_COUNT; i++) {
+        if (!used[i]) {
+            new_order[count++] = (partial_stage_id_t)i;
+        }
+    }
+    std::stable_sort(new_order + explicit_count, new_order + count, partial_stage_cost_less);
+    
+    memcpy(g_order, new_order, sizeof(g_order));
+    g_order_count = count;
+    g_deadline_seconds = deadline_seconds > 0 ? deadline_seconds : PARTIAL_PIPELINE_DEFAULT_DEADLINE;
+    g_partials_per_minute = partials_per_minute;
+    
+    char log_msg[256];
+    int offset = snprintf(log_msg, sizeof(log_msg), "Порядок этапов валидации:");
+    for (size_t i = 0; i < g_order_count && offset < (int)sizeof(log_msg); i++) {
+        offset += snprintf(log_msg + offset, sizeof(log_msg) - offset, " %s",
+                           g_stages[g_order[i]].name);
+    }
+    partial_pipeline_log("INFO", log_msg);
+    return true;
+}
+
+size_t partial_pipeline_get_order(partial_stage_id_t* order, size_t max_count) {
+    partial_pipeline_ensure_order();
+    
+    if (!order) {
+        return 0;
+    }
+    
+    size_t count = g_order_count < max_count ? g_order_count : max_count;
+    memcpy(order, g_order, count * sizeof(partial_stage_id_t));
+    return count;
+}
+
+static void partial_pipeline_account(partial_stage_id_t stage, uint64_t executions,
+                                     uint64_t rejections, uint64_t time_ns) {
+    partial_stage_counters_t* counters = &g_counters[stage];
+    metrics_counter_add(&counters->executions, executions);
+    metrics_counter_add(&counters->time_ns, time_ns);
+    if (rejections > 0) {
+        metrics_counter_add(&counters->rejections, rejections);
+    }
+    
+    // Пакетный этап учитывается как среднее время на partial пачки
+    if (executions > 0) {
+        metrics_histogram_record(&counters->latency, time_ns / executions, executions);
+    }
+}
+
+partial_validation_result_t partial_pipeline_run(partial_validation_context_t* ctx) {
+    if (!ctx || !ctx->partial) {
+        partial_pipeline_log("ERROR", "Контекст валидации не может быть NULL");
+        return VALIDATION_INTERNAL_ERROR;
+    }
+    
+    partial_pipeline_ensure_order();
+    
+    for (size_t i = 0; i < g_order_count; i++) {
+        partial_stage_id_t stage = g_order[i];
+        
+        uint64_t start = partial_pipeline_now_ns();
+        partial_validation_result_t result = g_stages[stage].run(ctx);
+        uint64_t elapsed = partial_pipeline_now_ns() - start;
+        
+        bool rejected = result != VALIDATION_SUCCESS;
+        partial_pipeline_account(stage, 1, rejected ? 1 : 0, elapsed);
+        
+        if (rejected) {
+            char log_msg[128];
+            snprintf(log_msg, sizeof(log_msg), "Partial отклонен на этапе %s",
+                     g_stages[stage].name);
+            partial_pipeline_log("WARNING", log_msg);
+            return result;
+        }
+    }
+    
+    return VALIDATION_SUCCESS;
+}
+
+void partial_pipeline_run_batch(partial_validation_context_t* contexts, size_t count,
+                                partial_validation_result_t* results) {
+    if (!contexts || !results || count == 0) {
+        return;
+    }
+    
+    partial_pipeline_ensure_order();
+    
+    // Индексы partials, прошедших все предыдущие этапы
+    std::vector<size_t> pending;
+    pending.reserve(count);
+    for (size_t i = 0; i < count; i++) {
+        if (contexts[i].partial) {
+            results[i] = VALIDATION_SUCCESS;
+            pending.push_back(i);
+        } else {
+            results[i] = VALIDATION_INTERNAL_ERROR;
+        }
+    }
+    
+    std::vector<partial_validation_result_t> stage_results(count);
+    
+    for (size_t s = 0; s < g_order_count && !pending.empty(); s++) {
+        const partial_stage_t* stage = &g_stages[g_order[s]];
+        size_t stage_count = pending.size();
+        
+        uint64_t start = partial_pipeline_now_ns();
+        if (stage->run_batch) {
+            stage->run_batch(contexts, &pending[0], stage_count, &stage_results[0]);
+        } else {
+            for (size_t j = 0; j < stage_count; j++) {
+                stage_results[j] = stage->run(&contexts[pending[j]]);
+            }
+        }
+        uint64_t elapsed = partial_pipeline_now_ns() - start;
+        
+        size_t survivors = 0;
+        for (size_t j = 0; j < stage_count; j++) {
+            if (stage_results[j] == VALIDATION_SUCCESS) {
+                pending[survivors++] = pending[j];
+            } else {
+                results[pending[j]] = stage_results[j];
+            }
+        }
+        
+        partial_pipeline_account(g_order[s], stage_count, stage_count - survivors, elapsed);
+        pending.resize(survivors);
+    }
+}
+
+const char* partial_stage_to_string(partial_stage_id_t stage) {
+    if (stage < 0 || stage >= PARTIAL_STAGE_COUNT) {
+        return "unknown";
+    }
+    return g_stages[stage].name;
+}
+
+bool partial_pipeline_get_stage_stats(partial_stage_id_t stage, partial_stage_stats_t* stats) {
+    if (stage < 0 || stage >= PARTIAL_STAGE_COUNT || !stats) {
+        return false;
+    }
+    
+    partial_pipeline_ensure_order();
+    
+    memset(stats, 0, sizeof(partial_stage_stats_t));
+    stats->name = g_stages[stage].name;
+    stats->estimated_cost_ns = g_stages[stage].estimated_cost_ns;
+    stats->executions = metrics_counter_read(&g_counters[stage].executions);
+    stats->rejections = metrics_counter_read(&g_counters[stage].rejections);
+    stats->time_ns = metrics_counter_read(&g_counters[stage].time_ns);
+    metrics_histogram_summarize(&g_counters[stage].latency, &stats->latency);
+    
+    for (size_t i = 0; i < g_order_count; i++) {
+        if (g_order[i] == stage) {
+            stats->position = (uint32_t)i;
+            break;
+        }
+    }
+    return true;
+}
+
+void partial_pipeline_reset_stats(void) {
+    for (int i = 0; i < PARTIAL_STAGE_COUNT; i++) {
+        metrics_counter_reset(&g_counters[i].executions);
+        metrics_counter_reset(&g_counters[i].rejections);
+        metrics_counter_reset(&g_counters[i].time_ns);
+        metrics_histogram_reset(&g_counters[i].latency);
+    }
+}
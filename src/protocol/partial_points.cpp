@@ -0,0 +1,296 @@
+#include "protocol/partial_points.h"
+
+#include <pthread.h>
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include <new>
+#include <unordered_map>
+#include <vector>
+
+#define PARTIAL_POINTS_ID_SIZE 32
+
+typedef struct {
+    uint8_t launcher_id[PARTIAL_POINTS_ID_SIZE];
+} partial_points_key_t;
+
+// launcher_id - хэш, первых 8 байт достаточно для распределения
+struct partial_points_key_hash {
+    size_t operator()(const partial_points_key_t& key) const {
+        uint64_t word;
+        memcpy(&word, key.launcher_id, sizeof(word));
+        return (size_t)word;
+    }
+};
+
+struct partial_points_key_equal {
+    bool operator()(const partial_points_key_t& a, const partial_points_key_t& b) const {
+        return memcmp(a.launcher_id, b.launcher_id, PARTIAL_POINTS_ID_SIZE) == 0;
+    }
+};
+
+// Сумма фермера. Запись удаляется, когда на нее не ссылается ни одна
+// корзина; ссылки из корзин остаются валидными при перехэшировании.
+typedef struct {
+    partial_points_key_t key;
+    uint64_t points;
+    uint64_t last_minute;          // Последняя корзина, куда начислялись очки
+    uint32_t last_index;           // Позиция фермера в этой корзине
+    uint32_t buckets;              // Число ссылок из корзин
+} partial_points_launcher_t;
+
+typedef struct {
+    partial_points_launcher_t* launcher;
+    uint64_t points;
+} partial_points_credit_t;
+
+// Корзина одной минуты: начисления фермеров, объединенные по launcher_id
+typedef struct {
+    uint64_t minute;
+    std::vector<partial_points_credit_t> credits;
+} partial_points_bucket_t;
+
+typedef std::unordered_map<partial_points_key_t, partial_points_launcher_t,
+                           partial_points_key_hash, partial_points_key_equal> partial_points_map_t;
+
+static pthread_mutex_t g_points_mutex = PTHREAD_MUTEX_INITIALIZER;
+static bool g_points_active = false;
+static uint32_t g_points_window_seconds = 0;
+static partial_points_map_t* g_points_launchers = NULL;
+static partial_points_bucket_t* g_points_buckets = NULL;
+static uint32_t g_points_bucket_count = 0;
+
+static uint64_t g_points_total = 0;
+static uint64_t g_points_credited = 0;
+static uint64_t g_points_expired = 0;
+static uint64_t g_points_stale = 0;
+
+static void partial_points_log(const char* level, const char* message) {
+    time_t now = time(NULL);
+    struct tm* tm_info = localtime(&now);
+    char timestamp[20];
+    strftime(timestamp, sizeof(timestamp), "%Y-%m-%d %H:%M:%S", tm_info);
+    
+    printf("[%s] [PARTIAL_POINTS] [%s] %s\n", timestamp, level, message);
+    fflush(stdout);
+}
+
+static uint64_t partial_points_cutoff_minute(uint64_t now) {
+    return now > g_points_window_seconds ? (now - g_points_window_seconds) / 60 : 0;
+}
+
+// Вычитание корзины из сумм фермеров
+static uint64_t partial_points_bucket_expire(partial_points_bucket_t* bucket) {
+    uint64_t expired = 0;
+    for (size_t i = 0; i < bucket->credits.size(); i++) {
+        partial_points_launcher_t* launcher = bucket->credits[i].launcher;
+        launcher->points -= bucket->credits[i].points;
+        expired += bucket->credits[i].points;
+        if (--launcher->buckets == 0) {
+            g_points_launchers->erase(launcher->key);
+        }
+    }
+    bucket->credits.clear();
+    
+    g_points_total -= expired;
+    g_points_expired += expired;
+    return expired;
+}
+
+bool partial_points_init(uint32_t window_seconds) {
+    if (window_seconds == 0) {
+        partial_points_log("ERROR", "Окно PPLNS не может быть нулевым");
+        return false;
+    }
+    
+    if (g_points_active) {
+        partial_points_log("WARNING", "Хранилище очков уже инициализировано");
+        return true;
+    }
+    
+    // Минуты окна [cutoff, now] всегда попадают в разные корзины
+    uint32_t bucket_count = (window_seconds + 59) / 60 + 1;
+    
+    g_points_launchers = new (std::nothrow) partial_points_map_t();
+    g_points_buckets = new (std::nothrow) partial_points_bucket_t[bucket_count];
+    if (!g_points_launchers || !g_points_buckets) {
+        partial_points_log("ERROR", "Не удалось выделить память под хранилище очков");
+        delete g_points_launchers;
+        delete[] g_points_buckets;
+        g_points_launchers = NULL;
+        g_points_buckets = NULL;
+        return false;
+    }
+    
+    for (uint32_t i = 0; i < bucket_count; i++) {
+        g_points_buckets[i].minute = 0;
+    }
+    g_points_bucket_count = bucket_count;
+    g_points_window_seconds = window_seconds;
+    g_points_total = 0;
+    g_points_credited = 0;
+    g_points_expired = 0;
+    g_points_stale = 0;
+    __atomic_store_n(&g_points_active, true, __ATOMIC_RELEASE);
+    
+    char log_msg[128];
+    snprintf(log_msg, sizeof(log_msg), "Хранилище очков инициализировано: окно %u с, %u корзин",
+             window_seconds, bucket_count);
+    partial_points_log("INFO", log_msg);
+    return true;
+}
+
+void partial_points_cleanup(void) {
+    pthread_mutex_lock(&g_points_mutex);
+    if (!g_points_active) {
+        pthread_mutex_unlock(&g_points_mutex);
+        return;
+    }
+    
+    __atomic_store_n(&g_points_active, false, __ATOMIC_RELEASE);
+    delete g_points_launchers;
+    delete[] g_points_buckets;
+    g_points_launchers = NULL;
+    g_points_buckets = NULL;
+    g_points_bucket_count = 0;
+    g_points_total = 0;
+    pthread_mutex_unlock(&g_points_mutex);
+}
+
+bool partial_points_is_enabled(void) {
+    return __atomic_load_n(&g_points_active, __ATOMIC_ACQUIRE);
+}
+
+bool partial_points_credit(const uint8_t* launcher_id, uint64_t points,
+                           uint64_t timestamp, uint64_t now, uint64_t* launcher_points) {
+    if (!launcher_id) {
+        return false;
+    }
+    
+    // Метка времени из будущего занимала бы корзину самой старой минуты окна
+    if (timestamp > now) {
+        timestamp = now;
+    }
+    uint64_t minute = timestamp / 60;
+    
+    pthread_mutex_lock(&g_points_mutex);
+    if (!g_points_active) {
+        pthread_mutex_unlock(&g_points_mutex);
+        return false;
+    }
+    
+    partial_points_key_t key;
+    memcpy(key.launcher_id, launcher_id, PARTIAL_POINTS_ID_SIZE);
+    
+    partial_points_bucket_t* bucket = &g_points_buckets[minute % g_points_bucket_count];
+    bool stale = minute < partial_points_cutoff_minute(now);
+    if (!stale && bucket->minute != minute) {
+        if (bucket->minute > minute) {
+            // Корзину уже заняла более новая минута: начисление вне окна
+            stale = true;
+        } else {
+            // Корзина освобождается от минуты, вышедшей из окна
+            partial_points_bucket_expire(bucket);
+            bucket->minute = minute;
+        }
+    }
+    
+    if (stale) {
+        g_points_stale++;
+        if (launcher_points) {
+            partial_points_map_t::const_iterator it = g_points_launchers->find(key);
+            *launcher_points = it != g_points_launchers->end() ? it->second.points : 0;
+        }
+        pthread_mutex_unlock(&g_points_mutex);
+        return true;
+    }
+    
+    partial_points_launcher_t* launcher = &(*g_points_launchers)[key];
+    if (launcher->buckets == 0) {
+        launcher->key = key;
+    }
+    
+    // Повторные partials фермера за минуту складываются в одну запись корзины
+    uint32_t index = launcher->last_index;
+    if (launcher->buckets > 0 && launcher->last_minute == minute &&
+        index < bucket->credits.size() && bucket->credits[index].launcher == launcher) {
+        bucket->credits[index].points += points;
+    } else {
+        partial_points_credit_t credit;
+        credit.launcher = launcher;
+        credit.points = points;
+        bucket->credits.push_back(credit);
+        launcher->buckets++;
+        launcher->last_minute = minute;
+        launcher->last_index = (uint32_t)(bucket->credits.size() - 1);
+    }
+    
+    launcher->points += points;
+    g_points_total += points;
+    g_points_credited += points;
+    if (launcher_points) {
+        *launcher_points = launcher->points;
+    }
+    pthread_mutex_unlock(&g_points_mutex);
+    return true;
+}
+
+uint64_t partial_points_expire(uint64_t now) {
+    pthread_mutex_lock(&g_points_mutex);
+    if (!g_points_active) {
+        pthread_mutex_unlock(&g_points_mutex);
+        return 0;
+    }
+    
+    uint64_t cutoff = partial_points_cutoff_minute(now);
+    uint64_t expired = 0;
+    for (uint32_t i = 0; i < g_points_bucket_count; i++) {
+        partial_points_bucket_t* bucket = &g_points_buckets[i];
+        if (!bucket->credits.empty() && bucket->minute < cutoff) {
+            expired += partial_points_bucket_expire(bucket);
+        }
+    }
+    pthread_mutex_unlock(&g_points_mutex);
+    return expired;
+}
+
+uint64_t partial_points_get(const uint8_t* launcher_id) {
+    if (!launcher_id) {
+        return 0;
+    }
+    
+    partial_points_key_t key;
+    memcpy(key.launcher_id, launcher_id, PARTIAL_POINTS_ID_SIZE);
+    
+    uint64_t points = 0;
+    pthread_mutex_lock(&g_points_mutex);
+    if (g_points_active) {
+        partial_points_map_t::const_iterator it = g_points_launchers->find(key);
+        if (it != g_points_launchers->end()) {
+            points = it->second.points;
+        }
+    }
+    pthread_mutex_unlock(&g_points_mutex);
+    return points;
+}
+
+void partial_points_get_stats(partial_points_stats_t* stats) {
+    if (!stats) {
+        return;
+    }
+    
+    memset(stats, 0, sizeof(partial_points_stats_t));
+    pthread_mutex_lock(&g_points_mutex);
+    if (g_points_active) {
+        stats->total_points = g_points_total;
+        stats->credited_points = g_points_credited;
+        stats->expired_points = g_points_expired;
+        stats->stale_credits = g_points_stale;
+        stats->launchers = (uint32_t)g_points_launchers->size();
+        stats->window_seconds = g_points_window_seconds;
+    }
+    pthread_mutex_unlock(&g_points_mutex);
+}
@@ -0,0 +1,350 @@
+#include "protocol/partial_workers.h"
+#include "protocol/partial_completions.h"
+
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <time.h>
+
+static void partial_workers_log(const char* level, const char* message) {
+    time_t now = time(NULL);
+    struct tm* tm_info = localtime(&now);
+    char timestamp[20];
+    strftime(timestamp, sizeof(timestamp), "%Y-%m-%d %H:%M:%S", tm_info);
+    
+    printf("[%s] [PARTIAL_WORKERS] [%s] %s\n", timestamp, level, message);
+    fflush(stdout);
+}
+
+// Привязка воркера к ядру: воркеры распределяются по online CPU по кругу
+static void partial_workers_pin(pthread_t thread, uint32_t index) {
+    long cpu_count = sysconf(_SC_NPROCESSORS_ONLN);
+    if (cpu_count <= 0) {
+        return;
+    }
+    
+    cpu_set_t cpuset;
+    CPU_ZERO(&cpuset);
+    CPU_SET(index % (uint32_t)cpu_count, &cpuset);
+    
+    if (pthread_setaffinity_np(thread, sizeof(cpu_set_t), &cpuset) != 0) {
+        partial_workers_log("WARNING", "Не удалось привязать воркер к ядру");
+    }
+}
+
+static uint64_t partial_workers_now_us(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000ULL + (uint64_t)ts.tv_nsec / 1000ULL;
+}
+
+static void* partial_worker_loop(void* arg) {
+    partial_workers_t* workers = (partial_workers_t*)arg;
+    
+    partial_t batch[PARTIAL_WORKERS_BATCH_SIZE];
+    const partial_t* batch_ptrs[PARTIAL_WORKERS_BATCH_SIZE];
+    partial_validation_result_t results[PARTIAL_WORKERS_BATCH_SIZE];
+    partial_completion_t completions[PARTIAL_WORKERS_BATCH_SIZE];
+    
+    for (size_t i = 0; i < PARTIAL_WORKERS_BATCH_SIZE; i++) {
+        batch_ptrs[i] = &batch[i];
+    }
+    
+    for (;;) {
+        // Блокируется до появления partials; 0 означает закрытую пустую очередь
+        size_t count = partial_queue_pop_batch(&workers->queue, batch,
+                                               PARTIAL_WORKERS_BATCH_SIZE);
+        if (count == 0) {
+            break;
+        }
+        
+        // Вся пачка валидируется за один проход: общая точка сигнейджа,
+        // синглтоны по уникальным launcher_id, пакетная проверка подписей
+        uint64_t start_us = partial_workers_now_us();
+        partial_process_batch(batch_ptrs, count, results);
+        
+        // Завершения асинхронных partials уходят одной пачкой
+        size_t completed = 0;
+        for (size_t i = 0; i < count; i++) {
+            if (batch[i].ticket == 0) {
+                continue;
+            }
+            partial_completion_t* completion = &completions[completed++];
+            completion->ticket = batch[i].ticket;
+            memcpy(completion->launcher_id, batch[i].launcher_id, sizeof(completion->launcher_id));
+            completion->points = batch[i].points;
+            completion->result = results[i];
+        }
+        partial_completions_publish(completions, completed);
+        
+        // EDF очереди нужна оценка времени обработки, чтобы заранее
+        // отбрасывать partials, которые не успеют к дедлайну
+        if (workers->queue.edf) {
+            uint64_t elapsed_us = partial_workers_now_us() - start_us;
+            partial_edf_queue_record_service(workers->queue.edf, elapsed_us / count,
+                                             __atomic_load_n(&workers->thread_count,
+                                                             __ATOMIC_RELAXED));
+        }
+        
+        __atomic_fetch_add(&workers->processed, count, __ATOMIC_RELAXED);
+    }
+    
+    return NULL;
+}
+
+bool partial_workers_start(partial_workers_t* workers, uint32_t thread_count,
+                           uint32_t queue_size) {
+    return partial_workers_start_mode(workers, thread_count, queue_size,
+                                      PARTIAL_QUEUE_FIFO, 0);
+}
+
+bool partial_workers_start_mode(partial_workers_t* workers, uint32_t thread_count,
+                                uint32_t queue_size, partial_queue_mode_t mode,
+                                uint32_t deadline_seconds) {
+    if (!workers) {
+        partial_workers_log("ERROR", "Пул воркеров не может быть NULL");
+        return false;
+    }
+    
+    memset(workers, 0, sizeof(partial_workers_t));
+    
+    if (thread_count == 0) {
+        long cpu_count = sysconf(_SC_NPROCESSORS_ONLN);
+        thread_count = cpu_count > 0 ? (uint32_t)cpu_count : 1;
+    }
+    
+    bool queue_ready;
+    switch (mode) {
+        case PARTIAL_QUEUE_EDF:
+            queue_ready = partial_queue_init_edf(&workers->queue, queue_size, deadline_seconds);
+            break;
+        case PARTIAL_QUEUE_FAIR:
+            queue_ready = partial_queue_init_fair(&workers->queue, queue_size, 0);
+            break;
+        default:
+            queue_ready = partial_queue_init(&workers->queue, queue_size);
+            break;
+    }
+    if (!queue_ready) {
+        partial_workers_log("ERROR", "Не удалось инициализировать очередь воркеров");
+        return false;
+    }
+    
+    // Кольцо вмещает все partials, которые могут быть в очереди и в работе
+    if (!partial_completions_init(workers->queue.max_size * 2 +
+                                  thread_count * PARTIAL_WORKERS_BATCH_SIZE)) {
+        partial_queue_cleanup(&workers->queue);
+        return false;
+    }
+    
+    workers->threads = (pthread_t*)calloc(thread_count, sizeof(pthread_t));
+    if (!workers->threads) {
+        partial_workers_log("ERROR", "Не удалось выделить память для воркеров");
+        partial_queue_cleanup(&workers->queue);
+        return false;
+    }
+    
+    __atomic_store_n(&workers->running, true, __ATOMIC_SEQ_CST);
+    
+    for (uint32_t i = 0; i < thread_count; i++) {
+        if (pthread_create(&workers->threads[i], NULL, partial_worker_loop, workers) != 0) {
+            partial_workers_log("ERROR", "Не удалось создать поток воркера");
+            break;
+        }
+        
+        partial_workers_pin(workers->threads[i], i);
+        __atomic_fetch_add(&workers->thread_count, 1, __ATOMIC_RELAXED);
+    }
+    
+    if (workers->thread_count == 0) {
+        partial_workers_stop(workers);
+        return false;
+    }
+    
+    char log_msg[128];
+    snprintf(log_msg, sizeof(log_msg),
+             "Пул воркеров валидации запущен: потоки=%u, очередь=%u, режим=%s",
+             workers->thread_count, workers->queue.max_size,
+             mode == PARTIAL_QUEUE_EDF ? "edf" : mode == PARTIAL_QUEUE_FAIR ? "fair" : "fifo");
+    partial_workers_log("INFO", log_msg);
+    return true;
+}
+
+void partial_workers_stop(partial_workers_t* workers) {
+    if (!workers || !workers->threads) {
+        return;
+    }
+    
+    // Новые partials больше не принимаются. Отправитель, успевший увидеть
+    // running до сброса, держит inflight: очередь закрывается и
+    // освобождается только после его push, commit или abort.
+    __atomic_store_n(&workers->running, false, __ATOMIC_SEQ_CST);
+    while (__atomic_load_n(&workers->inflight, __ATOMIC_SEQ_CST) != 0) {
+        sched_yield();
+    }
+    
+    // Воркеры дорабатывают очередь
+    partial_queue_close(&workers->queue);
+    
+    for (uint32_t i = 0; i < workers->thread_count; i++) {
+        if (pthread_join(workers->threads[i], NULL) != 0) {
+            partial_workers_log("ERROR", "Ошибка при ожидании завершения воркера");
+        }
+    }
+    
+    // Все завершения опубликованы, ожидающие опроса могут забрать остаток
+    partial_completions_close();
+    
+    char log_msg[128];
+    snprintf(log_msg, sizeof(log_msg),
+             "Пул воркеров остановлен: обработано=%lu, отклонено=%lu",
+             workers->processed, workers->rejected);
+    partial_workers_log("INFO", log_msg);
+    
+    free(workers->threads);
+    workers->threads = NULL;
+    workers->thread_count = 0;
+    partial_queue_cleanup(&workers->queue);
+}
+
+bool partial_workers_is_running(const partial_workers_t* workers) {
+    return workers && __atomic_load_n(&workers->running, __ATOMIC_ACQUIRE);
+}
+
+// Вход отправителя: inflight увеличивается до проверки running, а stop
+// сбрасывает running до ожидания inflight, поэтому либо stop дождется
+// отправителя, либо отправитель увидит остановленный пул (seq_cst на
+// обеих сторонах)
+static bool partial_workers_enter(partial_workers_t* workers) {
+    __atomic_fetch_add(&workers->inflight, 1, __ATOMIC_SEQ_CST);
+    if (!__atomic_load_n(&workers->running, __ATOMIC_SEQ_CST)) {
+        __atomic_fetch_sub(&workers->inflight, 1, __ATOMIC_SEQ_CST);
+        return false;
+    }
+    return true;
+}
+
+static void partial_workers_leave(partial_workers_t* workers) {
+    __atomic_fetch_sub(&workers->inflight, 1, __ATOMIC_SEQ_CST);
+}
+
+partial_validation_result_t partial_workers_submit(partial_workers_t* workers,
+                                                   const partial_t* partial) {
+    if (!workers || !partial) {
+        partial_workers_log("ERROR", "Невалидные параметры для постановки partial в очередь");
+        return VALIDATION_INTERNAL_ERROR;
+    }
+    
+    if (!partial_workers_enter(workers)) {
+        return VALIDATION_INTERNAL_ERROR;
+    }
+    
+    // Backpressure: отправитель не блокируется на полной очереди
+    bool pushed = partial_queue_push(&workers->queue, partial);
+    partial_workers_leave(workers);
+    if (!pushed) {
+        __atomic_fetch_add(&workers->rejected, 1, __ATOMIC_RELAXED);
+        return VALIDATION_RATE_LIMITED;
+    }
+    
+    return VALIDATION_SUCCESS;
+}
+
+partial_t* partial_workers_reserve(partial_workers_t* workers,
+                                   partial_queue_reservation_t* reservation) {
+    if (!workers || !reservation) {
+        partial_workers_log("ERROR", "Невалидные параметры для резервирования partial");
+        return NULL;
+    }
+    
+    reservation->partial = NULL;
+    if (!partial_workers_enter(workers)) {
+        return NULL;
+    }
+    
+    // Резервирование держит inflight до commit или abort
+    partial_t* partial = partial_queue_reserve(&workers->queue, reservation);
+    if (!partial) {
+        partial_workers_leave(workers);
+        __atomic_fetch_add(&workers->rejected, 1, __ATOMIC_RELAXED);
+    }
+    return partial;
+}
+
+partial_validation_result_t partial_workers_commit(partial_workers_t* workers,
+                                                   partial_queue_reservation_t* reservation) {
+    if (!workers || !reservation || !reservation->partial) {
+        partial_workers_log("ERROR", "Невалидные параметры для подтверждения partial");
+        return VALIDATION_INTERNAL_ERROR;
+    }
+    
+    bool committed = partial_queue_commit(&workers->queue, reservation);
+    partial_workers_leave(workers);
+    if (!committed) {
+        __atomic_fetch_add(&workers->rejected, 1, __ATOMIC_RELAXED);
+        return VALIDATION_RATE_LIMITED;
+    }
+    
+    return VALIDATION_SUCCESS;
+}
+
+void partial_workers_abort(partial_workers_t* workers, partial_queue_reservation_t* reservation) {
+    if (!workers || !reservation || !reservation->partial) {
+        return;
+    }
+    
+    partial_queue_abort(&workers->queue, reservation);
+    partial_workers_leave(workers);
+}
+
+partial_validation_result_t partial_workers_submit_async(partial_workers_t* workers,
+                                                         const partial_t* partial,
+                                                         uint64_t* ticket) {
+    if (ticket) {
+        *ticket = 0;
+    }
+    
+    if (!workers || !partial || !ticket) {
+        partial_workers_log("ERROR", "Невалидные параметры для асинхронной постановки partial");
+        return VALIDATION_INTERNAL_ERROR;
+    }
+    
+    // Копия пишется прямо в слот очереди, номер - в саму копию
+    partial_queue_reservation_t reservation;
+    partial_t* slot = partial_workers_reserve(workers, &reservation);
+    if (!slot) {
+        return partial_workers_is_running(workers) ? VALIDATION_RATE_LIMITED
+                                                   : VALIDATION_INTERNAL_ERROR;
+    }
+    
+    memcpy(slot, partial, sizeof(partial_t));
+    return partial_workers_commit_async(workers, &reservation, ticket);
+}
+
+partial_validation_result_t partial_workers_commit_async(partial_workers_t* workers,
+                                                         partial_queue_reservation_t* reservation,
+                                                         uint64_t* ticket) {
+    if (ticket) {
+        *ticket = 0;
+    }
+    
+    if (!workers || !reservation || !reservation->partial || !ticket) {
+        partial_workers_log("ERROR", "Невалидные параметры для асинхронного подтверждения partial");
+        // Резервирование без подтверждения остановило бы кольцо
+        partial_workers_abort(workers, reservation);
+        return VALIDATION_INTERNAL_ERROR;
+    }
+    
+    uint64_t issued = partial_completions_next_ticket();
+    reservation->partial->ticket = issued;
+    
+    partial_validation_result_t result = partial_workers_commit(workers, reservation);
+    if (result == VALIDATION_SUCCESS) {
+        *ticket = issued;
+    }
+    return result;
+}
@@ -1,18 +1,31 @@
 #include "protocol/partials.h"
 #include "security/proof_verification.h"
+#include "security/pos_verifier.h"
 #include "security/auth.h"
 #include "blockchain/chia_operations.h"
 #include "protocol/singleton.h"
+#include "protocol/partial_dedup.h"
+#include "protocol/partial_journal.h"
+#include "protocol/partial_points.h"
+#include "protocol/partial_pipeline.h"
 #include <pthread.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+#include <openssl/sha.h>
 
 #include <stdio.h>
 #include <string.h>
 #include <stdlib.h>
 #include <time.h>
 
-static uint64_t g_valid_partials = 0;
-static uint64_t g_invalid_partials = 0;
-static uint64_t g_total_partials = 0;
+#include <vector>
+
+// Счетчики обновляются из потоков воркеров и cgo потоков без блокировок
+static metrics_counter_t g_valid_partials;
+static metrics_counter_t g_invalid_partials;
+static metrics_counter_t g_total_partials;
+static metrics_histogram_t g_result_latency[PARTIAL_RESULT_COUNT];
 
 static void partials_log(const char* level, const char* message) {
     time_t now = time(NULL);
@@ -24,6 +37,73 @@ static void partials_log(const char* level, const char* message) {
     fflush(stdout);
 }
 
+// Количество попыток извлечения перед засыпанием на futex
+#define PARTIAL_QUEUE_SPIN_COUNT 64
+
+// Итераций в подслоте для partials пула (POOL_SUB_SLOT_ITERS)
+#define PARTIAL_POOL_SUB_SLOT_ITERS 37600000000ULL
+
+static long partial_queue_futex(uint32_t* addr, int op, uint32_t val) {
+    return syscall(SYS_futex, addr, op, val, NULL, NULL, 0);
+}
+
+// Будим спящих потребителей только если они есть: в нормальном режиме
+// производитель не делает системных вызовов.
+static void partial_queue_wake(partial_queue_t* queue, uint32_t count) {
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&queue->idle_consumers, __ATOMIC_RELAXED) == 0) {
+        return;
+    }
+    __atomic_fetch_add(&queue->wake_seq, 1, __ATOMIC_SEQ_CST);
+    partial_queue_futex(&queue->wake_seq, FUTEX_WAKE_PRIVATE, count);
+}
+
+// Захватывает до max_count подряд идущих позиций, готовых для записи
+// (is_producer) или чтения. Возвращает число захваченных позиций и
+// первую позицию в *start.
+static size_t partial_queue_claim(partial_queue_t* queue, bool is_producer,
+                                  size_t max_count, uint64_t* start) {
+    uint64_t* counter = is_producer ? &queue->enqueue_pos : &queue->dequeue_pos;
+    uint64_t pos = __atomic_load_n(counter, __ATOMIC_RELAXED);
+    const uint64_t ready_offset = is_producer ? 0 : 1;
+    
+    for (;;) {
+        size_t available = 0;
+        bool retry = false;
+        
+        while (available < max_count) {
+            uint64_t slot_pos = pos + available;
+            partial_queue_slot_t* slot = &queue->slots[slot_pos % queue->max_size];
+            uint64_t seq = __atomic_load_n(&slot->sequence, __ATOMIC_ACQUIRE);
+            int64_t diff = (int64_t)(seq - (slot_pos + ready_offset));
+            
+            if (diff == 0) {
+                available++;
+                continue;
+            }
+            if (diff > 0 && available == 0) {
+                // Позицию уже забрал другой поток - перечитываем счетчик
+                retry = true;
+            }
+            break;
+        }
+        
+        if (retry) {
+            pos = __atomic_load_n(counter, __ATOMIC_RELAXED);
+            continue;
+        }
+        if (available == 0) {
+            return 0;
+        }
+        if (__atomic_compare_exchange_n(counter, &pos, pos + available, true,
+                                        __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+            *start = pos;
+            return available;
+        }
+        // pos обновлен compare_exchange, повторяем
+    }
+}
+
 bool partial_queue_init(partial_queue_t* queue, uint32_t max_size) {
     if (!queue) {
         partials_log("ERROR", "Очередь не может быть NULL");
@@ -31,95 +111,307 @@ bool partial_queue_init(partial_queue_t* queue, uint32_t max_size) {
     }
     
     memset(queue, 0, sizeof(partial_queue_t));
-    queue->max_size = max_size;
+    queue->max_size = max_size ? max_size : PARTIAL_QUEUE_DEFAULT_SIZE;
     
-    if (pthread_mutex_init(&queue->mutex, NULL) != 0) {
-        partials_log("ERROR", "Не удалось инициализировать мьютекс очереди");
+    void* slots = NULL;
+    if (posix_memalign(&slots, PARTIAL_QUEUE_CACHE_LINE,
+                       (size_t)queue->max_size * sizeof(partial_queue_slot_t)) != 0) {
+        partials_log("ERROR", "Не удалось выделить память для слотов очереди");
         return false;
     }
+    queue->slots = (partial_queue_slot_t*)slots;
     
-    if (pthread_cond_init(&queue->cond, NULL) != 0) {
-        partials_log("ERROR", "Не удалось инициализировать условную переменную");
-        pthread_mutex_destroy(&queue->mutex);
-        return false;
+    for (uint32_t i = 0; i < queue->max_size; i++) {
+        queue->slots[i].sequence = i;
+        queue->slots[i].skipped = false;
     }
     
-    partials_log("INFO", "Очередь partial решений инициализирована");
+    char log_msg[128];
+    snprintf(log_msg, sizeof(log_msg),
+             "Очередь partial решений инициализирована: емкость=%u", queue->max_size);
+    partials_log("INFO", log_msg);
     return true;
 }
 
-bool partial_queue_push(partial_queue_t* queue, const partial_t* partial) {
-    if (!queue || !partial) {
-        partials_log("ERROR", "Невалидные параметры для добавления в очередь");
+bool partial_queue_init_edf(partial_queue_t* queue, uint32_t capacity, uint32_t deadline_seconds) {
+    if (!queue) {
+        partials_log("ERROR", "Очередь не может быть NULL");
         return false;
     }
     
-    pthread_mutex_lock(&queue->mutex);
+    memset(queue, 0, sizeof(partial_queue_t));
+    queue->max_size = capacity ? capacity : PARTIAL_QUEUE_DEFAULT_SIZE;
     
-    if (queue->size >= queue->max_size) {
-        pthread_mutex_unlock(&queue->mutex);
-        partials_log("WARNING", "Очередь partial решений переполнена");
+    queue->edf = (partial_edf_queue_t*)malloc(sizeof(partial_edf_queue_t));
+    if (!queue->edf || !partial_edf_queue_init(queue->edf, queue->max_size, deadline_seconds)) {
+        partials_log("ERROR", "Не удалось инициализировать EDF очередь partials");
+        free(queue->edf);
+        queue->edf = NULL;
         return false;
     }
     
-    partial_queue_node_t* new_node = (partial_queue_node_t*)malloc(sizeof(partial_queue_node_t));
-    if (!new_node) {
-        pthread_mutex_unlock(&queue->mutex);
-        partials_log("ERROR", "Не удалось выделить память для узла очереди");
+    return true;
+}
+
+bool partial_queue_init_fair(partial_queue_t* queue, uint32_t capacity, uint32_t flow_capacity) {
+    if (!queue) {
+        partials_log("ERROR", "Очередь не может быть NULL");
         return false;
     }
     
-    memcpy(&new_node->partial, partial, sizeof(partial_t));
-    new_node->next = NULL;
+    memset(queue, 0, sizeof(partial_queue_t));
+    queue->max_size = capacity ? capacity : PARTIAL_QUEUE_DEFAULT_SIZE;
     
-    if (queue->tail) {
-        queue->tail->next = new_node;
-    } else {
-        queue->head = new_node;
+    queue->fair = (partial_fair_queue_t*)malloc(sizeof(partial_fair_queue_t));
+    if (!queue->fair || !partial_fair_queue_init(queue->fair, queue->max_size, flow_capacity)) {
+        partials_log("ERROR", "Не удалось инициализировать справедливую очередь partials");
+        free(queue->fair);
+        queue->fair = NULL;
+        return false;
     }
-    queue->tail = new_node;
-    queue->size++;
     
-    pthread_cond_signal(&queue->cond);
-    pthread_mutex_unlock(&queue->mutex);
+    return true;
+}
+
+partial_queue_mode_t partial_queue_get_mode(const partial_queue_t* queue) {
+    if (queue && queue->edf) {
+        return PARTIAL_QUEUE_EDF;
+    }
+    return queue && queue->fair ? PARTIAL_QUEUE_FAIR : PARTIAL_QUEUE_FIFO;
+}
+
+size_t partial_queue_push_batch(partial_queue_t* queue, const partial_t* partials, size_t count) {
+    if (queue && queue->edf) {
+        return partial_edf_queue_push_batch(queue->edf, partials, count);
+    }
+    
+    if (queue && queue->fair) {
+        return partial_fair_queue_push_batch(queue->fair, partials, count);
+    }
+    
+    if (!queue || !queue->slots || !partials) {
+        partials_log("ERROR", "Невалидные параметры для добавления в очередь");
+        return 0;
+    }
+    
+    size_t pushed = 0;
+    while (pushed < count) {
+        uint64_t start;
+        size_t claimed = partial_queue_claim(queue, true, count - pushed, &start);
+        if (claimed == 0) {
+            break; // Очередь заполнена
+        }
+        
+        for (size_t i = 0; i < claimed; i++) {
+            partial_queue_slot_t* slot = &queue->slots[(start + i) % queue->max_size];
+            memcpy(&slot->partial, &partials[pushed + i], sizeof(partial_t));
+            __atomic_store_n(&slot->sequence, start + i + 1, __ATOMIC_RELEASE);
+        }
+        pushed += claimed;
+    }
+    
+    if (pushed > 0) {
+        partial_queue_wake(queue, (uint32_t)pushed);
+    }
+    return pushed;
+}
+
+bool partial_queue_push(partial_queue_t* queue, const partial_t* partial) {
+    return partial_queue_push_batch(queue, partial, 1) == 1;
+}
+
+partial_t* partial_queue_reserve(partial_queue_t* queue, partial_queue_reservation_t* reservation) {
+    if (!queue || !reservation) {
+        partials_log("ERROR", "Невалидные параметры для резервирования слота очереди");
+        return NULL;
+    }
+    
+    reservation->partial = NULL;
+    if (queue->edf || queue->fair) {
+        reservation->partial = &reservation->staging;
+        return reservation->partial;
+    }
+    
+    if (!queue->slots) {
+        return NULL;
+    }
+    
+    uint64_t start;
+    if (partial_queue_claim(queue, true, 1, &start) == 0) {
+        return NULL; // Очередь заполнена
+    }
+    
+    reservation->position = start;
+    reservation->partial = &queue->slots[start % queue->max_size].partial;
+    return reservation->partial;
+}
+
+bool partial_queue_commit(partial_queue_t* queue, partial_queue_reservation_t* reservation) {
+    if (!queue || !reservation || !reservation->partial) {
+        partials_log("ERROR", "Невалидные параметры для подтверждения слота очереди");
+        return false;
+    }
     
-    partials_log("DEBUG", "Partial решение добавлено в очередь");
+    partial_t* partial = reservation->partial;
+    reservation->partial = NULL;
+    
+    if (partial == &reservation->staging) {
+        return partial_queue_push_batch(queue, partial, 1) == 1;
+    }
+    
+    partial_queue_slot_t* slot = &queue->slots[reservation->position % queue->max_size];
+    __atomic_store_n(&slot->sequence, reservation->position + 1, __ATOMIC_RELEASE);
+    partial_queue_wake(queue, 1);
     return true;
 }
 
+void partial_queue_abort(partial_queue_t* queue, partial_queue_reservation_t* reservation) {
+    if (!queue || !reservation || !reservation->partial) {
+        return;
+    }
+    
+    partial_t* partial = reservation->partial;
+    reservation->partial = NULL;
+    if (partial == &reservation->staging) {
+        return; // staging в очередь не попадал
+    }
+    
+    partial_queue_slot_t* slot = &queue->slots[reservation->position % queue->max_size];
+    slot->skipped = true;
+    __atomic_store_n(&slot->sequence, reservation->position + 1, __ATOMIC_RELEASE);
+    partial_queue_wake(queue, 1);
+}
+
+// Пропуски отмененных резервирований освобождаются без копирования; если
+// захваченными оказались только они, захватываем следующие позиции
+static size_t partial_queue_try_pop_batch(partial_queue_t* queue, partial_t* partials,
+                                          size_t max_count) {
+    size_t popped = 0;
+    for (;;) {
+        uint64_t start;
+        size_t claimed = partial_queue_claim(queue, false, max_count, &start);
+        
+        for (size_t i = 0; i < claimed; i++) {
+            uint64_t pos = start + i;
+            partial_queue_slot_t* slot = &queue->slots[pos % queue->max_size];
+            if (slot->skipped) {
+                slot->skipped = false;
+            } else {
+                memcpy(&partials[popped++], &slot->partial, sizeof(partial_t));
+            }
+            __atomic_store_n(&slot->sequence, pos + queue->max_size, __ATOMIC_RELEASE);
+        }
+        if (claimed == 0 || popped > 0) {
+            return popped;
+        }
+    }
+}
+
+size_t partial_queue_pop_batch(partial_queue_t* queue, partial_t* partials, size_t max_count) {
+    if (queue && queue->edf) {
+        return partial_edf_queue_pop_batch(queue->edf, partials, max_count);
+    }
+    
+    if (queue && queue->fair) {
+        return partial_fair_queue_pop_batch(queue->fair, partials, max_count);
+    }
+    
+    if (!queue || !queue->slots || !partials || max_count == 0) {
+        partials_log("ERROR", "Невалидные параметры для извлечения из очереди");
+        return 0;
+    }
+    
+    for (;;) {
+        for (int spin = 0; spin < PARTIAL_QUEUE_SPIN_COUNT; spin++) {
+            size_t popped = partial_queue_try_pop_batch(queue, partials, max_count);
+            if (popped > 0) {
+                return popped;
+            }
+        }
+        
+        // Регистрируемся как спящий потребитель и перепроверяем очередь,
+        // чтобы не пропустить запись, сделанную до регистрации
+        uint32_t seq = __atomic_load_n(&queue->wake_seq, __ATOMIC_SEQ_CST);
+        __atomic_fetch_add(&queue->idle_consumers, 1, __ATOMIC_SEQ_CST);
+        
+        size_t popped = partial_queue_try_pop_batch(queue, partials, max_count);
+        bool closed = __atomic_load_n(&queue->closed, __ATOMIC_SEQ_CST) != 0;
+        if (popped == 0 && !closed) {
+            partial_queue_futex(&queue->wake_seq, FUTEX_WAIT_PRIVATE, seq);
+        }
+        
+        __atomic_fetch_sub(&queue->idle_consumers, 1, __ATOMIC_SEQ_CST);
+        if (popped > 0 || closed) {
+            return popped;
+        }
+    }
+}
+
 bool partial_queue_pop(partial_queue_t* queue, partial_t* partial) {
-    if (!queue || !partial) {
+    return partial_queue_pop_batch(queue, partial, 1) == 1;
+}
+
+bool partial_queue_try_pop(partial_queue_t* queue, partial_t* partial) {
+    if (queue && queue->edf) {
+        return partial_edf_queue_try_pop_batch(queue->edf, partial, 1) == 1;
+    }
+    
+    if (queue && queue->fair) {
+        return partial_fair_queue_try_pop_batch(queue->fair, partial, 1) == 1;
+    }
+    
+    if (!queue || !queue->slots || !partial) {
         partials_log("ERROR", "Невалидные параметры для извлечения из очереди");
         return false;
     }
     
-    pthread_mutex_lock(&queue->mutex);
+    return partial_queue_try_pop_batch(queue, partial, 1) == 1;
+}
+
+uint32_t partial_queue_size(const partial_queue_t* queue) {
+    if (!queue) {
+        return 0;
+    }
     
-    while (queue->size == 0) {
-        pthread_cond_wait(&queue->cond, &queue->mutex);
+    if (queue->edf) {
+        return partial_edf_queue_size(queue->edf);
     }
     
-    if (!queue->head) {
-        pthread_mutex_unlock(&queue->mutex);
-        partials_log("ERROR", "Очередь пуста, но размер не нулевой");
-        return false;
+    if (queue->fair) {
+        return partial_fair_queue_size(queue->fair);
     }
     
-    partial_queue_node_t* node = queue->head;
-    memcpy(partial, &node->partial, sizeof(partial_t));
+    uint64_t dequeue_pos = __atomic_load_n(&queue->dequeue_pos, __ATOMIC_ACQUIRE);
+    uint64_t enqueue_pos = __atomic_load_n(&queue->enqueue_pos, __ATOMIC_ACQUIRE);
     
-    queue->head = node->next;
-    if (!queue->head) {
-        queue->tail = NULL;
+    // Позиции читаются не атомарно вместе, поэтому значение приблизительное
+    if (enqueue_pos <= dequeue_pos) {
+        return 0;
+    }
+    uint64_t size = enqueue_pos - dequeue_pos;
+    return size > queue->max_size ? queue->max_size : (uint32_t)size;
+}
+
+void partial_queue_close(partial_queue_t* queue) {
+    if (!queue) {
+        return;
     }
     
-    free(node);
-    queue->size--;
+    // После закрытия блокирующие pop возвращают оставшиеся элементы,
+    // а на пустой очереди сразу возвращают 0
+    if (queue->edf) {
+        partial_edf_queue_close(queue->edf);
+    }
     
-    pthread_mutex_unlock(&queue->mutex);
+    if (queue->fair) {
+        partial_fair_queue_close(queue->fair);
+    }
     
-    partials_log("DEBUG", "Partial решение извлечено из очереди");
-    return true;
+    __atomic_store_n(&queue->closed, 1, __ATOMIC_SEQ_CST);
+    __atomic_fetch_add(&queue->wake_seq, 1, __ATOMIC_SEQ_CST);
+    partial_queue_futex(&queue->wake_seq, FUTEX_WAKE_PRIVATE, INT32_MAX);
+    
+    partials_log("INFO", "Очередь partial решений закрыта");
 }
 
 void partial_queue_cleanup(partial_queue_t* queue) {
@@ -127,78 +419,164 @@ void partial_queue_cleanup(partial_queue_t* queue) {
         return;
     }
     
-    pthread_mutex_lock(&queue->mutex);
-    
-    partial_queue_node_t* current = queue->head;
-    while (current) {
-        partial_queue_node_t* next = current->next;
-        free(current);
-        current = next;
+    if (queue->edf) {
+        partial_edf_queue_cleanup(queue->edf);
+        free(queue->edf);
+        queue->edf = NULL;
     }
     
-    queue->head = NULL;
-    queue->tail = NULL;
-    queue->size = 0;
+    if (queue->fair) {
+        partial_fair_queue_cleanup(queue->fair);
+        free(queue->fair);
+        queue->fair = NULL;
+    }
     
-    pthread_mutex_unlock(&queue->mutex);
-    pthread_cond_destroy(&queue->cond);
-    pthread_mutex_destroy(&queue->mutex);
+    free(queue->slots);
+    queue->slots = NULL;
+    queue->enqueue_pos = 0;
+    queue->dequeue_pos = 0;
     
     partials_log("INFO", "Очередь partial решений очищена");
 }
 
-partial_validation_result_t partial_validate(const partial_t* partial) {
-    if (!partial) {
-        partials_log("ERROR", "Partial решение не может быть NULL");
-        return VALIDATION_INTERNAL_ERROR;
+void partial_context_init(partial_validation_context_t* ctx, const partial_t* partial) {
+    if (!ctx) {
+        return;
+    }
+    
+    memset(ctx, 0, sizeof(partial_validation_context_t));
+    ctx->partial = partial;
+    ctx->current_time = time(NULL);
+    ctx->dedup_claim.slot = UINT64_MAX;
+}
+
+void partial_context_set_signage_point(partial_validation_context_t* ctx,
+                                       const signage_point_t* signage_point) {
+    if (!ctx || !signage_point) {
+        return;
+    }
+    
+    ctx->signage_point = *signage_point;
+    ctx->signage_point_resolved = true;
+}
+
+void partial_context_set_singleton(partial_validation_context_t* ctx,
+                                   const singleton_t* singleton, bool found) {
+    if (!ctx) {
+        return;
+    }
+    
+    if (singleton) {
+        ctx->singleton = *singleton;
+    }
+    ctx->singleton_found = found && singleton;
+    ctx->singleton_resolved = true;
+}
+
+const singleton_t* partial_context_get_singleton(partial_validation_context_t* ctx) {
+    if (!ctx || !ctx->partial) {
+        return NULL;
     }
     
-    g_total_partials++;
+    // Синхронизация с блокчейном выполняется один раз на контекст
+    if (!ctx->singleton_resolved) {
+        ctx->singleton_found = singleton_init(ctx->partial->launcher_id, &ctx->singleton);
+        ctx->singleton_resolved = true;
+    }
     
-    // Проверка временной метки
-    uint64_t current_time = time(NULL);
-    if (current_time - partial->timestamp > 28) { // 28 секунд дедлайн
-        partials_log("WARNING", "Partial решение получено слишком поздно");
-        g_invalid_partials++;
-        return VALIDATION_TOO_LATE;
+    return ctx->singleton_found ? &ctx->singleton : NULL;
+}
+
+const signage_point_t* partial_context_get_signage_point(partial_validation_context_t* ctx) {
+    if (!ctx) {
+        return NULL;
     }
     
-    // Проверка синглтона
-    singleton_t farmer_singleton;
-    if (!singleton_init(partial->launcher_id, &farmer_singleton)) {
-        partials_log("ERROR", "Не удалось инициализировать синглтон фермера");
-        g_invalid_partials++;
-        return VALIDATION_INVALID_SINGLETON;
+    if (!ctx->signage_point_resolved) {
+        ctx->signage_point = chia_get_current_signage_point();
+        ctx->signage_point_resolved = true;
     }
     
-    if (!singleton_verify_pool_membership(&farmer_singleton)) {
-        partials_log("WARNING", "Синглтон не является членом пула");
-        g_invalid_partials++;
-        return VALIDATION_INVALID_SINGLETON;
+    return &ctx->signage_point;
+}
+
+const uint8_t* partial_context_get_proof_hash(partial_validation_context_t* ctx) {
+    if (!ctx || !ctx->partial) {
+        return NULL;
     }
     
-    // Проверка подписи
-    if (!partial_verify_signature(partial)) {
-        partials_log("ERROR", "Невалидная подпись partial решения");
-        g_invalid_partials++;
-        return VALIDATION_INVALID_SIGNATURE;
+    if (!ctx->proof_hash_ready) {
+        partial_dedup_hash_proof(ctx->partial->proof, sizeof(ctx->partial->proof),
+                                 ctx->partial->plot_size, ctx->proof_hash);
+        ctx->proof_hash_ready = true;
     }
     
-    // Проверка доказательства пространства
-    if (!partial_verify_proof(partial)) {
-        partials_log("ERROR", "Невалидное доказательство пространства");
-        g_invalid_partials++;
-        return VALIDATION_INVALID_PROOF;
+    return ctx->proof_hash;
+}
+
+// Сообщение, подписываемое фермером:
+// launcher_id || challenge || первые 32 байта proof || timestamp
+const uint8_t* partial_context_get_signature_message(partial_validation_context_t* ctx) {
+    if (!ctx || !ctx->partial) {
+        return NULL;
+    }
+    
+    if (!ctx->signature_message_ready) {
+        const partial_t* partial = ctx->partial;
+        uint8_t* message = ctx->signature_message;
+        memset(message, 0, PARTIAL_SIGNATURE_MESSAGE_SIZE);
+        memcpy(message, partial->launcher_id, 32);
+        memcpy(message + 32, partial->challenge, 32);
+        memcpy(message + 64, partial->proof, 32); // Первые 32 байта proof
+        memcpy(message + 96, &partial->timestamp, sizeof(uint64_t));
+        ctx->signature_message_ready = true;
+    }
+    
+    return ctx->signature_message;
+}
+
+static void partial_release_claim(partial_validation_context_t* ctx) {
+    partial_dedup_release(&ctx->dedup_claim);
+    ctx->dedup_claim.slot = UINT64_MAX;
+}
+
+// Запись невалидного partial в индексе дубликатов освобождается, чтобы
+// исправленная повторная отправка не считалась дубликатом
+static void partial_release_rejected(partial_validation_context_t* ctx,
+                                     partial_validation_result_t result) {
+    if (result != VALIDATION_SUCCESS && result != VALIDATION_DUPLICATE) {
+        partial_release_claim(ctx);
+    }
+}
+
+static void partial_record_result(partial_validation_result_t result, uint64_t latency_ns,
+                                  uint64_t count) {
+    if ((int)result >= 0 && result < PARTIAL_RESULT_COUNT) {
+        metrics_histogram_record(&g_result_latency[result], latency_ns, count);
+    }
+}
+
+partial_validation_result_t partial_validate_ctx(partial_validation_context_t* ctx) {
+    if (!ctx || !ctx->partial) {
+        partials_log("ERROR", "Partial решение не может быть NULL");
+        return VALIDATION_INTERNAL_ERROR;
     }
     
-    // Проверка вызова (challenge)
-    if (!partial_verify_challenge(partial->challenge)) {
-        partials_log("ERROR", "Невалидный вызов partial решения");
-        g_invalid_partials++;
-        return VALIDATION_INVALID_CHALLENGE;
+    const partial_t* partial = ctx->partial;
+    metrics_counter_add(&g_total_partials, 1);
+    uint64_t start_ns = metrics_now_ns();
+    
+    // Этапы выполняются в порядке оценки стоимости: дешевые проверки
+    // отсекают partial до запроса синглтона и криптографии
+    partial_validation_result_t result = partial_pipeline_run(ctx);
+    partial_record_result(result, metrics_now_ns() - start_ns, 1);
+    if (result != VALIDATION_SUCCESS) {
+        partial_release_rejected(ctx, result);
+        metrics_counter_add(&g_invalid_partials, 1);
+        return result;
     }
     
-    g_valid_partials++;
+    metrics_counter_add(&g_valid_partials, 1);
     
     char launcher_id_hex[65];
     for (int i = 0; i < 32; i++) {
@@ -206,68 +584,185 @@ partial_validation_result_t partial_validate(const partial_t* partial) {
     }
     
     char log_msg[256];
-    snprintf(log_msg, sizeof(log_msg), 
-             "Partial решение валидно: фермер=%s, сложность=%lu, очки=%lu", 
+    snprintf(log_msg, sizeof(log_msg),
+             "Partial решение валидно: фермер=%s, сложность=%lu, очки=%lu",
              launcher_id_hex, partial->difficulty, partial->points);
     partials_log("INFO", log_msg);
     
     return VALIDATION_SUCCESS;
 }
 
-bool partial_verify_proof(const partial_t* partial) {
+partial_validation_result_t partial_validate(const partial_t* partial) {
     if (!partial) {
         partials_log("ERROR", "Partial решение не может быть NULL");
-        return false;
+        return VALIDATION_INTERNAL_ERROR;
     }
     
-    proof_verification_params_t params = {
-        .challenge = *(uint64_t*)partial->challenge,
-        .k_size = partial->plot_size,
-        .sub_slot_iters = 37600000000ULL, // 37.6 миллиардов
-        .difficulty = (uint32_t)partial->difficulty,
-        .required_iterations = 0
-    };
+    partial_validation_context_t ctx;
+    partial_context_init(&ctx, partial);
+    return partial_validate_ctx(&ctx);
+}
+
+// Параметры проверки доказательства partial. Возвращает длину доказательства.
+static size_t partial_proof_params(partial_validation_context_t* ctx, uint8_t* plot_id,
+                                   proof_verification_params_t* params) {
+    const partial_t* partial = ctx->partial;
+    
+    // plot_id определяется пазлом пула и ключом плота; совпадение пазла
+    // с p2_singleton_puzzle фермера проверяет этап синглтона
+    uint8_t plot_id_input[sizeof(partial->pool_contract_puzzle_hash) +
+                          sizeof(partial->plot_public_key)];
+    memcpy(plot_id_input, partial->pool_contract_puzzle_hash,
+           sizeof(partial->pool_contract_puzzle_hash));
+    memcpy(plot_id_input + sizeof(partial->pool_contract_puzzle_hash), partial->plot_public_key,
+           sizeof(partial->plot_public_key));
+    SHA256(plot_id_input, sizeof(plot_id_input), plot_id);
     
-    proof_metadata_t metadata;
-    proof_verification_result_t result = proof_verify_space(partial->proof, 
-                                                           sizeof(partial->proof),
-                                                           &params, &metadata);
+    memset(params, 0, sizeof(*params));
+    params->challenge = *(uint64_t*)partial->challenge;
+    params->k_size = partial->plot_size;
+    params->sub_slot_iters = PARTIAL_POOL_SUB_SLOT_ITERS;
+    params->difficulty = (uint32_t)partial->difficulty;
+    params->plot_id = plot_id;
+    params->challenge_hash = partial->challenge;
+    params->sp_hash = partial_context_get_signage_point(ctx)->challenge_chain_sp;
+    
+    memcpy(ctx->proof_metadata.plot_public_key, partial->plot_public_key,
+           sizeof(ctx->proof_metadata.plot_public_key));
+    
+    // Длина доказательства зависит от k: 64 значения x по k бит
+    size_t proof_length = pos_proof_size(partial->plot_size);
+    if (proof_length > sizeof(partial->proof)) {
+        proof_length = sizeof(partial->proof);
+    }
+    return proof_length;
+}
+
+// Доказательство принято: partial приносит очки, равные его сложности
+static void partial_accept_proof(partial_validation_context_t* ctx) {
+    ctx->proof_verified = true;
+    *(uint64_t*)&ctx->partial->points = ctx->partial->difficulty;
+}
+
+// Проверка доказательства без логирования успеха, общая для одиночного
+// и пакетного пути. Разобранное доказательство сохраняется в контексте,
+// при успехе начисленные очки записываются в partial.
+static bool partial_check_proof(partial_validation_context_t* ctx) {
+    uint8_t plot_id[32];
+    proof_verification_params_t params;
+    size_t proof_length = partial_proof_params(ctx, plot_id, &params);
+    
+    proof_verification_result_t result = proof_verify_space(ctx->partial->proof, proof_length,
+                                                           &params, &ctx->proof_metadata);
     
     if (result != PROOF_VALID) {
-        proof_log_verification_result(result, metadata.plot_id);
+        proof_log_verification_result(result, plot_id);
         return false;
     }
     
-    // Сохраняем вычисленные очки
-    *(uint64_t*)&partial->points = metadata.iterations;
+    partial_accept_proof(ctx);
+    return true;
+}
+
+void partial_verify_proof_batch_ctx(partial_validation_context_t* contexts, const size_t* indices,
+                                    size_t count, partial_validation_result_t* results) {
+    if (!contexts || !indices || !results) {
+        partials_log("ERROR", "Невалидные параметры для пакетной проверки доказательств");
+        return;
+    }
+    
+    // Доказательства и требуемые итерации всей пачки проверяются одним
+    // вызовом proof_verify_space_batch
+    std::vector<size_t> positions;
+    std::vector<uint8_t> plot_ids(count * 32);
+    std::vector<proof_verification_params_t> params(count);
+    std::vector<const uint8_t*> proofs;
+    std::vector<size_t> proof_lengths;
+    std::vector<proof_metadata_t> metadata;
+    positions.reserve(count);
+    proofs.reserve(count);
+    proof_lengths.reserve(count);
+    
+    for (size_t j = 0; j < count; j++) {
+        partial_validation_context_t* ctx = &contexts[indices[j]];
+        if (ctx->proof_verified) {
+            results[j] = VALIDATION_SUCCESS;
+            continue;
+        }
+        
+        size_t n = positions.size();
+        proof_lengths.push_back(partial_proof_params(ctx, &plot_ids[n * 32], &params[n]));
+        proofs.push_back(ctx->partial->proof);
+        metadata.push_back(ctx->proof_metadata);
+        positions.push_back(j);
+    }
+    
+    size_t proof_count = positions.size();
+    if (proof_count == 0) {
+        return;
+    }
+    
+    std::vector<proof_verification_result_t> proof_results(proof_count);
+    proof_verify_space_batch(&proofs[0], &proof_lengths[0], &params[0], proof_count,
+                             &metadata[0], &proof_results[0]);
+    
+    for (size_t n = 0; n < proof_count; n++) {
+        partial_validation_context_t* ctx = &contexts[indices[positions[n]]];
+        ctx->proof_metadata = metadata[n];
+        
+        if (proof_results[n] != PROOF_VALID) {
+            proof_log_verification_result(proof_results[n], &plot_ids[n * 32]);
+            results[positions[n]] = VALIDATION_INVALID_PROOF;
+            continue;
+        }
+        
+        partial_accept_proof(ctx);
+        results[positions[n]] = VALIDATION_SUCCESS;
+    }
+}
+
+bool partial_verify_proof_ctx(partial_validation_context_t* ctx) {
+    if (!ctx || !ctx->partial) {
+        partials_log("ERROR", "Partial решение не может быть NULL");
+        return false;
+    }
+    
+    if (!ctx->proof_verified && !partial_check_proof(ctx)) {
+        return false;
+    }
     
     partials_log("DEBUG", "Доказательство пространства верифицировано успешно");
     return true;
 }
 
-bool partial_verify_signature(const partial_t* partial) {
+bool partial_verify_proof(const partial_t* partial) {
     if (!partial) {
         partials_log("ERROR", "Partial решение не может быть NULL");
         return false;
     }
     
-    // Создаем сообщение для проверки подписи
-    uint8_t message[128];
-    memcpy(message, partial->launcher_id, 32);
-    memcpy(message + 32, partial->challenge, 32);
-    memcpy(message + 64, partial->proof, 32); // Первые 32 байта proof
-    memcpy(message + 96, &partial->timestamp, sizeof(uint64_t));
+    partial_validation_context_t ctx;
+    partial_context_init(&ctx, partial);
+    return partial_verify_proof_ctx(&ctx);
+}
+
+bool partial_verify_signature_ctx(partial_validation_context_t* ctx) {
+    if (!ctx || !ctx->partial) {
+        partials_log("ERROR", "Partial решение не может быть NULL");
+        return false;
+    }
     
-    // Получаем публичный ключ фермера из синглтона
-    singleton_t farmer_singleton;
-    if (!singleton_init(partial->launcher_id, &farmer_singleton)) {
+    // Публичный ключ фермера берется из уже разрешенного синглтона
+    const singleton_t* farmer_singleton = partial_context_get_singleton(ctx);
+    if (!farmer_singleton) {
         partials_log("ERROR", "Не удалось получить синглтон для проверки подписи");
         return false;
     }
     
     // Проверяем BLS подпись
-    if (!auth_bls_verify_signature(farmer_singleton.owner_public_key, message, 
-                                  sizeof(message), partial->signature)) {
+    if (!auth_bls_verify_signature(farmer_singleton->owner_public_key,
+                                  partial_context_get_signature_message(ctx),
+                                  PARTIAL_SIGNATURE_MESSAGE_SIZE, ctx->partial->signature)) {
         partials_log("ERROR", "Невалидная BLS подпись partial решения");
         return false;
     }
@@ -276,6 +771,34 @@ bool partial_verify_signature(const partial_t* partial) {
     return true;
 }
 
+bool partial_verify_signature(const partial_t* partial) {
+    if (!partial) {
+        partials_log("ERROR", "Partial решение не может быть NULL");
+        return false;
+    }
+    
+    partial_validation_context_t ctx;
+    partial_context_init(&ctx, partial);
+    return partial_verify_signature_ctx(&ctx);
+}
+
+bool partial_verify_challenge_ctx(partial_validation_context_t* ctx) {
+    if (!ctx || !ctx->partial) {
+        partials_log("ERROR", "Partial решение не может быть NULL");
+        return false;
+    }
+    
+    // Сравниваем challenge с текущей точкой сигнейджа
+    const signage_point_t* current_sp = partial_context_get_signage_point(ctx);
+    if (memcmp(ctx->partial->challenge, current_sp->challenge_hash, 32) != 0) {
+        partials_log("WARNING", "Challenge не соответствует текущей точке сигнейджа");
+        return false;
+    }
+    
+    partials_log("DEBUG", "Challenge верифицирован успешно");
+    return true;
+}
+
 bool partial_verify_challenge(const uint8_t* challenge) {
     if (!challenge) {
         partials_log("ERROR", "Challenge не может быть NULL");
@@ -295,14 +818,143 @@ bool partial_verify_challenge(const uint8_t* challenge) {
     return true;
 }
 
+// Пакетная валидация над подготовленными контекстами
+static size_t partial_validate_contexts(partial_validation_context_t* contexts, size_t count,
+                                        partial_validation_result_t* results) {
+    uint64_t start_ns = metrics_now_ns();
+    
+    // Точка сигнейджа одна на всю пачку
+    signage_point_t current_sp = chia_get_current_signage_point();
+    
+    size_t processed = 0;
+    for (size_t i = 0; i < count; i++) {
+        if (contexts[i].partial) {
+            partial_context_set_signage_point(&contexts[i], &current_sp);
+            processed++;
+        }
+    }
+    metrics_counter_add(&g_total_partials, processed);
+    
+    partial_pipeline_run_batch(contexts, count, results);
+    
+    // Результат каждого partial пачки готов к концу пакетного прогона
+    uint64_t latency_ns = metrics_now_ns() - start_ns;
+    
+    size_t valid = 0;
+    for (size_t i = 0; i < count; i++) {
+        if (!contexts[i].partial) {
+            continue;
+        }
+        
+        partial_record_result(results[i], latency_ns, 1);
+        if (results[i] == VALIDATION_SUCCESS) {
+            valid++;
+        } else {
+            partial_release_rejected(&contexts[i], results[i]);
+        }
+    }
+    metrics_counter_add(&g_valid_partials, valid);
+    metrics_counter_add(&g_invalid_partials, processed - valid);
+    
+    char log_msg[128];
+    snprintf(log_msg, sizeof(log_msg),
+             "Пакетная валидация: partials=%zu, валидных=%zu", count, valid);
+    partials_log("DEBUG", log_msg);
+    
+    return valid;
+}
+
+size_t partial_validate_batch(const partial_t* const* partials, size_t count,
+                              partial_validation_result_t* results) {
+    if (!partials || !results) {
+        partials_log("ERROR", "Невалидные параметры для пакетной валидации partials");
+        return 0;
+    }
+    
+    if (count == 0) {
+        return 0;
+    }
+    
+    std::vector<partial_validation_context_t> contexts(count);
+    for (size_t i = 0; i < count; i++) {
+        partial_context_init(&contexts[i], partials[i]);
+    }
+    
+    return partial_validate_contexts(&contexts[0], count, results);
+}
+
+// Начисление очков фермеру за валидный partial. Используется синглтон,
+// уже полученный при валидации, без повторного запроса к ноде. Partial,
+// не попавший в журнал, не начислен: его запись в индексе дубликатов
+// освобождается, чтобы повторная отправка фермера была принята.
+static bool partial_credit(partial_validation_context_t* ctx) {
+    const partial_t* partial = ctx->partial;
+    if (!partial_context_get_singleton(ctx)) {
+        partials_log("ERROR", "Не удалось обновить статистику фермера");
+        partial_release_claim(ctx);
+        return false;
+    }
+    
+    // Запись в журнал: сброс на диск выполняется group commit'ом
+    // в фоне, поток валидации не ждет fsync
+    if (partial_journal_is_enabled()) {
+        partial_journal_entry_t entry;
+        memset(&entry, 0, sizeof(entry));
+        entry.timestamp = partial->timestamp;
+        entry.difficulty = partial->difficulty;
+        entry.points = partial->points;
+        memcpy(entry.launcher_id, partial->launcher_id, sizeof(entry.launcher_id));
+        memcpy(entry.proof_hash, partial_context_get_proof_hash(ctx), sizeof(entry.proof_hash));
+        
+        if (!partial_journal_append(&entry, NULL)) {
+            partials_log("ERROR", "Не удалось записать partial в журнал");
+            partial_release_claim(ctx);
+            return false;
+        }
+    }
+    
+    // Очки начисляются в хранилище окна PPLNS после записи в журнал,
+    // чтобы восстановление воспроизводило те же суммы. Синглтон
+    // контекста получает актуальную сумму фермера. Записанный в журнал
+    // partial уже принят: если хранилище остановлено (завершение пула),
+    // его очки вернет восстановление журнала, а отказ с повторной
+    // отправкой дал бы вторую запись и двойное начисление.
+    bool points_credited = false;
+    if (partial_points_is_enabled()) {
+        uint64_t launcher_points = 0;
+        points_credited = partial_points_credit(partial->launcher_id, partial->points,
+                                                partial->timestamp, (uint64_t)time(NULL),
+                                                &launcher_points);
+        if (points_credited) {
+            ctx->singleton.total_points = launcher_points;
+        } else {
+            partials_log("WARNING", "Хранилище очков остановлено, очки вернет журнал");
+        }
+    }
+    if (!points_credited) {
+        ctx->singleton.total_points += partial->points;
+    }
+    ctx->singleton.last_partial_time = partial->timestamp;
+    
+    // Адаптируем сложность если необходимо
+    // (реализация в difficulty_manager)
+    
+    partials_log("INFO", "Partial решение успешно обработано");
+    return true;
+}
+
 bool partial_process(const partial_t* partial) {
     if (!partial) {
         partials_log("ERROR", "Partial решение не может быть NULL");
         return false;
     }
     
+    // Контекст живет на протяжении всей обработки partial
+    partial_validation_context_t ctx;
+    partial_context_init(&ctx, partial);
+    
     // Валидация partial решения
-    partial_validation_result_t result = partial_validate(partial);
+    partial_validation_result_t result = partial_validate_ctx(&ctx);
     
     // Логируем результат валидации
     partial_log_validation_result(result, partial->launcher_id);
@@ -311,24 +963,52 @@ bool partial_process(const partial_t* partial) {
         return false;
     }
     
-    // Обновляем статистику фермера
-    singleton_t farmer_singleton;
-    if (!singleton_init(partial->launcher_id, &farmer_singleton)) {
-        partials_log("ERROR", "Не удалось обновить статистику фермера");
-        return false;
+    return partial_credit(&ctx);
+}
+
+size_t partial_process_batch(const partial_t* const* partials, size_t count,
+                             partial_validation_result_t* results) {
+    if (!partials || !results) {
+        partials_log("ERROR", "Невалидные параметры для пакетной обработки partials");
+        return 0;
     }
     
-    farmer_singleton.total_points += partial->points;
-    farmer_singleton.last_partial_time = partial->timestamp;
+    if (count == 0) {
+        return 0;
+    }
     
-    // Адаптируем сложность если необходимо
-    // (реализация в difficulty_manager)
+    std::vector<partial_validation_context_t> contexts(count);
+    for (size_t i = 0; i < count; i++) {
+        partial_context_init(&contexts[i], partials[i]);
+    }
     
-    partials_log("INFO", "Partial решение успешно обработано");
-    return true;
+    partial_validate_contexts(&contexts[0], count, results);
+    
+    size_t credited = 0;
+    for (size_t i = 0; i < count; i++) {
+        if (!partials[i]) {
+            continue;
+        }
+        
+        partial_log_validation_result(results[i], partials[i]->launcher_id);
+        
+        if (results[i] != VALIDATION_SUCCESS) {
+            continue;
+        }
+        
+        // Результат уходит отправителю асинхронного partial: валидный,
+        // но не начисленный partial не должен выглядеть принятым
+        if (partial_credit(&contexts[i])) {
+            credited++;
+        } else {
+            results[i] = VALIDATION_INTERNAL_ERROR;
+        }
+    }
+    
+    return credited;
 }
 
-void partial_log_validation_result(partial_validation_result_t result, const uint8_t* launcher_id) {
+const char* partial_result_to_string(partial_validation_result_t result) {
     const char* result_str = "UNKNOWN";
     
     switch (result) {
@@ -345,6 +1025,12 @@ void partial_log_validation_result(partial_validation_result_t result, const uin
         case VALIDATION_RATE_LIMITED: result_str = "RATE_LIMITED"; break;
     }
     
+    return result_str;
+}
+
+void partial_log_validation_result(partial_validation_result_t result, const uint8_t* launcher_id) {
+    const char* result_str = partial_result_to_string(result);
+    
     char launcher_id_hex[65] = {0};
     if (launcher_id) {
         for (int i = 0; i < 32; i++) {
@@ -365,13 +1051,37 @@ void partial_log_validation_result(partial_validation_result_t result, const uin
 }
 
 void partials_get_stats(uint64_t* valid, uint64_t* invalid, uint64_t* total) {
-    if (valid) *valid = g_valid_partials;
-    if (invalid) *invalid = g_invalid_partials;
-    if (total) *total = g_total_partials;
+    // Total увеличивается до результата, поэтому читается последним:
+    // partials в процессе валидации попадают только в total
+    uint64_t valid_count = metrics_counter_read(&g_valid_partials);
+    uint64_t invalid_count = metrics_counter_read(&g_invalid_partials);
+    uint64_t total_count = metrics_counter_read(&g_total_partials);
+    
+    if (valid) *valid = valid_count;
+    if (invalid) *invalid = invalid_count;
+    if (total) *total = total_count;
     
     char log_msg[128];
     snprintf(log_msg, sizeof(log_msg), 
              "Статистика partials: valid=%lu, invalid=%lu, total=%lu", 
-             g_valid_partials, g_invalid_partials, g_total_partials);
+             valid_count, invalid_count, total_count);
     partials_log("DEBUG", log_msg);
 }
+
+bool partials_get_latency(partial_validation_result_t result, metrics_latency_summary_t* summary) {
+    if ((int)result < 0 || result >= PARTIAL_RESULT_COUNT || !summary) {
+        return false;
+    }
+    
+    metrics_histogram_summarize(&g_result_latency[result], summary);
+    return true;
+}
+
+void partials_reset_stats(void) {
+    metrics_counter_reset(&g_valid_partials);
+    metrics_counter_reset(&g_invalid_partials);
+    metrics_counter_reset(&g_total_partials);
+    for (int i = 0; i < PARTIAL_RESULT_COUNT; i++) {
+        metrics_histogram_reset(&g_result_latency[i]);
+    }
+}
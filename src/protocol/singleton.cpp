@@ -1,11 +1,16 @@
 #include "protocol/singleton.h"
 #include "blockchain/chia_operations.h"
 #include "../../include/security/auth.h"
+#include "security/bls_key_cache.h"
+#include "blockchain/smart_coin.h"
 
 #include <stdio.h>
 #include <string.h>
+#include <stdlib.h>
 #include <time.h>
 
+#include <vector>
+
 static void singleton_log(const char* level, const char* message) {
     time_t now = time(NULL);
     struct tm* tm_info = localtime(&now);
@@ -68,6 +73,25 @@ bool singleton_validate_ownership(const singleton_t* singleton, const uint8_t* s
     return true;
 }
 
+bool singleton_set_owner_public_key(singleton_t* singleton, const uint8_t* owner_public_key) {
+    if (!singleton || !owner_public_key) {
+        singleton_log("ERROR", "Невалидные параметры для смены владельца синглтона");
+        return false;
+    }
+    
+    if (memcmp(singleton->owner_public_key, owner_public_key,
+               sizeof(singleton->owner_public_key)) == 0) {
+        return true;
+    }
+    
+    // Прежний ключ больше не подписывает partials этого синглтона
+    bls_key_cache_invalidate(singleton->owner_public_key);
+    memcpy(singleton->owner_public_key, owner_public_key, sizeof(singleton->owner_public_key));
+    
+    singleton_log("INFO", "Ключ владельца синглтона изменен");
+    return true;
+}
+
 bool singleton_verify_pool_membership(const singleton_t* singleton) {
     if (!singleton) {
         singleton_log("ERROR", "Синглтон не может быть NULL");
@@ -124,30 +148,71 @@ bool singleton_absorb_rewards(singleton_t* singleton) {
         return false;
     }
     
-    if (singleton->balance == 0) {
+    return singleton_absorb_rewards_batch(&singleton, 1);
+}
+
+bool singleton_absorb_rewards_batch(singleton_t* const* singletons, size_t count) {
+    if (count > 0 && !singletons) {
+        singleton_log("ERROR", "Невалидные параметры для пакетного поглощения");
+        return false;
+    }
+    
+    // Транзакции только для синглтонов с балансом
+    std::vector<absorb_transaction_t*> transactions;
+    std::vector<singleton_t*> owners;
+    bool success = true;
+    for (size_t i = 0; i < count; i++) {
+        singleton_t* singleton = singletons[i];
+        if (!singleton) {
+            singleton_log("ERROR", "Синглтон в пакете не может быть NULL");
+            success = false;
+            break;
+        }
+        if (singleton->balance == 0) {
+            continue;
+        }
+        
+        absorb_transaction_t* transaction =
+            smart_coin_create_absorb_transaction(singleton->launcher_id, singleton->balance);
+        if (!transaction) {
+            success = false;
+            break;
+        }
+        transactions.push_back(transaction);
+        owners.push_back(singleton);
+    }
+    
+    if (success && transactions.empty()) {
         singleton_log("DEBUG", "Нет вознаграждений для поглощения");
         return true;
     }
     
-    char launcher_id_hex[65];
-    for (int i = 0; i < 32; i++) {
-        sprintf(launcher_id_hex + i * 2, "%02x", singleton->launcher_id[i]);
+    // Все транзакции пакета подписываются ключом пула за один вызов
+    if (success && !smart_coin_sign_absorb_transactions(&transactions[0], transactions.size())) {
+        singleton_log("ERROR", "Не удалось подписать транзакции поглощения");
+        success = false;
     }
     
-    char log_msg[256];
-    snprintf(log_msg, sizeof(log_msg), 
-             "Поглощение вознаграждений для синглтона %s: %lu mojos", 
-             launcher_id_hex, singleton->balance);
-    singleton_log("INFO", log_msg);
-    
-    // Здесь будет реализация создания транзакции поглощения
-    // с использованием smart_coin.h
+    // Баланс обнуляется только у синглтонов, чья транзакция отправлена
+    size_t absorbed = 0;
+    for (size_t i = 0; success && i < transactions.size(); i++) {
+        if (!smart_coin_submit_transaction(transactions[i])) {
+            success = false;
+            break;
+        }
+        owners[i]->balance = 0;
+        absorbed++;
+    }
     
-    // После успешного поглощения обновляем баланс
-    singleton->balance = 0;
+    for (size_t i = 0; i < transactions.size(); i++) {
+        free(transactions[i]);
+    }
     
-    singleton_log("INFO", "Вознаграждения успешно поглощены");
-    return true;
+    char log_msg[128];
+    snprintf(log_msg, sizeof(log_msg), "Поглощение вознаграждений: %zu из %zu синглтонов",
+             absorbed, transactions.size());
+    singleton_log(success ? "INFO" : "ERROR", log_msg);
+    return success;
 }
 
 bool singleton_sync_with_blockchain(singleton_t* singleton) {
@@ -163,7 +228,8 @@ bool singleton_sync_with_blockchain(singleton_t* singleton) {
     }
     
     // Обновляем состояние на основе полученных данных
-    // В реальной реализации здесь будет парсинг ответа RPC
+    // В реальной реализации здесь будет парсинг ответа RPC; новый ключ
+    // владельца устанавливается через singleton_set_owner_public_key
     
     singleton_log("DEBUG", "Синхронизация синглтона с блокчейном завершена");
     return true;
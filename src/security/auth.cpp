@@ -1,5 +1,6 @@
 #include "security/auth.h"
 #include "protocol/singleton.h"
+#include "security/bls.h"
 
 #include <stdio.h>
 #include <string.h>
@@ -10,8 +11,16 @@
 #include <pthread.h>
 
 static bls_key_t g_pool_private_key;
+static bls_signer_t g_pool_signer;           // Предвычисления для ключа пула
+static bool g_pool_signer_ready = false;
 static std::map<std::string, auth_session_t*> g_sessions;
-static std::map<std::string, uint32_t> g_rate_limits;
+// Счетчик запросов фермера в текущей минуте
+typedef struct {
+    uint64_t minute;
+    uint32_t requests;
+} auth_rate_limit_t;
+
+static std::map<std::string, auth_rate_limit_t> g_rate_limits;
 static pthread_mutex_t g_auth_mutex = PTHREAD_MUTEX_INITIALIZER;
 
 static void auth_log(const char* level, const char* message) {
@@ -50,6 +59,12 @@ bool auth_init(const bls_key_t* pool_private_key) {
     
     memcpy(&g_pool_private_key, pool_private_key, sizeof(bls_key_t));
     
+    // Ключ пула подписывает выплаты и поглощения: гребенку строим один раз
+    g_pool_signer_ready = bls_signer_init(&g_pool_signer, g_pool_private_key.private_key);
+    if (!g_pool_signer_ready) {
+        auth_log("WARNING", "Приватный ключ пула вне диапазона BLS, подписи ключом пула недоступны");
+    }
+    
     // Инициализация генератора случайных чисел
     srand(time(NULL));
     
@@ -69,6 +84,9 @@ bool auth_cleanup(void) {
     g_sessions.clear();
     g_rate_limits.clear();
     
+    memset(&g_pool_signer, 0, sizeof(bls_signer_t));
+    g_pool_signer_ready = false;
+    
     pthread_mutex_unlock(&g_auth_mutex);
     
     auth_log("INFO", "Система аутентификации очищена");
@@ -82,16 +100,30 @@ bool auth_bls_verify_signature(const uint8_t* public_key, const uint8_t* message
         return false;
     }
     
-    // В реальной реализации здесь будет вызов библиотеки BLS
-    // Например, с использованием bls12381 или другой совместимой библиотеки
-    
-    // Упрощенная проверка - всегда возвращаем true для тестирования
-    // В продакшене здесь должна быть настоящая проверка BLS подписи
+    // Схема AugSchemeMPL: подписывается public_key || message
+    if (!bls_verify(public_key, message, message_len, signature)) {
+        auth_log("WARNING", "BLS подпись не прошла проверку");
+        return false;
+    }
     
     auth_log("DEBUG", "BLS подпись проверена успешно");
     return true;
 }
 
+// Ключ пула подписывает готовой гребенкой, прочие ключи - временной в scratch
+static const bls_signer_t* auth_signer_for(const uint8_t* private_key, bls_signer_t* scratch) {
+    if (g_pool_signer_ready &&
+        memcmp(private_key, g_pool_private_key.private_key, sizeof(g_pool_private_key.private_key)) == 0) {
+        return &g_pool_signer;
+    }
+    
+    if (!bls_signer_init(scratch, private_key)) {
+        auth_log("ERROR", "Приватный ключ BLS вне допустимого диапазона");
+        return NULL;
+    }
+    return scratch;
+}
+
 bool auth_bls_sign_message(const uint8_t* private_key, const uint8_t* message, 
                           size_t message_len, uint8_t* signature) {
     if (!private_key || !message || !signature) {
@@ -99,15 +131,43 @@ bool auth_bls_sign_message(const uint8_t* private_key, const uint8_t* message,
         return false;
     }
     
-    // В реальной реализации здесь будет вызов библиотеки BLS для подписи сообщения
+    bls_signer_t scratch;
+    const bls_signer_t* signer = auth_signer_for(private_key, &scratch);
+    bool signed_ok = signer && bls_sign(signer, message, message_len, signature);
+    memset(&scratch, 0, sizeof(bls_signer_t));
     
-    // Упрощенная реализация - заполняем подпись нулями
-    memset(signature, 0, 96);
+    if (!signed_ok) {
+        auth_log("ERROR", "Не удалось создать BLS подпись");
+        return false;
+    }
     
     auth_log("DEBUG", "BLS подпись создана успешно");
     return true;
 }
 
+bool auth_bls_sign_messages(const uint8_t* const* messages, const size_t* message_lens,
+                           size_t count, uint8_t* signatures) {
+    if (count > 0 && (!messages || !message_lens || !signatures)) {
+        auth_log("ERROR", "Невалидные параметры для пакетной подписи");
+        return false;
+    }
+    if (!g_pool_signer_ready) {
+        auth_log("ERROR", "Ключ пула не инициализирован для пакетной подписи");
+        return false;
+    }
+    
+    // Готовая гребенка ключа пула: хеширование пачкой, потоки на больших пакетах
+    if (!bls_sign_batch(&g_pool_signer, messages, message_lens, count, signatures)) {
+        auth_log("ERROR", "Не удалось создать пакет BLS подписей");
+        return false;
+    }
+    
+    char log_msg[128];
+    snprintf(log_msg, sizeof(log_msg), "Создано BLS подписей ключом пула: %zu", count);
+    auth_log("DEBUG", log_msg);
+    return true;
+}
+
 auth_session_t* auth_create_session(const uint8_t* farmer_id) {
     if (!farmer_id) {
         auth_log("ERROR", "Farmer ID не может быть NULL");
@@ -297,13 +357,22 @@ bool auth_check_rate_limit(const uint8_t* farmer_id, uint32_t max_requests_per_m
     auto it = g_rate_limits.find(farmer_key);
     if (it == g_rate_limits.end()) {
         // Создаем новую запись
-        g_rate_limits[farmer_key] = 1;
+        auth_rate_limit_t limit = { current_minute, 1 };
+        g_rate_limits[farmer_key] = limit;
+        pthread_mutex_unlock(&g_auth_mutex);
+        return true;
+    }
+    
+    // Новая минута - счетчик начинается заново
+    if (it->second.minute != current_minute) {
+        it->second.minute = current_minute;
+        it->second.requests = 1;
         pthread_mutex_unlock(&g_auth_mutex);
         return true;
     }
     
     // Проверяем количество запросов
-    if (it->second >= max_requests_per_minute) {
+    if (it->second.requests >= max_requests_per_minute) {
         pthread_mutex_unlock(&g_auth_mutex);
         
         char farmer_id_hex[65];
@@ -320,7 +389,7 @@ bool auth_check_rate_limit(const uint8_t* farmer_id, uint32_t max_requests_per_m
     }
     
     // Увеличиваем счетчик запросов
-    it->second++;
+    it->second.requests++;
     pthread_mutex_unlock(&g_auth_mutex);
     
     return true;
@@ -0,0 +1,3699 @@
+#include "security/bls.h"
+#include "security/bls_key_cache.h"
+
+#include <immintrin.h>
+
+#include <openssl/evp.h>
+#include <openssl/rand.h>
+#include <openssl/sha.h>
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <time.h>
+#include <pthread.h>
+#include <unistd.h>
+
+#include <vector>
+
+// Элемент Fp в форме Монтгомери (R = 2^384), слова little-endian.
+// Все функции поля держат значения полностью приведенными (< p).
+typedef struct {
+    uint64_t l[6];
+} bls_fp_t;
+
+// Башня расширений: Fp2 = Fp[u] / (u^2 + 1), Fp6 = Fp2[v] / (v^3 - xi),
+// xi = 1 + u, Fp12 = Fp6[w] / (w^2 - v)
+typedef struct {
+    bls_fp_t c0, c1;
+} bls_fp2_t;
+
+typedef struct {
+    bls_fp2_t c0, c1, c2;
+} bls_fp6_t;
+
+typedef struct {
+    bls_fp6_t c0, c1;
+} bls_fp12_t;
+
+// Точка в якобиевых координатах (x / z^2, y / z^3), z = 0 - бесконечность.
+// Кривые E1: y^2 = x^3 + 4 над Fp и E2: y^2 = x^3 + 4(1 + u) над Fp2.
+template <typename F>
+struct bls_point_t {
+    F x, y, z;
+};
+
+template <typename F>
+struct bls_affine_t {
+    F x, y;
+};
+
+typedef bls_point_t<bls_fp_t> bls_g1_t;
+typedef bls_point_t<bls_fp2_t> bls_g2_t;
+
+typedef bls_affine_t<bls_fp_t> bls_g1_affine_t;
+typedef bls_affine_t<bls_fp2_t> bls_g2_affine_t;
+
+// |x| параметра кривой, x = -0xd201000000010000
+#define BLS_X 0xd201000000010000ULL
+
+// Байт hash_to_field на элемент Fp (L = 64) и на два элемента Fp2
+#define BLS_HASH_FIELD_BYTES 64
+#define BLS_HASH_G2_BYTES (4 * BLS_HASH_FIELD_BYTES)
+
+// Модуль p
+static const bls_fp_t g_bls_p = { { 0xb9feffffffffaaab, 0x1eabfffeb153ffff, 0x6730d2a0f6b0f624,
+                                    0x64774b84f38512bf, 0x4b1ba7b6434bacd7, 0x1a0111ea397fe69a } };
+
+// R^2 mod p для перевода в форму Монтгомери
+static const bls_fp_t g_bls_r2 = { { 0xf4df1f341c341746, 0x0a76e6a609d104f1, 0x8de5476c4c95b6d5,
+                                     0x67eb88a9939d83c0, 0x9a793e85b519952d, 0x11988fe592cae3aa } };
+
+// R^3 mod p: старшая половина 64-байтового числа в hash_to_field
+static const bls_fp_t g_bls_r3 = { { 0xed48ac6bd94ca1e0, 0x315f831e03a7adf8, 0x9a53352a615e29dd,
+                                     0x34c04e5e921e1761, 0x2512d43565724728, 0x0aa6346091755d4d } };
+
+// Единица в форме Монтгомери
+static const bls_fp_t g_bls_one = { { 0x760900000002fffd, 0xebf4000bc40c0002, 0x5f48985753c758ba,
+                                      0x77ce585370525745, 0x5c071a97a256ec6d, 0x15f65ec3fa80e493 } };
+
+// 1/2 в форме Монтгомери
+static const bls_fp_t g_bls_half = { { 0x1804000000015554, 0x855000053ab00001, 0x633cb57c253c276f,
+                                       0x6e22d1ec31ebb502, 0xd3916126f2d14ca2, 0x17fbb8571a006596 } };
+
+// -p^-1 mod 2^64
+static const uint64_t g_bls_p_inv = 0x89f3fffcfffcfffd;
+
+// Показатели степеней (обычная форма)
+static const bls_fp_t g_bls_p_minus_2 = { { 0xb9feffffffffaaa9, 0x1eabfffeb153ffff, 0x6730d2a0f6b0f624,
+                                            0x64774b84f38512bf, 0x4b1ba7b6434bacd7, 0x1a0111ea397fe69a } };
+
+// (p - 3) / 4
+static const bls_fp_t g_bls_p_minus_3_div_4 = { { 0xee7fbfffffffeaaa, 0x07aaffffac54ffff, 0xd9cc34a83dac3d89,
+                                                  0xd91dd2e13ce144af, 0x92c6e9ed90d2eb35, 0x0680447a8e5ff9a6 } };
+
+// (p - 1) / 2
+static const bls_fp_t g_bls_p_minus_1_div_2 = { { 0xdcff7fffffffd555, 0x0f55ffff58a9ffff, 0xb39869507b587b12,
+                                                  0xb23ba5c279c2895f, 0x258dd3db21a5d66b, 0x0d0088f51cbff34d } };
+
+// (p + 1) / 4
+static const bls_fp_t g_bls_p_plus_1_div_4 = { { 0xee7fbfffffffeaab, 0x07aaffffac54ffff, 0xd9cc34a83dac3d89,
+                                                 0xd91dd2e13ce144af, 0x92c6e9ed90d2eb35, 0x0680447a8e5ff9a6 } };
+
+// Генератор G1
+static const bls_fp_t g_bls_g1_x = { { 0x5cb38790fd530c16, 0x7817fc679976fff5, 0x154f95c7143ba1c1,
+                                       0xf0ae6acdf3d0e747, 0xedce6ecc21dbf440, 0x120177419e0bfb75 } };
+
+static const bls_fp_t g_bls_g1_y = { { 0xbaac93d50ce72271, 0x8c22631a7918fd8e, 0xdd595f13570725ce,
+                                       0x51ac582950405194, 0x0e1c8c3fad0059c0, 0x0bbc3efc5008a26a } };
+
+// b = 4 для E1
+static const bls_fp_t g_bls_g1_b = { { 0xaa270000000cfff3, 0x53cc0032fc34000a, 0x478fe97a6b0a807f,
+                                       0xb1d37ebee6ba24d7, 0x8ec9733bbf78ab2f, 0x09d645513d83de7e } };
+
+// b' = 4(1 + u) для E2
+static const bls_fp2_t g_bls_g2_b = {
+    { { 0xaa270000000cfff3, 0x53cc0032fc34000a, 0x478fe97a6b0a807f,
+        0xb1d37ebee6ba24d7, 0x8ec9733bbf78ab2f, 0x09d645513d83de7e } },
+    { { 0xaa270000000cfff3, 0x53cc0032fc34000a, 0x478fe97a6b0a807f,
+        0xb1d37ebee6ba24d7, 0x8ec9733bbf78ab2f, 0x09d645513d83de7e } }
+};
+
+// xi^((p - 1) / 3)
+static const bls_fp2_t g_bls_frob6_c1 = {
+    { { 0x0000000000000000, 0x0000000000000000, 0x0000000000000000,
+        0x0000000000000000, 0x0000000000000000, 0x0000000000000000 } },
+    { { 0xcd03c9e48671f071, 0x5dab22461fcda5d2, 0x587042afd3851b95,
+        0x8eb60ebe01bacb9e, 0x03f97d6e83d050d2, 0x18f0206554638741 } }
+};
+
+// xi^(2(p - 1) / 3)
+static const bls_fp2_t g_bls_frob6_c2 = {
+    { { 0x890dc9e4867545c3, 0x2af322533285a5d5, 0x50880866309b7e2c,
+        0xa20d1b8c7e881024, 0x14e4f04fe2db9068, 0x14e56d3f1564853a } },
+    { { 0x0000000000000000, 0x0000000000000000, 0x0000000000000000,
+        0x0000000000000000, 0x0000000000000000, 0x0000000000000000 } }
+};
+
+// xi^((p - 1) / 6)
+static const bls_fp2_t g_bls_frob12_c1 = {
+    { { 0x07089552b319d465, 0xc6695f92b50a8313, 0x97e83cccd117228f,
+        0xa35baecab2dc29ee, 0x1ce393ea5daace4d, 0x08f2220fb0fb66eb } },
+    { { 0xb2f66aad4ce5d646, 0x5842a06bfc497cec, 0xcf4895d42599d394,
+        0xc11b9cba40a8e8d0, 0x2e3813cbe5a0de89, 0x110eefda88847faf } }
+};
+
+// SSWU на изогенной кривой E2': A', B', Z
+static const bls_fp2_t g_bls_sswu_a = {
+    { { 0x0000000000000000, 0x0000000000000000, 0x0000000000000000,
+        0x0000000000000000, 0x0000000000000000, 0x0000000000000000 } },
+    { { 0xe53a000003135242, 0x01080c0fdef80285, 0xe7889edbe340f6bd,
+        0x0b51375126310601, 0x02d6985717c744ab, 0x1220b4e979ea5467 } }
+};
+
+static const bls_fp2_t g_bls_sswu_b = {
+    { { 0x22ea00000cf89db2, 0x6ec832df71380aa4, 0x6e1b94403db5a66e,
+        0x75bf3c53a79473ba, 0x3dd3a569412c0a34, 0x125cdb5e74dc4fd1 } },
+    { { 0x22ea00000cf89db2, 0x6ec832df71380aa4, 0x6e1b94403db5a66e,
+        0x75bf3c53a79473ba, 0x3dd3a569412c0a34, 0x125cdb5e74dc4fd1 } }
+};
+
+static const bls_fp2_t g_bls_sswu_z = {
+    { { 0x87ebfffffff9555c, 0x656fffe5da8ffffa, 0x0fd0749345d33ad2,
+        0xd951e663066576f4, 0xde291a3d41e980d3, 0x0815664c7dfe040d } },
+    { { 0x43f5fffffffcaaae, 0x32b7fff2ed47fffd, 0x07e83a49a2e99d69,
+        0xeca8f3318332bb7a, 0xef148d1ea0f4c069, 0x040ab3263eff0206 } }
+};
+
+// -B' / A' и B' / (Z A') для x1 без инверсии констант
+static const bls_fp2_t g_bls_sswu_minus_b_div_a = {
+    { { 0x903c555555474fb3, 0x5f98cc95ce451105, 0x9f8e582eefe0fade,
+        0xc68946b6aebbd062, 0x467a4ad10ee6de53, 0x0e7146f483e23a05 } },
+    { { 0x29c2aaaaaab85af8, 0xbf133368e30eeefa, 0xc7a27a7206cffb45,
+        0x9dee04ce44c9425c, 0x04a15ce53464ce83, 0x0b8fcaf5b59dac95 } }
+};
+
+static const bls_fp2_t g_bls_sswu_b_div_za = {
+    { { 0xf2d8444444414324, 0x2585c28393a69d00, 0x5dd35cd05d972c42,
+        0xfd963b744ea89b53, 0x07f5d9fd91c1fa91, 0x127db28a3ce062c4 } },
+    { { 0x55743333333b3695, 0xeb72b871590828fc, 0x1c186171cb4d5da5,
+        0x34a33031ee956644, 0xc971692a149d16d0, 0x168a1e1ff5de8b82 } }
+};
+
+// Коэффициенты 3-изогении (младшие степени первыми)
+static const bls_fp2_t g_bls_iso_x_num[4] = {
+    {
+        { { 0x47f671c71ce05e62, 0x06dd57071206393e, 0x7c80cd2af3fd71a2,
+            0x048103ea9e6cd062, 0xc54516acc8d037f6, 0x13808f550920ea41 } },
+        { { 0x47f671c71ce05e62, 0x06dd57071206393e, 0x7c80cd2af3fd71a2,
+            0x048103ea9e6cd062, 0xc54516acc8d037f6, 0x13808f550920ea41 } }
+    },
+    {
+        { { 0x0000000000000000, 0x0000000000000000, 0x0000000000000000,
+            0x0000000000000000, 0x0000000000000000, 0x0000000000000000 } },
+        { { 0x5fe55555554c71d0, 0x873fffdd236aaaa3, 0x6a6b4619b26ef918,
+            0x21c2888408874945, 0x2836cda7028cabc5, 0x0ac73310a7fd5abd } }
+    },
+    {
+        { { 0x0a0c5555555971c3, 0xdb0c00101f9eaaae, 0xb1fb2f941d797997,
+            0xd3960742ef416e1c, 0xb70040e2c20556f4, 0x149d7861e581393b } },
+        { { 0xaff2aaaaaaa638e8, 0x439fffee91b55551, 0xb535a30cd9377c8c,
+            0x90e144420443a4a2, 0x941b66d3814655e2, 0x0563998853fead5e } }
+    },
+    {
+        { { 0x40aac71c71c725ed, 0x190955557a84e38e, 0xd817050a8f41abc3,
+            0xd86485d4c87f6fb1, 0x696eb479f885d059, 0x198e1a74328002d2 } },
+        { { 0x0000000000000000, 0x0000000000000000, 0x0000000000000000,
+            0x0000000000000000, 0x0000000000000000, 0x0000000000000000 } }
+    }
+};
+
+static const bls_fp2_t g_bls_iso_x_den[3] = {
+    {
+        { { 0x0000000000000000, 0x0000000000000000, 0x0000000000000000,
+            0x0000000000000000, 0x0000000000000000, 0x0000000000000000 } },
+        { { 0x1f3affffff13ab97, 0xf25bfc611da3ff3e, 0xca3757cb3819b208,
+            0x3e6427366f8cec18, 0x03977bc86095b089, 0x04f69db13f39a952 } }
+    },
+    {
+        { { 0x447600000027552e, 0xdcb8009a43480020, 0x6f7ee9ce4a6e8b59,
+            0xb10330b7c0a95bc6, 0x6140b1fcfb1e54b7, 0x0381be097f0bb4e1 } },
+        { { 0x7588ffffffd8557d, 0x41f3ff646e0bffdf, 0xf7b1e8d2ac426aca,
+            0xb3741acd32dbb6f8, 0xe9daf5b9482d581f, 0x167f53e0ba7431b8 } }
+    },
+    {
+        { { 0x760900000002fffd, 0xebf4000bc40c0002, 0x5f48985753c758ba,
+            0x77ce585370525745, 0x5c071a97a256ec6d, 0x15f65ec3fa80e493 } },
+        { { 0x0000000000000000, 0x0000000000000000, 0x0000000000000000,
+            0x0000000000000000, 0x0000000000000000, 0x0000000000000000 } }
+    }
+};
+
+static const bls_fp2_t g_bls_iso_y_num[4] = {
+    {
+        { { 0x96d8f684bdfc77be, 0xb530e4f43b66d0e2, 0x184a88ff379652fd,
+            0x57cb23ecfae804e1, 0x0fd2e39eada3eba9, 0x08c8055e31c5d5c3 } },
+        { { 0x96d8f684bdfc77be, 0xb530e4f43b66d0e2, 0x184a88ff379652fd,
+            0x57cb23ecfae804e1, 0x0fd2e39eada3eba9, 0x08c8055e31c5d5c3 } }
+    },
+    {
+        { { 0x0000000000000000, 0x0000000000000000, 0x0000000000000000,
+            0x0000000000000000, 0x0000000000000000, 0x0000000000000000 } },
+        { { 0xbf0a71c71c91b406, 0x4d6d55d28b7638fd, 0x9d82f98e5f205aee,
+            0xa27aa27b1d1a18d5, 0x02c3b2b2d2938e86, 0x0c7d13420b09807f } }
+    },
+    {
+        { { 0xd7f9555555531c74, 0x21cffff748daaaa8, 0x5a9ad1866c9bbe46,
+            0x4870a2210221d251, 0x4a0db369c0a32af1, 0x02b1ccc429ff56af } },
+        { { 0xe205aaaaaaac8e37, 0xfcdc000768795556, 0x0c96011a8a1537dd,
+            0x1c06a963f163406e, 0x010df44c82a881e6, 0x174f45260f808feb } }
+    },
+    {
+        { { 0xa470bda12f67f35c, 0xc0fe38e23327b425, 0xc9d3d0f2c6f0678d,
+            0x1c55c9935b5a982e, 0x27f6c0e2f0746764, 0x117c5e6e28aa9054 } },
+        { { 0x0000000000000000, 0x0000000000000000, 0x0000000000000000,
+            0x0000000000000000, 0x0000000000000000, 0x0000000000000000 } }
+    }
+};
+
+static const bls_fp2_t g_bls_iso_y_den[4] = {
+    {
+        { { 0x0162fffffa765adf, 0x8f7bea480083fb75, 0x561b3c2259e93611,
+            0x11e19fc1a9c875d5, 0xca713efc00367660, 0x03c6a03d41da1151 } },
+        { { 0x0162fffffa765adf, 0x8f7bea480083fb75, 0x561b3c2259e93611,
+            0x11e19fc1a9c875d5, 0xca713efc00367660, 0x03c6a03d41da1151 } }
+    },
+    {
+        { { 0x0000000000000000, 0x0000000000000000, 0x0000000000000000,
+            0x0000000000000000, 0x0000000000000000, 0x0000000000000000 } },
+        { { 0x5db0fffffd3b02c5, 0xd713f52358ebfdba, 0x5ea60761a84d161a,
+            0xbb2c75a34ea6c44a, 0x0ac6735921c1119b, 0x0ee3d913bdacfbf6 } }
+    },
+    {
+        { { 0x66b10000003affc5, 0xcb1400e764ec0030, 0xa73e5eb56fa5d106,
+            0x8984c913a0fe09a9, 0x11e10afb78ad7f13, 0x05429d0e3e918f52 } },
+        { { 0x534dffffffc4aae6, 0x5397ff174c67ffcf, 0xbff273eb870b251d,
+            0xdaf2827152870915, 0x393a9cbaca9e2dc3, 0x14be74dbfaee5748 } }
+    },
+    {
+        { { 0x760900000002fffd, 0xebf4000bc40c0002, 0x5f48985753c758ba,
+            0x77ce585370525745, 0x5c071a97a256ec6d, 0x15f65ec3fa80e493 } },
+        { { 0x0000000000000000, 0x0000000000000000, 0x0000000000000000,
+            0x0000000000000000, 0x0000000000000000, 0x0000000000000000 } }
+    }
+};
+
+// Эндоморфизм psi = изоморфизм^-1 * Фробениус * изоморфизм на E2:
+// psi(x, y) = (c1 * conj(x), c2 * conj(y)), c1 = 1 / xi^((p - 1) / 3),
+// c2 = 1 / xi^((p - 1) / 2)
+static const bls_fp2_t g_bls_psi_c1 = {
+    { { 0x0000000000000000, 0x0000000000000000, 0x0000000000000000,
+        0x0000000000000000, 0x0000000000000000, 0x0000000000000000 } },
+    { { 0x890dc9e4867545c3, 0x2af322533285a5d5, 0x50880866309b7e2c,
+        0xa20d1b8c7e881024, 0x14e4f04fe2db9068, 0x14e56d3f1564853a } }
+};
+
+static const bls_fp2_t g_bls_psi_c2 = {
+    { { 0x3e2f585da55c9ad1, 0x4294213d86c18183, 0x382844c88b623732,
+        0x92ad2afd19103e18, 0x1d794e4fac7cf0b9, 0x0bd592fc7d825ec8 } },
+    { { 0x7bcfa7a25aa30fda, 0xdc17dec12a927e7c, 0x2f088dd86b4ebef1,
+        0xd1ca2087da74d4a7, 0x2da2596696cebc1d, 0x0e2b7eedbbfd87d2 } }
+};
+
+// psi^2(x, y) = (c * x, -y), c = c1 * conj(c1) в Fp
+static const bls_fp_t g_bls_psi2_c1 = { { 0xcd03c9e48671f071, 0x5dab22461fcda5d2, 0x587042afd3851b95,
+                                          0x8eb60ebe01bacb9e, 0x03f97d6e83d050d2, 0x18f0206554638741 } };
+
+// Кубический корень из единицы beta = psi2_c1^2: эндоморфизм
+// phi(x, y) = (beta x, y) действует на G1 как [-x^2]
+static const bls_fp_t g_bls_g1_beta = { { 0x30f1361b798a64e8, 0xf3b8ddab7ece5a2a, 0x16a8ca3ac61577f7,
+                                          0xc26a2ff874fd029b, 0x3636b76660701c6e, 0x051ba4ab241b6160 } };
+
+// Порядок подгрупп r
+static const uint64_t g_bls_r[4] = {
+    0xffffffff00000001, 0x53bda402fffe5bfe, 0x3339d80809a1d805, 0x73eda753299d7d48
+};
+
+// (2^64 - 1)(1 + |x| + |x|^2 + |x|^3) mod r - сдвиг знаковой гребенки подписи
+static const uint64_t g_bls_sign_offset[4] = {
+    0x2dfdfffffffefffe, 0xe5fbb7fa89fdffff, 0xd7bcff2cf65fc72b, 0x1964257b4c658788
+};
+
+static void bls_log(const char* level, const char* message) {
+    time_t now = time(NULL);
+    struct tm* tm_info = localtime(&now);
+    char timestamp[20];
+    strftime(timestamp, sizeof(timestamp), "%Y-%m-%d %H:%M:%S", tm_info);
+    
+    printf("[%s] [BLS] [%s] %s\n", timestamp, level, message);
+    fflush(stdout);
+}
+
+// Fp
+
+static inline bool fp_is_zero(const bls_fp_t* a) {
+    return (a->l[0] | a->l[1] | a->l[2] | a->l[3] | a->l[4] | a->l[5]) == 0;
+}
+
+static inline bool fp_eq(const bls_fp_t* a, const bls_fp_t* b) {
+    return memcmp(a, b, sizeof(*a)) == 0;
+}
+
+// r = a mod p для a < 2p
+static inline void fp_reduce(bls_fp_t* r, const uint64_t* a) {
+    uint64_t t[6];
+    uint64_t borrow = 0;
+    for (int i = 0; i < 6; i++) {
+        unsigned __int128 d = (unsigned __int128)a[i] - g_bls_p.l[i] - borrow;
+        t[i] = (uint64_t)d;
+        borrow = (uint64_t)(d >> 64) & 1;
+    }
+    
+    // Заем - значит a < p и остается как есть
+    uint64_t keep = 0 - borrow;
+    for (int i = 0; i < 6; i++) {
+        r->l[i] = (a[i] & keep) | (t[i] & ~keep);
+    }
+}
+
+static inline void fp_add(bls_fp_t* r, const bls_fp_t* a, const bls_fp_t* b) {
+    // p < 2^381, поэтому сумма помещается в 384 бита
+    uint64_t t[6];
+    uint64_t carry = 0;
+    for (int i = 0; i < 6; i++) {
+        unsigned __int128 s = (unsigned __int128)a->l[i] + b->l[i] + carry;
+        t[i] = (uint64_t)s;
+        carry = (uint64_t)(s >> 64);
+    }
+    fp_reduce(r, t);
+}
+
+static inline void fp_sub(bls_fp_t* r, const bls_fp_t* a, const bls_fp_t* b) {
+    uint64_t t[6];
+    uint64_t borrow = 0;
+    for (int i = 0; i < 6; i++) {
+        unsigned __int128 d = (unsigned __int128)a->l[i] - b->l[i] - borrow;
+        t[i] = (uint64_t)d;
+        borrow = (uint64_t)(d >> 64) & 1;
+    }
+    
+    uint64_t mask = 0 - borrow;
+    uint64_t carry = 0;
+    for (int i = 0; i < 6; i++) {
+        unsigned __int128 s = (unsigned __int128)t[i] + (g_bls_p.l[i] & mask) + carry;
+        r->l[i] = (uint64_t)s;
+        carry = (uint64_t)(s >> 64);
+    }
+}
+
+static inline void fp_dbl(bls_fp_t* r, const bls_fp_t* a) {
+    fp_add(r, a, a);
+}
+
+static inline void fp_neg(bls_fp_t* r, const bls_fp_t* a) {
+    bls_fp_t zero;
+    memset(&zero, 0, sizeof(zero));
+    fp_sub(r, &zero, a);
+}
+
+// Умножение Монтгомери (CIOS): r = a * b / R mod p. Результат приведен,
+// если a * b < p * R, поэтому один из множителей может быть любым
+// 384-битным числом.
+static void fp_mul_portable(bls_fp_t* r, const bls_fp_t* a, const bls_fp_t* b) {
+    uint64_t t[8] = {0};
+    for (int i = 0; i < 6; i++) {
+        uint64_t carry = 0;
+        for (int j = 0; j < 6; j++) {
+            unsigned __int128 uv = (unsigned __int128)a->l[j] * b->l[i] + t[j] + carry;
+            t[j] = (uint64_t)uv;
+            carry = (uint64_t)(uv >> 64);
+        }
+        unsigned __int128 top = (unsigned __int128)t[6] + carry;
+        t[6] = (uint64_t)top;
+        t[7] = (uint64_t)(top >> 64);
+        
+        uint64_t m = t[0] * g_bls_p_inv;
+        unsigned __int128 uv = (unsigned __int128)m * g_bls_p.l[0] + t[0];
+        carry = (uint64_t)(uv >> 64);
+        for (int j = 1; j < 6; j++) {
+            uv = (unsigned __int128)m * g_bls_p.l[j] + t[j] + carry;
+            t[j - 1] = (uint64_t)uv;
+            carry = (uint64_t)(uv >> 64);
+        }
+        top = (unsigned __int128)t[6] + carry;
+        t[5] = (uint64_t)top;
+        t[6] = t[7] + (uint64_t)(top >> 64);
+    }
+    fp_reduce(r, t);
+}
+
+// Произведение 384 x 384 -> 768 бит без приведения
+static void fp_mul_384_portable(uint64_t* r, const uint64_t* a, const uint64_t* b) {
+    memset(r, 0, 12 * sizeof(uint64_t));
+    for (int i = 0; i < 6; i++) {
+        uint64_t carry = 0;
+        for (int j = 0; j < 6; j++) {
+            unsigned __int128 uv = (unsigned __int128)a[j] * b[i] + r[i + j] + carry;
+            r[i + j] = (uint64_t)uv;
+            carry = (uint64_t)(uv >> 64);
+        }
+        r[i + 6] = carry;
+    }
+}
+
+// Редукция Монтгомери: r = t / R mod p для t < p * R
+static void fp_redc_portable(bls_fp_t* r, const uint64_t* t) {
+    uint64_t w[12];
+    memcpy(w, t, sizeof(w));
+    uint64_t top = 0;
+    for (int i = 0; i < 6; i++) {
+        uint64_t m = w[i] * g_bls_p_inv;
+        uint64_t carry = 0;
+        for (int j = 0; j < 6; j++) {
+            unsigned __int128 uv = (unsigned __int128)m * g_bls_p.l[j] + w[i + j] + carry;
+            w[i + j] = (uint64_t)uv;
+            carry = (uint64_t)(uv >> 64);
+        }
+        for (int k = i + 6; k < 12 && carry; k++) {
+            w[k] += carry;
+            carry = w[k] < carry;
+        }
+        top += carry;
+    }
+    
+    // Результат w[6..11] + top * 2^384 < 2p
+    uint64_t d[6];
+    uint64_t borrow = 0;
+    for (int i = 0; i < 6; i++) {
+        unsigned __int128 diff = (unsigned __int128)w[6 + i] - g_bls_p.l[i] - borrow;
+        d[i] = (uint64_t)diff;
+        borrow = (uint64_t)(diff >> 64) & 1;
+    }
+    uint64_t keep = 0 - (uint64_t)(borrow > top);
+    for (int i = 0; i < 6; i++) {
+        r->l[i] = (w[6 + i] & keep) | (d[i] & ~keep);
+    }
+}
+
+// Ядра MULX/ADCX/ADOX: две независимые цепочки переносов (CF и OF) идут
+// через одно окно регистров, поэтому сложения младших и старших половин
+// произведений не ждут друг друга. Вызываются только если процессор
+// поддерживает BMI2 и ADX (g_bls_fp_impl == BLS_FP_MULX).
+
+// r[0..11] = a * b
+static void fp_mul_384_mulx(uint64_t* r, const uint64_t* a, const uint64_t* b) {
+    __asm__ __volatile__(
+        "movq (%[b]), %%rdx\n\t"
+        "mulxq (%[a]), %%rax, %%rbx\n\t"
+        "mulxq 8(%[a]), %%r12, %%rcx\n\t"
+        "addq %%r12, %%rbx\n\t"
+        "mulxq 16(%[a]), %%r12, %%r8\n\t"
+        "adcq %%r12, %%rcx\n\t"
+        "mulxq 24(%[a]), %%r12, %%r9\n\t"
+        "adcq %%r12, %%r8\n\t"
+        "mulxq 32(%[a]), %%r12, %%r10\n\t"
+        "adcq %%r12, %%r9\n\t"
+        "mulxq 40(%[a]), %%r12, %%r11\n\t"
+        "adcq %%r12, %%r10\n\t"
+        "adcq $0, %%r11\n\t"
+        "movq %%rax, (%[r])\n\t"
+        "movq 8(%[b]), %%rdx\n\t"
+        "xorl %%eax, %%eax\n\t"
+        "mulxq (%[a]), %%r12, %%r13\n\t"
+        "adcxq %%r12, %%rbx\n\t"
+        "adoxq %%r13, %%rcx\n\t"
+        "mulxq 8(%[a]), %%r12, %%r13\n\t"
+        "adcxq %%r12, %%rcx\n\t"
+        "adoxq %%r13, %%r8\n\t"
+        "mulxq 16(%[a]), %%r12, %%r13\n\t"
+        "adcxq %%r12, %%r8\n\t"
+        "adoxq %%r13, %%r9\n\t"
+        "mulxq 24(%[a]), %%r12, %%r13\n\t"
+        "adcxq %%r12, %%r9\n\t"
+        "adoxq %%r13, %%r10\n\t"
+        "mulxq 32(%[a]), %%r12, %%r13\n\t"
+        "adcxq %%r12, %%r10\n\t"
+        "adoxq %%r13, %%r11\n\t"
+        "mulxq 40(%[a]), %%r12, %%r13\n\t"
+        "adcxq %%r12, %%r11\n\t"
+        "adoxq %%r13, %%rax\n\t"
+        "movl $0, %%r12d\n\t"
+        "adcxq %%r12, %%rax\n\t"
+        "movq %%rbx, 8(%[r])\n\t"
+        "movq 16(%[b]), %%rdx\n\t"
+        "xorl %%ebx, %%ebx\n\t"
+        "mulxq (%[a]), %%r12, %%r13\n\t"
+        "adcxq %%r12, %%rcx\n\t"
+        "adoxq %%r13, %%r8\n\t"
+        "mulxq 8(%[a]), %%r12, %%r13\n\t"
+        "adcxq %%r12, %%r8\n\t"
+        "adoxq %%r13, %%r9\n\t"
+        "mulxq 16(%[a]), %%r12, %%r13\n\t"
+        "adcxq %%r12, %%r9\n\t"
+        "adoxq %%r13, %%r10\n\t"
+        "mulxq 24(%[a]), %%r12, %%r13\n\t"
+        "adcxq %%r12, %%r10\n\t"
+        "adoxq %%r13, %%r11\n\t"
+        "mulxq 32(%[a]), %%r12, %%r13\n\t"
+        "adcxq %%r12, %%r11\n\t"
+        "adoxq %%r13, %%rax\n\t"
+        "mulxq 40(%[a]), %%r12, %%r13\n\t"
+        "adcxq %%r12, %%rax\n\t"
+        "adoxq %%r13, %%rbx\n\t"
+        "movl $0, %%r12d\n\t"
+        "adcxq %%r12, %%rbx\n\t"
+        "movq %%rcx, 16(%[r])\n\t"
+        "movq 24(%[b]), %%rdx\n\t"
+        "xorl %%ecx, %%ecx\n\t"
+        "mulxq (%[a]), %%r12, %%r13\n\t"
+        "adcxq %%r12, %%r8\n\t"
+        "adoxq %%r13, %%r9\n\t"
+        "mulxq 8(%[a]), %%r12, %%r13\n\t"
+        "adcxq %%r12, %%r9\n\t"
+        "adoxq %%r13, %%r10\n\t"
+        "mulxq 16(%[a]), %%r12, %%r13\n\t"
+        "adcxq %%r12, %%r10\n\t"
+        "adoxq %%r13, %%r11\n\t"
+        "mulxq 24(%[a]), %%r12, %%r13\n\t"
+        "adcxq %%r12, %%r11\n\t"
+        "adoxq %%r13, %%rax\n\t"
+        "mulxq 32(%[a]), %%r12, %%r13\n\t"
+        "adcxq %%r12, %%rax\n\t"
+        "adoxq %%r13, %%rbx\n\t"
+        "mulxq 40(%[a]), %%r12, %%r13\n\t"
+        "adcxq %%r12, %%rbx\n\t"
+        "adoxq %%r13, %%rcx\n\t"
+        "movl $0, %%r12d\n\t"
+        "adcxq %%r12, %%rcx\n\t"
+        "movq %%r8, 24(%[r])\n\t"
+        "movq 32(%[b]), %%rdx\n\t"
+        "xorl %%r8d, %%r8d\n\t"
+        "mulxq (%[a]), %%r12, %%r13\n\t"
+        "adcxq %%r12, %%r9\n\t"
+        "adoxq %%r13, %%r10\n\t"
+        "mulxq 8(%[a]), %%r12, %%r13\n\t"
+        "adcxq %%r12, %%r10\n\t"
+        "adoxq %%r13, %%r11\n\t"
+        "mulxq 16(%[a]), %%r12, %%r13\n\t"
+        "adcxq %%r12, %%r11\n\t"
+        "adoxq %%r13, %%rax\n\t"
+        "mulxq 24(%[a]), %%r12, %%r13\n\t"
+        "adcxq %%r12, %%rax\n\t"
+        "adoxq %%r13, %%rbx\n\t"
+        "mulxq 32(%[a]), %%r12, %%r13\n\t"
+        "adcxq %%r12, %%rbx\n\t"
+        "adoxq %%r13, %%rcx\n\t"
+        "mulxq 40(%[a]), %%r12, %%r13\n\t"
+        "adcxq %%r12, %%rcx\n\t"
+        "adoxq %%r13, %%r8\n\t"
+        "movl $0, %%r12d\n\t"
+        "adcxq %%r12, %%r8\n\t"
+        "movq %%r9, 32(%[r])\n\t"
+        "movq 40(%[b]), %%rdx\n\t"
+        "xorl %%r9d, %%r9d\n\t"
+        "mulxq (%[a]), %%r12, %%r13\n\t"
+        "adcxq %%r12, %%r10\n\t"
+        "adoxq %%r13, %%r11\n\t"
+        "mulxq 8(%[a]), %%r12, %%r13\n\t"
+        "adcxq %%r12, %%r11\n\t"
+        "adoxq %%r13, %%rax\n\t"
+        "mulxq 16(%[a]), %%r12, %%r13\n\t"
+        "adcxq %%r12, %%rax\n\t"
+        "adoxq %%r13, %%rbx\n\t"
+        "mulxq 24(%[a]), %%r12, %%r13\n\t"
+        "adcxq %%r12, %%rbx\n\t"
+        "adoxq %%r13, %%rcx\n\t"
+        "mulxq 32(%[a]), %%r12, %%r13\n\t"
+        "adcxq %%r12, %%rcx\n\t"
+        "adoxq %%r13, %%r8\n\t"
+        "mulxq 40(%[a]), %%r12, %%r13\n\t"
+        "adcxq %%r12, %%r8\n\t"
+        "adoxq %%r13, %%r9\n\t"
+        "movl $0, %%r12d\n\t"
+        "adcxq %%r12, %%r9\n\t"
+        "movq %%r10, 40(%[r])\n\t"
+        "movq %%r11, 48(%[r])\n\t"
+        "movq %%rax, 56(%[r])\n\t"
+        "movq %%rbx, 64(%[r])\n\t"
+        "movq %%rcx, 72(%[r])\n\t"
+        "movq %%r8, 80(%[r])\n\t"
+        "movq %%r9, 88(%[r])\n\t"
+        :
+        : [r] "r"(r), [a] "r"(a), [b] "r"(b)
+        : "rax", "rbx", "rcx", "rdx", "r8", "r9", "r10", "r11", "r12", "r13", "cc", "memory");
+}
+
+// r[0..11] = a^2: 15 попарных произведений удваиваются, затем
+// добавляются 6 квадратов
+static void fp_sqr_384_mulx(uint64_t* r, const uint64_t* a) {
+    __asm__ __volatile__(
+        "movq 0(%[a]), %%rdx\n\t"
+        "xorl %%eax, %%eax\n\t"
+        "xorl %%ebx, %%ebx\n\t"
+        "xorl %%ecx, %%ecx\n\t"
+        "xorl %%r8d, %%r8d\n\t"
+        "xorl %%r9d, %%r9d\n\t"
+        "xorl %%r10d, %%r10d\n\t"
+        "mulxq 8(%[a]), %%r12, %%r13\n\t"
+        "adcxq %%r12, %%rax\n\t"
+        "adoxq %%r13, %%rbx\n\t"
+        "mulxq 16(%[a]), %%r12, %%r13\n\t"
+        "adcxq %%r12, %%rbx\n\t"
+        "adoxq %%r13, %%rcx\n\t"
+        "mulxq 24(%[a]), %%r12, %%r13\n\t"
+        "adcxq %%r12, %%rcx\n\t"
+        "adoxq %%r13, %%r8\n\t"
+        "mulxq 32(%[a]), %%r12, %%r13\n\t"
+        "adcxq %%r12, %%r8\n\t"
+        "adoxq %%r13, %%r9\n\t"
+        "mulxq 40(%[a]), %%r12, %%r13\n\t"
+        "adcxq %%r12, %%r9\n\t"
+        "adoxq %%r13, %%r10\n\t"
+        "movl $0, %%r12d\n\t"
+        "adcxq %%r12, %%r10\n\t"
+        "movq %%rax, 8(%[r])\n\t"
+        "movq %%rbx, 16(%[r])\n\t"
+        "movq 8(%[a]), %%rdx\n\t"
+        "xorl %%r11d, %%r11d\n\t"
+        "mulxq 16(%[a]), %%r12, %%r13\n\t"
+        "adcxq %%r12, %%rcx\n\t"
+        "adoxq %%r13, %%r8\n\t"
+        "mulxq 24(%[a]), %%r12, %%r13\n\t"
+        "adcxq %%r12, %%r8\n\t"
+        "adoxq %%r13, %%r9\n\t"
+        "mulxq 32(%[a]), %%r12, %%r13\n\t"
+        "adcxq %%r12, %%r9\n\t"
+        "adoxq %%r13, %%r10\n\t"
+        "mulxq 40(%[a]), %%r12, %%r13\n\t"
+        "adcxq %%r12, %%r10\n\t"
+        "adoxq %%r13, %%r11\n\t"
+        "movl $0, %%r12d\n\t"
+        "adcxq %%r12, %%r11\n\t"
+        "movq %%rcx, 24(%[r])\n\t"
+        "movq %%r8, 32(%[r])\n\t"
+        "movq 16(%[a]), %%rdx\n\t"
+        "xorl %%eax, %%eax\n\t"
+        "mulxq 24(%[a]), %%r12, %%r13\n\t"
+        "adcxq %%r12, %%r9\n\t"
+        "adoxq %%r13, %%r10\n\t"
+        "mulxq 32(%[a]), %%r12, %%r13\n\t"
+        "adcxq %%r12, %%r10\n\t"
+        "adoxq %%r13, %%r11\n\t"
+        "mulxq 40(%[a]), %%r12, %%r13\n\t"
+        "adcxq %%r12, %%r11\n\t"
+        "adoxq %%r13, %%rax\n\t"
+        "movl $0, %%r12d\n\t"
+        "adcxq %%r12, %%rax\n\t"
+        "movq %%r9, 40(%[r])\n\t"
+        "movq %%r10, 48(%[r])\n\t"
+        "movq 24(%[a]), %%rdx\n\t"
+        "xorl %%ebx, %%ebx\n\t"
+        "mulxq 32(%[a]), %%r12, %%r13\n\t"
+        "adcxq %%r12, %%r11\n\t"
+        "adoxq %%r13, %%rax\n\t"
+        "mulxq 40(%[a]), %%r12, %%r13\n\t"
+        "adcxq %%r12, %%rax\n\t"
+        "adoxq %%r13, %%rbx\n\t"
+        "movl $0, %%r12d\n\t"
+        "adcxq %%r12, %%rbx\n\t"
+        "movq %%r11, 56(%[r])\n\t"
+        "movq %%rax, 64(%[r])\n\t"
+        "movq 32(%[a]), %%rdx\n\t"
+        "xorl %%ecx, %%ecx\n\t"
+        "mulxq 40(%[a]), %%r12, %%r13\n\t"
+        "adcxq %%r12, %%rbx\n\t"
+        "adoxq %%r13, %%rcx\n\t"
+        "movl $0, %%r12d\n\t"
+        "adcxq %%r12, %%rcx\n\t"
+        "movq %%rbx, 72(%[r])\n\t"
+        "movq %%rcx, 80(%[r])\n\t"
+        "xorl %%eax, %%eax\n\t"
+        "movq 0(%[a]), %%rdx\n\t"
+        "mulxq %%rdx, %%r12, %%r13\n\t"
+        "movl $0, %%ebx\n\t"
+        "adcxq %%rbx, %%rbx\n\t"
+        "adoxq %%r12, %%rbx\n\t"
+        "movq %%rbx, 0(%[r])\n\t"
+        "movq 8(%[r]), %%rbx\n\t"
+        "adcxq %%rbx, %%rbx\n\t"
+        "adoxq %%r13, %%rbx\n\t"
+        "movq %%rbx, 8(%[r])\n\t"
+        "movq 8(%[a]), %%rdx\n\t"
+        "mulxq %%rdx, %%r12, %%r13\n\t"
+        "movq 16(%[r]), %%rbx\n\t"
+        "adcxq %%rbx, %%rbx\n\t"
+        "adoxq %%r12, %%rbx\n\t"
+        "movq %%rbx, 16(%[r])\n\t"
+        "movq 24(%[r]), %%rbx\n\t"
+        "adcxq %%rbx, %%rbx\n\t"
+        "adoxq %%r13, %%rbx\n\t"
+        "movq %%rbx, 24(%[r])\n\t"
+        "movq 16(%[a]), %%rdx\n\t"
+        "mulxq %%rdx, %%r12, %%r13\n\t"
+        "movq 32(%[r]), %%rbx\n\t"
+        "adcxq %%rbx, %%rbx\n\t"
+        "adoxq %%r12, %%rbx\n\t"
+        "movq %%rbx, 32(%[r])\n\t"
+        "movq 40(%[r]), %%rbx\n\t"
+        "adcxq %%rbx, %%rbx\n\t"
+        "adoxq %%r13, %%rbx\n\t"
+        "movq %%rbx, 40(%[r])\n\t"
+        "movq 24(%[a]), %%rdx\n\t"
+        "mulxq %%rdx, %%r12, %%r13\n\t"
+        "movq 48(%[r]), %%rbx\n\t"
+        "adcxq %%rbx, %%rbx\n\t"
+        "adoxq %%r12, %%rbx\n\t"
+        "movq %%rbx, 48(%[r])\n\t"
+        "movq 56(%[r]), %%rbx\n\t"
+        "adcxq %%rbx, %%rbx\n\t"
+        "adoxq %%r13, %%rbx\n\t"
+        "movq %%rbx, 56(%[r])\n\t"
+        "movq 32(%[a]), %%rdx\n\t"
+        "mulxq %%rdx, %%r12, %%r13\n\t"
+        "movq 64(%[r]), %%rbx\n\t"
+        "adcxq %%rbx, %%rbx\n\t"
+        "adoxq %%r12, %%rbx\n\t"
+        "movq %%rbx, 64(%[r])\n\t"
+        "movq 72(%[r]), %%rbx\n\t"
+        "adcxq %%rbx, %%rbx\n\t"
+        "adoxq %%r13, %%rbx\n\t"
+        "movq %%rbx, 72(%[r])\n\t"
+        "movq 40(%[a]), %%rdx\n\t"
+        "mulxq %%rdx, %%r12, %%r13\n\t"
+        "movq 80(%[r]), %%rbx\n\t"
+        "adcxq %%rbx, %%rbx\n\t"
+        "adoxq %%r12, %%rbx\n\t"
+        "movq %%rbx, 80(%[r])\n\t"
+        "movl $0, %%ebx\n\t"
+        "adcxq %%rbx, %%rbx\n\t"
+        "adoxq %%r13, %%rbx\n\t"
+        "movq %%rbx, 88(%[r])\n\t"
+        :
+        : [r] "r"(r), [a] "r"(a)
+        : "rax", "rbx", "rcx", "rdx", "r8", "r9", "r10", "r11", "r12", "r13", "cc", "memory");
+}
+
+// r = t / R mod p для t < p * R. Перенос за окно накапливается в r14.
+static void fp_redc_mulx(bls_fp_t* r, const uint64_t* t) {
+    __asm__ __volatile__(
+        "movq 0(%[t]), %%rax\n\t"
+        "movq 8(%[t]), %%rbx\n\t"
+        "movq 16(%[t]), %%rcx\n\t"
+        "movq 24(%[t]), %%r8\n\t"
+        "movq 32(%[t]), %%r9\n\t"
+        "movq 40(%[t]), %%r10\n\t"
+        "movq 48(%[t]), %%r11\n\t"
+        "xorl %%r14d, %%r14d\n\t"
+        "movq %%rax, %%rdx\n\t"
+        "imulq %[pinv], %%rdx\n\t"
+        "xorl %%r12d, %%r12d\n\t"
+        "mulxq %[p], %%r12, %%r13\n\t"
+        "adcxq %%r12, %%rax\n\t"
+        "adoxq %%r13, %%rbx\n\t"
+        "mulxq 8+%[p], %%r12, %%r13\n\t"
+        "adcxq %%r12, %%rbx\n\t"
+        "adoxq %%r13, %%rcx\n\t"
+        "mulxq 16+%[p], %%r12, %%r13\n\t"
+        "adcxq %%r12, %%rcx\n\t"
+        "adoxq %%r13, %%r8\n\t"
+        "mulxq 24+%[p], %%r12, %%r13\n\t"
+        "adcxq %%r12, %%r8\n\t"
+        "adoxq %%r13, %%r9\n\t"
+        "mulxq 32+%[p], %%r12, %%r13\n\t"
+        "adcxq %%r12, %%r9\n\t"
+        "adoxq %%r13, %%r10\n\t"
+        "mulxq 40+%[p], %%r12, %%r13\n\t"
+        "adcxq %%r12, %%r10\n\t"
+        "adoxq %%r13, %%r11\n\t"
+        "adcxq %%r14, %%r11\n\t"
+        "movl $0, %%r14d\n\t"
+        "adcxq %%rax, %%r14\n\t"
+        "adoxq %%rax, %%r14\n\t"
+        "movq 56(%[t]), %%rax\n\t"
+        "movq %%rbx, %%rdx\n\t"
+        "imulq %[pinv], %%rdx\n\t"
+        "xorl %%r12d, %%r12d\n\t"
+        "mulxq %[p], %%r12, %%r13\n\t"
+        "adcxq %%r12, %%rbx\n\t"
+        "adoxq %%r13, %%rcx\n\t"
+        "mulxq 8+%[p], %%r12, %%r13\n\t"
+        "adcxq %%r12, %%rcx\n\t"
+        "adoxq %%r13, %%r8\n\t"
+        "mulxq 16+%[p], %%r12, %%r13\n\t"
+        "adcxq %%r12, %%r8\n\t"
+        "adoxq %%r13, %%r9\n\t"
+        "mulxq 24+%[p], %%r12, %%r13\n\t"
+        "adcxq %%r12, %%r9\n\t"
+        "adoxq %%r13, %%r10\n\t"
+        "mulxq 32+%[p], %%r12, %%r13\n\t"
+        "adcxq %%r12, %%r10\n\t"
+        "adoxq %%r13, %%r11\n\t"
+        "mulxq 40+%[p], %%r12, %%r13\n\t"
+        "adcxq %%r12, %%r11\n\t"
+        "adoxq %%r13, %%rax\n\t"
+        "adcxq %%r14, %%rax\n\t"
+        "movl $0, %%r14d\n\t"
+        "adcxq %%rbx, %%r14\n\t"
+        "adoxq %%rbx, %%r14\n\t"
+        "movq 64(%[t]), %%rbx\n\t"
+        "movq %%rcx, %%rdx\n\t"
+        "imulq %[pinv], %%rdx\n\t"
+        "xorl %%r12d, %%r12d\n\t"
+        "mulxq %[p], %%r12, %%r13\n\t"
+        "adcxq %%r12, %%rcx\n\t"
+        "adoxq %%r13, %%r8\n\t"
+        "mulxq 8+%[p], %%r12, %%r13\n\t"
+        "adcxq %%r12, %%r8\n\t"
+        "adoxq %%r13, %%r9\n\t"
+        "mulxq 16+%[p], %%r12, %%r13\n\t"
+        "adcxq %%r12, %%r9\n\t"
+        "adoxq %%r13, %%r10\n\t"
+        "mulxq 24+%[p], %%r12, %%r13\n\t"
+        "adcxq %%r12, %%r10\n\t"
+        "adoxq %%r13, %%r11\n\t"
+        "mulxq 32+%[p], %%r12, %%r13\n\t"
+        "adcxq %%r12, %%r11\n\t"
+        "adoxq %%r13, %%rax\n\t"
+        "mulxq 40+%[p], %%r12, %%r13\n\t"
+        "adcxq %%r12, %%rax\n\t"
+        "adoxq %%r13, %%rbx\n\t"
+        "adcxq %%r14, %%rbx\n\t"
+        "movl $0, %%r14d\n\t"
+        "adcxq %%rcx, %%r14\n\t"
+        "adoxq %%rcx, %%r14\n\t"
+        "movq 72(%[t]), %%rcx\n\t"
+        "movq %%r8, %%rdx\n\t"
+        "imulq %[pinv], %%rdx\n\t"
+        "xorl %%r12d, %%r12d\n\t"
+        "mulxq %[p], %%r12, %%r13\n\t"
+        "adcxq %%r12, %%r8\n\t"
+        "adoxq %%r13, %%r9\n\t"
+        "mulxq 8+%[p], %%r12, %%r13\n\t"
+        "adcxq %%r12, %%r9\n\t"
+        "adoxq %%r13, %%r10\n\t"
+        "mulxq 16+%[p], %%r12, %%r13\n\t"
+        "adcxq %%r12, %%r10\n\t"
+        "adoxq %%r13, %%r11\n\t"
+        "mulxq 24+%[p], %%r12, %%r13\n\t"
+        "adcxq %%r12, %%r11\n\t"
+        "adoxq %%r13, %%rax\n\t"
+        "mulxq 32+%[p], %%r12, %%r13\n\t"
+        "adcxq %%r12, %%rax\n\t"
+        "adoxq %%r13, %%rbx\n\t"
+        "mulxq 40+%[p], %%r12, %%r13\n\t"
+        "adcxq %%r12, %%rbx\n\t"
+        "adoxq %%r13, %%rcx\n\t"
+        "adcxq %%r14, %%rcx\n\t"
+        "movl $0, %%r14d\n\t"
+        "adcxq %%r8, %%r14\n\t"
+        "adoxq %%r8, %%r14\n\t"
+        "movq 80(%[t]), %%r8\n\t"
+        "movq %%r9, %%rdx\n\t"
+        "imulq %[pinv], %%rdx\n\t"
+        "xorl %%r12d, %%r12d\n\t"
+        "mulxq %[p], %%r12, %%r13\n\t"
+        "adcxq %%r12, %%r9\n\t"
+        "adoxq %%r13, %%r10\n\t"
+        "mulxq 8+%[p], %%r12, %%r13\n\t"
+        "adcxq %%r12, %%r10\n\t"
+        "adoxq %%r13, %%r11\n\t"
+        "mulxq 16+%[p], %%r12, %%r13\n\t"
+        "adcxq %%r12, %%r11\n\t"
+        "adoxq %%r13, %%rax\n\t"
+        "mulxq 24+%[p], %%r12, %%r13\n\t"
+        "adcxq %%r12, %%rax\n\t"
+        "adoxq %%r13, %%rbx\n\t"
+        "mulxq 32+%[p], %%r12, %%r13\n\t"
+        "adcxq %%r12, %%rbx\n\t"
+        "adoxq %%r13, %%rcx\n\t"
+        "mulxq 40+%[p], %%r12, %%r13\n\t"
+        "adcxq %%r12, %%rcx\n\t"
+        "adoxq %%r13, %%r8\n\t"
+        "adcxq %%r14, %%r8\n\t"
+        "movl $0, %%r14d\n\t"
+        "adcxq %%r9, %%r14\n\t"
+        "adoxq %%r9, %%r14\n\t"
+        "movq 88(%[t]), %%r9\n\t"
+        "movq %%r10, %%rdx\n\t"
+        "imulq %[pinv], %%rdx\n\t"
+        "xorl %%r12d, %%r12d\n\t"
+        "mulxq %[p], %%r12, %%r13\n\t"
+        "adcxq %%r12, %%r10\n\t"
+        "adoxq %%r13, %%r11\n\t"
+        "mulxq 8+%[p], %%r12, %%r13\n\t"
+        "adcxq %%r12, %%r11\n\t"
+        "adoxq %%r13, %%rax\n\t"
+        "mulxq 16+%[p], %%r12, %%r13\n\t"
+        "adcxq %%r12, %%rax\n\t"
+        "adoxq %%r13, %%rbx\n\t"
+        "mulxq 24+%[p], %%r12, %%r13\n\t"
+        "adcxq %%r12, %%rbx\n\t"
+        "adoxq %%r13, %%rcx\n\t"
+        "mulxq 32+%[p], %%r12, %%r13\n\t"
+        "adcxq %%r12, %%rcx\n\t"
+        "adoxq %%r13, %%r8\n\t"
+        "mulxq 40+%[p], %%r12, %%r13\n\t"
+        "adcxq %%r12, %%r8\n\t"
+        "adoxq %%r13, %%r9\n\t"
+        "adcxq %%r14, %%r9\n\t"
+        "movl $0, %%r14d\n\t"
+        "adcxq %%r10, %%r14\n\t"
+        "adoxq %%r10, %%r14\n\t"
+        "movq %%r11, (%[r])\n\t"
+        "movq %%rax, 8(%[r])\n\t"
+        "movq %%rbx, 16(%[r])\n\t"
+        "movq %%rcx, 24(%[r])\n\t"
+        "movq %%r8, 32(%[r])\n\t"
+        "movq %%r9, 40(%[r])\n\t"
+        "subq %[p], %%r11\n\t"
+        "sbbq 8+%[p], %%rax\n\t"
+        "sbbq 16+%[p], %%rbx\n\t"
+        "sbbq 24+%[p], %%rcx\n\t"
+        "sbbq 32+%[p], %%r8\n\t"
+        "sbbq 40+%[p], %%r9\n\t"
+        "sbbq $0, %%r14\n\t"
+        "cmovcq (%[r]), %%r11\n\t"
+        "cmovcq 8(%[r]), %%rax\n\t"
+        "cmovcq 16(%[r]), %%rbx\n\t"
+        "cmovcq 24(%[r]), %%rcx\n\t"
+        "cmovcq 32(%[r]), %%r8\n\t"
+        "cmovcq 40(%[r]), %%r9\n\t"
+        "movq %%r11, (%[r])\n\t"
+        "movq %%rax, 8(%[r])\n\t"
+        "movq %%rbx, 16(%[r])\n\t"
+        "movq %%rcx, 24(%[r])\n\t"
+        "movq %%r8, 32(%[r])\n\t"
+        "movq %%r9, 40(%[r])\n\t"
+        :
+        : [r] "r"(r->l), [t] "r"(t), [p] "m"(g_bls_p), [pinv] "m"(g_bls_p_inv)
+        : "rax", "rbx", "rcx", "rdx", "r8", "r9", "r10", "r11", "r12", "r13", "r14", "cc",
+          "memory");
+}
+
+static pthread_once_t g_bls_fp_once = PTHREAD_ONCE_INIT;
+static bls_fp_impl_t g_bls_fp_best_impl = BLS_FP_PORTABLE;
+static bls_fp_impl_t g_bls_fp_impl = BLS_FP_PORTABLE;  // Доступ через __atomic_*
+
+static void bls_fp_detect_impl(void) {
+    if (__builtin_cpu_supports("bmi2") && __builtin_cpu_supports("adx")) {
+        g_bls_fp_best_impl = BLS_FP_MULX;
+    }
+    __atomic_store_n(&g_bls_fp_impl, g_bls_fp_best_impl, __ATOMIC_RELAXED);
+}
+
+static inline bool fp_use_mulx(void) {
+    return __atomic_load_n(&g_bls_fp_impl, __ATOMIC_RELAXED) == BLS_FP_MULX;
+}
+
+static inline void fp_mul_384(uint64_t* r, const bls_fp_t* a, const bls_fp_t* b) {
+    if (fp_use_mulx()) {
+        fp_mul_384_mulx(r, a->l, b->l);
+    } else {
+        fp_mul_384_portable(r, a->l, b->l);
+    }
+}
+
+static inline void fp_sqr_384(uint64_t* r, const bls_fp_t* a) {
+    if (fp_use_mulx()) {
+        fp_sqr_384_mulx(r, a->l);
+    } else {
+        fp_mul_384_portable(r, a->l, a->l);
+    }
+}
+
+static inline void fp_redc(bls_fp_t* r, const uint64_t* t) {
+    if (fp_use_mulx()) {
+        fp_redc_mulx(r, t);
+    } else {
+        fp_redc_portable(r, t);
+    }
+}
+
+static inline void fp_mul(bls_fp_t* r, const bls_fp_t* a, const bls_fp_t* b) {
+    if (fp_use_mulx()) {
+        uint64_t t[12];
+        fp_mul_384_mulx(t, a->l, b->l);
+        fp_redc_mulx(r, t);
+    } else {
+        fp_mul_portable(r, a, b);
+    }
+}
+
+static inline void fp_sqr(bls_fp_t* r, const bls_fp_t* a) {
+    if (fp_use_mulx()) {
+        uint64_t t[12];
+        fp_sqr_384_mulx(t, a->l);
+        fp_redc_mulx(r, t);
+    } else {
+        fp_mul_portable(r, a, a);
+    }
+}
+
+// r = a^e, показатель - exp_words слов little-endian
+static void fp_pow(bls_fp_t* r, const bls_fp_t* a, const uint64_t* exp, size_t exp_words) {
+    bls_fp_t acc = g_bls_one;
+    bls_fp_t base = *a;
+    for (size_t i = exp_words * 64; i-- > 0;) {
+        fp_sqr(&acc, &acc);
+        if ((exp[i / 64] >> (i % 64)) & 1) {
+            fp_mul(&acc, &acc, &base);
+        }
+    }
+    *r = acc;
+}
+
+static void fp_inv(bls_fp_t* r, const bls_fp_t* a) {
+    fp_pow(r, a, g_bls_p_minus_2.l, 6);
+}
+
+// p = 3 mod 4: корень a^((p + 1) / 4), если он существует
+static bool fp_sqrt(bls_fp_t* r, const bls_fp_t* a) {
+    bls_fp_t root, check;
+    fp_pow(&root, a, g_bls_p_plus_1_div_4.l, 6);
+    fp_sqr(&check, &root);
+    if (!fp_eq(&check, a)) {
+        return false;
+    }
+    *r = root;
+    return true;
+}
+
+// Перевод из формы Монтгомери в обычную
+static inline void fp_to_normal(bls_fp_t* r, const bls_fp_t* a) {
+    bls_fp_t one;
+    memset(&one, 0, sizeof(one));
+    one.l[0] = 1;
+    fp_mul(r, a, &one);
+}
+
+static inline void fp_load_be(uint64_t* words, const uint8_t* in) {
+    for (int i = 0; i < 6; i++) {
+        uint64_t w = 0;
+        for (int j = 0; j < 8; j++) {
+            w = (w << 8) | in[(5 - i) * 8 + j];
+        }
+        words[i] = w;
+    }
+}
+
+// 48 байт big-endian; false, если значение не меньше p
+static bool fp_from_bytes(bls_fp_t* r, const uint8_t* in) {
+    bls_fp_t raw;
+    fp_load_be(raw.l, in);
+    
+    for (int i = 5; i >= 0; i--) {
+        if (raw.l[i] != g_bls_p.l[i]) {
+            if (raw.l[i] > g_bls_p.l[i]) {
+                return false;
+            }
+            break;
+        }
+        if (i == 0) {
+            return false;
+        }
+    }
+    fp_mul(r, &raw, &g_bls_r2);
+    return true;
+}
+
+static void fp_to_bytes(uint8_t* out, const bls_fp_t* a) {
+    bls_fp_t normal;
+    fp_to_normal(&normal, a);
+    for (int i = 0; i < 6; i++) {
+        uint64_t w = normal.l[5 - i];
+        for (int j = 0; j < 8; j++) {
+            out[i * 8 + j] = (uint8_t)(w >> (56 - 8 * j));
+        }
+    }
+}
+
+// 64 байта big-endian по модулю p: hi * 2^384 + lo, где lo * R^2 / R
+// и hi * R^3 / R дают форму Монтгомери без отдельного деления
+static void fp_from_bytes_wide(bls_fp_t* r, const uint8_t* in) {
+    uint8_t hi_bytes[48] = {0};
+    memcpy(hi_bytes + 32, in, 16);
+    
+    bls_fp_t lo, hi;
+    fp_load_be(lo.l, in + 16);
+    fp_load_be(hi.l, hi_bytes);
+    fp_mul(&lo, &lo, &g_bls_r2);
+    fp_mul(&hi, &hi, &g_bls_r3);
+    fp_add(r, &lo, &hi);
+}
+
+// Лексикографически большее из (y, -y): y > (p - 1) / 2
+static bool fp_is_lex_largest(const bls_fp_t* a) {
+    bls_fp_t normal;
+    fp_to_normal(&normal, a);
+    for (int i = 5; i >= 0; i--) {
+        if (normal.l[i] != g_bls_p_minus_1_div_2.l[i]) {
+            return normal.l[i] > g_bls_p_minus_1_div_2.l[i];
+        }
+    }
+    return false;
+}
+
+static inline bool fp_is_odd(const bls_fp_t* a) {
+    bls_fp_t normal;
+    fp_to_normal(&normal, a);
+    return normal.l[0] & 1;
+}
+
+// Fp2
+
+static inline bool fp2_is_zero(const bls_fp2_t* a) {
+    return fp_is_zero(&a->c0) && fp_is_zero(&a->c1);
+}
+
+static inline bool fp2_eq(const bls_fp2_t* a, const bls_fp2_t* b) {
+    return fp_eq(&a->c0, &b->c0) && fp_eq(&a->c1, &b->c1);
+}
+
+static inline void fp2_add(bls_fp2_t* r, const bls_fp2_t* a, const bls_fp2_t* b) {
+    fp_add(&r->c0, &a->c0, &b->c0);
+    fp_add(&r->c1, &a->c1, &b->c1);
+}
+
+static inline void fp2_sub(bls_fp2_t* r, const bls_fp2_t* a, const bls_fp2_t* b) {
+    fp_sub(&r->c0, &a->c0, &b->c0);
+    fp_sub(&r->c1, &a->c1, &b->c1);
+}
+
+static inline void fp2_dbl(bls_fp2_t* r, const bls_fp2_t* a) {
+    fp_dbl(&r->c0, &a->c0);
+    fp_dbl(&r->c1, &a->c1);
+}
+
+static inline void fp2_neg(bls_fp2_t* r, const bls_fp2_t* a) {
+    fp_neg(&r->c0, &a->c0);
+    fp_neg(&r->c1, &a->c1);
+}
+
+static inline void fp2_conj(bls_fp2_t* r, const bls_fp2_t* a) {
+    r->c0 = a->c0;
+    fp_neg(&r->c1, &a->c1);
+}
+
+// a + b без приведения: для a, b < p сумма меньше 2p < 2^382
+static inline void fp_add_unreduced(bls_fp_t* r, const bls_fp_t* a, const bls_fp_t* b) {
+    uint64_t carry = 0;
+    for (int i = 0; i < 6; i++) {
+        unsigned __int128 s = (unsigned __int128)a->l[i] + b->l[i] + carry;
+        r->l[i] = (uint64_t)s;
+        carry = (uint64_t)(s >> 64);
+    }
+}
+
+// a - b без приведения для a >= b
+static inline void fp_sub_unreduced(bls_fp_t* r, const bls_fp_t* a, const bls_fp_t* b) {
+    uint64_t borrow = 0;
+    for (int i = 0; i < 6; i++) {
+        unsigned __int128 d = (unsigned __int128)a->l[i] - b->l[i] - borrow;
+        r->l[i] = (uint64_t)d;
+        borrow = (uint64_t)(d >> 64) & 1;
+    }
+}
+
+// r = a - b для 768-битных чисел; при заеме прибавляется p * 2^384,
+// чтобы результат оставался в [0, p * R) для редукции
+static inline void fp_wide_sub(uint64_t* r, const uint64_t* a, const uint64_t* b) {
+    uint64_t borrow = 0;
+    for (int i = 0; i < 12; i++) {
+        unsigned __int128 d = (unsigned __int128)a[i] - b[i] - borrow;
+        r[i] = (uint64_t)d;
+        borrow = (uint64_t)(d >> 64) & 1;
+    }
+    
+    uint64_t mask = 0 - borrow;
+    uint64_t carry = 0;
+    for (int i = 0; i < 6; i++) {
+        unsigned __int128 s = (unsigned __int128)r[6 + i] + (g_bls_p.l[i] & mask) + carry;
+        r[6 + i] = (uint64_t)s;
+        carry = (uint64_t)(s >> 64);
+    }
+}
+
+// Карацуба с отложенной редукцией: три произведения 384 x 384, вычитания
+// над 768-битными значениями и две редукции Монтгомери вместо трех
+static void fp2_mul(bls_fp2_t* r, const bls_fp2_t* a, const bls_fp2_t* b) {
+    uint64_t t0[12], t1[12], t2[12];
+    bls_fp_t sa, sb;
+    fp_mul_384(t0, &a->c0, &b->c0);
+    fp_mul_384(t1, &a->c1, &b->c1);
+    fp_add_unreduced(&sa, &a->c0, &a->c1);
+    fp_add_unreduced(&sb, &b->c0, &b->c1);
+    fp_mul_384(t2, &sa, &sb);
+    
+    // a0 b1 + a1 b0 < 2 p^2 < p * R
+    fp_wide_sub(t2, t2, t0);
+    fp_wide_sub(t2, t2, t1);
+    fp_redc(&r->c1, t2);
+    fp_wide_sub(t0, t0, t1);
+    fp_redc(&r->c0, t0);
+}
+
+// (a0 + a1)(a0 - a1) + 2 a0 a1 u; множители меньше 2p, произведения
+// меньше 4 p^2 < p * R
+static void fp2_sqr(bls_fp2_t* r, const bls_fp2_t* a) {
+    uint64_t t[12];
+    bls_fp_t s, d, a0_dbl;
+    fp_add_unreduced(&s, &a->c0, &a->c1);
+    fp_add_unreduced(&d, &a->c0, &g_bls_p);
+    fp_sub_unreduced(&d, &d, &a->c1);
+    fp_add_unreduced(&a0_dbl, &a->c0, &a->c0);
+    
+    fp_mul_384(t, &a0_dbl, &a->c1);
+    fp_redc(&r->c1, t);
+    fp_mul_384(t, &s, &d);
+    fp_redc(&r->c0, t);
+}
+
+static inline void fp2_mul_fp(bls_fp2_t* r, const bls_fp2_t* a, const bls_fp_t* b) {
+    fp_mul(&r->c0, &a->c0, b);
+    fp_mul(&r->c1, &a->c1, b);
+}
+
+// Умножение на xi = 1 + u
+static inline void fp2_mul_nr(bls_fp2_t* r, const bls_fp2_t* a) {
+    bls_fp_t t0, t1;
+    fp_sub(&t0, &a->c0, &a->c1);
+    fp_add(&t1, &a->c0, &a->c1);
+    r->c0 = t0;
+    r->c1 = t1;
+}
+
+static void fp2_inv(bls_fp2_t* r, const bls_fp2_t* a) {
+    bls_fp_t t0, t1;
+    fp_sqr(&t0, &a->c0);
+    fp_sqr(&t1, &a->c1);
+    fp_add(&t0, &t0, &t1);
+    fp_inv(&t0, &t0);
+    
+    fp_mul(&r->c0, &a->c0, &t0);
+    fp_mul(&t1, &a->c1, &t0);
+    fp_neg(&r->c1, &t1);
+}
+
+static void fp2_pow(bls_fp2_t* r, const bls_fp2_t* a, const uint64_t* exp, size_t exp_words) {
+    bls_fp2_t acc;
+    acc.c0 = g_bls_one;
+    memset(&acc.c1, 0, sizeof(acc.c1));
+    bls_fp2_t base = *a;
+    for (size_t i = exp_words * 64; i-- > 0;) {
+        fp2_sqr(&acc, &acc);
+        if ((exp[i / 64] >> (i % 64)) & 1) {
+            fp2_mul(&acc, &acc, &base);
+        }
+    }
+    *r = acc;
+}
+
+// Корень в Fp2 для p = 3 mod 4 (Adj, Rodriguez-Henriquez, алгоритм 9)
+static bool fp2_sqrt_alg9(bls_fp2_t* r, const bls_fp2_t* a) {
+    bls_fp2_t a1, alpha, x0, x, check;
+    fp2_pow(&a1, a, g_bls_p_minus_3_div_4.l, 6);
+    fp2_sqr(&alpha, &a1);
+    fp2_mul(&alpha, &alpha, a);
+    fp2_mul(&x0, &a1, a);
+    
+    bls_fp_t minus_one;
+    fp_neg(&minus_one, &g_bls_one);
+    if (fp_eq(&alpha.c0, &minus_one) && fp_is_zero(&alpha.c1)) {
+        // x = u * x0
+        fp_neg(&x.c0, &x0.c1);
+        x.c1 = x0.c0;
+    } else {
+        bls_fp2_t b = alpha;
+        fp_add(&b.c0, &b.c0, &g_bls_one);
+        fp2_pow(&b, &b, g_bls_p_minus_1_div_2.l, 6);
+        fp2_mul(&x, &b, &x0);
+    }
+    
+    fp2_sqr(&check, &x);
+    if (!fp2_eq(&check, a)) {
+        return false;
+    }
+    *r = x;
+    return true;
+}
+
+// Корень в Fp2 через норму: a - квадрат, только если n = a0^2 + a1^2 -
+// квадрат в Fp. Тогда при lambda = sqrt(n) и delta = (a0 +- lambda) / 2
+// корень равен x0 + x1 u, x0 = sqrt(delta), x1 = a1 / (2 x0). Степень
+// t = delta^((p - 3) / 4) дает сразу x0 = t delta и 1 / x0 = t, поэтому
+// вместо двух степеней в Fp2 считаются две-три в Fp. Вырожденные входы
+// (a1 = 0) уходят в алгоритм 9.
+static bool fp2_sqrt(bls_fp2_t* r, const bls_fp2_t* a) {
+    bls_fp_t norm, t, lambda, check;
+    fp_sqr(&norm, &a->c0);
+    fp_sqr(&t, &a->c1);
+    fp_add(&norm, &norm, &t);
+    fp_pow(&t, &norm, g_bls_p_minus_3_div_4.l, 6);
+    fp_mul(&lambda, &t, &norm);
+    fp_sqr(&check, &lambda);
+    if (!fp_eq(&check, &norm)) {
+        return false;
+    }
+    
+    bls_fp2_t x;
+    for (int attempt = 0; attempt < 2; attempt++) {
+        bls_fp_t delta;
+        if (attempt == 0) {
+            fp_add(&delta, &a->c0, &lambda);
+        } else {
+            fp_sub(&delta, &a->c0, &lambda);
+        }
+        fp_mul(&delta, &delta, &g_bls_half);
+        fp_pow(&t, &delta, g_bls_p_minus_3_div_4.l, 6);
+        fp_mul(&x.c0, &t, &delta);
+        fp_mul(&check, &x.c0, &t);
+        if (fp_eq(&check, &g_bls_one)) {
+            fp_mul(&x.c1, &a->c1, &t);
+            fp_mul(&x.c1, &x.c1, &g_bls_half);
+            
+            bls_fp2_t square;
+            fp2_sqr(&square, &x);
+            if (fp2_eq(&square, a)) {
+                *r = x;
+                return true;
+            }
+            break;
+        }
+    }
+    return fp2_sqrt_alg9(r, a);
+}
+
+// sgn0 из RFC 9380 для Fp2
+static bool fp2_sgn0(const bls_fp2_t* a) {
+    return fp_is_odd(&a->c0) || (fp_is_zero(&a->c0) && fp_is_odd(&a->c1));
+}
+
+// Лексикографический порядок ZCash: сначала c1, при c1 = 0 - c0
+static bool fp2_is_lex_largest(const bls_fp2_t* a) {
+    return fp_is_zero(&a->c1) ? fp_is_lex_largest(&a->c0) : fp_is_lex_largest(&a->c1);
+}
+
+// Fp6
+
+static inline void fp6_add(bls_fp6_t* r, const bls_fp6_t* a, const bls_fp6_t* b) {
+    fp2_add(&r->c0, &a->c0, &b->c0);
+    fp2_add(&r->c1, &a->c1, &b->c1);
+    fp2_add(&r->c2, &a->c2, &b->c2);
+}
+
+static inline void fp6_sub(bls_fp6_t* r, const bls_fp6_t* a, const bls_fp6_t* b) {
+    fp2_sub(&r->c0, &a->c0, &b->c0);
+    fp2_sub(&r->c1, &a->c1, &b->c1);
+    fp2_sub(&r->c2, &a->c2, &b->c2);
+}
+
+static inline void fp6_neg(bls_fp6_t* r, const bls_fp6_t* a) {
+    fp2_neg(&r->c0, &a->c0);
+    fp2_neg(&r->c1, &a->c1);
+    fp2_neg(&r->c2, &a->c2);
+}
+
+// Умножение на v: (c0, c1, c2) -> (xi c2, c0, c1)
+static inline void fp6_mul_nr(bls_fp6_t* r, const bls_fp6_t* a) {
+    bls_fp2_t t;
+    fp2_mul_nr(&t, &a->c2);
+    r->c2 = a->c1;
+    r->c1 = a->c0;
+    r->c0 = t;
+}
+
+// Карацуба для кубического расширения: шесть умножений Fp2
+static void fp6_mul(bls_fp6_t* r, const bls_fp6_t* a, const bls_fp6_t* b) {
+    bls_fp2_t t0, t1, t2, s, u, c0, c1, c2;
+    fp2_mul(&t0, &a->c0, &b->c0);
+    fp2_mul(&t1, &a->c1, &b->c1);
+    fp2_mul(&t2, &a->c2, &b->c2);
+    
+    // c0 = xi ((a1 + a2)(b1 + b2) - t1 - t2) + t0
+    fp2_add(&s, &a->c1, &a->c2);
+    fp2_add(&u, &b->c1, &b->c2);
+    fp2_mul(&c0, &s, &u);
+    fp2_sub(&c0, &c0, &t1);
+    fp2_sub(&c0, &c0, &t2);
+    fp2_mul_nr(&c0, &c0);
+    fp2_add(&c0, &c0, &t0);
+    
+    // c1 = (a0 + a1)(b0 + b1) - t0 - t1 + xi t2
+    fp2_add(&s, &a->c0, &a->c1);
+    fp2_add(&u, &b->c0, &b->c1);
+    fp2_mul(&c1, &s, &u);
+    fp2_sub(&c1, &c1, &t0);
+    fp2_sub(&c1, &c1, &t1);
+    fp2_mul_nr(&s, &t2);
+    fp2_add(&c1, &c1, &s);
+    
+    // c2 = (a0 + a2)(b0 + b2) - t0 - t2 + t1
+    fp2_add(&s, &a->c0, &a->c2);
+    fp2_add(&u, &b->c0, &b->c2);
+    fp2_mul(&c2, &s, &u);
+    fp2_sub(&c2, &c2, &t0);
+    fp2_sub(&c2, &c2, &t2);
+    fp2_add(&c2, &c2, &t1);
+    
+    r->c0 = c0;
+    r->c1 = c1;
+    r->c2 = c2;
+}
+
+// Умножение на b0 + b1 v (разреженный множитель линии)
+static void fp6_mul_01(bls_fp6_t* r, const bls_fp6_t* a, const bls_fp2_t* b0,
+                       const bls_fp2_t* b1) {
+    bls_fp2_t aa, bb, s, u, c0, c1, c2;
+    fp2_mul(&aa, &a->c0, b0);
+    fp2_mul(&bb, &a->c1, b1);
+    
+    fp2_mul(&c0, &a->c2, b1);
+    fp2_mul_nr(&c0, &c0);
+    fp2_add(&c0, &c0, &aa);
+    
+    fp2_add(&s, b0, b1);
+    fp2_add(&u, &a->c0, &a->c1);
+    fp2_mul(&c1, &s, &u);
+    fp2_sub(&c1, &c1, &aa);
+    fp2_sub(&c1, &c1, &bb);
+    
+    fp2_mul(&c2, &a->c2, b0);
+    fp2_add(&c2, &c2, &bb);
+    
+    r->c0 = c0;
+    r->c1 = c1;
+    r->c2 = c2;
+}
+
+// Умножение на b1 v
+static void fp6_mul_1(bls_fp6_t* r, const bls_fp6_t* a, const bls_fp2_t* b1) {
+    bls_fp2_t c0, c1, c2;
+    fp2_mul(&c0, &a->c2, b1);
+    fp2_mul_nr(&c0, &c0);
+    fp2_mul(&c1, &a->c0, b1);
+    fp2_mul(&c2, &a->c1, b1);
+    r->c0 = c0;
+    r->c1 = c1;
+    r->c2 = c2;
+}
+
+static void fp6_inv(bls_fp6_t* r, const bls_fp6_t* a) {
+    bls_fp2_t c0, c1, c2, t, s;
+    fp2_sqr(&c0, &a->c0);
+    fp2_mul(&t, &a->c1, &a->c2);
+    fp2_mul_nr(&t, &t);
+    fp2_sub(&c0, &c0, &t);
+    
+    fp2_sqr(&c1, &a->c2);
+    fp2_mul_nr(&c1, &c1);
+    fp2_mul(&t, &a->c0, &a->c1);
+    fp2_sub(&c1, &c1, &t);
+    
+    fp2_sqr(&c2, &a->c1);
+    fp2_mul(&t, &a->c0, &a->c2);
+    fp2_sub(&c2, &c2, &t);
+    
+    // Норма: a0 c0 + xi (a2 c1 + a1 c2)
+    fp2_mul(&t, &a->c2, &c1);
+    fp2_mul(&s, &a->c1, &c2);
+    fp2_add(&t, &t, &s);
+    fp2_mul_nr(&t, &t);
+    fp2_mul(&s, &a->c0, &c0);
+    fp2_add(&t, &t, &s);
+    fp2_inv(&t, &t);
+    
+    fp2_mul(&r->c0, &c0, &t);
+    fp2_mul(&r->c1, &c1, &t);
+    fp2_mul(&r->c2, &c2, &t);
+}
+
+static inline void fp6_mul_fp2(bls_fp6_t* r, const bls_fp6_t* a, const bls_fp2_t* b) {
+    fp2_mul(&r->c0, &a->c0, b);
+    fp2_mul(&r->c1, &a->c1, b);
+    fp2_mul(&r->c2, &a->c2, b);
+}
+
+// Фробениус: сопряжение коэффициентов и умножение на xi^((p - 1) / 3),
+// xi^(2(p - 1) / 3)
+static void fp6_frob(bls_fp6_t* r, const bls_fp6_t* a) {
+    fp2_conj(&r->c0, &a->c0);
+    fp2_conj(&r->c1, &a->c1);
+    fp2_conj(&r->c2, &a->c2);
+    fp2_mul(&r->c1, &r->c1, &g_bls_frob6_c1);
+    fp2_mul(&r->c2, &r->c2, &g_bls_frob6_c2);
+}
+
+// Fp12
+
+static inline void fp12_set_one(bls_fp12_t* r) {
+    memset(r, 0, sizeof(*r));
+    r->c0.c0.c0 = g_bls_one;
+}
+
+static inline bool fp12_is_one(const bls_fp12_t* a) {
+    bls_fp12_t one;
+    fp12_set_one(&one);
+    return memcmp(a, &one, sizeof(one)) == 0;
+}
+
+static inline void fp12_conj(bls_fp12_t* r, const bls_fp12_t* a) {
+    r->c0 = a->c0;
+    fp6_neg(&r->c1, &a->c1);
+}
+
+static void fp12_mul(bls_fp12_t* r, const bls_fp12_t* a, const bls_fp12_t* b) {
+    bls_fp6_t aa, bb, s, u;
+    fp6_mul(&aa, &a->c0, &b->c0);
+    fp6_mul(&bb, &a->c1, &b->c1);
+    fp6_add(&s, &a->c0, &a->c1);
+    fp6_add(&u, &b->c0, &b->c1);
+    
+    fp6_mul(&r->c1, &s, &u);
+    fp6_sub(&r->c1, &r->c1, &aa);
+    fp6_sub(&r->c1, &r->c1, &bb);
+    fp6_mul_nr(&bb, &bb);
+    fp6_add(&r->c0, &aa, &bb);
+}
+
+// Комплексное возведение в квадрат: два умножения Fp6
+static void fp12_sqr(bls_fp12_t* r, const bls_fp12_t* a) {
+    bls_fp6_t t, s, u;
+    fp6_mul(&t, &a->c0, &a->c1);
+    fp6_add(&s, &a->c0, &a->c1);
+    fp6_mul_nr(&u, &a->c1);
+    fp6_add(&u, &u, &a->c0);
+    fp6_mul(&s, &s, &u);
+    fp6_sub(&s, &s, &t);
+    fp6_mul_nr(&u, &t);
+    fp6_sub(&r->c0, &s, &u);
+    fp6_add(&r->c1, &t, &t);
+}
+
+static void fp12_inv(bls_fp12_t* r, const bls_fp12_t* a) {
+    bls_fp6_t t0, t1;
+    fp6_mul(&t0, &a->c0, &a->c0);
+    fp6_mul(&t1, &a->c1, &a->c1);
+    fp6_mul_nr(&t1, &t1);
+    fp6_sub(&t0, &t0, &t1);
+    fp6_inv(&t0, &t0);
+    
+    fp6_mul(&r->c0, &a->c0, &t0);
+    fp6_mul(&t1, &a->c1, &t0);
+    fp6_neg(&r->c1, &t1);
+}
+
+// Умножение на значение линии c0 + c1 v + c4 v w
+static void fp12_mul_014(bls_fp12_t* r, const bls_fp12_t* a, const bls_fp2_t* c0,
+                         const bls_fp2_t* c1, const bls_fp2_t* c4) {
+    bls_fp6_t aa, bb, s;
+    bls_fp2_t o;
+    fp6_mul_01(&aa, &a->c0, c0, c1);
+    fp6_mul_1(&bb, &a->c1, c4);
+    fp2_add(&o, c1, c4);
+    
+    fp6_add(&s, &a->c1, &a->c0);
+    fp6_mul_01(&s, &s, c0, &o);
+    fp6_sub(&s, &s, &aa);
+    fp6_sub(&r->c1, &s, &bb);
+    fp6_mul_nr(&bb, &bb);
+    fp6_add(&r->c0, &bb, &aa);
+}
+
+static void fp12_frob(bls_fp12_t* r, const bls_fp12_t* a) {
+    fp6_frob(&r->c0, &a->c0);
+    fp6_frob(&r->c1, &a->c1);
+    fp6_mul_fp2(&r->c1, &r->c1, &g_bls_frob12_c1);
+}
+
+static void fp12_frob_n(bls_fp12_t* r, const bls_fp12_t* a, int n) {
+    *r = *a;
+    for (int i = 0; i < n; i++) {
+        fp12_frob(r, r);
+    }
+}
+
+// Квадрат в Fp4 = Fp2[w^3] для циклотомического возведения в квадрат
+static void fp4_sqr(bls_fp2_t* r0, bls_fp2_t* r1, const bls_fp2_t* a, const bls_fp2_t* b) {
+    bls_fp2_t t0, t1, t2;
+    fp2_sqr(&t0, a);
+    fp2_sqr(&t1, b);
+    fp2_mul_nr(&t2, &t1);
+    fp2_add(r0, &t2, &t0);
+    
+    fp2_add(&t2, a, b);
+    fp2_sqr(&t2, &t2);
+    fp2_sub(&t2, &t2, &t0);
+    fp2_sub(r1, &t2, &t1);
+}
+
+// 3 a^2 -/+ 2 a для компонент циклотомического квадрата
+static inline void fp12_cyc_component(bls_fp2_t* z, const bls_fp2_t* t, bool minus) {
+    if (minus) {
+        fp2_sub(z, t, z);
+    } else {
+        fp2_add(z, t, z);
+    }
+    fp2_dbl(z, z);
+    fp2_add(z, z, t);
+}
+
+// Квадрат элемента циклотомической подгруппы (Granger, Scott)
+static void fp12_cyc_sqr(bls_fp12_t* r, const bls_fp12_t* a) {
+    bls_fp2_t z0 = a->c0.c0, z4 = a->c0.c1, z3 = a->c0.c2;
+    bls_fp2_t z2 = a->c1.c0, z1 = a->c1.c1, z5 = a->c1.c2;
+    bls_fp2_t t0, t1, t2, t3;
+    
+    fp4_sqr(&t0, &t1, &z0, &z1);
+    fp12_cyc_component(&z0, &t0, true);
+    fp12_cyc_component(&z1, &t1, false);
+    
+    fp4_sqr(&t0, &t1, &z2, &z3);
+    fp4_sqr(&t2, &t3, &z4, &z5);
+    fp12_cyc_component(&z4, &t0, true);
+    fp12_cyc_component(&z5, &t1, false);
+    
+    fp2_mul_nr(&t0, &t3);
+    fp12_cyc_component(&z2, &t0, false);
+    fp12_cyc_component(&z3, &t2, true);
+    
+    r->c0.c0 = z0;
+    r->c0.c1 = z4;
+    r->c0.c2 = z3;
+    r->c1.c0 = z2;
+    r->c1.c1 = z1;
+    r->c1.c2 = z5;
+}
+
+// a^x для x = -BLS_X в циклотомической подгруппе (обратный - сопряженный)
+static void fp12_cyc_exp(bls_fp12_t* r, const bls_fp12_t* a) {
+    bls_fp12_t acc;
+    fp12_set_one(&acc);
+    bool found = false;
+    for (int i = 63; i >= 0; i--) {
+        bool bit = (BLS_X >> i) & 1;
+        if (found) {
+            fp12_cyc_sqr(&acc, &acc);
+        } else {
+            found = bit;
+        }
+        if (bit) {
+            fp12_mul(&acc, &acc, a);
+        }
+    }
+    fp12_conj(r, &acc);
+}
+
+// Финальная экспонента (p^12 - 1) / r: простая часть (p^6 - 1)(p^2 + 1),
+// трудная часть - цепочка возведений в степень x
+static void bls_final_exponentiation(bls_fp12_t* r, const bls_fp12_t* f) {
+    bls_fp12_t t0, t1, t2, t3, t4, t5, t6;
+    
+    fp12_conj(&t0, f);
+    fp12_inv(&t1, f);
+    fp12_mul(&t2, &t0, &t1);
+    t1 = t2;
+    fp12_frob_n(&t2, &t2, 2);
+    fp12_mul(&t2, &t2, &t1);
+    
+    fp12_cyc_sqr(&t1, &t2);
+    fp12_conj(&t1, &t1);
+    fp12_cyc_exp(&t3, &t2);
+    fp12_cyc_sqr(&t4, &t3);
+    fp12_mul(&t5, &t1, &t3);
+    fp12_cyc_exp(&t1, &t5);
+    fp12_cyc_exp(&t0, &t1);
+    fp12_cyc_exp(&t6, &t0);
+    fp12_mul(&t6, &t6, &t4);
+    fp12_cyc_exp(&t4, &t6);
+    fp12_conj(&t5, &t5);
+    fp12_mul(&t5, &t5, &t2);
+    fp12_mul(&t4, &t4, &t5);
+    fp12_conj(&t5, &t2);
+    fp12_mul(&t1, &t1, &t2);
+    fp12_frob_n(&t1, &t1, 3);
+    fp12_mul(&t6, &t6, &t5);
+    fp12_frob(&t6, &t6);
+    fp12_mul(&t3, &t3, &t0);
+    fp12_frob_n(&t3, &t3, 2);
+    fp12_mul(&t3, &t3, &t1);
+    fp12_mul(&t3, &t3, &t6);
+    fp12_mul(r, &t3, &t4);
+}
+
+// Операции поля для общих шаблонов групп G1 (Fp) и G2 (Fp2)
+
+static inline void fe_add(bls_fp_t* r, const bls_fp_t* a, const bls_fp_t* b) { fp_add(r, a, b); }
+static inline void fe_sub(bls_fp_t* r, const bls_fp_t* a, const bls_fp_t* b) { fp_sub(r, a, b); }
+static inline void fe_mul(bls_fp_t* r, const bls_fp_t* a, const bls_fp_t* b) { fp_mul(r, a, b); }
+static inline void fe_sqr(bls_fp_t* r, const bls_fp_t* a) { fp_sqr(r, a); }
+static inline void fe_neg(bls_fp_t* r, const bls_fp_t* a) { fp_neg(r, a); }
+static inline void fe_inv(bls_fp_t* r, const bls_fp_t* a) { fp_inv(r, a); }
+static inline bool fe_is_zero(const bls_fp_t* a) { return fp_is_zero(a); }
+static inline bool fe_eq(const bls_fp_t* a, const bls_fp_t* b) { return fp_eq(a, b); }
+static inline void fe_set_one(bls_fp_t* r) { *r = g_bls_one; }
+
+static inline void fe_add(bls_fp2_t* r, const bls_fp2_t* a, const bls_fp2_t* b) { fp2_add(r, a, b); }
+static inline void fe_sub(bls_fp2_t* r, const bls_fp2_t* a, const bls_fp2_t* b) { fp2_sub(r, a, b); }
+static inline void fe_mul(bls_fp2_t* r, const bls_fp2_t* a, const bls_fp2_t* b) { fp2_mul(r, a, b); }
+static inline void fe_sqr(bls_fp2_t* r, const bls_fp2_t* a) { fp2_sqr(r, a); }
+static inline void fe_neg(bls_fp2_t* r, const bls_fp2_t* a) { fp2_neg(r, a); }
+static inline void fe_inv(bls_fp2_t* r, const bls_fp2_t* a) { fp2_inv(r, a); }
+static inline bool fe_is_zero(const bls_fp2_t* a) { return fp2_is_zero(a); }
+static inline bool fe_eq(const bls_fp2_t* a, const bls_fp2_t* b) { return fp2_eq(a, b); }
+
+static inline void fe_set_one(bls_fp2_t* r) {
+    r->c0 = g_bls_one;
+    memset(&r->c1, 0, sizeof(r->c1));
+}
+
+// Группы
+
+template <typename F>
+static inline bool point_is_infinity(const bls_point_t<F>* p) {
+    return fe_is_zero(&p->z);
+}
+
+template <typename F>
+static inline void point_set_infinity(bls_point_t<F>* r) {
+    memset(r, 0, sizeof(*r));
+    fe_set_one(&r->x);
+    fe_set_one(&r->y);
+}
+
+template <typename F>
+static inline void point_from_affine(bls_point_t<F>* r, const F* x, const F* y) {
+    r->x = *x;
+    r->y = *y;
+    fe_set_one(&r->z);
+}
+
+// Удвоение для a = 0 (dbl-2009-l)
+template <typename F>
+static void point_dbl(bls_point_t<F>* r, const bls_point_t<F>* p) {
+    if (point_is_infinity(p)) {
+        *r = *p;
+        return;
+    }
+    
+    F a, b, c, d, e, f, t;
+    fe_sqr(&a, &p->x);
+    fe_sqr(&b, &p->y);
+    fe_sqr(&c, &b);
+    
+    fe_add(&d, &p->x, &b);
+    fe_sqr(&d, &d);
+    fe_sub(&d, &d, &a);
+    fe_sub(&d, &d, &c);
+    fe_add(&d, &d, &d);
+    
+    fe_add(&e, &a, &a);
+    fe_add(&e, &e, &a);
+    fe_sqr(&f, &e);
+    
+    // z3 считается до перезаписи y, если r совпадает с p
+    fe_mul(&t, &p->y, &p->z);
+    fe_add(&r->z, &t, &t);
+    
+    fe_sub(&r->x, &f, &d);
+    fe_sub(&r->x, &r->x, &d);
+    
+    fe_add(&c, &c, &c);
+    fe_add(&c, &c, &c);
+    fe_add(&c, &c, &c);
+    fe_sub(&t, &d, &r->x);
+    fe_mul(&t, &e, &t);
+    fe_sub(&r->y, &t, &c);
+}
+
+// Сложение в якобиевых координатах (add-2007-bl)
+template <typename F>
+static void point_add(bls_point_t<F>* r, const bls_point_t<F>* p, const bls_point_t<F>* q) {
+    if (point_is_infinity(p)) {
+        *r = *q;
+        return;
+    }
+    if (point_is_infinity(q)) {
+        *r = *p;
+        return;
+    }
+    
+    F z1z1, z2z2, u1, u2, s1, s2, h, i, j, rr, v, t;
+    fe_sqr(&z1z1, &p->z);
+    fe_sqr(&z2z2, &q->z);
+    fe_mul(&u1, &p->x, &z2z2);
+    fe_mul(&u2, &q->x, &z1z1);
+    fe_mul(&s1, &p->y, &q->z);
+    fe_mul(&s1, &s1, &z2z2);
+    fe_mul(&s2, &q->y, &p->z);
+    fe_mul(&s2, &s2, &z1z1);
+    
+    fe_sub(&h, &u2, &u1);
+    fe_sub(&rr, &s2, &s1);
+    if (fe_is_zero(&h)) {
+        if (fe_is_zero(&rr)) {
+            point_dbl(r, p);
+        } else {
+            point_set_infinity(r);
+        }
+        return;
+    }
+    
+    fe_add(&i, &h, &h);
+    fe_sqr(&i, &i);
+    fe_mul(&j, &h, &i);
+    fe_add(&rr, &rr, &rr);
+    fe_mul(&v, &u1, &i);
+    
+    fe_add(&t, &p->z, &q->z);
+    fe_sqr(&t, &t);
+    fe_sub(&t, &t, &z1z1);
+    fe_sub(&t, &t, &z2z2);
+    fe_mul(&r->z, &t, &h);
+    
+    fe_sqr(&r->x, &rr);
+    fe_sub(&r->x, &r->x, &j);
+    fe_sub(&r->x, &r->x, &v);
+    fe_sub(&r->x, &r->x, &v);
+    
+    fe_sub(&t, &v, &r->x);
+    fe_mul(&t, &t, &rr);
+    fe_mul(&s1, &s1, &j);
+    fe_add(&s1, &s1, &s1);
+    fe_sub(&r->y, &t, &s1);
+}
+
+template <typename F>
+static inline void point_neg(bls_point_t<F>* r, const bls_point_t<F>* p) {
+    r->x = p->x;
+    fe_neg(&r->y, &p->y);
+    r->z = p->z;
+}
+
+// r = [k] p, скаляр - words слов little-endian
+template <typename F>
+static void point_mul(bls_point_t<F>* r, const bls_point_t<F>* p, const uint64_t* scalar,
+                      size_t words) {
+    bls_point_t<F> acc;
+    bls_point_t<F> base = *p;
+    point_set_infinity(&acc);
+    for (size_t i = words * 64; i-- > 0;) {
+        point_dbl(&acc, &acc);
+        if ((scalar[i / 64] >> (i % 64)) & 1) {
+            point_add(&acc, &acc, &base);
+        }
+    }
+    *r = acc;
+}
+
+// false для бесконечности
+template <typename F>
+static bool point_to_affine(F* x, F* y, const bls_point_t<F>* p) {
+    if (point_is_infinity(p)) {
+        return false;
+    }
+    
+    F z_inv, z_inv2;
+    fe_inv(&z_inv, &p->z);
+    fe_sqr(&z_inv2, &z_inv);
+    fe_mul(x, &p->x, &z_inv2);
+    fe_mul(&z_inv2, &z_inv2, &z_inv);
+    fe_mul(y, &p->y, &z_inv2);
+    return true;
+}
+
+// Равенство в якобиевых координатах без инверсий: X1 Z2^2 = X2 Z1^2,
+// Y1 Z2^3 = Y2 Z1^3
+template <typename F>
+static bool point_equal(const bls_point_t<F>* p, const bls_point_t<F>* q) {
+    if (point_is_infinity(p) || point_is_infinity(q)) {
+        return point_is_infinity(p) && point_is_infinity(q);
+    }
+    
+    F pz2, qz2, a, b;
+    fe_sqr(&pz2, &p->z);
+    fe_sqr(&qz2, &q->z);
+    fe_mul(&a, &p->x, &qz2);
+    fe_mul(&b, &q->x, &pz2);
+    if (!fe_eq(&a, &b)) {
+        return false;
+    }
+    fe_mul(&pz2, &pz2, &p->z);
+    fe_mul(&qz2, &qz2, &q->z);
+    fe_mul(&a, &p->y, &qz2);
+    fe_mul(&b, &q->y, &pz2);
+    return fe_eq(&a, &b);
+}
+
+// psi в якобиевых координатах: сопряжение коммутирует с делением на z^2 и z^3
+static void g2_psi(bls_g2_t* r, const bls_g2_t* p) {
+    fp2_conj(&r->x, &p->x);
+    fp2_mul(&r->x, &r->x, &g_bls_psi_c1);
+    fp2_conj(&r->y, &p->y);
+    fp2_mul(&r->y, &r->y, &g_bls_psi_c2);
+    fp2_conj(&r->z, &p->z);
+}
+
+static void g2_psi2(bls_g2_t* r, const bls_g2_t* p) {
+    fp2_mul_fp(&r->x, &p->x, &g_bls_psi2_c1);
+    fp2_neg(&r->y, &p->y);
+    r->z = p->z;
+}
+
+// [x] p для x = -BLS_X: 64 удвоения и 5 сложений
+static void g2_mul_by_x(bls_g2_t* r, const bls_g2_t* p) {
+    const uint64_t scalar = BLS_X;
+    point_mul(r, p, &scalar, 1);
+    point_neg(r, r);
+}
+
+// Проверки подгруппы через эндоморфизмы (Scott, eprint 2021/1130):
+// вместо [r] p - 255 удвоений - одно или два умножения на 64-битный x.
+// Точка E1 лежит в G1 тогда и только тогда, когда phi(p) = [-x^2] p
+static bool g1_in_subgroup(const bls_g1_t* p) {
+    const uint64_t scalar = BLS_X;
+    bls_g1_t t, phi;
+    point_mul(&t, p, &scalar, 1);
+    point_mul(&t, &t, &scalar, 1);
+    point_neg(&t, &t);
+    
+    phi = *p;
+    fp_mul(&phi.x, &p->x, &g_bls_g1_beta);
+    return point_equal(&phi, &t);
+}
+
+// Точка E2 лежит в G2 тогда и только тогда, когда psi(p) = [x] p
+static bool g2_in_subgroup(const bls_g2_t* p) {
+    bls_g2_t t, psi;
+    g2_mul_by_x(&t, p);
+    g2_psi(&psi, p);
+    return point_equal(&psi, &t);
+}
+
+// Мультискалярное умножение sum [k_i] P_i (Пиппенджер). Скаляры
+// разбиваются на окна по c бит со знаковыми цифрами из
+// [-2^(c-1), 2^(c-1)], поэтому корзин в окне 2^(c-1), а -P берется
+// бесплатно. Точки корзины складываются попарно деревом в аффинных
+// координатах: все пары всех корзин одного уровня используют одну
+// инверсию (трюк Монтгомери), сложение стоит около 6 умножений вместо
+// 11 в якобиевых. Окна независимы и при большом числе точек считаются в
+// нескольких потоках.
+
+#define BLS_MSM_MAX_WORDS 4             // Скаляры до 256 бит
+#define BLS_MSM_MAX_WINDOW 16
+#define BLS_MSM_AFFINE_MIN 256          // С этого числа точек корзины - аффинные
+#define BLS_MSM_THREAD_MIN 4096         // С этого числа точек окна - в потоках
+
+// Окно c минимизирует число сложений: окна * (точки + 2 * корзины)
+static size_t bls_msm_window_bits(size_t count, size_t scalar_bits) {
+    size_t best = 2;
+    uint64_t best_cost = UINT64_MAX;
+    for (size_t c = 2; c <= BLS_MSM_MAX_WINDOW; c++) {
+        uint64_t windows = (scalar_bits + 1 + c - 1) / c;
+        uint64_t cost = windows * ((uint64_t)count + ((uint64_t)1 << c));
+        if (cost < best_cost) {
+            best_cost = cost;
+            best = c;
+        }
+    }
+    return best;
+}
+
+// Знаковые цифры скаляра: digits[j] для окна j, перенос в следующее окно
+static void bls_msm_recode(int32_t* digits, const uint64_t* scalar, size_t words, size_t c,
+                           size_t windows) {
+    int32_t carry = 0;
+    for (size_t j = 0; j < windows; j++) {
+        size_t bit = j * c;
+        uint64_t value = 0;
+        if (bit < words * 64) {
+            value = scalar[bit / 64] >> (bit % 64);
+            if (bit % 64 + c > 64 && bit / 64 + 1 < words) {
+                value |= scalar[bit / 64 + 1] << (64 - bit % 64);
+            }
+        }
+        int32_t digit = (int32_t)(value & (((uint64_t)1 << c) - 1)) + carry;
+        carry = digit > (1 << (c - 1));
+        digits[j] = carry ? digit - (1 << c) : digit;
+    }
+}
+
+// Элемент корзины при аффинном сложении
+template <typename F>
+struct bls_msm_entry_t {
+    F x, y;
+    bool infinity;
+};
+
+// Пара элементов корзины на уровне дерева
+typedef struct {
+    uint32_t dst;
+    uint32_t src;                       // Складываются src и src + 1
+    uint8_t kind;
+} bls_msm_pair_t;
+
+#define BLS_MSM_PAIR_ADD 0
+#define BLS_MSM_PAIR_DBL 1
+#define BLS_MSM_PAIR_COPY 2             // Одно из слагаемых - бесконечность
+#define BLS_MSM_PAIR_INFINITY 3         // P + (-P)
+
+// r_i = 1 / a_i одной инверсией; все a_i ненулевые
+template <typename F>
+static void fe_batch_inv(F* r, const F* a, size_t count) {
+    if (count == 0) {
+        return;
+    }
+    
+    std::vector<F> prefix(count);
+    prefix[0] = a[0];
+    for (size_t i = 1; i < count; i++) {
+        fe_mul(&prefix[i], &prefix[i - 1], &a[i]);
+    }
+    F inv;
+    fe_inv(&inv, &prefix[count - 1]);
+    for (size_t i = count; i-- > 1;) {
+        F t;
+        fe_mul(&t, &inv, &prefix[i - 1]);
+        fe_mul(&inv, &inv, &a[i]);
+        r[i] = t;
+    }
+    r[0] = inv;
+}
+
+// Корзины окна в аффинных координатах: точки сортируются по корзинам,
+// затем уровни дерева сложений, пока в каждой корзине не останется
+// одна точка
+template <typename F>
+static void bls_msm_buckets_affine(bls_msm_entry_t<F>* buckets, const bls_affine_t<F>* points,
+                                   const int32_t* digits, size_t stride, size_t count,
+                                   size_t bucket_count) {
+    std::vector<uint32_t> start(bucket_count + 1, 0);
+    for (size_t i = 0; i < count; i++) {
+        int32_t digit = digits[i * stride];
+        if (digit != 0) {
+            start[(digit < 0 ? -digit : digit)]++;
+        }
+    }
+    for (size_t b = 1; b <= bucket_count; b++) {
+        start[b] += start[b - 1];
+    }
+    
+    // start[b] - начало корзины b + 1 (цифра b + 1), len[b] - число точек
+    std::vector<uint32_t> len(bucket_count, 0);
+    std::vector<bls_msm_entry_t<F> > work(start[bucket_count]);
+    for (size_t i = 0; i < count; i++) {
+        int32_t digit = digits[i * stride];
+        if (digit == 0) {
+            continue;
+        }
+        size_t b = (size_t)(digit < 0 ? -digit : digit) - 1;
+        bls_msm_entry_t<F>* entry = &work[start[b] + len[b]++];
+        entry->x = points[i].x;
+        if (digit < 0) {
+            fe_neg(&entry->y, &points[i].y);
+        } else {
+            entry->y = points[i].y;
+        }
+        entry->infinity = false;
+    }
+    
+    std::vector<bls_msm_pair_t> pairs;
+    std::vector<F> denominators;
+    for (;;) {
+        pairs.clear();
+        denominators.clear();
+        for (size_t b = 0; b < bucket_count; b++) {
+            for (uint32_t k = 0; 2 * k + 1 < len[b]; k++) {
+                bls_msm_pair_t pair;
+                pair.dst = start[b] + k;
+                pair.src = start[b] + 2 * k;
+                const bls_msm_entry_t<F>* p = &work[pair.src];
+                const bls_msm_entry_t<F>* q = &work[pair.src + 1];
+                F d;
+                if (p->infinity || q->infinity) {
+                    pair.kind = BLS_MSM_PAIR_COPY;
+                } else {
+                    fe_sub(&d, &q->x, &p->x);
+                    if (!fe_is_zero(&d)) {
+                        pair.kind = BLS_MSM_PAIR_ADD;
+                        denominators.push_back(d);
+                    } else if (fe_eq(&p->y, &q->y)) {
+                        pair.kind = BLS_MSM_PAIR_DBL;
+                        fe_add(&d, &p->y, &p->y);
+                        denominators.push_back(d);
+                    } else {
+                        pair.kind = BLS_MSM_PAIR_INFINITY;
+                    }
+                }
+                pairs.push_back(pair);
+            }
+        }
+        if (pairs.empty()) {
+            break;
+        }
+        
+        fe_batch_inv(denominators.empty() ? NULL : &denominators[0],
+                     denominators.empty() ? NULL : &denominators[0], denominators.size());
+        
+        // Запись в dst = start + k после чтения src = start + 2k, start + 2k + 1
+        size_t next = 0;
+        for (size_t i = 0; i < pairs.size(); i++) {
+            const bls_msm_entry_t<F> p = work[pairs[i].src];
+            const bls_msm_entry_t<F> q = work[pairs[i].src + 1];
+            bls_msm_entry_t<F>* r = &work[pairs[i].dst];
+            if (pairs[i].kind == BLS_MSM_PAIR_COPY) {
+                *r = p.infinity ? q : p;
+                continue;
+            }
+            if (pairs[i].kind == BLS_MSM_PAIR_INFINITY) {
+                r->infinity = true;
+                continue;
+            }
+            
+            // lambda = (y2 - y1) / (x2 - x1) или 3 x1^2 / (2 y1)
+            F lambda, t;
+            if (pairs[i].kind == BLS_MSM_PAIR_ADD) {
+                fe_sub(&lambda, &q.y, &p.y);
+            } else {
+                fe_sqr(&t, &p.x);
+                fe_add(&lambda, &t, &t);
+                fe_add(&lambda, &lambda, &t);
+            }
+            fe_mul(&lambda, &lambda, &denominators[next++]);
+            
+            fe_sqr(&t, &lambda);
+            fe_sub(&t, &t, &p.x);
+            fe_sub(&r->x, &t, &q.x);
+            fe_sub(&t, &p.x, &r->x);
+            fe_mul(&t, &t, &lambda);
+            fe_sub(&r->y, &t, &p.y);
+            r->infinity = false;
+        }
+        
+        // Непарный последний элемент переходит за результаты пар
+        for (size_t b = 0; b < bucket_count; b++) {
+            if (len[b] > 1) {
+                if (len[b] & 1) {
+                    work[start[b] + len[b] / 2] = work[start[b] + len[b] - 1];
+                }
+                len[b] = (len[b] + 1) / 2;
+            }
+        }
+    }
+    
+    for (size_t b = 0; b < bucket_count; b++) {
+        if (len[b] == 0) {
+            buckets[b].infinity = true;
+        } else {
+            buckets[b] = work[start[b]];
+        }
+    }
+}
+
+// Сумма окна: корзины b = 1..2^(c-1) с весом b через бегущую сумму
+template <typename F>
+static void bls_msm_window(bls_point_t<F>* r, const bls_affine_t<F>* points,
+                           const int32_t* digits, size_t stride, size_t count, size_t c) {
+    size_t bucket_count = (size_t)1 << (c - 1);
+    std::vector<bls_point_t<F> > buckets(bucket_count);
+    
+    if (count >= BLS_MSM_AFFINE_MIN) {
+        std::vector<bls_msm_entry_t<F> > affine(bucket_count);
+        bls_msm_buckets_affine(&affine[0], points, digits, stride, count, bucket_count);
+        for (size_t b = 0; b < bucket_count; b++) {
+            if (affine[b].infinity) {
+                point_set_infinity(&buckets[b]);
+            } else {
+                point_from_affine(&buckets[b], &affine[b].x, &affine[b].y);
+            }
+        }
+    } else {
+        for (size_t b = 0; b < bucket_count; b++) {
+            point_set_infinity(&buckets[b]);
+        }
+        for (size_t i = 0; i < count; i++) {
+            int32_t digit = digits[i * stride];
+            if (digit == 0) {
+                continue;
+            }
+            bls_point_t<F> p;
+            point_from_affine(&p, &points[i].x, &points[i].y);
+            if (digit < 0) {
+                point_neg(&p, &p);
+            }
+            bls_point_t<F>* bucket = &buckets[(size_t)(digit < 0 ? -digit : digit) - 1];
+            point_add(bucket, bucket, &p);
+        }
+    }
+    
+    bls_point_t<F> running;
+    point_set_infinity(&running);
+    point_set_infinity(r);
+    for (size_t b = bucket_count; b-- > 0;) {
+        point_add(&running, &running, &buckets[b]);
+        point_add(r, r, &running);
+    }
+}
+
+template <typename F>
+struct bls_msm_job_t {
+    const bls_affine_t<F>* points;
+    const int32_t* digits;
+    size_t count;
+    size_t c;
+    size_t windows;
+    size_t first;                       // Окна first, first + step, ...
+    size_t step;
+    bls_point_t<F>* results;
+};
+
+template <typename F>
+static void* bls_msm_worker(void* arg) {
+    const bls_msm_job_t<F>* job = (const bls_msm_job_t<F>*)arg;
+    for (size_t j = job->first; j < job->windows; j += job->step) {
+        bls_msm_window(&job->results[j], job->points, job->digits + j, job->windows,
+                       job->count, job->c);
+    }
+    return NULL;
+}
+
+// threads - число потоков по окнам, 1 - без потоков
+template <typename F>
+static void bls_msm(bls_point_t<F>* r, const bls_affine_t<F>* points, const uint64_t* scalars,
+                    size_t words, size_t count, size_t threads) {
+    point_set_infinity(r);
+    if (count == 0) {
+        return;
+    }
+    
+    size_t c = bls_msm_window_bits(count, words * 64);
+    size_t windows = (words * 64 + 1 + c - 1) / c;
+    std::vector<int32_t> digits(count * windows);
+    for (size_t i = 0; i < count; i++) {
+        bls_msm_recode(&digits[i * windows], scalars + i * words, words, c, windows);
+    }
+    
+    std::vector<bls_point_t<F> > results(windows);
+    if (threads > windows) {
+        threads = windows;
+    }
+    std::vector<bls_msm_job_t<F> > jobs(threads > 0 ? threads : 1);
+    std::vector<pthread_t> handles(jobs.size());
+    std::vector<bool> started(jobs.size(), false);
+    for (size_t t = 0; t < jobs.size(); t++) {
+        jobs[t].points = points;
+        jobs[t].digits = &digits[0];
+        jobs[t].count = count;
+        jobs[t].c = c;
+        jobs[t].windows = windows;
+        jobs[t].first = t;
+        jobs[t].step = jobs.size();
+        jobs[t].results = &results[0];
+        // Первая часть окон - в текущем потоке; если поток не создался,
+        // его окна тоже считаются здесь
+        if (t > 0) {
+            started[t] = pthread_create(&handles[t], NULL, bls_msm_worker<F>, &jobs[t]) == 0;
+        }
+    }
+    bls_msm_worker<F>(&jobs[0]);
+    for (size_t t = 1; t < jobs.size(); t++) {
+        if (started[t]) {
+            pthread_join(handles[t], NULL);
+        } else {
+            bls_msm_worker<F>(&jobs[t]);
+        }
+    }
+    
+    // Горнер по окнам: r = sum 2^(c j) W_j
+    for (size_t j = windows; j-- > 0;) {
+        for (size_t i = 0; i < c && j + 1 < windows; i++) {
+            point_dbl(r, r);
+        }
+        point_add(r, r, &results[j]);
+    }
+}
+
+// Потоки для окон: по числу online CPU при большом числе точек
+static size_t bls_msm_threads(size_t count) {
+    if (count < BLS_MSM_THREAD_MIN) {
+        return 1;
+    }
+    long cpu_count = sysconf(_SC_NPROCESSORS_ONLN);
+    return cpu_count > 1 ? (size_t)cpu_count : 1;
+}
+
+// Кодирование ZCash: старшие биты первого байта - сжатие, бесконечность
+// и знак y (лексикографически большее значение)
+#define BLS_FLAG_COMPRESSED 0x80
+#define BLS_FLAG_INFINITY 0x40
+#define BLS_FLAG_SIGN 0x20
+
+static bool bls_decode_infinity(const uint8_t* in, size_t size) {
+    if ((in[0] & ~BLS_FLAG_COMPRESSED) != BLS_FLAG_INFINITY) {
+        return false;
+    }
+    for (size_t i = 1; i < size; i++) {
+        if (in[i] != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Сжатая точка E1 (без проверки подгруппы)
+static bool g1_decode(bls_g1_t* r, const uint8_t* in) {
+    if (!(in[0] & BLS_FLAG_COMPRESSED)) {
+        return false;
+    }
+    if (in[0] & BLS_FLAG_INFINITY) {
+        if (!bls_decode_infinity(in, BLS_PUBLIC_KEY_SIZE)) {
+            return false;
+        }
+        point_set_infinity(r);
+        return true;
+    }
+    
+    uint8_t x_bytes[48];
+    memcpy(x_bytes, in, sizeof(x_bytes));
+    x_bytes[0] &= 0x1f;
+    
+    bls_fp_t x, y, rhs;
+    if (!fp_from_bytes(&x, x_bytes)) {
+        return false;
+    }
+    fp_sqr(&rhs, &x);
+    fp_mul(&rhs, &rhs, &x);
+    fp_add(&rhs, &rhs, &g_bls_g1_b);
+    if (!fp_sqrt(&y, &rhs)) {
+        return false;
+    }
+    
+    if (fp_is_lex_largest(&y) != ((in[0] & BLS_FLAG_SIGN) != 0)) {
+        fp_neg(&y, &y);
+    }
+    point_from_affine(r, &x, &y);
+    return true;
+}
+
+// Сжатая точка E2: x.c1 || x.c0 (без проверки подгруппы)
+static bool g2_decode(bls_g2_t* r, const uint8_t* in) {
+    if (!(in[0] & BLS_FLAG_COMPRESSED)) {
+        return false;
+    }
+    if (in[0] & BLS_FLAG_INFINITY) {
+        if (!bls_decode_infinity(in, BLS_SIGNATURE_SIZE)) {
+            return false;
+        }
+        point_set_infinity(r);
+        return true;
+    }
+    
+    uint8_t c1_bytes[48];
+    memcpy(c1_bytes, in, sizeof(c1_bytes));
+    c1_bytes[0] &= 0x1f;
+    
+    bls_fp2_t x, y, rhs;
+    if (!fp_from_bytes(&x.c1, c1_bytes) || !fp_from_bytes(&x.c0, in + 48)) {
+        return false;
+    }
+    fp2_sqr(&rhs, &x);
+    fp2_mul(&rhs, &rhs, &x);
+    fp2_add(&rhs, &rhs, &g_bls_g2_b);
+    if (!fp2_sqrt(&y, &rhs)) {
+        return false;
+    }
+    
+    if (fp2_is_lex_largest(&y) != ((in[0] & BLS_FLAG_SIGN) != 0)) {
+        fp2_neg(&y, &y);
+    }
+    point_from_affine(r, &x, &y);
+    return true;
+}
+
+static void g2_encode_affine(uint8_t* out, const bls_fp2_t* x, const bls_fp2_t* y) {
+    fp_to_bytes(out, &x->c1);
+    fp_to_bytes(out + 48, &x->c0);
+    out[0] |= BLS_FLAG_COMPRESSED;
+    if (fp2_is_lex_largest(y)) {
+        out[0] |= BLS_FLAG_SIGN;
+    }
+}
+
+static void g2_encode_infinity(uint8_t* out) {
+    memset(out, 0, BLS_SIGNATURE_SIZE);
+    out[0] = BLS_FLAG_COMPRESSED | BLS_FLAG_INFINITY;
+}
+
+static void g2_encode(uint8_t* out, const bls_g2_t* p) {
+    bls_fp2_t x, y;
+    if (!point_to_affine(&x, &y, p)) {
+        g2_encode_infinity(out);
+        return;
+    }
+    g2_encode_affine(out, &x, &y);
+}
+
+// Кодирование пачки точек: аффинные координаты через одну инверсию
+static void g2_encode_batch(uint8_t* out, const bls_g2_t* points, size_t count) {
+    std::vector<bls_fp2_t> z_inv;
+    z_inv.reserve(count);
+    for (size_t i = 0; i < count; i++) {
+        if (!point_is_infinity(&points[i])) {
+            z_inv.push_back(points[i].z);
+        }
+    }
+    fe_batch_inv(z_inv.empty() ? NULL : &z_inv[0], z_inv.empty() ? NULL : &z_inv[0],
+                 z_inv.size());
+    
+    for (size_t i = 0, next = 0; i < count; i++) {
+        if (point_is_infinity(&points[i])) {
+            g2_encode_infinity(out + i * BLS_SIGNATURE_SIZE);
+            continue;
+        }
+        bls_fp2_t x, y, t;
+        fp2_sqr(&t, &z_inv[next]);
+        fp2_mul(&x, &points[i].x, &t);
+        fp2_mul(&t, &t, &z_inv[next++]);
+        fp2_mul(&y, &points[i].y, &t);
+        g2_encode_affine(out + i * BLS_SIGNATURE_SIZE, &x, &y);
+    }
+}
+
+static void g1_encode(uint8_t* out, const bls_g1_t* p) {
+    bls_fp_t x, y;
+    if (!point_to_affine(&x, &y, p)) {
+        memset(out, 0, BLS_PUBLIC_KEY_SIZE);
+        out[0] = BLS_FLAG_COMPRESSED | BLS_FLAG_INFINITY;
+        return;
+    }
+    
+    fp_to_bytes(out, &x);
+    out[0] |= BLS_FLAG_COMPRESSED;
+    if (fp_is_lex_largest(&y)) {
+        out[0] |= BLS_FLAG_SIGN;
+    }
+}
+
+// Публичный ключ: точка G1 подгруппы r, не бесконечность
+static bool bls_decode_public_key(bls_g1_t* r, const uint8_t* public_key) {
+    return g1_decode(r, public_key) && !point_is_infinity(r) && g1_in_subgroup(r);
+}
+
+// Ключ через кеш распакованных ключей: распаковка и проверка подгруппы
+// выполняются один раз на ключ фермера. g1_decode возвращает z = 1,
+// поэтому аффинные координаты берутся без инверсии.
+static bool bls_decode_public_key_cached(bls_g1_t* r, const uint8_t* public_key) {
+    bls_public_key_t decoded;
+    if (bls_key_cache_lookup(public_key, &decoded)) {
+        memcpy(r->x.l, decoded.x, sizeof(decoded.x));
+        memcpy(r->y.l, decoded.y, sizeof(decoded.y));
+        r->z = g_bls_one;
+        return true;
+    }
+    
+    if (!bls_decode_public_key(r, public_key)) {
+        return false;
+    }
+    if (bls_key_cache_is_enabled()) {
+        memcpy(decoded.x, r->x.l, sizeof(decoded.x));
+        memcpy(decoded.y, r->y.l, sizeof(decoded.y));
+        bls_key_cache_store(public_key, &decoded);
+    }
+    return true;
+}
+
+static bool bls_decode_signature(bls_g2_t* r, const uint8_t* signature) {
+    return g2_decode(r, signature) && g2_in_subgroup(r);
+}
+
+// Спаривание: оптимальный ate для BLS12, точки G2 в якобиевых
+// координатах, коэффициенты линий по Costello, Lange, Naehrig (eprint
+// 2010/354, алгоритмы 26 и 27)
+
+static void miller_dbl(bls_g2_t* r, bls_fp2_t* coeffs) {
+    bls_fp2_t t0, t1, t2, t3, t4, t5, t6, zz;
+    fp2_sqr(&t0, &r->x);
+    fp2_sqr(&t1, &r->y);
+    fp2_sqr(&t2, &t1);
+    
+    fp2_add(&t3, &t1, &r->x);
+    fp2_sqr(&t3, &t3);
+    fp2_sub(&t3, &t3, &t0);
+    fp2_sub(&t3, &t3, &t2);
+    fp2_dbl(&t3, &t3);
+    
+    fp2_dbl(&t4, &t0);
+    fp2_add(&t4, &t4, &t0);
+    fp2_add(&t6, &r->x, &t4);
+    fp2_sqr(&t5, &t4);
+    fp2_sqr(&zz, &r->z);
+    
+    fp2_sub(&r->x, &t5, &t3);
+    fp2_sub(&r->x, &r->x, &t3);
+    fp2_add(&r->z, &r->z, &r->y);
+    fp2_sqr(&r->z, &r->z);
+    fp2_sub(&r->z, &r->z, &t1);
+    fp2_sub(&r->z, &r->z, &zz);
+    fp2_sub(&r->y, &t3, &r->x);
+    fp2_mul(&r->y, &r->y, &t4);
+    fp2_dbl(&t2, &t2);
+    fp2_dbl(&t2, &t2);
+    fp2_dbl(&t2, &t2);
+    fp2_sub(&r->y, &r->y, &t2);
+    
+    fp2_mul(&t3, &t4, &zz);
+    fp2_dbl(&t3, &t3);
+    fp2_neg(&coeffs[1], &t3);
+    
+    fp2_sqr(&t6, &t6);
+    fp2_sub(&t6, &t6, &t0);
+    fp2_sub(&t6, &t6, &t5);
+    fp2_dbl(&t1, &t1);
+    fp2_dbl(&t1, &t1);
+    fp2_sub(&coeffs[2], &t6, &t1);
+    
+    fp2_mul(&t0, &r->z, &zz);
+    fp2_dbl(&coeffs[0], &t0);
+}
+
+static void miller_add(bls_g2_t* r, const bls_g2_affine_t* q, bls_fp2_t* coeffs) {
+    bls_fp2_t zz, yy, t0, t1, t2, t3, t4, t5, t6, t7, t8, t9, t10;
+    fp2_sqr(&zz, &r->z);
+    fp2_sqr(&yy, &q->y);
+    fp2_mul(&t0, &zz, &q->x);
+    
+    fp2_add(&t1, &q->y, &r->z);
+    fp2_sqr(&t1, &t1);
+    fp2_sub(&t1, &t1, &yy);
+    fp2_sub(&t1, &t1, &zz);
+    fp2_mul(&t1, &t1, &zz);
+    
+    fp2_sub(&t2, &t0, &r->x);
+    fp2_sqr(&t3, &t2);
+    fp2_dbl(&t4, &t3);
+    fp2_dbl(&t4, &t4);
+    fp2_mul(&t5, &t4, &t2);
+    fp2_sub(&t6, &t1, &r->y);
+    fp2_sub(&t6, &t6, &r->y);
+    fp2_mul(&t9, &t6, &q->x);
+    fp2_mul(&t7, &t4, &r->x);
+    
+    fp2_sqr(&r->x, &t6);
+    fp2_sub(&r->x, &r->x, &t5);
+    fp2_sub(&r->x, &r->x, &t7);
+    fp2_sub(&r->x, &r->x, &t7);
+    fp2_add(&r->z, &r->z, &t2);
+    fp2_sqr(&r->z, &r->z);
+    fp2_sub(&r->z, &r->z, &zz);
+    fp2_sub(&r->z, &r->z, &t3);
+    
+    fp2_add(&t10, &q->y, &r->z);
+    fp2_sub(&t8, &t7, &r->x);
+    fp2_mul(&t8, &t8, &t6);
+    fp2_mul(&t0, &r->y, &t5);
+    fp2_dbl(&t0, &t0);
+    fp2_sub(&r->y, &t8, &t0);
+    
+    fp2_sqr(&t10, &t10);
+    fp2_sub(&t10, &t10, &yy);
+    fp2_sqr(&t0, &r->z);
+    fp2_sub(&t10, &t10, &t0);
+    fp2_dbl(&t9, &t9);
+    fp2_sub(&coeffs[2], &t9, &t10);
+    fp2_dbl(&coeffs[0], &r->z);
+    fp2_neg(&t6, &t6);
+    fp2_dbl(&coeffs[1], &t6);
+}
+
+// Значение линии в точке p: коэффициенты c0 и c1 умножаются на y и x
+static void miller_ell(bls_fp12_t* f, const bls_fp2_t* coeffs, const bls_g1_affine_t* p) {
+    bls_fp2_t c0, c1;
+    fp2_mul_fp(&c0, &coeffs[0], &p->y);
+    fp2_mul_fp(&c1, &coeffs[1], &p->x);
+    fp12_mul_014(f, f, &coeffs[2], &c1, &c0);
+}
+
+// Произведение циклов Миллера по всем парам с общим возведением f в
+// квадрат. Пары с бесконечностью в спаривание не входят.
+static void bls_miller_loop(bls_fp12_t* f, const bls_g1_affine_t* ps, const bls_g2_affine_t* qs,
+                            size_t count) {
+    std::vector<bls_g2_t> rs(count);
+    for (size_t i = 0; i < count; i++) {
+        point_from_affine(&rs[i], &qs[i].x, &qs[i].y);
+    }
+    
+    fp12_set_one(f);
+    bls_fp2_t coeffs[3];
+    bool found = false;
+    for (int bit = 63; bit >= 0; bit--) {
+        bool set = ((BLS_X >> 1) >> bit) & 1;
+        if (!found) {
+            found = set;
+            continue;
+        }
+        
+        for (size_t i = 0; i < count; i++) {
+            miller_dbl(&rs[i], coeffs);
+            miller_ell(f, coeffs, &ps[i]);
+        }
+        if (set) {
+            for (size_t i = 0; i < count; i++) {
+                miller_add(&rs[i], &qs[i], coeffs);
+                miller_ell(f, coeffs, &ps[i]);
+            }
+        }
+        fp12_sqr(f, f);
+    }
+    for (size_t i = 0; i < count; i++) {
+        miller_dbl(&rs[i], coeffs);
+        miller_ell(f, coeffs, &ps[i]);
+    }
+    
+    // x < 0
+    fp12_conj(f, f);
+}
+
+// Проверка prod e(ps[i], qs[i]) == 1
+static bool bls_pairing_product_is_one(const bls_g1_affine_t* ps, const bls_g2_affine_t* qs,
+                                       size_t count) {
+    bls_fp12_t f;
+    bls_miller_loop(&f, ps, qs, count);
+    bls_final_exponentiation(&f, &f);
+    return fp12_is_one(&f);
+}
+
+// Хэширование в G2 (RFC 9380, BLS12381G2_XMD:SHA-256_SSWU_RO_)
+
+// expand_message_xmd с SHA-256; сообщение - prefix || message, чтобы
+// AugSchemeMPL не копировала публичный ключ и сообщение в один буфер
+static void bls_expand_message_xmd(const uint8_t* prefix, size_t prefix_len,
+                                   const uint8_t* message, size_t message_len,
+                                   const uint8_t* dst, size_t dst_len, uint8_t* out,
+                                   size_t out_len) {
+    static const uint8_t zero_pad[SHA256_CBLOCK] = {0};
+    uint8_t length_tail[3] = { (uint8_t)(out_len >> 8), (uint8_t)out_len, 0 };
+    uint8_t dst_len_byte = (uint8_t)dst_len;
+    
+    uint8_t b0[SHA256_DIGEST_LENGTH];
+    EVP_MD_CTX* ctx = EVP_MD_CTX_new();
+    EVP_DigestInit_ex(ctx, EVP_sha256(), NULL);
+    EVP_DigestUpdate(ctx, zero_pad, sizeof(zero_pad));
+    EVP_DigestUpdate(ctx, prefix, prefix_len);
+    EVP_DigestUpdate(ctx, message, message_len);
+    EVP_DigestUpdate(ctx, length_tail, sizeof(length_tail));
+    EVP_DigestUpdate(ctx, dst, dst_len);
+    EVP_DigestUpdate(ctx, &dst_len_byte, 1);
+    EVP_DigestFinal_ex(ctx, b0, NULL);
+    EVP_MD_CTX_free(ctx);
+    
+    // b_i = H((b0 xor b_(i-1)) || i || DST || len(DST)), b_0 xor - только для i > 1
+    uint8_t block[SHA256_DIGEST_LENGTH + 1 + 256];
+    uint8_t bi[SHA256_DIGEST_LENGTH] = {0};
+    for (size_t i = 1, offset = 0; offset < out_len; i++, offset += SHA256_DIGEST_LENGTH) {
+        for (size_t j = 0; j < SHA256_DIGEST_LENGTH; j++) {
+            block[j] = b0[j] ^ bi[j];
+        }
+        block[SHA256_DIGEST_LENGTH] = (uint8_t)i;
+        memcpy(block + SHA256_DIGEST_LENGTH + 1, dst, dst_len);
+        block[SHA256_DIGEST_LENGTH + 1 + dst_len] = dst_len_byte;
+        SHA256(block, SHA256_DIGEST_LENGTH + 2 + dst_len, bi);
+        
+        size_t chunk = out_len - offset < SHA256_DIGEST_LENGTH ? out_len - offset :
+                                                                 SHA256_DIGEST_LENGTH;
+        memcpy(out + offset, bi, chunk);
+    }
+}
+
+// expand_message_xmd для восьми сообщений на AVX2 (многобуферный SHA256,
+// по сообщению в полосе). Первый блок b0 - Z_pad из нулей, его состояние
+// постоянно. В блоках b_i от сообщения зависят только первые 33 байта,
+// остальные (хвост DST' и дополнение) общие для полос и шагов, их
+// расписание считается один раз.
+
+static const uint32_t g_bls_sha256_k[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+static const uint32_t g_bls_sha256_iv[8] = {
+    0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
+};
+
+// Состояние после блока Z_pad
+static const uint32_t g_bls_sha256_zpad_state[8] = {
+    0xda5698be, 0x17b9b469, 0x62335799, 0x779fbeca, 0x8ce5d491, 0xc0d26243, 0xbafef9ea, 0x1837a9d8
+};
+
+#define BLS_SHA256_LANES 8
+#define BLS_SHA256_BLOCK 64
+
+#define BLS_AVX2_ROTR(v, n) _mm256_or_si256(_mm256_srli_epi32(v, n), _mm256_slli_epi32(v, 32 - (n)))
+
+static inline uint32_t bls_load_be32(const uint8_t* p) {
+    uint32_t word;
+    memcpy(&word, p, sizeof(word));
+    return __builtin_bswap32(word);
+}
+
+static inline void bls_store_be64(uint8_t* p, uint64_t value) {
+    value = __builtin_bswap64(value);
+    memcpy(p, &value, sizeof(value));
+}
+
+// Расписание общего для всех полос блока: kw[t] = w[t] + k[t]
+static void bls_sha256_schedule_kw(const uint8_t* block, uint32_t* kw) {
+    uint32_t w[64];
+    for (int t = 0; t < 16; t++) {
+        w[t] = bls_load_be32(block + 4 * t);
+    }
+    for (int t = 16; t < 64; t++) {
+        uint32_t x = w[t - 15];
+        uint32_t y = w[t - 2];
+        uint32_t s0 = ((x >> 7) | (x << 25)) ^ ((x >> 18) | (x << 14)) ^ (x >> 3);
+        uint32_t s1 = ((y >> 17) | (y << 15)) ^ ((y >> 19) | (y << 13)) ^ (y >> 10);
+        w[t] = w[t - 16] + s0 + w[t - 7] + s1;
+    }
+    for (int t = 0; t < 64; t++) {
+        kw[t] = w[t] + g_bls_sha256_k[t];
+    }
+}
+
+__attribute__((target("avx2")))
+static inline void bls_sha256_rounds_avx2(__m256i* state, const __m256i* kw) {
+    __m256i a = state[0], b = state[1], c = state[2], d = state[3];
+    __m256i e = state[4], f = state[5], g = state[6], h = state[7];
+    
+    for (int t = 0; t < 64; t++) {
+        __m256i s1 = _mm256_xor_si256(_mm256_xor_si256(BLS_AVX2_ROTR(e, 6), BLS_AVX2_ROTR(e, 11)),
+                                      BLS_AVX2_ROTR(e, 25));
+        __m256i ch = _mm256_xor_si256(_mm256_and_si256(e, f), _mm256_andnot_si256(e, g));
+        __m256i t1 = _mm256_add_epi32(_mm256_add_epi32(h, s1), _mm256_add_epi32(ch, kw[t]));
+        __m256i s0 = _mm256_xor_si256(_mm256_xor_si256(BLS_AVX2_ROTR(a, 2), BLS_AVX2_ROTR(a, 13)),
+                                      BLS_AVX2_ROTR(a, 22));
+        __m256i maj = _mm256_or_si256(_mm256_and_si256(a, b), _mm256_and_si256(c, _mm256_or_si256(a, b)));
+        __m256i t2 = _mm256_add_epi32(s0, maj);
+        h = g;
+        g = f;
+        f = e;
+        e = _mm256_add_epi32(d, t1);
+        d = c;
+        c = b;
+        b = a;
+        a = _mm256_add_epi32(t1, t2);
+    }
+    
+    state[0] = _mm256_add_epi32(state[0], a);
+    state[1] = _mm256_add_epi32(state[1], b);
+    state[2] = _mm256_add_epi32(state[2], c);
+    state[3] = _mm256_add_epi32(state[3], d);
+    state[4] = _mm256_add_epi32(state[4], e);
+    state[5] = _mm256_add_epi32(state[5], f);
+    state[6] = _mm256_add_epi32(state[6], g);
+    state[7] = _mm256_add_epi32(state[7], h);
+}
+
+// Сжатие блока из слов w[0..15] каждой полосы; w расширяется на месте
+__attribute__((target("avx2")))
+static void bls_sha256_compress_avx2(__m256i* state, __m256i* w) {
+    for (int t = 16; t < 64; t++) {
+        __m256i x = w[t - 15];
+        __m256i y = w[t - 2];
+        __m256i s0 = _mm256_xor_si256(_mm256_xor_si256(BLS_AVX2_ROTR(x, 7), BLS_AVX2_ROTR(x, 18)),
+                                      _mm256_srli_epi32(x, 3));
+        __m256i s1 = _mm256_xor_si256(_mm256_xor_si256(BLS_AVX2_ROTR(y, 17), BLS_AVX2_ROTR(y, 19)),
+                                      _mm256_srli_epi32(y, 10));
+        w[t] = _mm256_add_epi32(_mm256_add_epi32(w[t - 16], s0), _mm256_add_epi32(w[t - 7], s1));
+    }
+    for (int t = 0; t < 64; t++) {
+        w[t] = _mm256_add_epi32(w[t], _mm256_set1_epi32((int)g_bls_sha256_k[t]));
+    }
+    bls_sha256_rounds_avx2(state, w);
+}
+
+// prefix || message (prefix_len байт префикса в каждой полосе или без
+// него), выход - BLS_HASH_G2_BYTES байт на сообщение
+__attribute__((target("avx2")))
+static void bls_expand_message_xmd_x8_avx2(const uint8_t* const* prefixes, size_t prefix_len,
+                                           const uint8_t* const* messages,
+                                           const size_t* message_lens, const uint8_t* dst,
+                                           size_t dst_len, uint8_t (*out)[BLS_HASH_G2_BYTES]) {
+    // b0 = H(Z_pad || prefix || msg || I2OSP(len, 2) || 0 || DST'): с
+    // состояния после Z_pad сжимаются блоки остатка, полосы с коротким
+    // сообщением после своего последнего блока не меняются
+    size_t blocks[BLS_SHA256_LANES];
+    size_t max_blocks = 0;
+    for (int lane = 0; lane < BLS_SHA256_LANES; lane++) {
+        size_t len = prefix_len + message_lens[lane] + 4 + dst_len;
+        blocks[lane] = (len + 9 + BLS_SHA256_BLOCK - 1) / BLS_SHA256_BLOCK;
+        if (blocks[lane] > max_blocks) {
+            max_blocks = blocks[lane];
+        }
+    }
+    
+    size_t stride = max_blocks * BLS_SHA256_BLOCK;
+    std::vector<uint8_t> padded(BLS_SHA256_LANES * stride, 0);
+    for (int lane = 0; lane < BLS_SHA256_LANES; lane++) {
+        uint8_t* p = &padded[lane * stride];
+        size_t len = 0;
+        if (prefix_len > 0) {
+            memcpy(p, prefixes[lane], prefix_len);
+            len += prefix_len;
+        }
+        if (message_lens[lane] > 0) {
+            memcpy(p + len, messages[lane], message_lens[lane]);
+            len += message_lens[lane];
+        }
+        p[len++] = (uint8_t)(BLS_HASH_G2_BYTES >> 8);
+        p[len++] = (uint8_t)BLS_HASH_G2_BYTES;
+        p[len++] = 0;
+        memcpy(p + len, dst, dst_len);
+        len += dst_len;
+        p[len++] = (uint8_t)dst_len;
+        p[len] = 0x80;
+        bls_store_be64(p + blocks[lane] * BLS_SHA256_BLOCK - 8,
+                       (uint64_t)(BLS_SHA256_BLOCK + len) * 8);
+    }
+    
+    __m256i b0[8];
+    __m256i w[64];
+    for (int i = 0; i < 8; i++) {
+        b0[i] = _mm256_set1_epi32((int)g_bls_sha256_zpad_state[i]);
+    }
+    for (size_t block = 0; block < max_blocks; block++) {
+        uint32_t active[BLS_SHA256_LANES];
+        for (int t = 0; t < 16; t++) {
+            uint32_t words[BLS_SHA256_LANES];
+            for (int lane = 0; lane < BLS_SHA256_LANES; lane++) {
+                words[lane] = bls_load_be32(&padded[lane * stride + block * BLS_SHA256_BLOCK + 4 * t]);
+            }
+            w[t] = _mm256_loadu_si256((const __m256i*)words);
+        }
+        for (int lane = 0; lane < BLS_SHA256_LANES; lane++) {
+            active[lane] = block < blocks[lane] ? 0xffffffff : 0;
+        }
+        
+        __m256i state[8];
+        memcpy(state, b0, sizeof(state));
+        bls_sha256_compress_avx2(state, w);
+        __m256i mask = _mm256_loadu_si256((const __m256i*)active);
+        for (int i = 0; i < 8; i++) {
+            b0[i] = _mm256_blendv_epi8(b0[i], state[i], mask);
+        }
+    }
+    
+    // b_i = H((b0 xor b_(i-1)) || i || DST'): первый блок собирается из
+    // слов состояния, хвост одинаков для всех полос
+    uint8_t tail[BLS_SHA256_BLOCK * 5];
+    size_t tail_len = SHA256_DIGEST_LENGTH + 1 + dst_len + 1;
+    size_t tail_blocks = (tail_len + 9 + BLS_SHA256_BLOCK - 1) / BLS_SHA256_BLOCK;
+    memset(tail, 0, sizeof(tail));
+    memcpy(tail + SHA256_DIGEST_LENGTH + 1, dst, dst_len);
+    tail[SHA256_DIGEST_LENGTH + 1 + dst_len] = (uint8_t)dst_len;
+    tail[tail_len] = 0x80;
+    bls_store_be64(tail + tail_blocks * BLS_SHA256_BLOCK - 8, (uint64_t)tail_len * 8);
+    
+    std::vector<uint32_t> tail_kw((tail_blocks - 1) * 64);
+    for (size_t block = 1; block < tail_blocks; block++) {
+        bls_sha256_schedule_kw(tail + block * BLS_SHA256_BLOCK, &tail_kw[(block - 1) * 64]);
+    }
+    
+    __m256i bi[8];
+    for (size_t i = 1, offset = 0; offset < BLS_HASH_G2_BYTES; i++, offset += SHA256_DIGEST_LENGTH) {
+        for (int t = 0; t < 8; t++) {
+            w[t] = i == 1 ? b0[t] : _mm256_xor_si256(b0[t], bi[t]);
+        }
+        tail[SHA256_DIGEST_LENGTH] = (uint8_t)i;
+        for (int t = 8; t < 16; t++) {
+            w[t] = _mm256_set1_epi32((int)bls_load_be32(tail + 4 * t));
+        }
+        
+        for (int t = 0; t < 8; t++) {
+            bi[t] = _mm256_set1_epi32((int)g_bls_sha256_iv[t]);
+        }
+        bls_sha256_compress_avx2(bi, w);
+        for (size_t block = 1; block < tail_blocks; block++) {
+            for (int t = 0; t < 64; t++) {
+                w[t] = _mm256_set1_epi32((int)tail_kw[(block - 1) * 64 + t]);
+            }
+            bls_sha256_rounds_avx2(bi, w);
+        }
+        
+        for (int t = 0; t < 8; t++) {
+            uint32_t words[BLS_SHA256_LANES];
+            _mm256_storeu_si256((__m256i*)words, bi[t]);
+            for (int lane = 0; lane < BLS_SHA256_LANES; lane++) {
+                uint32_t word = __builtin_bswap32(words[lane]);
+                memcpy(out[lane] + offset + 4 * t, &word, sizeof(word));
+            }
+        }
+    }
+}
+
+// Пачка сообщений: по восемь на AVX2, хвост пачки и процессоры без AVX2 -
+// по одному
+static void bls_expand_message_xmd_batch(const uint8_t* const* prefixes, size_t prefix_len,
+                                         const uint8_t* const* messages,
+                                         const size_t* message_lens, size_t count,
+                                         const uint8_t* dst, size_t dst_len,
+                                         uint8_t (*out)[BLS_HASH_G2_BYTES]) {
+    size_t i = 0;
+    if (__builtin_cpu_supports("avx2")) {
+        for (; i + BLS_SHA256_LANES <= count; i += BLS_SHA256_LANES) {
+            bls_expand_message_xmd_x8_avx2(prefix_len > 0 ? prefixes + i : NULL, prefix_len,
+                                           messages + i, message_lens + i, dst, dst_len, out + i);
+        }
+    }
+    for (; i < count; i++) {
+        bls_expand_message_xmd(prefix_len > 0 ? prefixes[i] : NULL, prefix_len, messages[i],
+                               message_lens[i], dst, dst_len, out[i], BLS_HASH_G2_BYTES);
+    }
+}
+
+// Simplified SWU на изогенной кривой E2': y^2 = x^3 + A' x + B'
+static void bls_map_to_curve_sswu(bls_fp2_t* x, bls_fp2_t* y, const bls_fp2_t* u) {
+    bls_fp2_t zu2, denom, x1, gx;
+    fp2_sqr(&zu2, u);
+    fp2_mul(&zu2, &zu2, &g_bls_sswu_z);
+    fp2_sqr(&denom, &zu2);
+    fp2_add(&denom, &denom, &zu2);
+    
+    // x1 = -B/A (1 + 1 / (Z^2 u^4 + Z u^2)), при нулевом знаменателе B / (Z A)
+    if (fp2_is_zero(&denom)) {
+        x1 = g_bls_sswu_b_div_za;
+    } else {
+        fp2_inv(&denom, &denom);
+        fp_add(&denom.c0, &denom.c0, &g_bls_one);
+        fp2_mul(&x1, &g_bls_sswu_minus_b_div_a, &denom);
+    }
+    
+    // gx = x^3 + A x + B; если для x1 корня нет, он есть для x2 = Z u^2 x1
+    for (int attempt = 0; attempt < 2; attempt++) {
+        fp2_sqr(&gx, &x1);
+        fp2_add(&gx, &gx, &g_bls_sswu_a);
+        fp2_mul(&gx, &gx, &x1);
+        fp2_add(&gx, &gx, &g_bls_sswu_b);
+        if (fp2_sqrt(y, &gx)) {
+            break;
+        }
+        fp2_mul(&x1, &x1, &zu2);
+    }
+    *x = x1;
+    
+    if (fp2_sgn0(u) != fp2_sgn0(y)) {
+        fp2_neg(y, y);
+    }
+}
+
+// Многочлен с коэффициентами от младшей степени, схема Горнера
+static void bls_iso_poly(bls_fp2_t* r, const bls_fp2_t* coeffs, size_t count,
+                         const bls_fp2_t* x) {
+    *r = coeffs[count - 1];
+    for (size_t i = count - 1; i-- > 0;) {
+        fp2_mul(r, r, x);
+        fp2_add(r, r, &coeffs[i]);
+    }
+}
+
+// 3-изогения E2' -> E2. Знаменатель x - моничный многочлен степени 2.
+static void bls_iso_map(bls_g2_t* r, const bls_fp2_t* x, const bls_fp2_t* y) {
+    bls_fp2_t x_num, x_den, y_num, y_den, t;
+    bls_iso_poly(&x_num, g_bls_iso_x_num, 4, x);
+    bls_iso_poly(&x_den, g_bls_iso_x_den, 3, x);
+    bls_iso_poly(&y_num, g_bls_iso_y_num, 4, x);
+    bls_iso_poly(&y_den, g_bls_iso_y_den, 4, x);
+    
+    // Якобиевы координаты без инверсий: z = x_den y_den,
+    // X = x_num x_den y_den^2, Y = y y_num x_den^3 y_den^2
+    fp2_mul(&r->z, &x_den, &y_den);
+    fp2_sqr(&t, &r->z);
+    fp2_mul(&r->x, &x_num, &y_den);
+    fp2_mul(&r->x, &r->x, &r->z);
+    fp2_mul(&r->y, &y_num, &t);
+    fp2_mul(&r->y, &r->y, &x_den);
+    fp2_mul(&r->y, &r->y, y);
+}
+
+// Очистка кофактора h_eff через эндоморфизм psi (Budroni, Pintore;
+// RFC 9380, G.3): h_eff P = [x^2 - x - 1] P + [x - 1] psi(P) + psi^2(2P).
+// Два умножения на 64-битный x вместо умножения на 636-битный h_eff.
+static void g2_clear_cofactor(bls_g2_t* r, const bls_g2_t* p) {
+    bls_g2_t t1, t2, t3, neg;
+    g2_mul_by_x(&t1, p);
+    g2_psi(&t2, p);
+    point_dbl(&t3, p);
+    g2_psi2(&t3, &t3);
+    
+    point_neg(&neg, &t2);
+    point_add(&t3, &t3, &neg);
+    point_add(&t2, &t1, &t2);
+    g2_mul_by_x(&t2, &t2);
+    point_add(&t3, &t3, &t2);
+    point_neg(&neg, &t1);
+    point_add(&t3, &t3, &neg);
+    point_neg(&neg, p);
+    point_add(r, &t3, &neg);
+}
+
+// Равномерные байты expand_message_xmd -> два элемента Fp2 -> SSWU и
+// изогения -> сумма в E2 с очисткой кофактора
+static void bls_map_uniform_to_g2(bls_g2_t* r, const uint8_t* uniform) {
+    bls_g2_t q[2];
+    for (int i = 0; i < 2; i++) {
+        bls_fp2_t u, x, y;
+        fp_from_bytes_wide(&u.c0, uniform + (2 * i) * BLS_HASH_FIELD_BYTES);
+        fp_from_bytes_wide(&u.c1, uniform + (2 * i + 1) * BLS_HASH_FIELD_BYTES);
+        bls_map_to_curve_sswu(&x, &y, &u);
+        bls_iso_map(&q[i], &x, &y);
+    }
+    
+    point_add(r, &q[0], &q[1]);
+    g2_clear_cofactor(r, r);
+}
+
+static void bls_hash_to_g2_point(bls_g2_t* r, const uint8_t* prefix, size_t prefix_len,
+                                 const uint8_t* message, size_t message_len,
+                                 const uint8_t* dst, size_t dst_len) {
+    uint8_t uniform[BLS_HASH_G2_BYTES];
+    bls_expand_message_xmd(prefix, prefix_len, message, message_len, dst, dst_len, uniform,
+                           sizeof(uniform));
+    bls_map_uniform_to_g2(r, uniform);
+}
+
+// Пачка: expand_message_xmd по восемь сообщений, затем отображение по одному
+static void bls_hash_to_g2_points(bls_g2_t* r, const uint8_t* const* prefixes,
+                                  size_t prefix_len, const uint8_t* const* messages,
+                                  const size_t* message_lens, size_t count,
+                                  const uint8_t* dst, size_t dst_len) {
+    std::vector<uint8_t> uniform(count * BLS_HASH_G2_BYTES);
+    uint8_t (*blocks)[BLS_HASH_G2_BYTES] = (uint8_t (*)[BLS_HASH_G2_BYTES])&uniform[0];
+    bls_expand_message_xmd_batch(prefixes, prefix_len, messages, message_lens, count, dst,
+                                 dst_len, blocks);
+    for (size_t i = 0; i < count; i++) {
+        bls_map_uniform_to_g2(&r[i], blocks[i]);
+    }
+}
+
+// AugSchemeMPL
+
+static const uint8_t g_bls_aug_dst[] = BLS_AUG_DST;
+#define BLS_AUG_DST_LEN (sizeof(g_bls_aug_dst) - 1)
+
+// Подпись, подготовленная к проверке: ключ, хэш сообщения и подпись в
+// аффинных координатах
+typedef struct {
+    bls_g1_t public_key;
+    bls_g2_affine_t message_hash;
+    bls_g2_t signature;
+} bls_prepared_t;
+
+static bool bls_prepare_points(bls_prepared_t* prepared, const uint8_t* public_key,
+                               const uint8_t* signature) {
+    return bls_decode_public_key_cached(&prepared->public_key, public_key) &&
+           bls_decode_signature(&prepared->signature, signature);
+}
+
+// Хэш в бесконечность не попадает с пренебрежимой вероятностью; такая
+// подпись просто не проходит проверку
+static bool bls_prepare_hash(bls_prepared_t* prepared, const bls_g2_t* hash) {
+    return point_to_affine(&prepared->message_hash.x, &prepared->message_hash.y, hash);
+}
+
+static bool bls_prepare(bls_prepared_t* prepared, const uint8_t* public_key,
+                        const uint8_t* message, size_t message_len, const uint8_t* signature) {
+    if (!bls_prepare_points(prepared, public_key, signature)) {
+        return false;
+    }
+    
+    bls_g2_t hash;
+    bls_hash_to_g2_point(&hash, public_key, BLS_PUBLIC_KEY_SIZE, message, message_len,
+                         g_bls_aug_dst, BLS_AUG_DST_LEN);
+    return bls_prepare_hash(prepared, &hash);
+}
+
+// Пара (-g1, sum) замыкает произведение спариваний
+static void bls_negated_generator(bls_g1_affine_t* r) {
+    r->x = g_bls_g1_x;
+    fp_neg(&r->y, &g_bls_g1_y);
+}
+
+// Проверка подмножества подписей с множителями scalars (NULL - без
+// множителей): prod e(r_i pk_i, H_i) * e(-g1, sum r_i sig_i) == 1
+static bool bls_verify_prepared(const bls_prepared_t* const* items, const uint64_t* scalars,
+                                size_t count) {
+    std::vector<bls_g1_affine_t> ps(count + 1);
+    std::vector<bls_g2_affine_t> qs(count + 1);
+    std::vector<bls_g2_affine_t> signatures;
+    std::vector<uint64_t> signature_scalars;
+    bls_g2_t sum;
+    point_set_infinity(&sum);
+    
+    for (size_t i = 0; i < count; i++) {
+        bls_g1_t public_key = items[i]->public_key;
+        if (scalars) {
+            point_mul(&public_key, &public_key, &scalars[i], 1);
+        }
+        point_to_affine(&ps[i].x, &ps[i].y, &public_key);
+        qs[i] = items[i]->message_hash;
+        
+        // g2_decode возвращает z = 1; бесконечность в сумму ничего не вносит
+        const bls_g2_t* signature = &items[i]->signature;
+        if (!scalars) {
+            point_add(&sum, &sum, signature);
+        } else if (!point_is_infinity(signature)) {
+            bls_g2_affine_t affine = { signature->x, signature->y };
+            signatures.push_back(affine);
+            signature_scalars.push_back(scalars[i]);
+        }
+    }
+    // sum r_i sig_i - мультискалярное умножение в G2
+    if (!signatures.empty()) {
+        bls_msm(&sum, &signatures[0], &signature_scalars[0], 1, signatures.size(),
+                bls_msm_threads(signatures.size()));
+    }
+    
+    // Сумма подписей - бесконечность: спаривание с ней равно 1
+    size_t pairs = count;
+    if (point_to_affine(&qs[count].x, &qs[count].y, &sum)) {
+        bls_negated_generator(&ps[count]);
+        pairs++;
+    }
+    return bls_pairing_product_is_one(&ps[0], &qs[0], pairs);
+}
+
+// Подпись [sk] H. На G2 psi = [x], поэтому при sk = sum d_i |x|^i
+// [sk] H = sum [d_i] B_i с B_i = (-psi)^i (H). Цифры d_i нечетные и
+// записаны разрядами +-1 (знаки - столбцы signer->comb), так что точка
+// столбца - +-(B_0 +- B_1 +- B_2 +- B_3) из таблицы в 8 точек без
+// бесконечности. Таблица просматривается целиком с маской, знак
+// применяется маской, поэтому время и доступы к памяти не зависят от ключа.
+static void bls_sign_point(bls_g2_t* r, const bls_signer_t* signer, const bls_g2_t* hash) {
+    bls_g2_t bases[BLS_SIGN_DIGITS];
+    bases[0] = *hash;
+    g2_psi(&bases[1], hash);
+    point_neg(&bases[1], &bases[1]);
+    g2_psi2(&bases[2], hash);
+    g2_psi(&bases[3], &bases[2]);
+    point_neg(&bases[3], &bases[3]);
+    
+    // table[m] = B_0 + sum (бит i-1 индекса m ? B_i : -B_i) - от сообщения,
+    // не от ключа, ветвления здесь допустимы
+    const int table_size = 1 << (BLS_SIGN_DIGITS - 1);
+    bls_g2_t table[1 << (BLS_SIGN_DIGITS - 1)];
+    bls_g2_t twice[BLS_SIGN_DIGITS];
+    table[0] = bases[0];
+    for (int d = 1; d < BLS_SIGN_DIGITS; d++) {
+        bls_g2_t negated;
+        point_neg(&negated, &bases[d]);
+        point_add(&table[0], &table[0], &negated);
+        point_dbl(&twice[d], &bases[d]);
+    }
+    for (int index = 1; index < table_size; index++) {
+        int top = 31 - __builtin_clz(index);
+        point_add(&table[index], &table[index ^ (1 << top)], &twice[top + 1]);
+    }
+    
+    const size_t words = sizeof(bls_g2_t) / sizeof(uint64_t);
+    for (int column = BLS_SIGN_COMB_COLUMNS; column-- > 0;) {
+        // Знак B_0 отрицательный: берется -table[~m]
+        uint64_t bits = signer->comb[column];
+        uint64_t negative = (bits & 1) - 1;
+        uint64_t index = ((bits >> 1) ^ negative) & (uint64_t)(table_size - 1);
+        
+        bls_g2_t point;
+        uint64_t* out = (uint64_t*)&point;
+        memset(&point, 0, sizeof(point));
+        for (int entry = 0; entry < table_size; entry++) {
+            uint64_t mask = 0 - (((index ^ (uint64_t)entry) - 1) >> 63);
+            const uint64_t* in = (const uint64_t*)&table[entry];
+            for (size_t w = 0; w < words; w++) {
+                out[w] |= in[w] & mask;
+            }
+        }
+        
+        bls_fp2_t negated_y;
+        fp2_neg(&negated_y, &point.y);
+        uint64_t* y = (uint64_t*)&point.y;
+        const uint64_t* n = (const uint64_t*)&negated_y;
+        for (size_t w = 0; w < sizeof(bls_fp2_t) / sizeof(uint64_t); w++) {
+            y[w] ^= (y[w] ^ n[w]) & negative;
+        }
+        
+        // Промежуточные суммы не бывают бесконечностью или равными точке
+        // столбца, кроме пренебрежимо редких ключей: ветви point_add не
+        // срабатывают, а результат верен в любом случае
+        if (column == BLS_SIGN_COMB_COLUMNS - 1) {
+            *r = point;
+        } else {
+            point_dbl(r, r);
+            point_add(r, r, &point);
+        }
+    }
+    memset(table, 0, sizeof(table));
+}
+
+// Пачка подписей: сообщения [first, count) с шагом step
+typedef struct {
+    const bls_signer_t* signer;
+    const uint8_t (*uniform)[BLS_HASH_G2_BYTES];
+    bls_g2_t* signatures;
+    size_t count;
+    size_t first;
+    size_t step;
+} bls_sign_job_t;
+
+static void* bls_sign_worker(void* arg) {
+    const bls_sign_job_t* job = (const bls_sign_job_t*)arg;
+    for (size_t i = job->first; i < job->count; i += job->step) {
+        bls_g2_t hash;
+        bls_map_uniform_to_g2(&hash, job->uniform[i]);
+        bls_sign_point(&job->signatures[i], job->signer, &hash);
+    }
+    return NULL;
+}
+
+// Пачка не прошла: делим пополам, пока не останутся отдельные подписи
+static void bls_verify_bisect(const bls_prepared_t* const* items, const uint64_t* scalars,
+                              const size_t* indices, size_t count, bool* results) {
+    if (count == 1) {
+        results[indices[0]] = bls_verify_prepared(items, NULL, 1);
+        return;
+    }
+    if (bls_verify_prepared(items, scalars, count)) {
+        for (size_t i = 0; i < count; i++) {
+            results[indices[i]] = true;
+        }
+        return;
+    }
+    
+    size_t half = count / 2;
+    bls_verify_bisect(items, scalars, indices, half, results);
+    bls_verify_bisect(items + half, scalars + half, indices + half, count - half, results);
+}
+
+bool bls_public_key_is_valid(const uint8_t* public_key) {
+    pthread_once(&g_bls_fp_once, bls_fp_detect_impl);
+    if (!public_key) {
+        return false;
+    }
+    
+    bls_g1_t point;
+    return bls_decode_public_key_cached(&point, public_key);
+}
+
+bool bls_public_key_decode(const uint8_t* public_key, bls_public_key_t* decoded) {
+    pthread_once(&g_bls_fp_once, bls_fp_detect_impl);
+    if (!public_key || !decoded) {
+        return false;
+    }
+    
+    bls_g1_t point;
+    if (!bls_decode_public_key(&point, public_key)) {
+        return false;
+    }
+    memcpy(decoded->x, point.x.l, sizeof(decoded->x));
+    memcpy(decoded->y, point.y.l, sizeof(decoded->y));
+    return true;
+}
+
+bool bls_signature_is_valid(const uint8_t* signature) {
+    pthread_once(&g_bls_fp_once, bls_fp_detect_impl);
+    if (!signature) {
+        return false;
+    }
+    
+    bls_g2_t point;
+    return bls_decode_signature(&point, signature);
+}
+
+bool bls_hash_to_g2(const uint8_t* message, size_t message_len, const uint8_t* dst,
+                    size_t dst_len, uint8_t* out) {
+    if ((!message && message_len > 0) || !dst || dst_len == 0 || dst_len > 255 || !out) {
+        bls_log("ERROR", "Невалидные параметры для хэширования в G2");
+        return false;
+    }
+    pthread_once(&g_bls_fp_once, bls_fp_detect_impl);
+    
+    bls_g2_t point;
+    bls_hash_to_g2_point(&point, NULL, 0, message, message_len, dst, dst_len);
+    g2_encode(out, &point);
+    return true;
+}
+
+bool bls_hash_to_g2_batch(const uint8_t* const* messages, const size_t* message_lens,
+                          size_t count, const uint8_t* dst, size_t dst_len, uint8_t* out) {
+    if (!messages || !message_lens || !dst || dst_len == 0 || dst_len > 255 || !out) {
+        bls_log("ERROR", "Невалидные параметры для пакетного хэширования в G2");
+        return false;
+    }
+    for (size_t i = 0; i < count; i++) {
+        if (!messages[i] && message_lens[i] > 0) {
+            bls_log("ERROR", "Невалидные параметры для пакетного хэширования в G2");
+            return false;
+        }
+    }
+    if (count == 0) {
+        return true;
+    }
+    pthread_once(&g_bls_fp_once, bls_fp_detect_impl);
+    
+    std::vector<bls_g2_t> points(count);
+    bls_hash_to_g2_points(&points[0], NULL, 0, messages, message_lens, count, dst, dst_len);
+    for (size_t i = 0; i < count; i++) {
+        g2_encode(out + i * BLS_SIGNATURE_SIZE, &points[i]);
+    }
+    return true;
+}
+
+bool bls_verify(const uint8_t* public_key, const uint8_t* message, size_t message_len,
+                const uint8_t* signature) {
+    if (!public_key || (!message && message_len > 0) || !signature) {
+        bls_log("ERROR", "Невалидные параметры для проверки BLS подписи");
+        return false;
+    }
+    pthread_once(&g_bls_fp_once, bls_fp_detect_impl);
+    
+    bls_prepared_t prepared;
+    if (!bls_prepare(&prepared, public_key, message, message_len, signature)) {
+        return false;
+    }
+    
+    const bls_prepared_t* item = &prepared;
+    return bls_verify_prepared(&item, NULL, 1);
+}
+
+void bls_verify_batch(const uint8_t* const* public_keys, const uint8_t* const* messages,
+                      const size_t* message_lens, const uint8_t* const* signatures,
+                      size_t count, bool* results) {
+    if (!public_keys || !messages || !message_lens || !signatures || !results) {
+        bls_log("ERROR", "Невалидные параметры для пакетной проверки BLS подписей");
+        return;
+    }
+    pthread_once(&g_bls_fp_once, bls_fp_detect_impl);
+    
+    // Некорректные ключи и подписи отклоняются сразу и в пачку не входят
+    std::vector<bls_prepared_t> prepared(count);
+    std::vector<size_t> decoded;
+    std::vector<const uint8_t*> hash_keys;
+    std::vector<const uint8_t*> hash_messages;
+    std::vector<size_t> hash_lens;
+    decoded.reserve(count);
+    for (size_t i = 0; i < count; i++) {
+        results[i] = false;
+        if (!public_keys[i] || (!messages[i] && message_lens[i] > 0) || !signatures[i]) {
+            continue;
+        }
+        if (bls_prepare_points(&prepared[i], public_keys[i], signatures[i])) {
+            decoded.push_back(i);
+            hash_keys.push_back(public_keys[i]);
+            hash_messages.push_back(messages[i]);
+            hash_lens.push_back(message_lens[i]);
+        }
+    }
+    if (decoded.empty()) {
+        return;
+    }
+    
+    // Хэши pk_i || m_i всей пачки: expand_message_xmd на многобуферном SHA256
+    std::vector<bls_g2_t> hashes(decoded.size());
+    bls_hash_to_g2_points(&hashes[0], &hash_keys[0], BLS_PUBLIC_KEY_SIZE, &hash_messages[0],
+                          &hash_lens[0], decoded.size(), g_bls_aug_dst, BLS_AUG_DST_LEN);
+    
+    std::vector<const bls_prepared_t*> items;
+    std::vector<size_t> indices;
+    items.reserve(decoded.size());
+    indices.reserve(decoded.size());
+    for (size_t j = 0; j < decoded.size(); j++) {
+        if (bls_prepare_hash(&prepared[decoded[j]], &hashes[j])) {
+            items.push_back(&prepared[decoded[j]]);
+            indices.push_back(decoded[j]);
+        }
+    }
+    if (items.empty()) {
+        return;
+    }
+    
+    // Случайные ненулевые множители не известны отправителям, поэтому
+    // неверные подписи не могут компенсировать друг друга
+    std::vector<uint64_t> scalars(items.size());
+    if (RAND_bytes((uint8_t*)&scalars[0], (int)(scalars.size() * sizeof(uint64_t))) != 1) {
+        bls_log("WARNING", "RAND_bytes недоступен, подписи проверяются по одной");
+        for (size_t i = 0; i < items.size(); i++) {
+            results[indices[i]] = bls_verify_prepared(&items[i], NULL, 1);
+        }
+        return;
+    }
+    for (size_t i = 0; i < scalars.size(); i++) {
+        scalars[i] |= 1;
+    }
+    
+    bls_verify_bisect(&items[0], &scalars[0], &indices[0], items.size(), results);
+}
+
+bool bls_g1_multiexp(const bls_public_key_t* points, const uint64_t* scalars,
+                     size_t scalar_words, size_t count, uint8_t* out) {
+    if ((count > 0 && (!points || !scalars)) || scalar_words == 0 ||
+        scalar_words > BLS_MSM_MAX_WORDS || !out) {
+        bls_log("ERROR", "Невалидные параметры для мультиэкспоненцирования G1");
+        return false;
+    }
+    pthread_once(&g_bls_fp_once, bls_fp_detect_impl);
+    
+    std::vector<bls_g1_affine_t> affine(count);
+    for (size_t i = 0; i < count; i++) {
+        memcpy(affine[i].x.l, points[i].x, sizeof(points[i].x));
+        memcpy(affine[i].y.l, points[i].y, sizeof(points[i].y));
+    }
+    
+    bls_g1_t sum;
+    bls_msm(&sum, count > 0 ? &affine[0] : NULL, scalars, scalar_words, count,
+            bls_msm_threads(count));
+    g1_encode(out, &sum);
+    return true;
+}
+
+bool bls_signer_init(bls_signer_t* signer, const uint8_t* private_key) {
+    if (!signer || !private_key) {
+        bls_log("ERROR", "Невалидные параметры для ключа подписи BLS");
+        return false;
+    }
+    pthread_once(&g_bls_fp_once, bls_fp_detect_impl);
+    
+    // Секретный ключ - 32 байта big-endian, меньше r
+    uint64_t secret[4];
+    for (int i = 0; i < 4; i++) {
+        uint64_t word;
+        memcpy(&word, private_key + 24 - 8 * i, sizeof(word));
+        secret[i] = __builtin_bswap64(word);
+    }
+    int i = 3;
+    while (i > 0 && secret[i] == g_bls_r[i]) {
+        i--;
+    }
+    if (secret[i] >= g_bls_r[i]) {
+        memset(secret, 0, sizeof(secret));
+        bls_log("ERROR", "Секретный ключ BLS не меньше порядка подгруппы");
+        return false;
+    }
+    // Нулевой ключ подписывал бы бесконечностью любое сообщение
+    if ((secret[0] | secret[1] | secret[2] | secret[3]) == 0) {
+        bls_log("ERROR", "Секретный ключ BLS не может быть нулевым");
+        return false;
+    }
+    
+    bls_g1_t generator, public_key;
+    point_from_affine(&generator, &g_bls_g1_x, &g_bls_g1_y);
+    point_mul(&public_key, &generator, secret, 4);
+    g1_encode(signer->public_key, &public_key);
+    
+    // Знаковая гребенка: d_i = 2 e_i - (2^64 - 1) - сумма разрядов +-1 по
+    // битам e_i, тогда sum d_i |x|^i = sk при e = (sk + offset) / 2 mod r.
+    // Приведения - маской, без ветвлений по ключу.
+    uint64_t reduced[4];
+    uint64_t carry = 0;
+    for (int i = 0; i < 4; i++) {
+        unsigned __int128 sum = (unsigned __int128)secret[i] + g_bls_sign_offset[i] + carry;
+        secret[i] = (uint64_t)sum;
+        carry = (uint64_t)(sum >> 64);
+    }
+    uint64_t borrow = 0;
+    for (int i = 0; i < 4; i++) {
+        unsigned __int128 d = (unsigned __int128)secret[i] - g_bls_r[i] - borrow;
+        reduced[i] = (uint64_t)d;
+        borrow = (uint64_t)(d >> 64) & 1;
+    }
+    // Сумма < 2r < 2^256: заем без переноса - сумма меньше r
+    uint64_t keep = 0 - (borrow & (carry ^ 1));
+    for (int i = 0; i < 4; i++) {
+        secret[i] = (secret[i] & keep) | (reduced[i] & ~keep);
+    }
+    
+    // Деление на 2 по модулю нечетного r: к нечетному прибавляется r
+    uint64_t odd = 0 - (secret[0] & 1);
+    carry = 0;
+    for (int i = 0; i < 4; i++) {
+        unsigned __int128 sum = (unsigned __int128)secret[i] + (g_bls_r[i] & odd) + carry;
+        secret[i] = (uint64_t)sum;
+        carry = (uint64_t)(sum >> 64);
+    }
+    for (int i = 0; i < 4; i++) {
+        secret[i] = (secret[i] >> 1) | (i < 3 ? secret[i + 1] << 63 : carry << 63);
+    }
+    memset(reduced, 0, sizeof(reduced));
+    
+    // Цифры e по основанию |x|: e < r < |x|^4
+    uint64_t digits[BLS_SIGN_DIGITS];
+    for (int d = 0; d < BLS_SIGN_DIGITS; d++) {
+        unsigned __int128 remainder = 0;
+        for (int i = 3; i >= 0; i--) {
+            unsigned __int128 value = (remainder << 64) | secret[i];
+            secret[i] = (uint64_t)(value / BLS_X);
+            remainder = value % BLS_X;
+        }
+        digits[d] = (uint64_t)remainder;
+    }
+    
+    for (int column = 0; column < BLS_SIGN_COMB_COLUMNS; column++) {
+        uint8_t index = 0;
+        for (int d = 0; d < BLS_SIGN_DIGITS; d++) {
+            index |= (uint8_t)(((digits[d] >> column) & 1) << d);
+        }
+        signer->comb[column] = index;
+    }
+    memset(secret, 0, sizeof(secret));
+    memset(digits, 0, sizeof(digits));
+    return true;
+}
+
+bool bls_sign(const bls_signer_t* signer, const uint8_t* message, size_t message_len,
+              uint8_t* signature) {
+    if (!signer || (!message && message_len > 0) || !signature) {
+        bls_log("ERROR", "Невалидные параметры для BLS подписи");
+        return false;
+    }
+    pthread_once(&g_bls_fp_once, bls_fp_detect_impl);
+    
+    bls_g2_t hash, point;
+    bls_hash_to_g2_point(&hash, signer->public_key, BLS_PUBLIC_KEY_SIZE, message, message_len,
+                         g_bls_aug_dst, BLS_AUG_DST_LEN);
+    bls_sign_point(&point, signer, &hash);
+    g2_encode(signature, &point);
+    return true;
+}
+
+bool bls_sign_batch(const bls_signer_t* signer, const uint8_t* const* messages,
+                    const size_t* message_lens, size_t count, uint8_t* signatures) {
+    if (!signer || !messages || !message_lens || !signatures) {
+        bls_log("ERROR", "Невалидные параметры для пакетной BLS подписи");
+        return false;
+    }
+    for (size_t i = 0; i < count; i++) {
+        if (!messages[i] && message_lens[i] > 0) {
+            bls_log("ERROR", "Невалидные параметры для пакетной BLS подписи");
+            return false;
+        }
+    }
+    if (count == 0) {
+        return true;
+    }
+    pthread_once(&g_bls_fp_once, bls_fp_detect_impl);
+    
+    std::vector<const uint8_t*> prefixes(count, signer->public_key);
+    std::vector<uint8_t> uniform(count * BLS_HASH_G2_BYTES);
+    uint8_t (*blocks)[BLS_HASH_G2_BYTES] = (uint8_t (*)[BLS_HASH_G2_BYTES])&uniform[0];
+    bls_expand_message_xmd_batch(&prefixes[0], BLS_PUBLIC_KEY_SIZE, messages, message_lens,
+                                 count, g_bls_aug_dst, BLS_AUG_DST_LEN, blocks);
+    
+    // Отображение в G2 и гребенка - независимо по сообщениям
+    size_t threads = 1;
+    if (count >= BLS_SIGN_THREAD_MIN) {
+        long cpu_count = sysconf(_SC_NPROCESSORS_ONLN);
+        threads = cpu_count > 1 ? (size_t)cpu_count : 1;
+        if (threads > count / (BLS_SIGN_THREAD_MIN / 2)) {
+            threads = count / (BLS_SIGN_THREAD_MIN / 2);
+        }
+    }
+    
+    std::vector<bls_g2_t> points(count);
+    std::vector<bls_sign_job_t> jobs(threads);
+    std::vector<pthread_t> handles(threads);
+    std::vector<bool> started(threads, false);
+    for (size_t t = 0; t < threads; t++) {
+        jobs[t].signer = signer;
+        jobs[t].uniform = blocks;
+        jobs[t].signatures = &points[0];
+        jobs[t].count = count;
+        jobs[t].first = t;
+        jobs[t].step = threads;
+        if (t > 0) {
+            started[t] = pthread_create(&handles[t], NULL, bls_sign_worker, &jobs[t]) == 0;
+        }
+    }
+    bls_sign_worker(&jobs[0]);
+    for (size_t t = 1; t < threads; t++) {
+        if (started[t]) {
+            pthread_join(handles[t], NULL);
+        } else {
+            bls_sign_worker(&jobs[t]);
+        }
+    }
+    
+    g2_encode_batch(signatures, &points[0], count);
+    return true;
+}
+
+bls_fp_impl_t bls_fp_best_impl(void) {
+    pthread_once(&g_bls_fp_once, bls_fp_detect_impl);
+    return g_bls_fp_best_impl;
+}
+
+bls_fp_impl_t bls_fp_get_impl(void) {
+    pthread_once(&g_bls_fp_once, bls_fp_detect_impl);
+    return __atomic_load_n(&g_bls_fp_impl, __ATOMIC_RELAXED);
+}
+
+bool bls_fp_set_impl(bls_fp_impl_t impl) {
+    if (impl > bls_fp_best_impl()) {
+        char log_msg[128];
+        snprintf(log_msg, sizeof(log_msg), "Реализация Fp %s не поддерживается процессором",
+                 bls_fp_impl_name(impl));
+        bls_log("WARNING", log_msg);
+        return false;
+    }
+    
+    __atomic_store_n(&g_bls_fp_impl, impl, __ATOMIC_RELAXED);
+    return true;
+}
+
+const char* bls_fp_impl_name(bls_fp_impl_t impl) {
+    switch (impl) {
+        case BLS_FP_PORTABLE: return "portable";
+        case BLS_FP_MULX: return "mulx";
+    }
+    return "unknown";
+}
+
+void bls_fp_mont_mul(uint64_t* r, const uint64_t* a, const uint64_t* b) {
+    pthread_once(&g_bls_fp_once, bls_fp_detect_impl);
+    bls_fp_t x, y, z;
+    memcpy(x.l, a, sizeof(x.l));
+    memcpy(y.l, b, sizeof(y.l));
+    fp_mul(&z, &x, &y);
+    memcpy(r, z.l, sizeof(z.l));
+}
+
+void bls_fp_mont_sqr(uint64_t* r, const uint64_t* a) {
+    pthread_once(&g_bls_fp_once, bls_fp_detect_impl);
+    bls_fp_t x, z;
+    memcpy(x.l, a, sizeof(x.l));
+    fp_sqr(&z, &x);
+    memcpy(r, z.l, sizeof(z.l));
+}
+
+void bls_fp_mont_redc(uint64_t* r, const uint64_t* t) {
+    pthread_once(&g_bls_fp_once, bls_fp_detect_impl);
+    bls_fp_t z;
+    fp_redc(&z, t);
+    memcpy(r, z.l, sizeof(z.l));
+}
+
+void bls_fp2_mont_mul(uint64_t* r, const uint64_t* a, const uint64_t* b) {
+    pthread_once(&g_bls_fp_once, bls_fp_detect_impl);
+    bls_fp2_t x, y, z;
+    memcpy(&x, a, sizeof(x));
+    memcpy(&y, b, sizeof(y));
+    fp2_mul(&z, &x, &y);
+    memcpy(r, &z, sizeof(z));
+}
+
+void bls_fp2_mont_sqr(uint64_t* r, const uint64_t* a) {
+    pthread_once(&g_bls_fp_once, bls_fp_detect_impl);
+    bls_fp2_t x, z;
+    memcpy(&x, a, sizeof(x));
+    fp2_sqr(&z, &x);
+    memcpy(r, &z, sizeof(z));
+}
@@ -0,0 +1,224 @@
+#include "security/bls_key_cache.h"
+
+#include <immintrin.h>
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define BLS_KEY_CACHE_MIN_SETS 16
+
+// Запись хранит полный сжатый ключ: совпадение индекса набора без
+// сравнения ключа вернуло бы чужую точку
+typedef struct {
+    uint8_t public_key[BLS_PUBLIC_KEY_SIZE];
+    uint64_t last_used;            // Такт последнего обращения, 0 - пустая запись
+    bls_public_key_t decoded;
+} bls_key_cache_entry_t;
+
+typedef struct {
+    uint32_t lock;                 // Спинлок набора (доступ через __atomic_*)
+    bls_key_cache_entry_t ways[BLS_KEY_CACHE_WAYS];
+} __attribute__((aligned(64))) bls_key_cache_set_t;
+
+typedef struct {
+    bls_key_cache_set_t* sets;
+    uint32_t set_count;            // Степень двойки
+    uint64_t clock;                // Счетчик обращений для вытеснения
+    uint64_t hits;
+    uint64_t misses;
+    uint64_t evictions;
+    uint64_t occupied;             // Непустых записей
+} bls_key_cache_table_t;
+
+static bls_key_cache_table_t g_bls_key_cache;
+
+static void bls_key_cache_log(const char* level, const char* message) {
+    time_t now = time(NULL);
+    struct tm* tm_info = localtime(&now);
+    char timestamp[20];
+    strftime(timestamp, sizeof(timestamp), "%Y-%m-%d %H:%M:%S", tm_info);
+    
+    printf("[%s] [BLS_KEY_CACHE] [%s] %s\n", timestamp, level, message);
+    fflush(stdout);
+}
+
+static void bls_key_cache_lock(bls_key_cache_set_t* set) {
+    while (__atomic_exchange_n(&set->lock, 1, __ATOMIC_ACQUIRE)) {
+        while (__atomic_load_n(&set->lock, __ATOMIC_RELAXED)) {
+            _mm_pause();
+        }
+    }
+}
+
+static void bls_key_cache_unlock(bls_key_cache_set_t* set) {
+    __atomic_store_n(&set->lock, 0, __ATOMIC_RELEASE);
+}
+
+// Младшие слова координаты x равномерны; старший байт несет флаги
+static bls_key_cache_set_t* bls_key_cache_set_for(const uint8_t* public_key) {
+    uint64_t index;
+    memcpy(&index, public_key + BLS_PUBLIC_KEY_SIZE - sizeof(index), sizeof(index));
+    return &g_bls_key_cache.sets[index & (g_bls_key_cache.set_count - 1)];
+}
+
+static uint64_t bls_key_cache_tick(void) {
+    return __atomic_add_fetch(&g_bls_key_cache.clock, 1, __ATOMIC_RELAXED);
+}
+
+bool bls_key_cache_init(uint32_t capacity) {
+    bls_key_cache_cleanup();
+    
+    if (capacity == 0) {
+        bls_key_cache_log("INFO", "Кеш публичных ключей BLS отключен");
+        return true;
+    }
+    
+    uint32_t set_count = BLS_KEY_CACHE_MIN_SETS;
+    while ((uint64_t)set_count * BLS_KEY_CACHE_WAYS < capacity && set_count < (1U << 24)) {
+        set_count <<= 1;
+    }
+    
+    bls_key_cache_set_t* sets = NULL;
+    if (posix_memalign((void**)&sets, 64, (size_t)set_count * sizeof(bls_key_cache_set_t)) != 0) {
+        bls_key_cache_log("ERROR", "Не удалось выделить память для кеша публичных ключей");
+        return false;
+    }
+    memset(sets, 0, (size_t)set_count * sizeof(bls_key_cache_set_t));
+    
+    g_bls_key_cache.sets = sets;
+    g_bls_key_cache.set_count = set_count;
+    
+    char log_msg[256];
+    snprintf(log_msg, sizeof(log_msg),
+             "Кеш публичных ключей BLS инициализирован: записей=%u, память=%lu байт",
+             set_count * BLS_KEY_CACHE_WAYS,
+             (uint64_t)set_count * sizeof(bls_key_cache_set_t));
+    bls_key_cache_log("INFO", log_msg);
+    return true;
+}
+
+void bls_key_cache_cleanup(void) {
+    free(g_bls_key_cache.sets);
+    memset(&g_bls_key_cache, 0, sizeof(bls_key_cache_table_t));
+}
+
+bool bls_key_cache_is_enabled(void) {
+    return g_bls_key_cache.sets != NULL;
+}
+
+void bls_key_cache_clear(void) {
+    for (uint32_t s = 0; s < g_bls_key_cache.set_count; s++) {
+        bls_key_cache_set_t* set = &g_bls_key_cache.sets[s];
+        bls_key_cache_lock(set);
+        for (int way = 0; way < BLS_KEY_CACHE_WAYS; way++) {
+            if (set->ways[way].last_used != 0) {
+                set->ways[way].last_used = 0;
+                __atomic_fetch_sub(&g_bls_key_cache.occupied, 1, __ATOMIC_RELAXED);
+                __atomic_fetch_add(&g_bls_key_cache.evictions, 1, __ATOMIC_RELAXED);
+            }
+        }
+        bls_key_cache_unlock(set);
+    }
+}
+
+bool bls_key_cache_lookup(const uint8_t* public_key, bls_public_key_t* decoded) {
+    if (!g_bls_key_cache.sets || !public_key || !decoded) {
+        return false;
+    }
+    
+    bls_key_cache_set_t* set = bls_key_cache_set_for(public_key);
+    uint64_t now = bls_key_cache_tick();
+    bool hit = false;
+    
+    bls_key_cache_lock(set);
+    for (int way = 0; way < BLS_KEY_CACHE_WAYS; way++) {
+        bls_key_cache_entry_t* entry = &set->ways[way];
+        if (entry->last_used != 0 &&
+            memcmp(entry->public_key, public_key, BLS_PUBLIC_KEY_SIZE) == 0) {
+            entry->last_used = now;
+            *decoded = entry->decoded;
+            hit = true;
+            break;
+        }
+    }
+    bls_key_cache_unlock(set);
+    
+    __atomic_fetch_add(hit ? &g_bls_key_cache.hits : &g_bls_key_cache.misses, 1,
+                       __ATOMIC_RELAXED);
+    return hit;
+}
+
+// Запись вытесняет ту же запись, пустую, иначе - давно не использованную
+void bls_key_cache_store(const uint8_t* public_key, const bls_public_key_t* decoded) {
+    if (!g_bls_key_cache.sets || !public_key || !decoded) {
+        return;
+    }
+    
+    bls_key_cache_set_t* set = bls_key_cache_set_for(public_key);
+    uint64_t now = bls_key_cache_tick();
+    
+    bls_key_cache_lock(set);
+    int victim = 0;
+    for (int way = 0; way < BLS_KEY_CACHE_WAYS; way++) {
+        bls_key_cache_entry_t* entry = &set->ways[way];
+        if (entry->last_used != 0 &&
+            memcmp(entry->public_key, public_key, BLS_PUBLIC_KEY_SIZE) == 0) {
+            victim = way;
+            break;
+        }
+        if (entry->last_used < set->ways[victim].last_used) {
+            victim = way;
+        }
+    }
+    
+    bls_key_cache_entry_t* entry = &set->ways[victim];
+    if (entry->last_used == 0) {
+        __atomic_fetch_add(&g_bls_key_cache.occupied, 1, __ATOMIC_RELAXED);
+    } else if (memcmp(entry->public_key, public_key, BLS_PUBLIC_KEY_SIZE) != 0) {
+        __atomic_fetch_add(&g_bls_key_cache.evictions, 1, __ATOMIC_RELAXED);
+    }
+    memcpy(entry->public_key, public_key, BLS_PUBLIC_KEY_SIZE);
+    entry->decoded = *decoded;
+    entry->last_used = now;
+    bls_key_cache_unlock(set);
+}
+
+void bls_key_cache_invalidate(const uint8_t* public_key) {
+    if (!g_bls_key_cache.sets || !public_key) {
+        return;
+    }
+    
+    bls_key_cache_set_t* set = bls_key_cache_set_for(public_key);
+    bls_key_cache_lock(set);
+    for (int way = 0; way < BLS_KEY_CACHE_WAYS; way++) {
+        bls_key_cache_entry_t* entry = &set->ways[way];
+        if (entry->last_used != 0 &&
+            memcmp(entry->public_key, public_key, BLS_PUBLIC_KEY_SIZE) == 0) {
+            entry->last_used = 0;
+            __atomic_fetch_sub(&g_bls_key_cache.occupied, 1, __ATOMIC_RELAXED);
+            break;
+        }
+    }
+    bls_key_cache_unlock(set);
+}
+
+bool bls_key_cache_get_stats(cache_stats_t* stats) {
+    if (!stats) {
+        return false;
+    }
+    
+    memset(stats, 0, sizeof(cache_stats_t));
+    if (!g_bls_key_cache.sets) {
+        return false;
+    }
+    
+    stats->hits = __atomic_load_n(&g_bls_key_cache.hits, __ATOMIC_RELAXED);
+    stats->misses = __atomic_load_n(&g_bls_key_cache.misses, __ATOMIC_RELAXED);
+    stats->evictions = __atomic_load_n(&g_bls_key_cache.evictions, __ATOMIC_RELAXED);
+    stats->memory_used = __atomic_load_n(&g_bls_key_cache.occupied, __ATOMIC_RELAXED) *
+                         sizeof(bls_key_cache_entry_t);
+    stats->max_memory = (size_t)g_bls_key_cache.set_count * sizeof(bls_key_cache_set_t);
+    return true;
+}
@@ -0,0 +1,1207 @@
+#include "security/pos_verifier.h"
+
+#include <immintrin.h>
+#include <openssl/sha.h>
+#include <pthread.h>
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+// Константы chiapos
+#define POS_EXTRA_BITS 6               // Биты x, добавляемые к выходу f1
+#define POS_BC 15113                   // Размер бакета сопоставления
+#define POS_B 119
+#define POS_C 127
+#define POS_MATCH_TARGETS 64           // Число целей сопоставления на левый y
+
+// Флаги BLAKE3 для единственного блока: CHUNK_START | CHUNK_END | ROOT
+#define POS_BLAKE3_FLAGS 11
+#define POS_BLAKE3_BLOCK_SIZE 64
+#define POS_BLAKE3_ROUNDS 7
+
+// Строка входа BLAKE3 с запасом под 8-байтовую запись битов
+#define POS_FX_INPUT_STRIDE (POS_BLAKE3_BLOCK_SIZE + 8)
+// Метаданные таблицы - до 4k бит, выровнены влево
+#define POS_META_SIZE 40
+
+// Размер метаданных входа таблицы в единицах k (chiapos kVectorLens)
+static const uint8_t g_pos_vector_lens[8] = { 0, 0, 1, 2, 4, 4, 3, 2 };
+
+static const uint32_t g_pos_chacha_sigma[4] = {
+    0x61707865, 0x3320646e, 0x79622d32, 0x6b206574 // "expand 32-byte k"
+};
+
+static const uint32_t g_pos_blake3_iv[8] = {
+    0x6A09E667, 0xBB67AE85, 0x3C6EF372, 0xA54FF53A,
+    0x510E527F, 0x9B05688C, 0x1F83D9AB, 0x5BE0CD19
+};
+
+// Порядок слов сообщения в каждом раунде BLAKE3 (перестановка
+// применена заранее, чтобы векторные ядра не переставляли регистры)
+static const uint8_t g_pos_blake3_schedule[POS_BLAKE3_ROUNDS][16] = {
+    { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15 },
+    { 2, 6, 3, 10, 7, 0, 4, 13, 1, 11, 12, 5, 9, 14, 15, 8 },
+    { 3, 4, 10, 12, 13, 2, 7, 14, 6, 5, 9, 0, 11, 15, 8, 1 },
+    { 10, 7, 12, 9, 14, 3, 13, 15, 4, 0, 11, 2, 5, 8, 1, 6 },
+    { 12, 13, 9, 11, 15, 10, 14, 8, 7, 2, 5, 3, 0, 1, 6, 4 },
+    { 9, 14, 11, 5, 8, 12, 15, 1, 13, 3, 0, 10, 2, 6, 4, 7 },
+    { 11, 15, 5, 0, 1, 9, 8, 6, 14, 10, 2, 12, 3, 4, 7, 13 }
+};
+
+typedef void (*pos_chacha8_fn)(const uint32_t* key, const uint64_t* counters, size_t count,
+                               uint8_t* out);
+typedef void (*pos_blake3_fn)(const uint8_t* inputs, size_t stride, size_t length,
+                              size_t count, uint8_t* out);
+
+static pthread_once_t g_pos_isa_once = PTHREAD_ONCE_INIT;
+static pos_isa_t g_pos_best_isa = POS_ISA_SCALAR;
+static pos_isa_t g_pos_isa = POS_ISA_SCALAR;  // Доступ через __atomic_*
+static bool g_pos_has_bmi2 = false;
+
+static void pos_log(const char* level, const char* message) {
+    time_t now = time(NULL);
+    struct tm* tm_info = localtime(&now);
+    char timestamp[20];
+    strftime(timestamp, sizeof(timestamp), "%Y-%m-%d %H:%M:%S", tm_info);
+    
+    printf("[%s] [POS_VERIFIER] [%s] %s\n", timestamp, level, message);
+    fflush(stdout);
+}
+
+static inline uint32_t pos_load_le32(const uint8_t* p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) |
+           ((uint32_t)p[3] << 24);
+}
+
+static inline void pos_store_le32(uint8_t* p, uint32_t v) {
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+    p[2] = (uint8_t)(v >> 16);
+    p[3] = (uint8_t)(v >> 24);
+}
+
+static inline uint64_t pos_load_be64(const uint8_t* p) {
+    uint64_t v;
+    memcpy(&v, p, sizeof(v));
+    return __builtin_bswap64(v);
+}
+
+// Чтение count (1..57) бит big-endian начиная с бита pos. Буфер должен
+// иметь 8 читаемых байт начиная с pos / 8.
+static inline uint64_t pos_bits_get(const uint8_t* buf, uint32_t pos, uint32_t count) {
+    return (pos_load_be64(buf + pos / 8) << (pos % 8)) >> (64 - count);
+}
+
+// Запись count (1..56) бит value в обнуленный буфер начиная с бита pos
+static inline void pos_bits_put(uint8_t* buf, uint32_t pos, uint64_t value, uint32_t count) {
+    uint64_t shifted = value << (64 - count - pos % 8);
+    uint8_t* p = buf + pos / 8;
+    for (int i = 0; i < 8; i++) {
+        p[i] |= (uint8_t)(shifted >> (56 - 8 * i));
+    }
+}
+
+static void pos_bits_copy(uint8_t* dst, uint32_t dst_pos, const uint8_t* src, uint32_t src_pos,
+                          uint32_t count) {
+    while (count > 0) {
+        uint32_t chunk = count < 56 ? count : 56;
+        pos_bits_put(dst, dst_pos, pos_bits_get(src, src_pos, chunk), chunk);
+        dst_pos += chunk;
+        src_pos += chunk;
+        count -= chunk;
+    }
+}
+
+// ChaCha8
+
+#define POS_ROTL32(v, n) (((v) << (n)) | ((v) >> (32 - (n))))
+
+#define POS_CHACHA_QR(x, a, b, c, d) do { \
+    x[a] += x[b]; x[d] = POS_ROTL32(x[d] ^ x[a], 16); \
+    x[c] += x[d]; x[b] = POS_ROTL32(x[b] ^ x[c], 12); \
+    x[a] += x[b]; x[d] = POS_ROTL32(x[d] ^ x[a], 8); \
+    x[c] += x[d]; x[b] = POS_ROTL32(x[b] ^ x[c], 7); \
+} while (0)
+
+static void pos_chacha8_scalar(const uint32_t* key, const uint64_t* counters, size_t count,
+                               uint8_t* out) {
+    for (size_t i = 0; i < count; i++) {
+        uint32_t state[16];
+        memcpy(state, g_pos_chacha_sigma, sizeof(g_pos_chacha_sigma));
+        memcpy(state + 4, key, 8 * sizeof(uint32_t));
+        state[12] = (uint32_t)counters[i];
+        state[13] = (uint32_t)(counters[i] >> 32);
+        state[14] = 0;
+        state[15] = 0;
+        
+        uint32_t x[16];
+        memcpy(x, state, sizeof(x));
+        for (int round = 0; round < 8; round += 2) {
+            POS_CHACHA_QR(x, 0, 4, 8, 12);
+            POS_CHACHA_QR(x, 1, 5, 9, 13);
+            POS_CHACHA_QR(x, 2, 6, 10, 14);
+            POS_CHACHA_QR(x, 3, 7, 11, 15);
+            POS_CHACHA_QR(x, 0, 5, 10, 15);
+            POS_CHACHA_QR(x, 1, 6, 11, 12);
+            POS_CHACHA_QR(x, 2, 7, 8, 13);
+            POS_CHACHA_QR(x, 3, 4, 9, 14);
+        }
+        
+        for (int w = 0; w < 16; w++) {
+            pos_store_le32(out + i * 64 + w * 4, x[w] + state[w]);
+        }
+    }
+}
+
+// Векторные ядра: в каждой полосе регистра свой блок ChaCha8 (или свой
+// вход BLAKE3), слово состояния w всех полос лежит в одном регистре
+
+#define POS_AVX2_ROTL(v, n) \
+    _mm256_or_si256(_mm256_slli_epi32(v, n), _mm256_srli_epi32(v, 32 - (n)))
+
+#define POS_AVX2_CHACHA_QR(x, a, b, c, d) do { \
+    x[a] = _mm256_add_epi32(x[a], x[b]); x[d] = POS_AVX2_ROTL(_mm256_xor_si256(x[d], x[a]), 16); \
+    x[c] = _mm256_add_epi32(x[c], x[d]); x[b] = POS_AVX2_ROTL(_mm256_xor_si256(x[b], x[c]), 12); \
+    x[a] = _mm256_add_epi32(x[a], x[b]); x[d] = POS_AVX2_ROTL(_mm256_xor_si256(x[d], x[a]), 8); \
+    x[c] = _mm256_add_epi32(x[c], x[d]); x[b] = POS_AVX2_ROTL(_mm256_xor_si256(x[b], x[c]), 7); \
+} while (0)
+
+__attribute__((target("avx2")))
+static void pos_chacha8_avx2(const uint32_t* key, const uint64_t* counters, size_t count,
+                             uint8_t* out) {
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        uint32_t counter_lo[8], counter_hi[8];
+        for (int lane = 0; lane < 8; lane++) {
+            counter_lo[lane] = (uint32_t)counters[i + lane];
+            counter_hi[lane] = (uint32_t)(counters[i + lane] >> 32);
+        }
+        
+        __m256i state[16], x[16];
+        for (int w = 0; w < 4; w++) {
+            state[w] = _mm256_set1_epi32((int)g_pos_chacha_sigma[w]);
+        }
+        for (int w = 0; w < 8; w++) {
+            state[4 + w] = _mm256_set1_epi32((int)key[w]);
+        }
+        state[12] = _mm256_loadu_si256((const __m256i*)counter_lo);
+        state[13] = _mm256_loadu_si256((const __m256i*)counter_hi);
+        state[14] = _mm256_setzero_si256();
+        state[15] = _mm256_setzero_si256();
+        memcpy(x, state, sizeof(x));
+        
+        for (int round = 0; round < 8; round += 2) {
+            POS_AVX2_CHACHA_QR(x, 0, 4, 8, 12);
+            POS_AVX2_CHACHA_QR(x, 1, 5, 9, 13);
+            POS_AVX2_CHACHA_QR(x, 2, 6, 10, 14);
+            POS_AVX2_CHACHA_QR(x, 3, 7, 11, 15);
+            POS_AVX2_CHACHA_QR(x, 0, 5, 10, 15);
+            POS_AVX2_CHACHA_QR(x, 1, 6, 11, 12);
+            POS_AVX2_CHACHA_QR(x, 2, 7, 8, 13);
+            POS_AVX2_CHACHA_QR(x, 3, 4, 9, 14);
+        }
+        
+        uint32_t words[16][8] __attribute__((aligned(32)));
+        for (int w = 0; w < 16; w++) {
+            _mm256_store_si256((__m256i*)words[w], _mm256_add_epi32(x[w], state[w]));
+        }
+        for (int lane = 0; lane < 8; lane++) {
+            for (int w = 0; w < 16; w++) {
+                pos_store_le32(out + (i + lane) * 64 + w * 4, words[w][lane]);
+            }
+        }
+    }
+    
+    pos_chacha8_scalar(key, counters + i, count - i, out + i * 64);
+}
+
+// _mm512_rol/ror_epi32 в заголовках GCC берут _mm512_undefined_epi32(),
+// что при оптимизации дает ложное предупреждение -Wmaybe-uninitialized
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+
+#define POS_AVX512_CHACHA_QR(x, a, b, c, d) do { \
+    x[a] = _mm512_add_epi32(x[a], x[b]); x[d] = _mm512_rol_epi32(_mm512_xor_si512(x[d], x[a]), 16); \
+    x[c] = _mm512_add_epi32(x[c], x[d]); x[b] = _mm512_rol_epi32(_mm512_xor_si512(x[b], x[c]), 12); \
+    x[a] = _mm512_add_epi32(x[a], x[b]); x[d] = _mm512_rol_epi32(_mm512_xor_si512(x[d], x[a]), 8); \
+    x[c] = _mm512_add_epi32(x[c], x[d]); x[b] = _mm512_rol_epi32(_mm512_xor_si512(x[b], x[c]), 7); \
+} while (0)
+
+__attribute__((target("avx512f")))
+static void pos_chacha8_avx512(const uint32_t* key, const uint64_t* counters, size_t count,
+                               uint8_t* out) {
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        uint32_t counter_lo[16], counter_hi[16];
+        for (int lane = 0; lane < 16; lane++) {
+            counter_lo[lane] = (uint32_t)counters[i + lane];
+            counter_hi[lane] = (uint32_t)(counters[i + lane] >> 32);
+        }
+        
+        __m512i state[16], x[16];
+        for (int w = 0; w < 4; w++) {
+            state[w] = _mm512_set1_epi32((int)g_pos_chacha_sigma[w]);
+        }
+        for (int w = 0; w < 8; w++) {
+            state[4 + w] = _mm512_set1_epi32((int)key[w]);
+        }
+        state[12] = _mm512_loadu_si512(counter_lo);
+        state[13] = _mm512_loadu_si512(counter_hi);
+        state[14] = _mm512_setzero_si512();
+        state[15] = _mm512_setzero_si512();
+        memcpy(x, state, sizeof(x));
+        
+        for (int round = 0; round < 8; round += 2) {
+            POS_AVX512_CHACHA_QR(x, 0, 4, 8, 12);
+            POS_AVX512_CHACHA_QR(x, 1, 5, 9, 13);
+            POS_AVX512_CHACHA_QR(x, 2, 6, 10, 14);
+            POS_AVX512_CHACHA_QR(x, 3, 7, 11, 15);
+            POS_AVX512_CHACHA_QR(x, 0, 5, 10, 15);
+            POS_AVX512_CHACHA_QR(x, 1, 6, 11, 12);
+            POS_AVX512_CHACHA_QR(x, 2, 7, 8, 13);
+            POS_AVX512_CHACHA_QR(x, 3, 4, 9, 14);
+        }
+        
+        uint32_t words[16][16] __attribute__((aligned(64)));
+        for (int w = 0; w < 16; w++) {
+            _mm512_store_si512(words[w], _mm512_add_epi32(x[w], state[w]));
+        }
+        for (int lane = 0; lane < 16; lane++) {
+            for (int w = 0; w < 16; w++) {
+                pos_store_le32(out + (i + lane) * 64 + w * 4, words[w][lane]);
+            }
+        }
+    }
+    
+    // Остаток меньше 16 блоков добирается 8-полосным ядром
+    pos_chacha8_avx2(key, counters + i, count - i, out + i * 64);
+}
+
+// BLAKE3 (один блок: все входы fx не длиннее 64 байт)
+
+#define POS_ROTR32(v, n) (((v) >> (n)) | ((v) << (32 - (n))))
+
+#define POS_BLAKE3_G(v, a, b, c, d, mx, my) do { \
+    v[a] = v[a] + v[b] + (mx); v[d] = POS_ROTR32(v[d] ^ v[a], 16); \
+    v[c] = v[c] + v[d];        v[b] = POS_ROTR32(v[b] ^ v[c], 12); \
+    v[a] = v[a] + v[b] + (my); v[d] = POS_ROTR32(v[d] ^ v[a], 8); \
+    v[c] = v[c] + v[d];        v[b] = POS_ROTR32(v[b] ^ v[c], 7); \
+} while (0)
+
+static void pos_blake3_scalar(const uint8_t* inputs, size_t stride, size_t length, size_t count,
+                              uint8_t* out) {
+    for (size_t i = 0; i < count; i++) {
+        uint8_t block[POS_BLAKE3_BLOCK_SIZE] = {0};
+        memcpy(block, inputs + i * stride, length);
+        
+        uint32_t m[16];
+        for (int w = 0; w < 16; w++) {
+            m[w] = pos_load_le32(block + w * 4);
+        }
+        
+        uint32_t v[16];
+        memcpy(v, g_pos_blake3_iv, sizeof(g_pos_blake3_iv));
+        memcpy(v + 8, g_pos_blake3_iv, 4 * sizeof(uint32_t));
+        v[12] = 0;
+        v[13] = 0;
+        v[14] = (uint32_t)length;
+        v[15] = POS_BLAKE3_FLAGS;
+        
+        for (int round = 0; round < POS_BLAKE3_ROUNDS; round++) {
+            const uint8_t* s = g_pos_blake3_schedule[round];
+            POS_BLAKE3_G(v, 0, 4, 8, 12, m[s[0]], m[s[1]]);
+            POS_BLAKE3_G(v, 1, 5, 9, 13, m[s[2]], m[s[3]]);
+            POS_BLAKE3_G(v, 2, 6, 10, 14, m[s[4]], m[s[5]]);
+            POS_BLAKE3_G(v, 3, 7, 11, 15, m[s[6]], m[s[7]]);
+            POS_BLAKE3_G(v, 0, 5, 10, 15, m[s[8]], m[s[9]]);
+            POS_BLAKE3_G(v, 1, 6, 11, 12, m[s[10]], m[s[11]]);
+            POS_BLAKE3_G(v, 2, 7, 8, 13, m[s[12]], m[s[13]]);
+            POS_BLAKE3_G(v, 3, 4, 9, 14, m[s[14]], m[s[15]]);
+        }
+        
+        for (int w = 0; w < 8; w++) {
+            pos_store_le32(out + i * 32 + w * 4, v[w] ^ v[w + 8]);
+        }
+    }
+}
+
+#define POS_AVX2_ROTR(v, n) \
+    _mm256_or_si256(_mm256_srli_epi32(v, n), _mm256_slli_epi32(v, 32 - (n)))
+
+#define POS_AVX2_BLAKE3_G(v, a, b, c, d, mx, my) do { \
+    v[a] = _mm256_add_epi32(_mm256_add_epi32(v[a], v[b]), mx); \
+    v[d] = POS_AVX2_ROTR(_mm256_xor_si256(v[d], v[a]), 16); \
+    v[c] = _mm256_add_epi32(v[c], v[d]); \
+    v[b] = POS_AVX2_ROTR(_mm256_xor_si256(v[b], v[c]), 12); \
+    v[a] = _mm256_add_epi32(_mm256_add_epi32(v[a], v[b]), my); \
+    v[d] = POS_AVX2_ROTR(_mm256_xor_si256(v[d], v[a]), 8); \
+    v[c] = _mm256_add_epi32(v[c], v[d]); \
+    v[b] = POS_AVX2_ROTR(_mm256_xor_si256(v[b], v[c]), 7); \
+} while (0)
+
+__attribute__((target("avx2")))
+static void pos_blake3_avx2(const uint8_t* inputs, size_t stride, size_t length, size_t count,
+                            uint8_t* out) {
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        uint32_t words[16][8] __attribute__((aligned(32)));
+        for (int lane = 0; lane < 8; lane++) {
+            uint8_t block[POS_BLAKE3_BLOCK_SIZE] = {0};
+            memcpy(block, inputs + (i + lane) * stride, length);
+            for (int w = 0; w < 16; w++) {
+                words[w][lane] = pos_load_le32(block + w * 4);
+            }
+        }
+        
+        __m256i m[16], v[16];
+        for (int w = 0; w < 16; w++) {
+            m[w] = _mm256_load_si256((const __m256i*)words[w]);
+        }
+        for (int w = 0; w < 8; w++) {
+            v[w] = _mm256_set1_epi32((int)g_pos_blake3_iv[w]);
+        }
+        for (int w = 0; w < 4; w++) {
+            v[8 + w] = v[w];
+        }
+        v[12] = _mm256_setzero_si256();
+        v[13] = _mm256_setzero_si256();
+        v[14] = _mm256_set1_epi32((int)length);
+        v[15] = _mm256_set1_epi32(POS_BLAKE3_FLAGS);
+        
+        for (int round = 0; round < POS_BLAKE3_ROUNDS; round++) {
+            const uint8_t* s = g_pos_blake3_schedule[round];
+            POS_AVX2_BLAKE3_G(v, 0, 4, 8, 12, m[s[0]], m[s[1]]);
+            POS_AVX2_BLAKE3_G(v, 1, 5, 9, 13, m[s[2]], m[s[3]]);
+            POS_AVX2_BLAKE3_G(v, 2, 6, 10, 14, m[s[4]], m[s[5]]);
+            POS_AVX2_BLAKE3_G(v, 3, 7, 11, 15, m[s[6]], m[s[7]]);
+            POS_AVX2_BLAKE3_G(v, 0, 5, 10, 15, m[s[8]], m[s[9]]);
+            POS_AVX2_BLAKE3_G(v, 1, 6, 11, 12, m[s[10]], m[s[11]]);
+            POS_AVX2_BLAKE3_G(v, 2, 7, 8, 13, m[s[12]], m[s[13]]);
+            POS_AVX2_BLAKE3_G(v, 3, 4, 9, 14, m[s[14]], m[s[15]]);
+        }
+        
+        for (int w = 0; w < 8; w++) {
+            _mm256_store_si256((__m256i*)words[w], _mm256_xor_si256(v[w], v[w + 8]));
+        }
+        for (int lane = 0; lane < 8; lane++) {
+            for (int w = 0; w < 8; w++) {
+                pos_store_le32(out + (i + lane) * 32 + w * 4, words[w][lane]);
+            }
+        }
+    }
+    
+    pos_blake3_scalar(inputs + i * stride, stride, length, count - i, out + i * 32);
+}
+
+#define POS_AVX512_BLAKE3_G(v, a, b, c, d, mx, my) do { \
+    v[a] = _mm512_add_epi32(_mm512_add_epi32(v[a], v[b]), mx); \
+    v[d] = _mm512_ror_epi32(_mm512_xor_si512(v[d], v[a]), 16); \
+    v[c] = _mm512_add_epi32(v[c], v[d]); \
+    v[b] = _mm512_ror_epi32(_mm512_xor_si512(v[b], v[c]), 12); \
+    v[a] = _mm512_add_epi32(_mm512_add_epi32(v[a], v[b]), my); \
+    v[d] = _mm512_ror_epi32(_mm512_xor_si512(v[d], v[a]), 8); \
+    v[c] = _mm512_add_epi32(v[c], v[d]); \
+    v[b] = _mm512_ror_epi32(_mm512_xor_si512(v[b], v[c]), 7); \
+} while (0)
+
+__attribute__((target("avx512f")))
+static void pos_blake3_avx512(const uint8_t* inputs, size_t stride, size_t length, size_t count,
+                              uint8_t* out) {
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        uint32_t words[16][16] __attribute__((aligned(64)));
+        for (int lane = 0; lane < 16; lane++) {
+            uint8_t block[POS_BLAKE3_BLOCK_SIZE] = {0};
+            memcpy(block, inputs + (i + lane) * stride, length);
+            for (int w = 0; w < 16; w++) {
+                words[w][lane] = pos_load_le32(block + w * 4);
+            }
+        }
+        
+        __m512i m[16], v[16];
+        for (int w = 0; w < 16; w++) {
+            m[w] = _mm512_load_si512(words[w]);
+        }
+        for (int w = 0; w < 8; w++) {
+            v[w] = _mm512_set1_epi32((int)g_pos_blake3_iv[w]);
+        }
+        for (int w = 0; w < 4; w++) {
+            v[8 + w] = v[w];
+        }
+        v[12] = _mm512_setzero_si512();
+        v[13] = _mm512_setzero_si512();
+        v[14] = _mm512_set1_epi32((int)length);
+        v[15] = _mm512_set1_epi32(POS_BLAKE3_FLAGS);
+        
+        for (int round = 0; round < POS_BLAKE3_ROUNDS; round++) {
+            const uint8_t* s = g_pos_blake3_schedule[round];
+            POS_AVX512_BLAKE3_G(v, 0, 4, 8, 12, m[s[0]], m[s[1]]);
+            POS_AVX512_BLAKE3_G(v, 1, 5, 9, 13, m[s[2]], m[s[3]]);
+            POS_AVX512_BLAKE3_G(v, 2, 6, 10, 14, m[s[4]], m[s[5]]);
+            POS_AVX512_BLAKE3_G(v, 3, 7, 11, 15, m[s[6]], m[s[7]]);
+            POS_AVX512_BLAKE3_G(v, 0, 5, 10, 15, m[s[8]], m[s[9]]);
+            POS_AVX512_BLAKE3_G(v, 1, 6, 11, 12, m[s[10]], m[s[11]]);
+            POS_AVX512_BLAKE3_G(v, 2, 7, 8, 13, m[s[12]], m[s[13]]);
+            POS_AVX512_BLAKE3_G(v, 3, 4, 9, 14, m[s[14]], m[s[15]]);
+        }
+        
+        for (int w = 0; w < 8; w++) {
+            _mm512_store_si512(words[w], _mm512_xor_si512(v[w], v[w + 8]));
+        }
+        for (int lane = 0; lane < 16; lane++) {
+            for (int w = 0; w < 8; w++) {
+                pos_store_le32(out + (i + lane) * 32 + w * 4, words[w][lane]);
+            }
+        }
+    }
+    
+    pos_blake3_avx2(inputs + i * stride, stride, length, count - i, out + i * 32);
+}
+
+#pragma GCC diagnostic pop
+
+// Выбор реализации
+
+static void pos_detect_isa(void) {
+    if (__builtin_cpu_supports("avx512f")) {
+        g_pos_best_isa = POS_ISA_AVX512;
+    } else if (__builtin_cpu_supports("avx2")) {
+        g_pos_best_isa = POS_ISA_AVX2;
+    } else {
+        g_pos_best_isa = POS_ISA_SCALAR;
+    }
+    g_pos_has_bmi2 = __builtin_cpu_supports("bmi2");
+    __atomic_store_n(&g_pos_isa, g_pos_best_isa, __ATOMIC_RELAXED);
+}
+
+pos_isa_t pos_verifier_best_isa(void) {
+    pthread_once(&g_pos_isa_once, pos_detect_isa);
+    return g_pos_best_isa;
+}
+
+pos_isa_t pos_verifier_get_isa(void) {
+    pthread_once(&g_pos_isa_once, pos_detect_isa);
+    return __atomic_load_n(&g_pos_isa, __ATOMIC_RELAXED);
+}
+
+bool pos_verifier_set_isa(pos_isa_t isa) {
+    if (isa > pos_verifier_best_isa()) {
+        char log_msg[128];
+        snprintf(log_msg, sizeof(log_msg), "Набор инструкций %s не поддерживается процессором",
+                 pos_isa_name(isa));
+        pos_log("WARNING", log_msg);
+        return false;
+    }
+    
+    __atomic_store_n(&g_pos_isa, isa, __ATOMIC_RELAXED);
+    return true;
+}
+
+const char* pos_isa_name(pos_isa_t isa) {
+    switch (isa) {
+        case POS_ISA_SCALAR: return "scalar";
+        case POS_ISA_AVX2: return "avx2";
+        case POS_ISA_AVX512: return "avx512";
+    }
+    return "unknown";
+}
+
+static void pos_chacha8_dispatch(const uint32_t* key, const uint64_t* counters, size_t count,
+                                 uint8_t* out) {
+    switch (pos_verifier_get_isa()) {
+        case POS_ISA_AVX512: pos_chacha8_avx512(key, counters, count, out); break;
+        case POS_ISA_AVX2: pos_chacha8_avx2(key, counters, count, out); break;
+        default: pos_chacha8_scalar(key, counters, count, out); break;
+    }
+}
+
+static void pos_blake3_dispatch(const uint8_t* inputs, size_t stride, size_t length,
+                                size_t count, uint8_t* out) {
+    switch (pos_verifier_get_isa()) {
+        case POS_ISA_AVX512: pos_blake3_avx512(inputs, stride, length, count, out); break;
+        case POS_ISA_AVX2: pos_blake3_avx2(inputs, stride, length, count, out); break;
+        default: pos_blake3_scalar(inputs, stride, length, count, out); break;
+    }
+}
+
+void pos_chacha8_blocks(const uint8_t* key, const uint64_t* counters, size_t count,
+                        uint8_t* out) {
+    if (!key || !counters || !out) {
+        return;
+    }
+    
+    uint32_t key_words[8];
+    for (int w = 0; w < 8; w++) {
+        key_words[w] = pos_load_le32(key + w * 4);
+    }
+    pos_chacha8_dispatch(key_words, counters, count, out);
+}
+
+void pos_blake3_blocks(const uint8_t* inputs, size_t stride, size_t length, size_t count,
+                       uint8_t* out) {
+    if (!inputs || !out || length > POS_BLAKE3_BLOCK_SIZE) {
+        return;
+    }
+    pos_blake3_dispatch(inputs, stride, length, count, out);
+}
+
+// Представление доказательства
+
+// 8 байт доказательства, содержащие x с номером index, и смещение x от
+// старшего бита слова. Для последних x слово берется с конца
+// доказательства, чтобы не читать за его пределами: x заканчивается не
+// дальше конца данных, поэтому смещение + k не превышает 64.
+static inline uint64_t pos_view_word(const uint8_t* data, size_t length, uint32_t k,
+                                     uint32_t index, uint32_t* offset) {
+    uint32_t bit = index * k;
+    size_t byte = bit / 8 < length - 8 ? bit / 8 : length - 8;
+    *offset = bit - (uint32_t)byte * 8;
+    return pos_load_be64(data + byte);
+}
+
+template <uint32_t K>
+static void pos_view_xs_shift(const pos_proof_view_t* view, uint64_t* xs) {
+    const uint32_t k = K ? K : view->k;
+    const size_t length = K ? pos_proof_size(K) : view->length;
+    
+    for (uint32_t i = 0; i < POS_PROOF_X_COUNT; i++) {
+        uint32_t offset;
+        uint64_t word = pos_view_word(view->data, length, k, i, &offset);
+        xs[i] = (word << offset) >> (64 - k);
+    }
+}
+
+// shrx и bzhi вместо пары сдвигов по cl. pext с маской поля дает тот же
+// результат, но на AMD до Zen 3 выполняется микрокодом.
+template <uint32_t K>
+__attribute__((target("bmi2")))
+static void pos_view_xs_bmi2(const pos_proof_view_t* view, uint64_t* xs) {
+    const uint32_t k = K ? K : view->k;
+    const size_t length = K ? pos_proof_size(K) : view->length;
+    
+    for (uint32_t i = 0; i < POS_PROOF_X_COUNT; i++) {
+        uint32_t offset;
+        uint64_t word = pos_view_word(view->data, length, k, i, &offset);
+        xs[i] = _bzhi_u64(word >> (64 - offset - k), k);
+    }
+}
+
+static inline bool pos_view_use_bmi2(void) {
+    return pos_verifier_get_isa() != POS_ISA_SCALAR && g_pos_has_bmi2;
+}
+
+template <uint32_t K>
+static void pos_view_xs(const pos_proof_view_t* view, uint64_t* xs) {
+    if (pos_view_use_bmi2()) {
+        pos_view_xs_bmi2<K>(view, xs);
+    } else {
+        pos_view_xs_shift<K>(view, xs);
+    }
+}
+
+bool pos_proof_view_init(pos_proof_view_t* view, const uint8_t* proof, size_t proof_length,
+                         uint32_t k) {
+    if (!view || !proof || k < POS_MIN_K || k > POS_MAX_K || proof_length != pos_proof_size(k)) {
+        return false;
+    }
+    
+    view->data = proof;
+    view->length = proof_length;
+    view->k = k;
+    return true;
+}
+
+uint64_t pos_proof_view_x(const pos_proof_view_t* view, uint32_t index) {
+    if (!view || !view->data || index >= POS_PROOF_X_COUNT) {
+        return 0;
+    }
+    
+    uint32_t offset;
+    uint64_t word = pos_view_word(view->data, view->length, view->k, index, &offset);
+    return (word << offset) >> (64 - view->k);
+}
+
+void pos_proof_view_xs(const pos_proof_view_t* view, uint64_t* xs) {
+    if (!view || !view->data || !xs) {
+        return;
+    }
+    pos_view_xs<0>(view, xs);
+}
+
+// Верификация
+
+// Константы верификатора для одного k. Для специализированных k те же
+// значения известны при компиляции, обобщенный путь берет их из таблицы.
+typedef struct {
+    uint32_t k;
+    uint32_t y_bits;                   // Выход f1..f7: k + 6 бит
+    uint32_t meta_bits[8];             // Метаданные входа таблицы
+    uint32_t input_length[8];          // Байт входа BLAKE3 таблицы
+    uint32_t quality_length;           // Байт входа SHA256 строки качества
+} pos_k_params_t;
+
+typedef uint8_t pos_meta_t[POS_META_SIZE];
+typedef uint8_t pos_fx_input_t[POS_FX_INPUT_STRIDE];
+typedef uint8_t pos_hash_t[32];
+
+// Шаги верификации для одного размера плота. Одиночная проверка вызывает
+// их подряд, пакетная - таблица за таблицей для всей пачки, чтобы хэши
+// BLAKE3 всех доказательств считались одним вызовом ядра.
+typedef struct {
+    void (*load_xs)(const pos_proof_view_t* view, uint64_t* xs);
+    void (*compute_f1)(const pos_k_params_t* params, const uint8_t* plot_id, const uint64_t* xs,
+                       uint64_t* ys);
+    bool (*pack_fx[8])(const pos_k_params_t* params, const uint64_t* xs, const uint64_t* ys,
+                       const pos_meta_t* meta, size_t pairs, pos_fx_input_t* inputs);
+    void (*unpack_fx[8])(const pos_k_params_t* params, const pos_fx_input_t* inputs,
+                         const pos_hash_t* hashes, size_t pairs, uint64_t* ys, pos_meta_t* meta);
+    void (*quality_string)(const pos_k_params_t* params, const uint64_t* proof_xs,
+                           const uint8_t* challenge, uint8_t* quality_string);
+    bool (*verify)(const pos_k_params_t* params, const uint8_t* plot_id, const uint8_t* challenge,
+                   const pos_proof_view_t* proof, uint8_t* quality_string);
+} pos_k_impl_t;
+
+// Таблица выбора реализации по k заполняется pos_verifier_precompute;
+// указатели читаются через __atomic_*
+static pos_k_params_t g_pos_k_params[POS_MAX_K + 1];
+static const pos_k_impl_t* g_pos_impl_table[POS_MAX_K + 1];
+
+size_t pos_proof_size(uint32_t k) {
+    return (size_t)k * POS_PROOF_X_COUNT / 8;
+}
+
+static void pos_k_params_build(uint32_t k, pos_k_params_t* params) {
+    memset(params, 0, sizeof(*params));
+    params->k = k;
+    params->y_bits = k + POS_EXTRA_BITS;
+    for (int table = 2; table <= 7; table++) {
+        params->meta_bits[table] = g_pos_vector_lens[table] * k;
+        params->input_length[table] = (params->y_bits + 2 * params->meta_bits[table] + 7) / 8;
+    }
+    params->quality_length = POS_CHALLENGE_SIZE + (2 * k + 7) / 8;
+}
+
+// Правая запись сопоставляется левой, если она лежит в следующем бакете
+// и совпадает с одной из 64 целей левой. Первая компонента цели задает m
+// однозначно, поэтому перебор целей не нужен.
+static bool pos_is_match(uint64_t y_left, uint64_t y_right) {
+    uint64_t bucket_left = y_left / POS_BC;
+    if (y_right / POS_BC != bucket_left + 1) {
+        return false;
+    }
+    
+    uint64_t parity = bucket_left % 2;
+    uint64_t left = y_left % POS_BC;
+    uint64_t right = y_right % POS_BC;
+    
+    uint64_t m = (right / POS_C + POS_B - left / POS_C) % POS_B;
+    if (m >= POS_MATCH_TARGETS) {
+        return false;
+    }
+    
+    uint64_t shift = 2 * m + parity;
+    return right % POS_C == (shift * shift + left) % POS_C;
+}
+
+// Шаблоны ниже параметризованы размером плота: при K != 0 сдвиги, маски
+// и длины входов хэшей становятся константами, K == 0 - обобщенный путь
+// с константами из pos_k_params_t.
+
+// 64 значения x по k бит прямо из данных доказательства; они же -
+// метаданные таблицы 1, которые pos_pack_fx берет из xs
+template <uint32_t K>
+static void pos_load_xs(const pos_proof_view_t* view, uint64_t* xs) {
+    pos_view_xs<K>(view, xs);
+}
+
+// f1: k бит ключевого потока ChaCha8 начиная с бита x * k, дополненные
+// старшими битами x
+template <uint32_t K>
+static void pos_compute_f1(const pos_k_params_t* params, const uint8_t* plot_id,
+                           const uint64_t* xs, uint64_t* ys) {
+    const uint32_t k = K ? K : params->k;
+    
+    uint8_t key[32];
+    key[0] = 1;
+    memcpy(key + 1, plot_id, 31);
+    uint32_t key_words[8];
+    for (int w = 0; w < 8; w++) {
+        key_words[w] = pos_load_le32(key + w * 4);
+    }
+    
+    // Блок, на который приходится бит x * k, и при пересечении границы
+    // блока - следующий. Блоки одного x идут подряд, поэтому k бит
+    // читаются прямо из ключевого потока без склейки.
+    uint64_t counters[POS_PROOF_X_COUNT * 2];
+    size_t first_slot[POS_PROOF_X_COUNT];
+    size_t block_count = 0;
+    for (int i = 0; i < POS_PROOF_X_COUNT; i++) {
+        uint64_t bit = xs[i] * k;
+        first_slot[i] = block_count;
+        counters[block_count++] = bit / 512;
+        if (bit % 512 + k > 512) {
+            counters[block_count++] = bit / 512 + 1;
+        }
+    }
+    
+    // Запас в 8 байт под чтение битов в конце последнего блока
+    uint8_t keystream[POS_PROOF_X_COUNT * 2 * 64 + 8];
+    pos_chacha8_dispatch(key_words, counters, block_count, keystream);
+    memset(keystream + block_count * 64, 0, 8);
+    
+    for (int i = 0; i < POS_PROOF_X_COUNT; i++) {
+        uint64_t bits = pos_bits_get(keystream + first_slot[i] * 64,
+                                     (uint32_t)(xs[i] * k % 512), k);
+        ys[i] = (bits << POS_EXTRA_BITS) | (xs[i] >> (k - POS_EXTRA_BITS));
+    }
+}
+
+// Входы fx: y_left || meta_left || meta_right для каждой пары (для
+// таблицы 2 метаданные - сами x). Возвращает false, если какая-либо пара
+// не сопоставляется.
+template <uint32_t K, int TABLE>
+static bool pos_pack_fx(const pos_k_params_t* params, const uint64_t* xs, const uint64_t* ys,
+                        const pos_meta_t* meta, size_t pairs, pos_fx_input_t* inputs) {
+    const uint32_t y_bits = K ? K + POS_EXTRA_BITS : params->y_bits;
+    const uint32_t meta_bits = K ? g_pos_vector_lens[TABLE] * K : params->meta_bits[TABLE];
+    
+    memset(inputs, 0, pairs * sizeof(pos_fx_input_t));
+    for (size_t i = 0; i < pairs; i++) {
+        if (!pos_is_match(ys[2 * i], ys[2 * i + 1])) {
+            return false;
+        }
+        pos_bits_put(inputs[i], 0, ys[2 * i], y_bits);
+        if (TABLE == 2) {
+            pos_bits_put(inputs[i], y_bits, xs[2 * i], meta_bits);
+            pos_bits_put(inputs[i], y_bits + meta_bits, xs[2 * i + 1], meta_bits);
+        } else {
+            pos_bits_copy(inputs[i], y_bits, meta[2 * i], 0, meta_bits);
+            pos_bits_copy(inputs[i], y_bits + meta_bits, meta[2 * i + 1], 0, meta_bits);
+        }
+    }
+    return true;
+}
+
+// Выход fx - k + 6 старших бит хэша, новые метаданные - конкатенация
+// (таблицы 2, 3) или следующие биты хэша. Запись на место входов: пара i
+// читается из элементов 2i и 2i + 1, уже скопированных во входы хэша.
+template <uint32_t K, int TABLE>
+static void pos_unpack_fx(const pos_k_params_t* params, const pos_fx_input_t* inputs,
+                          const pos_hash_t* hashes, size_t pairs, uint64_t* ys, pos_meta_t* meta) {
+    const uint32_t y_bits = K ? K + POS_EXTRA_BITS : params->y_bits;
+    const uint32_t meta_bits = K ? g_pos_vector_lens[TABLE] * K : params->meta_bits[TABLE];
+    
+    for (size_t i = 0; i < pairs; i++) {
+        ys[i] = pos_load_be64(hashes[i]) >> (64 - y_bits);
+        
+        memset(meta[i], 0, POS_META_SIZE);
+        if (TABLE < 4) {
+            pos_bits_copy(meta[i], 0, inputs[i], y_bits, 2 * meta_bits);
+        } else if (TABLE < 7) {
+            const uint32_t next_bits = K ? g_pos_vector_lens[TABLE + 1] * K :
+                                           params->meta_bits[TABLE + 1];
+            uint8_t hash[32 + 8] = {0};
+            memcpy(hash, hashes[i], 32);
+            pos_bits_copy(meta[i], 0, hash, y_bits, next_bits);
+        }
+    }
+}
+
+// fx: BLAKE3 для всех пар таблицы одним пакетным вызовом
+template <uint32_t K, int TABLE>
+static bool pos_compute_fx(const pos_k_params_t* params, const uint64_t* xs, size_t pairs,
+                           uint64_t* ys, pos_meta_t* meta) {
+    const size_t length = K ? (K + POS_EXTRA_BITS + 2 * g_pos_vector_lens[TABLE] * K + 7) / 8 :
+                              params->input_length[TABLE];
+    
+    pos_fx_input_t inputs[POS_PROOF_X_COUNT / 2];
+    if (!pos_pack_fx<K, TABLE>(params, xs, ys, meta, pairs, inputs)) {
+        return false;
+    }
+    
+    pos_hash_t hashes[POS_PROOF_X_COUNT / 2];
+    pos_blake3_dispatch(inputs[0], POS_FX_INPUT_STRIDE, length, pairs, hashes[0]);
+    
+    pos_unpack_fx<K, TABLE>(params, inputs, hashes, pairs, ys, meta);
+    return true;
+}
+
+// Левая группа идет первой, если ее x меньше, сравнивая с конца
+static bool pos_group_less(const uint64_t* left, const uint64_t* right, size_t size) {
+    for (size_t i = size; i-- > 0;) {
+        if (left[i] != right[i]) {
+            return left[i] < right[i];
+        }
+    }
+    return false;
+}
+
+// Строка качества: x из порядка доказательства переводятся в порядок
+// плота, хэшируются challenge и два соседних x по индексу из challenge
+template <uint32_t K>
+static void pos_quality_string(const pos_k_params_t* params, const uint64_t* proof_xs,
+                               const uint8_t* challenge, uint8_t* quality_string) {
+    const uint32_t k = K ? K : params->k;
+    const size_t length = K ? POS_CHALLENGE_SIZE + (2 * K + 7) / 8 : params->quality_length;
+    
+    uint64_t xs[POS_PROOF_X_COUNT];
+    uint64_t reordered[POS_PROOF_X_COUNT];
+    memcpy(xs, proof_xs, sizeof(xs));
+    
+    for (int table = 1; table < 7; table++) {
+        size_t size = (size_t)1 << (table - 1);
+        for (size_t j = 0; j < POS_PROOF_X_COUNT; j += 2 * size) {
+            const uint64_t* left = xs + j;
+            const uint64_t* right = xs + j + size;
+            bool keep = pos_group_less(left, right, size);
+            memcpy(reordered + j, keep ? left : right, size * sizeof(uint64_t));
+            memcpy(reordered + j + size, keep ? right : left, size * sizeof(uint64_t));
+        }
+        memcpy(xs, reordered, sizeof(xs));
+    }
+    
+    uint32_t quality_index = (uint32_t)(challenge[31] & 0x1f) << 1;
+    
+    uint8_t hash_input[POS_CHALLENGE_SIZE + 16] = {0};
+    memcpy(hash_input, challenge, POS_CHALLENGE_SIZE);
+    pos_bits_put(hash_input + POS_CHALLENGE_SIZE, 0, xs[quality_index], k);
+    pos_bits_put(hash_input + POS_CHALLENGE_SIZE, k, xs[quality_index + 1], k);
+    
+    SHA256(hash_input, length, quality_string);
+}
+
+// Выход f7 должен совпадать с первыми k битами challenge
+static bool pos_check_challenge(uint32_t k, uint64_t y7, const uint8_t* challenge) {
+    uint8_t challenge_bits[POS_CHALLENGE_SIZE] = {0};
+    memcpy(challenge_bits, challenge, POS_CHALLENGE_SIZE);
+    return (y7 >> POS_EXTRA_BITS) == pos_bits_get(challenge_bits, 0, k);
+}
+
+// Проверка доказательства для размера K (0 - любой k из params). Длина
+// доказательства и диапазон k проверены вызывающим.
+template <uint32_t K>
+static bool pos_verify_k(const pos_k_params_t* params, const uint8_t* plot_id,
+                         const uint8_t* challenge, const pos_proof_view_t* proof,
+                         uint8_t* quality_string) {
+    uint64_t xs[POS_PROOF_X_COUNT];
+    uint64_t ys[POS_PROOF_X_COUNT];
+    pos_meta_t meta[POS_PROOF_X_COUNT / 2];
+    
+    pos_load_xs<K>(proof, xs);
+    pos_compute_f1<K>(params, plot_id, xs, ys);
+    
+    // Таблицы 2..7: на каждом шаге число записей уменьшается вдвое
+    if (!pos_compute_fx<K, 2>(params, xs, 32, ys, meta) ||
+        !pos_compute_fx<K, 3>(params, xs, 16, ys, meta) ||
+        !pos_compute_fx<K, 4>(params, xs, 8, ys, meta) ||
+        !pos_compute_fx<K, 5>(params, xs, 4, ys, meta) ||
+        !pos_compute_fx<K, 6>(params, xs, 2, ys, meta) ||
+        !pos_compute_fx<K, 7>(params, xs, 1, ys, meta)) {
+        return false;
+    }
+    
+    if (!pos_check_challenge(K ? K : params->k, ys[0], challenge)) {
+        return false;
+    }
+    
+    if (quality_string) {
+        pos_quality_string<K>(params, xs, challenge, quality_string);
+    }
+    return true;
+}
+
+template <uint32_t K>
+static const pos_k_impl_t* pos_impl(void) {
+    static const pos_k_impl_t impl = {
+        pos_load_xs<K>,
+        pos_compute_f1<K>,
+        { NULL, NULL, pos_pack_fx<K, 2>, pos_pack_fx<K, 3>, pos_pack_fx<K, 4>,
+          pos_pack_fx<K, 5>, pos_pack_fx<K, 6>, pos_pack_fx<K, 7> },
+        { NULL, NULL, pos_unpack_fx<K, 2>, pos_unpack_fx<K, 3>, pos_unpack_fx<K, 4>,
+          pos_unpack_fx<K, 5>, pos_unpack_fx<K, 6>, pos_unpack_fx<K, 7> },
+        pos_quality_string<K>,
+        pos_verify_k<K>
+    };
+    return &impl;
+}
+
+// Специализации для распространенных размеров плота, для остальных -
+// обобщенный путь
+static const pos_k_impl_t* pos_verify_select(uint32_t k) {
+    switch (k) {
+        case 32: return pos_impl<32>();
+        case 33: return pos_impl<33>();
+        case 34: return pos_impl<34>();
+        case 35: return pos_impl<35>();
+    }
+    return pos_impl<0>();
+}
+
+bool pos_verifier_precompute(uint32_t k) {
+    if (k < POS_MIN_K || k > POS_MAX_K) {
+        char log_msg[128];
+        snprintf(log_msg, sizeof(log_msg), "Невалидный k для предварительных вычислений: %u", k);
+        pos_log("ERROR", log_msg);
+        return false;
+    }
+    
+    pos_verifier_best_isa();
+    
+    // Константы записываются до публикации указателя; повторный вызов
+    // записывает те же значения
+    pos_k_params_build(k, &g_pos_k_params[k]);
+    __atomic_store_n(&g_pos_impl_table[k], pos_verify_select(k), __ATOMIC_RELEASE);
+    return true;
+}
+
+bool pos_verifier_is_specialized(uint32_t k) {
+    return k >= POS_MIN_K && k <= POS_MAX_K && pos_verify_select(k) != pos_impl<0>();
+}
+
+// Реализация и константы для k; без предварительных вычислений -
+// обобщенная реализация с константами в local
+static const pos_k_impl_t* pos_resolve(uint32_t k, const pos_k_params_t** params,
+                                       pos_k_params_t* local) {
+    const pos_k_impl_t* impl = __atomic_load_n(&g_pos_impl_table[k], __ATOMIC_ACQUIRE);
+    if (impl) {
+        *params = &g_pos_k_params[k];
+        return impl;
+    }
+    
+    pos_k_params_build(k, local);
+    *params = local;
+    return pos_impl<0>();
+}
+
+static bool pos_verify_check_args(const uint8_t* plot_id, uint32_t k, const uint8_t* challenge,
+                                  const uint8_t* proof, size_t proof_length,
+                                  pos_proof_view_t* view) {
+    if (!plot_id || !challenge || !proof) {
+        pos_log("ERROR", "Невалидные параметры для проверки доказательства");
+        return false;
+    }
+    
+    return pos_proof_view_init(view, proof, proof_length, k);
+}
+
+bool pos_verify_proof(const uint8_t* plot_id, uint32_t k, const uint8_t* challenge,
+                      const uint8_t* proof, size_t proof_length, uint8_t* quality_string) {
+    pos_proof_view_t view;
+    if (!pos_verify_check_args(plot_id, k, challenge, proof, proof_length, &view)) {
+        return false;
+    }
+    
+    const pos_k_params_t* params;
+    pos_k_params_t local;
+    const pos_k_impl_t* impl = pos_resolve(k, &params, &local);
+    return impl->verify(params, plot_id, challenge, &view, quality_string);
+}
+
+bool pos_verify_proof_generic(const uint8_t* plot_id, uint32_t k, const uint8_t* challenge,
+                              const uint8_t* proof, size_t proof_length,
+                              uint8_t* quality_string) {
+    pos_proof_view_t view;
+    if (!pos_verify_check_args(plot_id, k, challenge, proof, proof_length, &view)) {
+        return false;
+    }
+    
+    pos_k_params_t params;
+    pos_k_params_build(k, &params);
+    return pos_verify_k<0>(&params, plot_id, challenge, &view, quality_string);
+}
+
+uint32_t pos_verify_proof_depth(const uint8_t* plot_id, uint32_t k, const uint8_t* challenge,
+                                const uint8_t* proof, size_t proof_length, bool generic) {
+    pos_proof_view_t view;
+    if (!pos_verify_check_args(plot_id, k, challenge, proof, proof_length, &view)) {
+        return 0;
+    }
+    
+    const pos_k_params_t* params;
+    pos_k_params_t local;
+    const pos_k_impl_t* impl;
+    if (generic) {
+        pos_k_params_build(k, &local);
+        params = &local;
+        impl = pos_impl<0>();
+    } else {
+        impl = pos_resolve(k, &params, &local);
+    }
+    
+    // Те же шаги, что у пакетной проверки, с остановкой на первой
+    // несопоставившейся таблице
+    uint64_t xs[POS_PROOF_X_COUNT];
+    uint64_t ys[POS_PROOF_X_COUNT];
+    pos_meta_t meta[POS_PROOF_X_COUNT / 2];
+    pos_fx_input_t inputs[POS_PROOF_X_COUNT / 2];
+    pos_hash_t hashes[POS_PROOF_X_COUNT / 2];
+    
+    impl->load_xs(&view, xs);
+    impl->compute_f1(params, plot_id, xs, ys);
+    
+    size_t pairs = POS_PROOF_X_COUNT / 2;
+    for (int table = 2; table <= 7; table++, pairs /= 2) {
+        if (!impl->pack_fx[table](params, xs, ys, meta, pairs, inputs)) {
+            return (uint32_t)table - 1;
+        }
+        pos_blake3_dispatch(inputs[0], POS_FX_INPUT_STRIDE, params->input_length[table], pairs,
+                            hashes[0]);
+        impl->unpack_fx[table](params, inputs, hashes, pairs, ys, meta);
+    }
+    
+    return pos_check_challenge(k, ys[0], challenge) ? POS_VERIFY_DEPTH_VALID : 7;
+}
+
+// Пакетная проверка
+
+// Доказательств, проверяемых вместе: на таблице 2 это 512 входов BLAKE3
+#define POS_BATCH_CHUNK 16
+
+// Состояние доказательства пачки между таблицами
+typedef struct {
+    size_t index;                      // Номер в пачке
+    pos_proof_view_t proof;
+    const pos_k_impl_t* impl;
+    const pos_k_params_t* params;
+    pos_k_params_t local_params;
+    uint64_t xs[POS_PROOF_X_COUNT];
+    uint64_t ys[POS_PROOF_X_COUNT];
+    pos_meta_t meta[POS_PROOF_X_COUNT / 2];
+    size_t offset;                     // Первый вход BLAKE3 текущей таблицы
+    bool alive;
+} pos_batch_entry_t;
+
+// Доказательства отсортированы по k, поэтому входы одной длины идут
+// подряд: один вызов ядра BLAKE3 на каждую серию
+static void pos_batch_hash(pos_batch_entry_t* entries, size_t count, int table,
+                           const pos_fx_input_t* inputs, size_t rows, pos_hash_t* hashes) {
+    size_t run_begin = 0;
+    size_t run_length = 0;
+    for (size_t e = 0; e < count; e++) {
+        if (!entries[e].alive) {
+            continue;
+        }
+        size_t length = entries[e].params->input_length[table];
+        if (length != run_length) {
+            if (entries[e].offset > run_begin) {
+                pos_blake3_dispatch(inputs[run_begin], POS_FX_INPUT_STRIDE, run_length,
+                                    entries[e].offset - run_begin, hashes[run_begin]);
+            }
+            run_begin = entries[e].offset;
+            run_length = length;
+        }
+    }
+    if (rows > run_begin) {
+        pos_blake3_dispatch(inputs[run_begin], POS_FX_INPUT_STRIDE, run_length,
+                            rows - run_begin, hashes[run_begin]);
+    }
+}
+
+static void pos_batch_verify_chunk(pos_batch_entry_t* entries, size_t count,
+                                   const uint8_t* const* plot_ids, const uint32_t* ks,
+                                   const uint8_t* const* challenges, pos_fx_input_t* inputs,
+                                   pos_hash_t* hashes,
+                                   uint8_t (*quality_strings)[POS_QUALITY_STRING_SIZE],
+                                   bool* results) {
+    for (size_t e = 0; e < count; e++) {
+        pos_batch_entry_t* entry = &entries[e];
+        size_t i = entry->index;
+        entry->impl = pos_resolve(ks[i], &entry->params, &entry->local_params);
+        entry->impl->load_xs(&entry->proof, entry->xs);
+        entry->impl->compute_f1(entry->params, plot_ids[i], entry->xs, entry->ys);
+        entry->alive = true;
+    }
+    
+    size_t pairs = POS_PROOF_X_COUNT / 2;
+    for (int table = 2; table <= 7; table++, pairs /= 2) {
+        size_t rows = 0;
+        for (size_t e = 0; e < count; e++) {
+            pos_batch_entry_t* entry = &entries[e];
+            if (!entry->alive) {
+                continue;
+            }
+            entry->offset = rows;
+            if (entry->impl->pack_fx[table](entry->params, entry->xs, entry->ys, entry->meta,
+                                            pairs, inputs + rows)) {
+                rows += pairs;
+            } else {
+                entry->alive = false;
+            }
+        }
+        
+        pos_batch_hash(entries, count, table, inputs, rows, hashes);
+        
+        for (size_t e = 0; e < count; e++) {
+            pos_batch_entry_t* entry = &entries[e];
+            if (entry->alive) {
+                entry->impl->unpack_fx[table](entry->params, inputs + entry->offset,
+                                              hashes + entry->offset, pairs, entry->ys,
+                                              entry->meta);
+            }
+        }
+    }
+    
+    for (size_t e = 0; e < count; e++) {
+        pos_batch_entry_t* entry = &entries[e];
+        size_t i = entry->index;
+        if (!entry->alive || !pos_check_challenge(ks[i], entry->ys[0], challenges[i])) {
+            continue;
+        }
+        
+        results[i] = true;
+        if (quality_strings) {
+            entry->impl->quality_string(entry->params, entry->xs, challenges[i],
+                                        quality_strings[i]);
+        }
+    }
+}
+
+void pos_verify_proofs_batch(const uint8_t* const* plot_ids, const uint32_t* ks,
+                             const uint8_t* const* challenges, const uint8_t* const* proofs,
+                             const size_t* proof_lengths, size_t count,
+                             uint8_t (*quality_strings)[POS_QUALITY_STRING_SIZE], bool* results) {
+    if (!plot_ids || !ks || !challenges || !proofs || !proof_lengths || !results) {
+        pos_log("ERROR", "Невалидные параметры для пакетной проверки доказательств");
+        return;
+    }
+    
+    // (k, номер): после сортировки доказательства одного k идут подряд
+    // в исходном порядке
+    std::vector<std::pair<uint32_t, size_t> > order;
+    order.reserve(count);
+    for (size_t i = 0; i < count; i++) {
+        pos_proof_view_t view;
+        results[i] = false;
+        if (pos_verify_check_args(plot_ids[i], ks[i], challenges[i], proofs[i], proof_lengths[i],
+                                  &view)) {
+            order.push_back(std::make_pair(ks[i], i));
+        }
+    }
+    if (order.empty()) {
+        return;
+    }
+    std::sort(order.begin(), order.end());
+    
+    size_t chunk = order.size() < POS_BATCH_CHUNK ? order.size() : POS_BATCH_CHUNK;
+    std::vector<pos_batch_entry_t> entries(chunk);
+    std::vector<uint8_t> inputs(chunk * POS_PROOF_X_COUNT / 2 * sizeof(pos_fx_input_t));
+    std::vector<uint8_t> hashes(chunk * POS_PROOF_X_COUNT / 2 * sizeof(pos_hash_t));
+    
+    for (size_t start = 0; start < order.size(); start += chunk) {
+        size_t n = order.size() - start < chunk ? order.size() - start : chunk;
+        for (size_t e = 0; e < n; e++) {
+            size_t i = order[start + e].second;
+            entries[e].index = i;
+            pos_proof_view_init(&entries[e].proof, proofs[i], proof_lengths[i], ks[i]);
+        }
+        pos_batch_verify_chunk(&entries[0], n, plot_ids, ks, challenges,
+                               (pos_fx_input_t*)&inputs[0], (pos_hash_t*)&hashes[0],
+                               quality_strings, results);
+    }
+}
@@ -0,0 +1,312 @@
+#include "security/proof_cache.h"
+
+#include <immintrin.h>
+#include <openssl/evp.h>
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define PROOF_CACHE_MIN_SETS 16
+
+// Запись хранит полный дайджест: совпадение отпечатка без сравнения
+// ключа вернуло бы чужое качество
+typedef struct {
+    uint8_t digest[PROOF_CACHE_DIGEST_SIZE];
+    uint64_t expires;              // Секунда истечения, 0 - пустая запись
+    uint8_t plot_id[32];
+    uint8_t quality_string[32];
+    uint64_t quality;
+    uint32_t proof_size;
+    proof_verification_result_t result;
+} proof_cache_entry_t;
+
+typedef struct {
+    uint32_t lock;                 // Спинлок набора (доступ через __atomic_*)
+    proof_cache_entry_t ways[PROOF_CACHE_WAYS];
+} __attribute__((aligned(64))) proof_cache_set_t;
+
+typedef struct {
+    proof_cache_set_t* sets;
+    uint32_t set_count;            // Степень двойки
+    uint32_t ttl_seconds;
+    uint64_t hits;
+    uint64_t misses;
+    uint64_t evictions;
+    uint64_t occupied;             // Непустых записей
+} proof_cache_table_t;
+
+static proof_cache_table_t g_proof_cache;
+static proof_cache_table_t g_proof_negative_cache;
+
+static void proof_cache_log(const char* level, const char* message) {
+    time_t now = time(NULL);
+    struct tm* tm_info = localtime(&now);
+    char timestamp[20];
+    strftime(timestamp, sizeof(timestamp), "%Y-%m-%d %H:%M:%S", tm_info);
+    
+    printf("[%s] [PROOF_CACHE] [%s] %s\n", timestamp, level, message);
+    fflush(stdout);
+}
+
+static void proof_cache_lock(proof_cache_set_t* set) {
+    while (__atomic_exchange_n(&set->lock, 1, __ATOMIC_ACQUIRE)) {
+        while (__atomic_load_n(&set->lock, __ATOMIC_RELAXED)) {
+            _mm_pause();
+        }
+    }
+}
+
+static void proof_cache_unlock(proof_cache_set_t* set) {
+    __atomic_store_n(&set->lock, 0, __ATOMIC_RELEASE);
+}
+
+static bool proof_cache_table_init(proof_cache_table_t* table, uint32_t capacity,
+                                   uint32_t ttl_seconds) {
+    uint32_t set_count = PROOF_CACHE_MIN_SETS;
+    while ((uint64_t)set_count * PROOF_CACHE_WAYS < capacity && set_count < (1U << 28)) {
+        set_count <<= 1;
+    }
+    
+    proof_cache_set_t* sets = NULL;
+    if (posix_memalign((void**)&sets, 64, (size_t)set_count * sizeof(proof_cache_set_t)) != 0) {
+        return false;
+    }
+    memset(sets, 0, (size_t)set_count * sizeof(proof_cache_set_t));
+    
+    memset(table, 0, sizeof(proof_cache_table_t));
+    table->sets = sets;
+    table->set_count = set_count;
+    table->ttl_seconds = ttl_seconds;
+    return true;
+}
+
+static void proof_cache_table_cleanup(proof_cache_table_t* table) {
+    free(table->sets);
+    memset(table, 0, sizeof(proof_cache_table_t));
+}
+
+static proof_cache_set_t* proof_cache_set_for(const proof_cache_table_t* table,
+                                              const uint8_t* digest) {
+    uint64_t index;
+    memcpy(&index, digest, sizeof(index));
+    return &table->sets[index & (table->set_count - 1)];
+}
+
+// Поиск в таблице: при попадании запись копируется в *found
+static bool proof_cache_table_find(proof_cache_table_t* table, const uint8_t* digest,
+                                   uint64_t now, proof_cache_entry_t* found) {
+    proof_cache_set_t* set = proof_cache_set_for(table, digest);
+    bool hit = false;
+    
+    proof_cache_lock(set);
+    for (int way = 0; way < PROOF_CACHE_WAYS; way++) {
+        proof_cache_entry_t* entry = &set->ways[way];
+        if (entry->expires > now &&
+            memcmp(entry->digest, digest, PROOF_CACHE_DIGEST_SIZE) == 0) {
+            *found = *entry;
+            hit = true;
+            break;
+        }
+    }
+    proof_cache_unlock(set);
+    
+    return hit;
+}
+
+// Запись вытесняет ту же запись, пустую или истекшую, иначе - ту,
+// что истекает раньше всех
+static void proof_cache_table_store(proof_cache_table_t* table, const proof_cache_entry_t* value,
+                                    uint64_t now) {
+    proof_cache_set_t* set = proof_cache_set_for(table, value->digest);
+    
+    proof_cache_lock(set);
+    int victim = 0;
+    for (int way = 0; way < PROOF_CACHE_WAYS; way++) {
+        proof_cache_entry_t* entry = &set->ways[way];
+        if (entry->expires != 0 &&
+            memcmp(entry->digest, value->digest, PROOF_CACHE_DIGEST_SIZE) == 0) {
+            victim = way;
+            break;
+        }
+        if (entry->expires < set->ways[victim].expires) {
+            victim = way;
+        }
+    }
+    
+    proof_cache_entry_t* entry = &set->ways[victim];
+    if (entry->expires == 0) {
+        __atomic_fetch_add(&table->occupied, 1, __ATOMIC_RELAXED);
+    } else if (entry->expires > now &&
+               memcmp(entry->digest, value->digest, PROOF_CACHE_DIGEST_SIZE) != 0) {
+        __atomic_fetch_add(&table->evictions, 1, __ATOMIC_RELAXED);
+    }
+    *entry = *value;
+    entry->expires = now + table->ttl_seconds;
+    proof_cache_unlock(set);
+}
+
+bool proof_cache_init(uint32_t capacity, uint32_t ttl_seconds,
+                      uint32_t negative_capacity, uint32_t negative_ttl_seconds) {
+    proof_cache_cleanup();
+    
+    if (capacity == 0) {
+        proof_cache_log("INFO", "Кеш верификации доказательств отключен");
+        return true;
+    }
+    
+    if (!proof_cache_table_init(&g_proof_cache, capacity, ttl_seconds)) {
+        proof_cache_log("ERROR", "Не удалось выделить память для кеша доказательств");
+        return false;
+    }
+    
+    if (negative_capacity > 0 &&
+        !proof_cache_table_init(&g_proof_negative_cache, negative_capacity,
+                                negative_ttl_seconds)) {
+        proof_cache_log("ERROR", "Не удалось выделить память для кеша отклоненных доказательств");
+        proof_cache_cleanup();
+        return false;
+    }
+    
+    char log_msg[256];
+    snprintf(log_msg, sizeof(log_msg),
+             "Кеш доказательств инициализирован: записей=%u (ttl=%u с), "
+             "отклоненных=%u (ttl=%u с), память=%lu байт",
+             g_proof_cache.set_count * PROOF_CACHE_WAYS, ttl_seconds,
+             g_proof_negative_cache.set_count * PROOF_CACHE_WAYS, negative_ttl_seconds,
+             (uint64_t)(g_proof_cache.set_count + g_proof_negative_cache.set_count) *
+                 sizeof(proof_cache_set_t));
+    proof_cache_log("INFO", log_msg);
+    return true;
+}
+
+void proof_cache_cleanup(void) {
+    proof_cache_table_cleanup(&g_proof_cache);
+    proof_cache_table_cleanup(&g_proof_negative_cache);
+}
+
+bool proof_cache_is_enabled(void) {
+    return g_proof_cache.sets != NULL;
+}
+
+void proof_cache_clear(void) {
+    proof_cache_table_t* tables[2] = { &g_proof_cache, &g_proof_negative_cache };
+    for (int t = 0; t < 2; t++) {
+        proof_cache_table_t* table = tables[t];
+        for (uint32_t s = 0; s < table->set_count; s++) {
+            proof_cache_set_t* set = &table->sets[s];
+            proof_cache_lock(set);
+            for (int way = 0; way < PROOF_CACHE_WAYS; way++) {
+                if (set->ways[way].expires != 0) {
+                    set->ways[way].expires = 0;
+                    __atomic_fetch_sub(&table->occupied, 1, __ATOMIC_RELAXED);
+                    __atomic_fetch_add(&table->evictions, 1, __ATOMIC_RELAXED);
+                }
+            }
+            proof_cache_unlock(set);
+        }
+    }
+}
+
+void proof_cache_digest(const uint8_t* proof_data, size_t proof_length,
+                        const proof_verification_params_t* params, uint8_t* digest) {
+    uint8_t k_size[4] = {
+        (uint8_t)params->k_size, (uint8_t)(params->k_size >> 8),
+        (uint8_t)(params->k_size >> 16), (uint8_t)(params->k_size >> 24)
+    };
+    const uint8_t* sp_hash = params->sp_hash ? params->sp_hash : params->challenge_hash;
+    
+    EVP_MD_CTX* ctx = EVP_MD_CTX_new();
+    EVP_DigestInit_ex(ctx, EVP_sha256(), NULL);
+    EVP_DigestUpdate(ctx, params->plot_id, 32);
+    EVP_DigestUpdate(ctx, params->challenge_hash, 32);
+    EVP_DigestUpdate(ctx, sp_hash, 32);
+    EVP_DigestUpdate(ctx, k_size, sizeof(k_size));
+    EVP_DigestUpdate(ctx, proof_data, proof_length);
+    EVP_DigestFinal_ex(ctx, digest, NULL);
+    EVP_MD_CTX_free(ctx);
+}
+
+bool proof_cache_lookup(const uint8_t* digest, proof_metadata_t* metadata,
+                        proof_verification_result_t* result) {
+    if (!g_proof_cache.sets || !digest || !metadata || !result) {
+        return false;
+    }
+    
+    uint64_t now = (uint64_t)time(NULL);
+    proof_cache_entry_t entry;
+    
+    if (proof_cache_table_find(&g_proof_cache, digest, now, &entry)) {
+        __atomic_fetch_add(&g_proof_cache.hits, 1, __ATOMIC_RELAXED);
+        memcpy(metadata->plot_id, entry.plot_id, sizeof(metadata->plot_id));
+        memcpy(metadata->quality_string, entry.quality_string, sizeof(metadata->quality_string));
+        metadata->quality = entry.quality;
+        metadata->proof_size = entry.proof_size;
+        *result = PROOF_VALID;
+        return true;
+    }
+    __atomic_fetch_add(&g_proof_cache.misses, 1, __ATOMIC_RELAXED);
+    
+    if (!g_proof_negative_cache.sets) {
+        return false;
+    }
+    
+    if (proof_cache_table_find(&g_proof_negative_cache, digest, now, &entry)) {
+        __atomic_fetch_add(&g_proof_negative_cache.hits, 1, __ATOMIC_RELAXED);
+        *result = entry.result;
+        return true;
+    }
+    __atomic_fetch_add(&g_proof_negative_cache.misses, 1, __ATOMIC_RELAXED);
+    return false;
+}
+
+void proof_cache_store(const uint8_t* digest, const proof_metadata_t* metadata) {
+    if (!g_proof_cache.sets || !digest || !metadata) {
+        return;
+    }
+    
+    proof_cache_entry_t entry;
+    memset(&entry, 0, sizeof(entry));
+    memcpy(entry.digest, digest, PROOF_CACHE_DIGEST_SIZE);
+    memcpy(entry.plot_id, metadata->plot_id, sizeof(entry.plot_id));
+    memcpy(entry.quality_string, metadata->quality_string, sizeof(entry.quality_string));
+    entry.quality = metadata->quality;
+    entry.proof_size = metadata->proof_size;
+    entry.result = PROOF_VALID;
+    
+    proof_cache_table_store(&g_proof_cache, &entry, (uint64_t)time(NULL));
+}
+
+void proof_cache_store_negative(const uint8_t* digest, proof_verification_result_t result) {
+    if (!g_proof_negative_cache.sets || !digest) {
+        return;
+    }
+    
+    proof_cache_entry_t entry;
+    memset(&entry, 0, sizeof(entry));
+    memcpy(entry.digest, digest, PROOF_CACHE_DIGEST_SIZE);
+    entry.result = result;
+    
+    proof_cache_table_store(&g_proof_negative_cache, &entry, (uint64_t)time(NULL));
+}
+
+bool proof_cache_get_stats(bool negative, cache_stats_t* stats) {
+    if (!stats) {
+        return false;
+    }
+    
+    const proof_cache_table_t* table = negative ? &g_proof_negative_cache : &g_proof_cache;
+    memset(stats, 0, sizeof(cache_stats_t));
+    if (!table->sets) {
+        return false;
+    }
+    
+    stats->hits = __atomic_load_n(&table->hits, __ATOMIC_RELAXED);
+    stats->misses = __atomic_load_n(&table->misses, __ATOMIC_RELAXED);
+    stats->evictions = __atomic_load_n(&table->evictions, __ATOMIC_RELAXED);
+    stats->memory_used = __atomic_load_n(&table->occupied, __ATOMIC_RELAXED) *
+                         sizeof(proof_cache_entry_t);
+    stats->max_memory = (size_t)table->set_count * sizeof(proof_cache_set_t);
+    return true;
+}
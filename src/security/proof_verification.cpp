@@ -1,11 +1,18 @@
 #include "security/proof_verification.h"
+#include "security/pos_verifier.h"
+#include "security/proof_cache.h"
 #include "math_operations.h"
 
+#include <immintrin.h>
+#include <openssl/sha.h>
+
 #include <stdio.h>
 #include <string.h>
 #include <stdlib.h>
 #include <time.h>
 
+#include <vector>
+
 static void proof_log(const char* level, const char* message) {
     time_t now = time(NULL);
     struct tm* tm_info = localtime(&now);
@@ -19,10 +26,12 @@ static void proof_log(const char* level, const char* message) {
 bool proof_verification_init(void) {
     proof_log("INFO", "Инициализация верификатора доказательств...");
     
-    // Инициализация любых необходимых ресурсов
-    // для верификации Proof of Space
-    
-    proof_log("INFO", "Верификатор доказательств успешно инициализирован");
+    // Ядра ChaCha8 и BLAKE3 выбираются один раз по возможностям CPU
+    char log_msg[128];
+    snprintf(log_msg, sizeof(log_msg),
+             "Верификатор доказательств успешно инициализирован: ядра f1/fx=%s",
+             pos_isa_name(pos_verifier_get_isa()));
+    proof_log("INFO", log_msg);
     return true;
 }
 
@@ -35,132 +44,594 @@ bool proof_verification_cleanup(void) {
     return true;
 }
 
-proof_verification_result_t proof_verify_space(const uint8_t* proof_data, 
-                                              size_t proof_length,
-                                              const proof_verification_params_t* params,
-                                              proof_metadata_t* metadata) {
+// Проверки до верификации: параметры, k и формат доказательства
+static proof_verification_result_t proof_check_format(const uint8_t* proof_data,
+                                                      size_t proof_length,
+                                                      const proof_verification_params_t* params,
+                                                      proof_metadata_t* metadata) {
     if (!proof_data || !params || !metadata) {
         proof_log("ERROR", "Невалидные параметры для верификации доказательства");
         return PROOF_INTERNAL_ERROR;
     }
     
-    proof_log("DEBUG", "Начало верификации Proof of Space...");
-    
     // Проверка размера плота (k-size)
     if (!proof_validate_k_size(params->k_size)) {
         proof_log("ERROR", "Невалидный размер плота (k-size)");
         return PROOF_INVALID_K_SIZE;
     }
     
-    // Проверка качества доказательства
-    uint64_t quality;
-    if (!proof_validate_quality(proof_data, params->k_size, params->challenge, &quality)) {
+    if (!params->plot_id || !params->challenge_hash ||
+        proof_length != pos_proof_size(params->k_size)) {
+        proof_log("ERROR", "Невалидный формат доказательства");
+        return PROOF_INVALID_FORMAT;
+    }
+    return PROOF_VALID;
+}
+
+// Повторно присланное доказательство берется из кеша: принятое -
+// с готовым качеством, отклоненное - с прежним результатом. Возвращает
+// true, если результат найден; digest заполняется при включенном кеше.
+static bool proof_check_cache(const uint8_t* proof_data, size_t proof_length,
+                              const proof_verification_params_t* params,
+                              proof_metadata_t* metadata, uint8_t* digest,
+                              proof_verification_result_t* result) {
+    if (!proof_cache_is_enabled()) {
+        return false;
+    }
+    
+    proof_cache_digest(proof_data, proof_length, params, digest);
+    if (!proof_cache_lookup(digest, metadata, result)) {
+        return false;
+    }
+    
+    if (*result != PROOF_VALID) {
+        proof_log("DEBUG", "Доказательство отклонено по кешу");
+    } else {
+        memcpy(metadata->plot_id, params->plot_id, sizeof(metadata->plot_id));
+    }
+    return true;
+}
+
+// challenge доказательства по параметрам; false - плот не проходит фильтр
+static bool proof_params_pos_challenge(const proof_verification_params_t* params,
+                                       uint8_t* pos_challenge) {
+    if (!proof_calculate_pos_challenge(params->plot_id, params->challenge_hash,
+                                       params->sp_hash, pos_challenge)) {
+        proof_log("ERROR", "Плот не проходит фильтр для точки сигнейджа");
+        return false;
+    }
+    return true;
+}
+
+// Качество - старшие 8 байт строки качества, не меньше 1
+static uint64_t proof_quality_from_string(const uint8_t* quality_string) {
+    uint64_t quality = 0;
+    for (int i = 0; i < 8; i++) {
+        quality = (quality << 8) | quality_string[i];
+    }
+    return quality ? quality : 1;
+}
+
+// Итог проверки качества: метаданные и запись в кеш. Строка качества
+// принятого доказательства уже записана в metadata.
+static proof_verification_result_t proof_finish_quality(bool valid, size_t proof_length,
+                                                        const proof_verification_params_t* params,
+                                                        proof_metadata_t* metadata,
+                                                        const uint8_t* digest) {
+    bool cache_enabled = proof_cache_is_enabled();
+    if (!valid) {
         proof_log("ERROR", "Невалидное качество доказательства");
+        if (cache_enabled) {
+            proof_cache_store_negative(digest, PROOF_INVALID_QUALITY);
+        }
         return PROOF_INVALID_QUALITY;
     }
     
-    metadata->quality = quality;
+    metadata->quality = proof_quality_from_string(metadata->quality_string);
+    metadata->proof_size = proof_length;
+    memcpy(metadata->plot_id, params->plot_id, sizeof(metadata->plot_id));
+    
+    // Итерации зависят от сложности и точки сигнейджа и в кеш не входят
+    if (cache_enabled) {
+        proof_cache_store(digest, metadata);
+    }
+    return PROOF_VALID;
+}
+
+proof_verification_result_t proof_verify_space_quality(const uint8_t* proof_data,
+                                                      size_t proof_length,
+                                                      const proof_verification_params_t* params,
+                                                      proof_metadata_t* metadata) {
+    proof_verification_result_t result = proof_check_format(proof_data, proof_length,
+                                                            params, metadata);
+    if (result != PROOF_VALID) {
+        return result;
+    }
+    
+    proof_log("DEBUG", "Начало верификации Proof of Space...");
+    
+    uint8_t digest[PROOF_CACHE_DIGEST_SIZE];
+    if (proof_check_cache(proof_data, proof_length, params, metadata, digest, &result)) {
+        return result;
+    }
+    
+    // Проверка доказательства и вычисление качества
+    uint64_t quality;
+    bool valid = proof_validate_quality(proof_data, proof_length, params,
+                                        metadata->quality_string, &quality);
+    return proof_finish_quality(valid, proof_length, params, metadata, digest);
+}
+
+proof_verification_result_t proof_verify_space(const uint8_t* proof_data, 
+                                              size_t proof_length,
+                                              const proof_verification_params_t* params,
+                                              proof_metadata_t* metadata) {
+    proof_verification_result_t result = proof_verify_space_quality(proof_data, proof_length,
+                                                                    params, metadata);
+    if (result != PROOF_VALID) {
+        return result;
+    }
     
     // Проверка итераций
+    const uint8_t* sp_hash = params->sp_hash ? params->sp_hash : params->challenge_hash;
     uint64_t iterations;
-    if (!proof_validate_iterations(quality, params->difficulty, 
-                                  params->sub_slot_iters, &iterations)) {
+    if (!proof_validate_iterations(metadata->quality_string, sp_hash, params->k_size,
+                                   params->difficulty, params->sub_slot_iters, &iterations)) {
         proof_log("ERROR", "Невалидное количество итераций");
         return PROOF_INVALID_ITERATIONS;
     }
     
     metadata->iterations = iterations;
-    metadata->proof_size = proof_length;
-    
-    // Извлекаем информацию о плоте из доказательства
-    // В реальной реализации здесь будет парсинг структуры доказательства
-    
-    // Упрощенное извлечение plot_id (первые 32 байта proof)
-    memcpy(metadata->plot_id, proof_data, 32);
     
     proof_log("DEBUG", "Proof of Space верифицирован успешно");
     return PROOF_VALID;
 }
 
-bool proof_validate_quality(const uint8_t* proof_data, uint32_t k_size, 
-                           uint64_t challenge, uint64_t* quality) {
-    if (!proof_data || !quality) {
+void proof_verify_space_batch(const uint8_t* const* proofs, const size_t* proof_lengths,
+                              const proof_verification_params_t* params, size_t count,
+                              proof_metadata_t* metadata, proof_verification_result_t* results) {
+    if (!proofs || !proof_lengths || !params || !metadata || !results) {
+        proof_log("ERROR", "Невалидные параметры для пакетной верификации доказательств");
+        return;
+    }
+    
+    // Формат и кеш - по каждому доказательству; непроверенные доказательства
+    // уходят в пакетный верификатор, доказательства с качеством - в расчет итераций
+    std::vector<uint8_t> digests(count * PROOF_CACHE_DIGEST_SIZE);
+    std::vector<uint8_t> pos_challenges(count * POS_CHALLENGE_SIZE);
+    std::vector<size_t> pending;
+    std::vector<size_t> qualified;
+    pending.reserve(count);
+    qualified.reserve(count);
+    
+    for (size_t i = 0; i < count; i++) {
+        results[i] = proof_check_format(proofs[i], proof_lengths[i], &params[i], &metadata[i]);
+        if (results[i] != PROOF_VALID) {
+            continue;
+        }
+        
+        if (proof_check_cache(proofs[i], proof_lengths[i], &params[i], &metadata[i],
+                              &digests[i * PROOF_CACHE_DIGEST_SIZE], &results[i])) {
+            if (results[i] == PROOF_VALID) {
+                qualified.push_back(i);
+            }
+            continue;
+        }
+        
+        // Плот, не прошедший фильтр, отклоняется без проверки таблиц
+        if (!proof_params_pos_challenge(&params[i], &pos_challenges[i * POS_CHALLENGE_SIZE])) {
+            results[i] = proof_finish_quality(false, proof_lengths[i], &params[i], &metadata[i],
+                                              &digests[i * PROOF_CACHE_DIGEST_SIZE]);
+            continue;
+        }
+        pending.push_back(i);
+    }
+    
+    size_t verify_count = pending.size();
+    if (verify_count > 0) {
+        std::vector<const uint8_t*> plot_ids(verify_count);
+        std::vector<const uint8_t*> challenges(verify_count);
+        std::vector<const uint8_t*> proof_ptrs(verify_count);
+        std::vector<uint32_t> ks(verify_count);
+        std::vector<size_t> lengths(verify_count);
+        std::vector<uint8_t> quality_strings(verify_count * POS_QUALITY_STRING_SIZE);
+        bool* valid = new bool[verify_count];
+        
+        for (size_t j = 0; j < verify_count; j++) {
+            size_t i = pending[j];
+            plot_ids[j] = params[i].plot_id;
+            challenges[j] = &pos_challenges[i * POS_CHALLENGE_SIZE];
+            proof_ptrs[j] = proofs[i];
+            ks[j] = params[i].k_size;
+            lengths[j] = proof_lengths[i];
+        }
+        
+        pos_verify_proofs_batch(&plot_ids[0], &ks[0], &challenges[0], &proof_ptrs[0], &lengths[0],
+                                verify_count,
+                                (uint8_t (*)[POS_QUALITY_STRING_SIZE])&quality_strings[0], valid);
+        
+        for (size_t j = 0; j < verify_count; j++) {
+            size_t i = pending[j];
+            if (valid[j]) {
+                memcpy(metadata[i].quality_string, &quality_strings[j * POS_QUALITY_STRING_SIZE],
+                       POS_QUALITY_STRING_SIZE);
+            }
+            results[i] = proof_finish_quality(valid[j], proof_lengths[i], &params[i], &metadata[i],
+                                              &digests[i * PROOF_CACHE_DIGEST_SIZE]);
+            if (results[i] == PROOF_VALID) {
+                qualified.push_back(i);
+            }
+        }
+        delete[] valid;
+    }
+    
+    // Требуемые итерации всех доказательств с качеством одним проходом
+    size_t qualified_count = qualified.size();
+    if (qualified_count > 0) {
+        std::vector<uint8_t> quality_strings(qualified_count * 32);
+        std::vector<uint8_t> sp_hashes(qualified_count * 32);
+        std::vector<uint32_t> ks(qualified_count);
+        std::vector<uint64_t> difficulties(qualified_count);
+        std::vector<uint64_t> iterations(qualified_count);
+        
+        for (size_t j = 0; j < qualified_count; j++) {
+            size_t i = qualified[j];
+            const uint8_t* sp_hash = params[i].sp_hash ? params[i].sp_hash :
+                                                         params[i].challenge_hash;
+            memcpy(&quality_strings[j * 32], metadata[i].quality_string, 32);
+            memcpy(&sp_hashes[j * 32], sp_hash, 32);
+            ks[j] = params[i].k_size;
+            difficulties[j] = params[i].difficulty;
+        }
+        
+        calculate_iterations_quality_batch(PROOF_DIFFICULTY_CONSTANT_FACTOR,
+                                           (const uint8_t (*)[32])&quality_strings[0],
+                                           (const uint8_t (*)[32])&sp_hashes[0],
+                                           &ks[0], &difficulties[0], qualified_count,
+                                           &iterations[0]);
+        
+        for (size_t j = 0; j < qualified_count; j++) {
+            size_t i = qualified[j];
+            uint64_t sp_interval_iters = params[i].sub_slot_iters / PROOF_NUM_SPS_SUB_SLOT;
+            if (difficulties[j] == 0 || iterations[j] >= sp_interval_iters) {
+                results[i] = PROOF_INVALID_ITERATIONS;
+                continue;
+            }
+            metadata[i].iterations = iterations[j];
+        }
+    }
+    
+    char log_msg[128];
+    snprintf(log_msg, sizeof(log_msg),
+             "Пакетная верификация: доказательств=%zu, проверено=%zu, с качеством=%zu",
+             count, verify_count, qualified_count);
+    proof_log("DEBUG", log_msg);
+}
+
+bool proof_validate_quality(const uint8_t* proof_data, size_t proof_length,
+                           const proof_verification_params_t* params,
+                           uint8_t* quality_string, uint64_t* quality) {
+    if (!proof_data || !params || !params->plot_id || !params->challenge_hash || !quality) {
         proof_log("ERROR", "Невалидные параметры для проверки качества");
         return false;
     }
     
-    // В реальной реализации здесь будет вычисление качества доказательства
-    // по алгоритму Chia Proof of Space
-    
-    // Упрощенная версия - вычисляем "качество" на основе первых 8 байт proof
-    *quality = *(uint64_t*)proof_data;
+    uint8_t pos_challenge[POS_CHALLENGE_SIZE];
+    if (!proof_params_pos_challenge(params, pos_challenge)) {
+        return false;
+    }
     
-    // Нормализуем качество
-    if (*quality == 0) {
-        *quality = 1; // Минимальное качество
+    // f1 и f2..f7 по алгоритму chiapos, качество - SHA256 от pos_challenge
+    // и двух x, выбранных по последним битам pos_challenge
+    uint8_t local_quality[POS_QUALITY_STRING_SIZE];
+    uint8_t* out = quality_string ? quality_string : local_quality;
+    if (!pos_verify_proof(params->plot_id, params->k_size, pos_challenge,
+                          proof_data, proof_length, out)) {
+        return false;
     }
     
+    *quality = proof_quality_from_string(out);
+    
     char log_msg[128];
     snprintf(log_msg, sizeof(log_msg), 
-             "Качество доказательства: %lu (k-size: %u)", *quality, k_size);
+             "Качество доказательства: %lu (k-size: %u)", *quality, params->k_size);
     proof_log("DEBUG", log_msg);
     
     return true;
 }
 
-bool proof_validate_iterations(uint64_t quality, uint64_t difficulty, 
-                              uint64_t sub_slot_iters, uint64_t* iterations) {
-    if (!iterations) {
-        proof_log("ERROR", "Iterations pointer не может быть NULL");
+bool proof_calculate_pos_challenge(const uint8_t* plot_id, const uint8_t* challenge_hash,
+                                   const uint8_t* sp_hash, uint8_t* pos_challenge) {
+    if (!plot_id || !challenge_hash || !pos_challenge) {
+        proof_log("ERROR", "Невалидные параметры для вычисления challenge доказательства");
         return false;
     }
     
-    if (quality == 0) {
-        proof_log("ERROR", "Качество не может быть нулевым");
-        return false;
+    uint8_t input[96];
+    memcpy(input, plot_id, 32);
+    memcpy(input + 32, challenge_hash, 32);
+    memcpy(input + 64, sp_hash ? sp_hash : challenge_hash, 32);
+    uint8_t filter_input[32];
+    SHA256(input, sizeof(input), filter_input);
+    SHA256(filter_input, sizeof(filter_input), pos_challenge);
+    
+    uint32_t prefix = ((uint32_t)filter_input[0] << 24) | ((uint32_t)filter_input[1] << 16) |
+                      ((uint32_t)filter_input[2] << 8) | filter_input[3];
+    return (prefix >> (32 - PROOF_PLOT_FILTER_PREFIX_BITS)) == 0;
+}
+
+// Требуемые итерации
+
+// 128 / 64 деление одной инструкцией divq; вызывающий гарантирует hi < divisor
+static inline uint64_t proof_div128(uint64_t hi, uint64_t lo, uint64_t divisor) {
+    uint64_t quotient, remainder;
+    __asm__("divq %4" : "=a"(quotient), "=d"(remainder) : "a"(lo), "d"(hi), "r"(divisor));
+    return quotient;
+}
+
+// floor(difficulty * dcf * hash / (2^256 * (2k + 1) * 2^(k - 1))) для хэша
+// из 4 слов little-endian. Вложенные деления с округлением вниз дают тот же
+// результат, что и одно деление на произведение: сначала берутся старшие
+// слова произведения (деление на 2^256), затем сдвиг на k - 1 и деление на
+// 2k + 1. Все условия вычисляются масками.
+static inline uint64_t proof_iterations_from_hash(unsigned __int128 dcf, const uint64_t* hash,
+                                                  uint32_t k_size, uint64_t difficulty) {
+    typedef unsigned __int128 u128;
+    
+    // difficulty * dcf - 192 бита
+    u128 low = (u128)difficulty * (uint64_t)dcf;
+    u128 high = (u128)difficulty * (uint64_t)(dcf >> 64) + (uint64_t)(low >> 64);
+    uint64_t m[3] = { (uint64_t)low, (uint64_t)high, (uint64_t)(high >> 64) };
+    
+    // Произведение на хэш - 448 бит
+    uint64_t p[7] = { 0, 0, 0, 0, 0, 0, 0 };
+    for (int i = 0; i < 3; i++) {
+        uint64_t carry = 0;
+        for (int j = 0; j < 4; j++) {
+            u128 t = (u128)m[i] * hash[j] + p[i + j] + carry;
+            p[i + j] = (uint64_t)t;
+            carry = (uint64_t)(t >> 64);
+        }
+        p[i + 4] = carry;
     }
     
-    if (difficulty == 0) {
-        proof_log("ERROR", "Сложность не может быть нулевой");
-        return false;
+    uint32_t shift = k_size - 1;
+    uint64_t t0 = (p[4] >> shift) | (p[5] << (64 - shift));
+    uint64_t t1 = (p[5] >> shift) | (p[6] << (64 - shift));
+    uint64_t t2 = p[6] >> shift;
+    
+    // Частное не помещается в 64 бита - насыщение
+    uint64_t divisor = 2 * (uint64_t)k_size + 1;
+    uint64_t saturate = 0 - (uint64_t)((t2 != 0) | (t1 >= divisor));
+    uint64_t iterations = proof_div128(t1 & ~saturate, t0, divisor) | saturate;
+    return iterations + (iterations == 0);
+}
+
+static inline void proof_hash_words(const uint8_t* digest, uint64_t* hash) {
+    for (int i = 0; i < 4; i++) {
+        uint64_t word;
+        memcpy(&word, digest + 8 * (3 - i), sizeof(word));
+        hash[i] = __builtin_bswap64(word);
+    }
+}
+
+uint64_t calculate_iterations_quality(unsigned __int128 difficulty_constant_factor,
+                                      const uint8_t* quality_string, uint32_t k_size,
+                                      uint64_t difficulty, const uint8_t* sp_hash) {
+    if (!quality_string || !sp_hash || k_size < 2 || k_size > 64) {
+        proof_log("ERROR", "Невалидные параметры для расчета итераций");
+        return UINT64_MAX;
+    }
+    
+    uint8_t input[64];
+    memcpy(input, quality_string, 32);
+    memcpy(input + 32, sp_hash, 32);
+    uint8_t digest[32];
+    SHA256(input, sizeof(input), digest);
+    
+    uint64_t hash[4];
+    proof_hash_words(digest, hash);
+    return proof_iterations_from_hash(difficulty_constant_factor, hash, k_size, difficulty);
+}
+
+// SHA256 восьми 64-байтовых сообщений quality_string || sp_hash на AVX2.
+// Второй блок - постоянное дополнение, его расписание считается один раз.
+
+static const uint32_t g_proof_sha256_k[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+static const uint32_t g_proof_sha256_iv[8] = {
+    0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
+};
+
+#define PROOF_SHA256_LANES 8
+
+#define PROOF_AVX2_ROTR(v, n) _mm256_or_si256(_mm256_srli_epi32(v, n), _mm256_slli_epi32(v, 32 - (n)))
+
+// Раунды сжатия; kw[t] - сумма константы раунда и слова расписания
+__attribute__((target("avx2")))
+static inline void proof_sha256_rounds_avx2(__m256i* state, const __m256i* kw) {
+    __m256i a = state[0], b = state[1], c = state[2], d = state[3];
+    __m256i e = state[4], f = state[5], g = state[6], h = state[7];
+    
+    for (int t = 0; t < 64; t++) {
+        __m256i s1 = _mm256_xor_si256(_mm256_xor_si256(PROOF_AVX2_ROTR(e, 6), PROOF_AVX2_ROTR(e, 11)),
+                                      PROOF_AVX2_ROTR(e, 25));
+        __m256i ch = _mm256_xor_si256(_mm256_and_si256(e, f), _mm256_andnot_si256(e, g));
+        __m256i t1 = _mm256_add_epi32(_mm256_add_epi32(h, s1), _mm256_add_epi32(ch, kw[t]));
+        __m256i s0 = _mm256_xor_si256(_mm256_xor_si256(PROOF_AVX2_ROTR(a, 2), PROOF_AVX2_ROTR(a, 13)),
+                                      PROOF_AVX2_ROTR(a, 22));
+        __m256i maj = _mm256_or_si256(_mm256_and_si256(a, b), _mm256_and_si256(c, _mm256_or_si256(a, b)));
+        __m256i t2 = _mm256_add_epi32(s0, maj);
+        h = g;
+        g = f;
+        f = e;
+        e = _mm256_add_epi32(d, t1);
+        d = c;
+        c = b;
+        b = a;
+        a = _mm256_add_epi32(t1, t2);
+    }
+    
+    state[0] = _mm256_add_epi32(state[0], a);
+    state[1] = _mm256_add_epi32(state[1], b);
+    state[2] = _mm256_add_epi32(state[2], c);
+    state[3] = _mm256_add_epi32(state[3], d);
+    state[4] = _mm256_add_epi32(state[4], e);
+    state[5] = _mm256_add_epi32(state[5], f);
+    state[6] = _mm256_add_epi32(state[6], g);
+    state[7] = _mm256_add_epi32(state[7], h);
+}
+
+// digest_words[w][lane] - слово w хэша сообщения lane
+__attribute__((target("avx2")))
+static void proof_sha256_x8_avx2(const uint8_t (*quality_strings)[32],
+                                 const uint8_t (*sp_hashes)[32],
+                                 const uint32_t* padding_kw,
+                                 uint32_t (*digest_words)[PROOF_SHA256_LANES]) {
+    __m256i w[64];
+    for (int t = 0; t < 16; t++) {
+        uint32_t words[PROOF_SHA256_LANES];
+        for (int lane = 0; lane < PROOF_SHA256_LANES; lane++) {
+            const uint8_t* src = t < 8 ? quality_strings[lane] + 4 * t :
+                                         sp_hashes[lane] + 4 * (t - 8);
+            uint32_t word;
+            memcpy(&word, src, sizeof(word));
+            words[lane] = __builtin_bswap32(word);
+        }
+        w[t] = _mm256_loadu_si256((const __m256i*)words);
+    }
+    for (int t = 16; t < 64; t++) {
+        __m256i x = w[t - 15];
+        __m256i y = w[t - 2];
+        __m256i s0 = _mm256_xor_si256(_mm256_xor_si256(PROOF_AVX2_ROTR(x, 7), PROOF_AVX2_ROTR(x, 18)),
+                                      _mm256_srli_epi32(x, 3));
+        __m256i s1 = _mm256_xor_si256(_mm256_xor_si256(PROOF_AVX2_ROTR(y, 17), PROOF_AVX2_ROTR(y, 19)),
+                                      _mm256_srli_epi32(y, 10));
+        w[t] = _mm256_add_epi32(_mm256_add_epi32(w[t - 16], s0), _mm256_add_epi32(w[t - 7], s1));
+    }
+    for (int t = 0; t < 64; t++) {
+        w[t] = _mm256_add_epi32(w[t], _mm256_set1_epi32((int)g_proof_sha256_k[t]));
     }
     
-    // Вычисляем итерации по формуле Chia
-    // iterations = (sub_slot_iters * difficulty * (2^64)) / (quality * 1000000000000)
+    __m256i state[8];
+    for (int i = 0; i < 8; i++) {
+        state[i] = _mm256_set1_epi32((int)g_proof_sha256_iv[i]);
+    }
+    proof_sha256_rounds_avx2(state, w);
     
-    uint64_t numerator = sub_slot_iters * difficulty;
-    uint64_t denominator = quality;
+    for (int t = 0; t < 64; t++) {
+        w[t] = _mm256_set1_epi32((int)padding_kw[t]);
+    }
+    proof_sha256_rounds_avx2(state, w);
     
-    // Предотвращаем деление на ноль
-    if (denominator == 0) {
-        *iterations = 0;
-        proof_log("ERROR", "Деноминатор равен нулю при вычислении итераций");
+    for (int i = 0; i < 8; i++) {
+        _mm256_storeu_si256((__m256i*)digest_words[i], state[i]);
+    }
+}
+
+// Расписание блока дополнения 64-байтового сообщения: 0x80, нули, длина 512 бит
+static void proof_sha256_padding_kw(uint32_t* kw) {
+    uint32_t w[64];
+    memset(w, 0, sizeof(w));
+    w[0] = 0x80000000;
+    w[15] = 512;
+    for (int t = 16; t < 64; t++) {
+        uint32_t x = w[t - 15];
+        uint32_t y = w[t - 2];
+        uint32_t s0 = ((x >> 7) | (x << 25)) ^ ((x >> 18) | (x << 14)) ^ (x >> 3);
+        uint32_t s1 = ((y >> 17) | (y << 15)) ^ ((y >> 19) | (y << 13)) ^ (y >> 10);
+        w[t] = w[t - 16] + s0 + w[t - 7] + s1;
+    }
+    for (int t = 0; t < 64; t++) {
+        kw[t] = w[t] + g_proof_sha256_k[t];
+    }
+}
+
+void calculate_iterations_quality_batch(unsigned __int128 difficulty_constant_factor,
+                                        const uint8_t (*quality_strings)[32],
+                                        const uint8_t (*sp_hashes)[32],
+                                        const uint32_t* k_sizes, const uint64_t* difficulties,
+                                        size_t count, uint64_t* iterations) {
+    if (!quality_strings || !sp_hashes || !k_sizes || !difficulties || !iterations) {
+        proof_log("ERROR", "Невалидные параметры для пакетного расчета итераций");
+        return;
+    }
+    
+    size_t i = 0;
+    if (__builtin_cpu_supports("avx2")) {
+        uint32_t padding_kw[64];
+        proof_sha256_padding_kw(padding_kw);
+        
+        uint32_t digest_words[8][PROOF_SHA256_LANES];
+        for (; i + PROOF_SHA256_LANES <= count; i += PROOF_SHA256_LANES) {
+            proof_sha256_x8_avx2(quality_strings + i, sp_hashes + i, padding_kw, digest_words);
+            
+            for (int lane = 0; lane < PROOF_SHA256_LANES; lane++) {
+                uint64_t hash[4];
+                for (int j = 0; j < 4; j++) {
+                    hash[j] = ((uint64_t)digest_words[6 - 2 * j][lane] << 32) |
+                              digest_words[7 - 2 * j][lane];
+                }
+                iterations[i + lane] = k_sizes[i + lane] >= 2 && k_sizes[i + lane] <= 64 ?
+                    proof_iterations_from_hash(difficulty_constant_factor, hash,
+                                               k_sizes[i + lane], difficulties[i + lane]) :
+                    UINT64_MAX;
+            }
+        }
+    }
+    
+    // Хвост пачки и процессоры без AVX2
+    for (; i < count; i++) {
+        iterations[i] = calculate_iterations_quality(difficulty_constant_factor, quality_strings[i],
+                                                     k_sizes[i], difficulties[i], sp_hashes[i]);
+    }
+}
+
+bool proof_validate_iterations(const uint8_t* quality_string, const uint8_t* sp_hash,
+                               uint32_t k_size, uint64_t difficulty,
+                               uint64_t sub_slot_iters, uint64_t* iterations) {
+    if (!quality_string || !sp_hash || !iterations) {
+        proof_log("ERROR", "Невалидные параметры для проверки итераций");
         return false;
     }
     
-    *iterations = numerator / denominator;
+    if (difficulty == 0) {
+        proof_log("ERROR", "Сложность не может быть нулевой");
+        return false;
+    }
     
-    // Применяем масштабирующий фактор (упрощенно)
-    *iterations = *iterations / 1000000;
+    *iterations = calculate_iterations_quality(PROOF_DIFFICULTY_CONSTANT_FACTOR, quality_string,
+                                               k_size, difficulty, sp_hash);
+    uint64_t sp_interval_iters = sub_slot_iters / PROOF_NUM_SPS_SUB_SLOT;
     
     char log_msg[256];
     snprintf(log_msg, sizeof(log_msg),
-             "Вычислены итерации: quality=%lu, difficulty=%lu, "
-             "sub_slot_iters=%lu, iterations=%lu",
-             quality, difficulty, sub_slot_iters, *iterations);
+             "Вычислены итерации: k=%u, difficulty=%lu, iterations=%lu, "
+             "sp_interval_iters=%lu",
+             k_size, difficulty, *iterations, sp_interval_iters);
     proof_log("DEBUG", log_msg);
     
-    return true;
+    return *iterations < sp_interval_iters;
 }
 
 bool proof_validate_k_size(uint32_t k_size) {
     // Проверяем, что k-size находится в допустимом диапазоне
-    bool valid = (k_size >= 25 && k_size <= 50);
+    bool valid = (k_size >= PROOF_MIN_K_SIZE && k_size <= PROOF_MAX_K_SIZE);
     
     if (!valid) {
         char log_msg[128];
         snprintf(log_msg, sizeof(log_msg), 
-                 "Невалидный k-size: %u (допустимый диапазон: 25-50)", k_size);
+                 "Невалидный k-size: %u (допустимый диапазон: %d-%d)", k_size,
+                 PROOF_MIN_K_SIZE, PROOF_MAX_K_SIZE);
         proof_log("ERROR", log_msg);
     } else {
         char log_msg[128];
@@ -235,18 +706,16 @@ bool proof_calculate_points(uint64_t quality, uint64_t difficulty, uint64_t* poi
     return true;
 }
 
-bool proof_verify_space_optimized(const uint8_t* proof_data, uint32_t k_size,
-                                 uint64_t challenge, uint64_t* quality) {
-    if (!proof_data || !quality) {
+bool proof_verify_space_optimized(const uint8_t* proof_data, size_t proof_length,
+                                 const proof_verification_params_t* params,
+                                 uint64_t* quality) {
+    if (!proof_data || !params || !quality) {
         proof_log("ERROR", "Невалидные параметры для оптимизированной верификации");
         return false;
     }
     
-    // Оптимизированная версия верификации Proof of Space
-    // В реальной реализации здесь будут ассемблерные оптимизации
-    
-    // Упрощенная реализация - используем базовую функцию
-    bool result = proof_validate_quality(proof_data, k_size, challenge, quality);
+    // Векторные ядра ChaCha8 и BLAKE3 выбираются внутри pos_verify_proof
+    bool result = proof_validate_quality(proof_data, proof_length, params, NULL, quality);
     
     proof_log("DEBUG", "Оптимизированная верификация Proof of Space завершена");
     return result;
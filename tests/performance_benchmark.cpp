@@ -2,8 +2,20 @@
 #include "math_operations.h"
 #include "security/auth.h"
 #include "security/proof_verification.h"
+#include "security/pos_verifier.h"
+#include "security/proof_cache.h"
+#include "security/bls.h"
+#include "security/bls_key_cache.h"
 #include "protocol/partials.h"
+#include "protocol/partial_journal.h"
+#include "optimizations.h"
 #include <random>
+#include <cstring>
+#include <cstdlib>
+#include <ctime>
+#include <thread>
+#include <vector>
+#include <memory>
 
 extern "C" {
     // Объявления ассемблерных функций
@@ -23,7 +35,7 @@ protected:
         auth_init(&test_key);
         proof_verification_init();
     }
-
+    
     void TearDown(const benchmark::State& state) override {
         auth_cleanup();
         proof_verification_cleanup();
@@ -133,15 +145,23 @@ BENCHMARK_F(PerformanceBenchmark, MathCalculateDifficulty)(benchmark::State& sta
 }
 
 BENCHMARK_F(PerformanceBenchmark, ProofVerification)(benchmark::State& state) {
-    uint8_t proof_data[368];
+    uint8_t proof_data[256];
     memset(proof_data, 0xAA, sizeof(proof_data)); // Заполняем тестовыми данными
+    uint8_t plot_id[32];
+    uint8_t challenge[32];
+    memset(plot_id, 0x11, sizeof(plot_id));
+    memset(challenge, 0x22, sizeof(challenge));
     
+    // Случайное доказательство отклоняется уже на сопоставлении таблицы 2
     proof_verification_params_t params = {
         .challenge = 123456789,
         .k_size = 32,
         .sub_slot_iters = 37600000000ULL,
         .difficulty = 1000,
-        .required_iterations = 0
+        .required_iterations = 0,
+        .plot_id = plot_id,
+        .challenge_hash = challenge,
+        .sp_hash = NULL
     };
     
     proof_metadata_t metadata;
@@ -200,7 +220,688 @@ BENCHMARK_F(PerformanceBenchmark, PayoutCalculation)(benchmark::State& state) {
     state.SetItemsProcessed(state.iterations());
 }
 
+// Пропускная способность очереди partials при росте числа производителей.
+// Четыре потребителя забирают элементы пачками, как воркеры валидации.
+static void BM_PartialQueueProducers(benchmark::State& state) {
+    const int producers = static_cast<int>(state.range(0));
+    const int consumers = 4;
+    const int per_producer = 4096;
+    const uint64_t stop_marker = UINT64_MAX;
+    
+    partial_queue_t queue;
+    partial_queue_init(&queue, PARTIAL_QUEUE_DEFAULT_SIZE);
+    
+    for (auto _ : state) {
+        std::vector<std::thread> threads;
+        for (int c = 0; c < consumers; c++) {
+            threads.emplace_back([&queue, stop_marker]() {
+                partial_t batch[32];
+                for (;;) {
+                    size_t n = partial_queue_pop_batch(&queue, batch, 32);
+                    for (size_t i = 0; i < n; i++) {
+                        if (batch[i].difficulty == stop_marker) {
+                            partial_queue_push_batch(&queue, batch + i + 1, n - i - 1);
+                            return;
+                        }
+                    }
+                    benchmark::DoNotOptimize(batch);
+                }
+            });
+        }
+        
+        std::vector<std::thread> producer_threads;
+        for (int p = 0; p < producers; p++) {
+            producer_threads.emplace_back([&queue]() {
+                partial_t partial;
+                memset(&partial, 0, sizeof(partial_t));
+                for (int i = 0; i < per_producer; i++) {
+                    partial.difficulty = i;
+                    while (!partial_queue_push(&queue, &partial)) {
+                        std::this_thread::yield();
+                    }
+                }
+            });
+        }
+        for (auto& t : producer_threads) t.join();
+        
+        partial_t stop;
+        memset(&stop, 0, sizeof(partial_t));
+        stop.difficulty = stop_marker;
+        for (int c = 0; c < consumers; c++) {
+            while (!partial_queue_push(&queue, &stop)) {
+                std::this_thread::yield();
+            }
+        }
+        for (auto& t : threads) t.join();
+        
+        partial_t rest;
+        while (partial_queue_try_pop(&queue, &rest)) {}
+    }
+    
+    partial_queue_cleanup(&queue);
+    state.SetItemsProcessed(state.iterations() * producers * per_producer);
+}
+
+// Стоимость приема одного partial от Go: разбор полей и постановка в
+// очередь. Потребитель не нужен - partial сразу извлекается обратно.
+static void fill_hex(char* out, size_t bytes, uint32_t seed) {
+    static const char digits[] = "0123456789abcdef";
+    for (size_t i = 0; i < bytes * 2; i++) {
+        out[i] = digits[(seed + i * 7) & 15];
+    }
+    out[bytes * 2] = '\0';
+}
+
+struct IngestRequest {
+    char challenge[65];
+    char launcher_id[65];
+    char signature[193];
+};
+
+// Прежний путь: sscanf на каждый байт и partial на стеке
+static void BM_PartialIngestSscanf(benchmark::State& state) {
+    IngestRequest request;
+    fill_hex(request.challenge, 32, 1);
+    fill_hex(request.launcher_id, 32, 2);
+    fill_hex(request.signature, 96, 3);
+    
+    partial_queue_t queue;
+    partial_queue_init(&queue, 1024);
+    partial_t popped;
+    
+    for (auto _ : state) {
+        uint8_t challenge[32], launcher_id[32], signature[96];
+        for (int i = 0; i < 32; i++) {
+            sscanf(request.challenge + i * 2, "%02hhx", &challenge[i]);
+            sscanf(request.launcher_id + i * 2, "%02hhx", &launcher_id[i]);
+        }
+        for (int i = 0; i < 96; i++) {
+            sscanf(request.signature + i * 2, "%02hhx", &signature[i]);
+        }
+        
+        partial_t partial;
+        memset(&partial, 0, sizeof(partial_t));
+        memcpy(partial.challenge, challenge, 32);
+        memcpy(partial.launcher_id, launcher_id, 32);
+        memcpy(partial.signature, signature, 96);
+        partial_queue_push(&queue, &partial);
+        partial_queue_try_pop(&queue, &popped);
+    }
+    
+    partial_queue_cleanup(&queue);
+    state.SetItemsProcessed(state.iterations());
+}
+
+// Строковый путь с векторным hex декодером
+static void BM_PartialIngestSimdHex(benchmark::State& state) {
+    IngestRequest request;
+    fill_hex(request.challenge, 32, 1);
+    fill_hex(request.launcher_id, 32, 2);
+    fill_hex(request.signature, 96, 3);
+    
+    partial_queue_t queue;
+    partial_queue_init(&queue, 1024);
+    partial_t popped;
+    
+    for (auto _ : state) {
+        partial_t partial;
+        memset(&partial, 0, sizeof(partial_t));
+        bool ok = vector_hex_decode(request.challenge, 32, partial.challenge) &&
+                  vector_hex_decode(request.launcher_id, 32, partial.launcher_id) &&
+                  vector_hex_decode(request.signature, 96, partial.signature);
+        benchmark::DoNotOptimize(ok);
+        partial_queue_push(&queue, &partial);
+        partial_queue_try_pop(&queue, &popped);
+    }
+    
+    partial_queue_cleanup(&queue);
+    state.SetItemsProcessed(state.iterations());
+}
+
+// Бинарный путь: поля пишутся прямо в зарезервированный слот очереди
+static void BM_PartialIngestBinary(benchmark::State& state) {
+    uint8_t challenge[32], launcher_id[32], signature[96];
+    memset(challenge, 1, sizeof(challenge));
+    memset(launcher_id, 2, sizeof(launcher_id));
+    memset(signature, 3, sizeof(signature));
+    
+    partial_queue_t queue;
+    partial_queue_init(&queue, 1024);
+    partial_queue_reservation_t reservation;
+    partial_t popped;
+    
+    for (auto _ : state) {
+        partial_t* partial = partial_queue_reserve(&queue, &reservation);
+        memset(partial, 0, sizeof(partial_t));
+        memcpy(partial->challenge, challenge, 32);
+        memcpy(partial->launcher_id, launcher_id, 32);
+        memcpy(partial->signature, signature, 96);
+        partial_queue_commit(&queue, &reservation);
+        partial_queue_try_pop(&queue, &popped);
+    }
+    
+    partial_queue_cleanup(&queue);
+    state.SetItemsProcessed(state.iterations());
+}
+
+// Добавление в журнал: копирование записи в mmap под мьютексом,
+// fsync выполняется фоновым group commit
+static void BM_PartialJournalAppend(benchmark::State& state) {
+    char directory[] = "/tmp/partial_journal_bench_XXXXXX";
+    if (!mkdtemp(directory)) {
+        state.SkipWithError("mkdtemp");
+        return;
+    }
+    
+    partial_journal_config_t config;
+    memset(&config, 0, sizeof(config));
+    config.directory = directory;
+    partial_journal_open(&config, NULL, NULL);
+    
+    partial_journal_entry_t entry;
+    memset(&entry, 0, sizeof(entry));
+    entry.timestamp = time(NULL);
+    entry.points = 1;
+    
+    for (auto _ : state) {
+        partial_journal_append(&entry, NULL);
+    }
+    
+    partial_journal_close();
+    std::string command = std::string("rm -rf ") + directory;
+    if (system(command.c_str()) != 0) {
+        state.SkipWithError("rm");
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+static void journal_bench_replay(const partial_journal_entry_t* entry, void* user) {
+    *(uint64_t*)user += entry->points;
+}
+
+// Восстановление state.range(0) записей при открытии журнала
+static void BM_PartialJournalReplay(benchmark::State& state) {
+    char directory[] = "/tmp/partial_journal_bench_XXXXXX";
+    if (!mkdtemp(directory)) {
+        state.SkipWithError("mkdtemp");
+        return;
+    }
+    
+    partial_journal_config_t config;
+    memset(&config, 0, sizeof(config));
+    config.directory = directory;
+    partial_journal_open(&config, NULL, NULL);
+    
+    partial_journal_entry_t entry;
+    memset(&entry, 0, sizeof(entry));
+    entry.timestamp = time(NULL);
+    entry.points = 1;
+    for (int64_t i = 0; i < state.range(0); i++) {
+        partial_journal_append(&entry, NULL);
+    }
+    partial_journal_close();
+    
+    for (auto _ : state) {
+        uint64_t points = 0;
+        partial_journal_open(&config, journal_bench_replay, &points);
+        partial_journal_close();
+        benchmark::DoNotOptimize(points);
+    }
+    
+    std::string command = std::string("rm -rf ") + directory;
+    if (system(command.c_str()) != 0) {
+        state.SkipWithError("rm");
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
 // Регистрируем бенчмарки с параметрами
+// Полная проверка валидного доказательства k=18 (f1, f2..f7, строка
+// качества); аргумент - набор инструкций ядер ChaCha8/BLAKE3
+static void BM_PosVerifyProof(benchmark::State& state) {
+    pos_isa_t isa = (pos_isa_t)state.range(0);
+    pos_isa_t saved = pos_verifier_get_isa();
+    if (!pos_verifier_set_isa(isa)) {
+        state.SkipWithError("Набор инструкций не поддерживается");
+        return;
+    }
+    
+    const char* hex[3] = {
+        "2291d8cdc310411e7ec27378a661c935187c07e4d5636e9bc3c400b27244b8cd",
+        "49df416d07d4bedc51431193e6c3f3391a2b8f1ff1fd42a29755d4c13a902931",
+        "1303a4e97acc0c2edb74148399c5f3820c4863b9848389d1bcc0d937548465fa"
+        "8936b4075d37fbb909ce3c730a43901151ba5eb53df43b52409f9238c0a58c08"
+        "9bac18149682ed065cc2e266bcb21c94238ecba4db28a72ac3980a6ae391541b"
+        "3660c7c69c074ba9398edbaa8797bcfc1f761716e79efa59311f1f21077f6e52"
+        "5201892286267596a1489b880d86ee3c"
+    };
+    std::vector<uint8_t> fields[3];
+    for (int f = 0; f < 3; f++) {
+        for (size_t i = 0; hex[f][i]; i += 2) {
+            unsigned int value;
+            sscanf(hex[f] + i, "%2x", &value);
+            fields[f].push_back((uint8_t)value);
+        }
+    }
+    
+    uint8_t quality_string[POS_QUALITY_STRING_SIZE];
+    for (auto _ : state) {
+        bool valid = pos_verify_proof(&fields[0][0], 18, &fields[1][0],
+                                      &fields[2][0], fields[2].size(), quality_string);
+        benchmark::DoNotOptimize(valid);
+    }
+    
+    state.SetLabel(pos_isa_name(isa));
+    state.SetItemsProcessed(state.iterations());
+    pos_verifier_set_isa(saved);
+}
+
+// Отклонение доказательства k32 (f1 и первое сопоставление) реализацией,
+// специализированной для k32 (аргумент 1), и обобщенной (0)
+static void BM_PosVerifyK32(benchmark::State& state) {
+    bool specialized = state.range(0) != 0;
+    pos_verifier_precompute(32);
+    
+    uint8_t plot_id[POS_PLOT_ID_SIZE];
+    uint8_t challenge[POS_CHALLENGE_SIZE];
+    uint8_t proof[256];
+    std::mt19937 rng(42);
+    for (size_t i = 0; i < sizeof(plot_id); i++) plot_id[i] = (uint8_t)rng();
+    for (size_t i = 0; i < sizeof(challenge); i++) challenge[i] = (uint8_t)rng();
+    for (size_t i = 0; i < sizeof(proof); i++) proof[i] = (uint8_t)rng();
+    
+    for (auto _ : state) {
+        bool valid = specialized ?
+            pos_verify_proof(plot_id, 32, challenge, proof, sizeof(proof), NULL) :
+            pos_verify_proof_generic(plot_id, 32, challenge, proof, sizeof(proof), NULL);
+        benchmark::DoNotOptimize(valid);
+    }
+    
+    state.SetLabel(specialized ? "k32" : "generic");
+    state.SetItemsProcessed(state.iterations());
+}
+
+// Требуемые итерации для пачки из 64 качеств: поэлементно (аргумент 0)
+// и пакетным проходом (1)
+static void BM_IterationsQuality(benchmark::State& state) {
+    const size_t count = 64;
+    bool batch = state.range(0) != 0;
+    
+    std::mt19937 rng(7);
+    std::vector<uint8_t> quality_strings(count * 32);
+    std::vector<uint8_t> sp_hashes(count * 32);
+    for (size_t i = 0; i < count * 32; i++) {
+        quality_strings[i] = (uint8_t)rng();
+        sp_hashes[i] = (uint8_t)rng();
+    }
+    std::vector<uint32_t> k_sizes(count, 32);
+    std::vector<uint64_t> difficulties(count, 1);
+    std::vector<uint64_t> iterations(count);
+    
+    for (auto _ : state) {
+        if (batch) {
+            calculate_iterations_quality_batch(PROOF_DIFFICULTY_CONSTANT_FACTOR,
+                                               (const uint8_t (*)[32])&quality_strings[0],
+                                               (const uint8_t (*)[32])&sp_hashes[0],
+                                               &k_sizes[0], &difficulties[0], count,
+                                               &iterations[0]);
+        } else {
+            for (size_t i = 0; i < count; i++) {
+                iterations[i] = calculate_iterations_quality(PROOF_DIFFICULTY_CONSTANT_FACTOR,
+                                                             &quality_strings[i * 32], k_sizes[i],
+                                                             difficulties[i], &sp_hashes[i * 32]);
+            }
+        }
+        benchmark::DoNotOptimize(&iterations[0]);
+    }
+    
+    state.SetLabel(batch ? "batch" : "scalar");
+    state.SetItemsProcessed(state.iterations() * count);
+}
+
+// Пакетная проверка 64 доказательств k=32 на ядрах выбранного набора
+// инструкций (аргумент - pos_isa_t); недоступные наборы пропускаются
+static void BM_PosVerifyBatch(benchmark::State& state) {
+    const size_t count = 64;
+    pos_isa_t isa = (pos_isa_t)state.range(0);
+    pos_isa_t saved = pos_verifier_get_isa();
+    if (isa > pos_verifier_best_isa() || !pos_verifier_set_isa(isa)) {
+        state.SkipWithError("набор инструкций недоступен");
+        return;
+    }
+    pos_verifier_precompute(32);
+    
+    std::mt19937 rng(42);
+    std::vector<uint8_t> data(count * (POS_PLOT_ID_SIZE + POS_CHALLENGE_SIZE + 256));
+    for (size_t i = 0; i < data.size(); i++) data[i] = (uint8_t)rng();
+    
+    std::vector<const uint8_t*> plot_ids(count), challenges(count), proofs(count);
+    std::vector<uint32_t> ks(count, 32);
+    std::vector<size_t> lengths(count, 256);
+    for (size_t i = 0; i < count; i++) {
+        uint8_t* item = &data[i * (POS_PLOT_ID_SIZE + POS_CHALLENGE_SIZE + 256)];
+        plot_ids[i] = item;
+        challenges[i] = item + POS_PLOT_ID_SIZE;
+        proofs[i] = item + POS_PLOT_ID_SIZE + POS_CHALLENGE_SIZE;
+    }
+    bool results[count];
+    
+    for (auto _ : state) {
+        pos_verify_proofs_batch(&plot_ids[0], &ks[0], &challenges[0], &proofs[0], &lengths[0],
+                                count, NULL, results);
+        benchmark::DoNotOptimize(results);
+    }
+    
+    pos_verifier_set_isa(saved);
+    state.SetLabel(pos_isa_name(isa));
+    state.SetItemsProcessed(state.iterations() * count);
+}
+
+// Чтение 64 значений x доказательства k=32 по месту: сдвиги (аргумент 0)
+// и BMI2 при лучшем наборе инструкций (1)
+static void BM_ProofViewXs(benchmark::State& state) {
+    pos_isa_t saved = pos_verifier_get_isa();
+    pos_verifier_set_isa(state.range(0) ? pos_verifier_best_isa() : POS_ISA_SCALAR);
+    
+    uint8_t proof[256];
+    std::mt19937 rng(42);
+    for (size_t i = 0; i < sizeof(proof); i++) proof[i] = (uint8_t)rng();
+    pos_proof_view_t view;
+    pos_proof_view_init(&view, proof, sizeof(proof), 32);
+    uint64_t xs[POS_PROOF_X_COUNT];
+    
+    for (auto _ : state) {
+        pos_proof_view_xs(&view, xs);
+        benchmark::DoNotOptimize(xs);
+    }
+    
+    pos_verifier_set_isa(saved);
+    state.SetLabel(state.range(0) ? "bmi2" : "shift");
+    state.SetItemsProcessed(state.iterations() * POS_PROOF_X_COUNT);
+}
+
+// Проверка пачки валидных подписей AugSchemeMPL: по одной (второй
+// аргумент 0) и пакетно с общим циклом Миллера (1)
+static void BM_BlsVerifyValid(benchmark::State& state) {
+    const size_t count = state.range(0);
+    bool batched = state.range(1) != 0;
+    
+    const char* hex[3] = {
+        "8530c1bdc4cd6b1408be0933c4a41ac3513350eef36850b804708e1f338932ce01b655a163344a4500b281c8750c461f",
+        "68656c6c6f",
+        "8d4a9f8654173f738035c3e264e33656edff0164322a8b9637f47424a60da290d5302583a5fcd7e98f8fa26233aad84c"
+        "08e2592dcfbdd8cc246bf8f14a6bfd8e38c6cb49d7b771fdc54d363dcc254820d3b09e16385a9e05d1f3ef792ae05f5f"
+    };
+    std::vector<uint8_t> fields[3];
+    for (int f = 0; f < 3; f++) {
+        for (size_t i = 0; hex[f][i]; i += 2) {
+            unsigned int value;
+            sscanf(hex[f] + i, "%2x", &value);
+            fields[f].push_back((uint8_t)value);
+        }
+    }
+    
+    std::vector<const uint8_t*> public_keys(count, &fields[0][0]);
+    std::vector<const uint8_t*> messages(count, &fields[1][0]);
+    std::vector<size_t> message_lens(count, fields[1].size());
+    std::vector<const uint8_t*> signatures(count, &fields[2][0]);
+    std::unique_ptr<bool[]> results(new bool[count]);
+    
+    for (auto _ : state) {
+        if (batched) {
+            bls_verify_batch(&public_keys[0], &messages[0], &message_lens[0], &signatures[0],
+                             count, results.get());
+        } else {
+            for (size_t i = 0; i < count; i++) {
+                results[i] = bls_verify(public_keys[i], messages[i], message_lens[i],
+                                        signatures[i]);
+            }
+        }
+        benchmark::DoNotOptimize(results[0]);
+    }
+    
+    state.SetLabel(batched ? "batch" : "single");
+    state.SetItemsProcessed(state.iterations() * count);
+}
+
+// Ядра Fp и Fp2: аргумент - реализация (portable, mulx), второй -
+// операция (0 mul, 1 sqr, 2 redc, 3 fp2_mul, 4 fp2_sqr)
+static void BM_BlsFpKernel(benchmark::State& state) {
+    bls_fp_impl_t impl = (bls_fp_impl_t)state.range(0);
+    bls_fp_impl_t saved = bls_fp_get_impl();
+    if (!bls_fp_set_impl(impl)) {
+        state.SkipWithError("Реализация не поддерживается");
+        return;
+    }
+    
+    // Элементы меньше p: старшее слово меньше старшего слова p
+    std::mt19937_64 rng(42);
+    uint64_t a[12], b[12], t[12], r[12];
+    for (int i = 0; i < 12; i++) {
+        a[i] = rng() >> (i % 6 == 5 ? 8 : 0);
+        b[i] = rng() >> (i % 6 == 5 ? 8 : 0);
+        t[i] = rng() >> (i == 11 ? 8 : 0);
+    }
+    
+    static const char* names[5] = {"mul", "sqr", "redc", "fp2_mul", "fp2_sqr"};
+    int op = state.range(1);
+    for (auto _ : state) {
+        switch (op) {
+            case 0: bls_fp_mont_mul(r, a, b); break;
+            case 1: bls_fp_mont_sqr(r, a); break;
+            case 2: bls_fp_mont_redc(r, t); break;
+            case 3: bls_fp2_mont_mul(r, a, b); break;
+            default: bls_fp2_mont_sqr(r, a); break;
+        }
+        benchmark::DoNotOptimize(r);
+        a[0] ^= r[0] & 1;
+    }
+    
+    state.SetLabel(std::string(bls_fp_impl_name(impl)) + " " + names[op]);
+    state.SetItemsProcessed(state.iterations());
+    bls_fp_set_impl(saved);
+}
+
+// Подготовка ключа фермера к проверке подписи: распаковка с проверкой
+// подгруппы (аргумент 0) и попадание в кеш распакованных ключей (1)
+static void BM_BlsPublicKeyCache(benchmark::State& state) {
+    bool cached = state.range(0) != 0;
+    const char* hex =
+        "8530c1bdc4cd6b1408be0933c4a41ac3513350eef36850b804708e1f338932ce01b655a163344a4500b281c8750c461f";
+    uint8_t public_key[BLS_PUBLIC_KEY_SIZE];
+    for (size_t i = 0; i < sizeof(public_key); i++) {
+        unsigned int value;
+        sscanf(hex + i * 2, "%2x", &value);
+        public_key[i] = (uint8_t)value;
+    }
+    
+    bls_public_key_t decoded;
+    if (cached) {
+        bls_key_cache_init(BLS_KEY_CACHE_DEFAULT_CAPACITY);
+        bls_public_key_decode(public_key, &decoded);
+        bls_key_cache_store(public_key, &decoded);
+    }
+    
+    for (auto _ : state) {
+        bool valid = cached ? bls_key_cache_lookup(public_key, &decoded) :
+                              bls_public_key_decode(public_key, &decoded);
+        benchmark::DoNotOptimize(valid);
+    }
+    
+    if (cached) {
+        bls_key_cache_cleanup();
+    }
+    state.SetLabel(cached ? "cache" : "decode");
+    state.SetItemsProcessed(state.iterations());
+}
+
+// Хэширование 16 сообщений в G2 по одному и пачкой (многобуферный
+// expand_message_xmd)
+static void BM_BlsHashToG2(benchmark::State& state) {
+    const size_t count = 16;
+    bool batched = state.range(0) != 0;
+    
+    std::vector<std::vector<uint8_t>> storage(count, std::vector<uint8_t>(80));
+    std::vector<const uint8_t*> messages(count);
+    std::vector<size_t> message_lens(count);
+    for (size_t i = 0; i < count; i++) {
+        for (size_t j = 0; j < storage[i].size(); j++) {
+            storage[i][j] = (uint8_t)(i * 31 + j);
+        }
+        messages[i] = &storage[i][0];
+        message_lens[i] = storage[i].size();
+    }
+    std::vector<uint8_t> out(count * BLS_SIGNATURE_SIZE);
+    
+    for (auto _ : state) {
+        if (batched) {
+            bls_hash_to_g2_batch(&messages[0], &message_lens[0], count,
+                                 (const uint8_t*)BLS_AUG_DST, strlen(BLS_AUG_DST), &out[0]);
+        } else {
+            for (size_t i = 0; i < count; i++) {
+                bls_hash_to_g2(messages[i], message_lens[i], (const uint8_t*)BLS_AUG_DST,
+                               strlen(BLS_AUG_DST), &out[i * BLS_SIGNATURE_SIZE]);
+            }
+        }
+        benchmark::DoNotOptimize(out[0]);
+    }
+    
+    state.SetLabel(batched ? "batch" : "single");
+    state.SetItemsProcessed(state.iterations() * count);
+}
+
+// Мультискалярное умножение в G1: первый аргумент - число точек, второй -
+// слов в скаляре (1 - 64 бита, 2 - 128 бит). 64 разные точки [j + 1] g1
+// повторяются по кругу.
+static void BM_BlsG1Multiexp(benchmark::State& state) {
+    const size_t count = state.range(0);
+    const size_t words = state.range(1);
+    
+    static std::vector<bls_public_key_t> base;
+    if (base.empty()) {
+        const char* generator_hex =
+            "97f1d3a73197d7942695638c4fa9ac0fc3688c4f9774b905a14e3a3f171bac58"
+            "6c55e83ff97a1aeffb3af00adb22c6bb";
+        uint8_t generator[BLS_PUBLIC_KEY_SIZE];
+        for (size_t i = 0; i < sizeof(generator); i++) {
+            unsigned int value;
+            sscanf(generator_hex + 2 * i, "%2x", &value);
+            generator[i] = (uint8_t)value;
+        }
+        bls_public_key_t g1;
+        bls_public_key_decode(generator, &g1);
+        for (uint64_t k = 1; k <= 64; k++) {
+            uint8_t encoded[BLS_PUBLIC_KEY_SIZE];
+            bls_public_key_t point;
+            bls_g1_multiexp(&g1, &k, 1, 1, encoded);
+            bls_public_key_decode(encoded, &point);
+            base.push_back(point);
+        }
+    }
+    
+    std::mt19937_64 rng(42);
+    std::vector<bls_public_key_t> points(count);
+    std::vector<uint64_t> scalars(count * words);
+    for (size_t i = 0; i < count; i++) {
+        points[i] = base[i % base.size()];
+    }
+    for (size_t i = 0; i < scalars.size(); i++) {
+        scalars[i] = rng();
+    }
+    uint8_t out[BLS_PUBLIC_KEY_SIZE];
+    
+    for (auto _ : state) {
+        bls_g1_multiexp(&points[0], &scalars[0], words, count, out);
+        benchmark::DoNotOptimize(out[0]);
+    }
+    
+    state.SetItemsProcessed(state.iterations() * count);
+}
+
+// Подпись 64 сообщений ключом пула: 0 - по одной, 1 - пакетом
+// (хеширование пачкой, потоки, одна инверсия на все подписи)
+static void BM_BlsSign(benchmark::State& state) {
+    const size_t count = 64;
+    bool batched = state.range(0) != 0;
+    
+    uint8_t private_key[32];
+    for (size_t i = 0; i < sizeof(private_key); i++) {
+        private_key[i] = (uint8_t)(i * 13 + 7);
+    }
+    private_key[0] &= 0x3f;
+    bls_signer_t signer;
+    bls_signer_init(&signer, private_key);
+    
+    std::vector<std::vector<uint8_t>> storage(count, std::vector<uint8_t>(44));
+    std::vector<const uint8_t*> messages(count);
+    std::vector<size_t> message_lens(count);
+    for (size_t i = 0; i < count; i++) {
+        for (size_t j = 0; j < storage[i].size(); j++) {
+            storage[i][j] = (uint8_t)(i * 31 + j);
+        }
+        messages[i] = &storage[i][0];
+        message_lens[i] = storage[i].size();
+    }
+    std::vector<uint8_t> out(count * BLS_SIGNATURE_SIZE);
+    
+    for (auto _ : state) {
+        if (batched) {
+            bls_sign_batch(&signer, &messages[0], &message_lens[0], count, &out[0]);
+        } else {
+            for (size_t i = 0; i < count; i++) {
+                bls_sign(&signer, messages[i], message_lens[i], &out[i * BLS_SIGNATURE_SIZE]);
+            }
+        }
+        benchmark::DoNotOptimize(out[0]);
+    }
+    
+    state.SetLabel(batched ? "batch" : "single");
+    state.SetItemsProcessed(state.iterations() * count);
+}
+
+// Повторная проверка доказательства k=32 через кеш: дайджест и поиск
+// вместо f1..f7
+static void BM_ProofCacheHit(benchmark::State& state) {
+    if (!proof_cache_init(65536, 300, 16384, 30)) {
+        state.SkipWithError("Кеш доказательств не инициализирован");
+        return;
+    }
+    
+    uint8_t plot_id[POS_PLOT_ID_SIZE];
+    uint8_t challenge[POS_CHALLENGE_SIZE];
+    uint8_t proof[256];
+    memset(plot_id, 0x22, sizeof(plot_id));
+    memset(challenge, 0x49, sizeof(challenge));
+    memset(proof, 0x13, sizeof(proof));
+    proof_verification_params_t params = {
+        .challenge = 123456789,
+        .k_size = 32,
+        .sub_slot_iters = 37600000000ULL,
+        .difficulty = 1000,
+        .required_iterations = 0,
+        .plot_id = plot_id,
+        .challenge_hash = challenge,
+        .sp_hash = NULL
+    };
+    
+    uint8_t digest[PROOF_CACHE_DIGEST_SIZE];
+    proof_cache_digest(proof, sizeof(proof), &params, digest);
+    proof_metadata_t metadata;
+    memset(&metadata, 0, sizeof(metadata));
+    metadata.quality = 0x123456789abcULL;
+    proof_cache_store(digest, &metadata);
+    
+    proof_verification_result_t result;
+    for (auto _ : state) {
+        proof_cache_digest(proof, sizeof(proof), &params, digest);
+        bool hit = proof_cache_lookup(digest, &metadata, &result);
+        benchmark::DoNotOptimize(hit);
+    }
+    
+    state.SetItemsProcessed(state.iterations());
+    proof_cache_cleanup();
+}
+
 BENCHMARK_REGISTER_F(PerformanceBenchmark, BLSVerifyBatch)
     ->Arg(1)->Arg(4)->Arg(8)->Arg(16)
     ->Unit(benchmark::kMicrosecond);
@@ -213,5 +914,33 @@ BENCHMARK_REGISTER_F(PerformanceBenchmark, MathCalculatePoints)
     ->Arg(1000)->Arg(10000)->Arg(100000)->Arg(1000000)
     ->Unit(benchmark::kNanosecond);
 
+BENCHMARK(BM_PartialQueueProducers)
+    ->RangeMultiplier(2)->Range(1, 64)
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+
+BENCHMARK(BM_PartialIngestSscanf)->Unit(benchmark::kNanosecond);
+BENCHMARK(BM_PartialIngestSimdHex)->Unit(benchmark::kNanosecond);
+BENCHMARK(BM_PartialIngestBinary)->Unit(benchmark::kNanosecond);
+BENCHMARK(BM_PartialJournalAppend)->Unit(benchmark::kNanosecond);
+BENCHMARK(BM_PartialJournalReplay)->Arg(1000000)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_PosVerifyProof)
+    ->Arg(POS_ISA_SCALAR)->Arg(POS_ISA_AVX2)->Arg(POS_ISA_AVX512)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_PosVerifyK32)->Arg(0)->Arg(1)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_ProofCacheHit)->Unit(benchmark::kNanosecond);
+BENCHMARK(BM_IterationsQuality)->Arg(0)->Arg(1)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_PosVerifyBatch)->Arg(POS_ISA_SCALAR)->Arg(POS_ISA_AVX2)->Arg(POS_ISA_AVX512)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_ProofViewXs)->Arg(0)->Arg(1);
+BENCHMARK(BM_BlsVerifyValid)->Args({16, 0})->Args({16, 1})->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_BlsFpKernel)->ArgsProduct({{BLS_FP_PORTABLE, BLS_FP_MULX}, {0, 1, 2, 3, 4}})
+    ->Unit(benchmark::kNanosecond);
+BENCHMARK(BM_BlsPublicKeyCache)->Arg(0)->Arg(1)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_BlsHashToG2)->Arg(0)->Arg(1)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_BlsG1Multiexp)->ArgsProduct({{8, 64, 512, 4096, 32768, 65536}, {1, 2}})
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_BlsSign)->Arg(0)->Arg(1)->Unit(benchmark::kMillisecond);
+
 // Основная функция
 BENCHMARK_MAIN();
@@ -1,8 +1,25 @@
 #include <gtest/gtest.h>
 #include "pool_core.h"
+#include "metrics.h"
+#include "optimizations.h"
 #include "protocol/partials.h"
+#include "protocol/partial_workers.h"
+#include "protocol/partial_completions.h"
+#include "protocol/partial_dedup.h"
+#include "protocol/partial_journal.h"
+#include "protocol/partial_pipeline.h"
+#include "protocol/partial_points.h"
 #include "protocol/singleton.h"
+#include "security/auth.h"
+#include "go_bridge.h"
 #include <cstring>
+#include <cstdio>
+#include <cstdlib>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
 
 class PoolTest : public ::testing::Test {
 protected:
@@ -22,7 +39,7 @@ protected:
         
         pool_init(&config);
     }
-
+    
     void TearDown() override {
         pool_cleanup();
     }
@@ -48,6 +65,30 @@ TEST_F(PoolTest, PoolStartStop) {
     EXPECT_TRUE(stop_result);
 }
 
+// Число воркеров из performance.worker_threads доходит до пула воркеров
+TEST_F(PoolTest, BridgePoolConfigWorkerThreads) {
+    PoolSettings settings;
+    settings.worker_threads = 3;
+    pool_config_t config;
+    ASSERT_TRUE(go_bridge_load_pool_config(&settings, &config));
+    EXPECT_EQ(config.worker_threads, 3u);
+    EXPECT_TRUE(pool_validate_config(&config));
+    
+    pool_context_t* context = pool_get_context();
+    context->config.worker_threads = config.worker_threads;
+    ASSERT_TRUE(pool_start());
+    EXPECT_EQ(context->partial_workers.thread_count, 3u);
+    EXPECT_TRUE(pool_stop());
+    
+    // 0 - по воркеру на ядро
+    settings.worker_threads = 0;
+    ASSERT_TRUE(go_bridge_load_pool_config(&settings, &config));
+    EXPECT_EQ(config.worker_threads, 0u);
+    
+    EXPECT_FALSE(go_bridge_load_pool_config(NULL, &config));
+    EXPECT_FALSE(go_bridge_start_pool(NULL));
+}
+
 TEST_F(PoolTest, ValidateConfig) {
     pool_config_t valid_config;
     pool_load_default_config(&valid_config);
@@ -77,13 +118,13 @@ TEST_F(PoolTest, PartialQueueOperations) {
     
     bool push_result = partial_queue_push(&queue, &partial);
     EXPECT_TRUE(push_result);
-    EXPECT_EQ(queue.size, 1);
+    EXPECT_EQ(partial_queue_size(&queue), 1u);
     
     // Тестируем извлечение partial
     partial_t popped_partial;
     bool pop_result = partial_queue_pop(&queue, &popped_partial);
     EXPECT_TRUE(pop_result);
-    EXPECT_EQ(queue.size, 0);
+    EXPECT_EQ(partial_queue_size(&queue), 0u);
     EXPECT_EQ(popped_partial.difficulty, 1000);
     
     partial_queue_cleanup(&queue);
@@ -106,6 +147,595 @@ TEST_F(PoolTest, PartialQueueOverflow) {
     partial_queue_cleanup(&queue);
 }
 
+TEST_F(PoolTest, PartialQueueBatchOperations) {
+    partial_queue_t queue;
+    ASSERT_TRUE(partial_queue_init(&queue, 8));
+    
+    partial_t batch[10];
+    memset(batch, 0, sizeof(batch));
+    for (int i = 0; i < 10; i++) {
+        batch[i].difficulty = 100 + i;
+    }
+    
+    // В очередь помещается только 8 элементов
+    EXPECT_EQ(partial_queue_push_batch(&queue, batch, 10), 8u);
+    EXPECT_EQ(partial_queue_size(&queue), 8u);
+    
+    partial_t popped[10];
+    EXPECT_EQ(partial_queue_pop_batch(&queue, popped, 5), 5u);
+    for (int i = 0; i < 5; i++) {
+        EXPECT_EQ(popped[i].difficulty, (uint64_t)(100 + i));
+    }
+    
+    // После освобождения слотов кольцо переиспользует их по кругу
+    EXPECT_EQ(partial_queue_push_batch(&queue, batch + 8, 2), 2u);
+    EXPECT_EQ(partial_queue_pop_batch(&queue, popped, 10), 5u);
+    EXPECT_EQ(popped[0].difficulty, 105u);
+    EXPECT_EQ(popped[2].difficulty, 107u);
+    EXPECT_EQ(popped[3].difficulty, 108u);
+    EXPECT_EQ(popped[4].difficulty, 109u);
+    
+    EXPECT_FALSE(partial_queue_try_pop(&queue, popped));
+    partial_queue_cleanup(&queue);
+}
+
+TEST_F(PoolTest, PartialQueueConcurrentProducers) {
+    const int producers = 8;
+    const int per_producer = 5000;
+    
+    partial_queue_t queue;
+    ASSERT_TRUE(partial_queue_init(&queue, 256));
+    
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; p++) {
+        threads.emplace_back([&queue, p]() {
+            partial_t partial;
+            memset(&partial, 0, sizeof(partial_t));
+            for (int i = 0; i < per_producer; i++) {
+                partial.difficulty = (uint64_t)p * per_producer + i;
+                while (!partial_queue_push(&queue, &partial)) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    
+    // Два потребителя: блокирующий пакетный и неблокирующий одиночный.
+    // Каждый завершается, получив сигнальный partial.
+    const uint64_t stop_marker = UINT64_MAX;
+    std::vector<std::atomic<int>> seen(producers * per_producer);
+    for (auto& counter : seen) counter.store(0);
+    
+    std::vector<std::thread> consumers;
+    for (int c = 0; c < 2; c++) {
+        consumers.emplace_back([&queue, &seen, stop_marker, c]() {
+            partial_t batch[16];
+            for (;;) {
+                size_t n = (c == 0) ? partial_queue_pop_batch(&queue, batch, 16)
+                                    : (partial_queue_try_pop(&queue, batch) ? 1 : 0);
+                for (size_t i = 0; i < n; i++) {
+                    if (batch[i].difficulty == stop_marker) {
+                        // Возвращаем остаток пачки, чтобы не потерять элементы
+                        partial_queue_push_batch(&queue, batch + i + 1, n - i - 1);
+                        return;
+                    }
+                    seen[batch[i].difficulty].fetch_add(1);
+                }
+            }
+        });
+    }
+    
+    for (auto& t : threads) t.join();
+    
+    partial_t stop;
+    memset(&stop, 0, sizeof(partial_t));
+    stop.difficulty = stop_marker;
+    EXPECT_TRUE(partial_queue_push(&queue, &stop));
+    EXPECT_TRUE(partial_queue_push(&queue, &stop));
+    for (auto& t : consumers) t.join();
+    
+    // Остатки, не забранные потребителями до сигнала
+    partial_t rest;
+    while (partial_queue_try_pop(&queue, &rest)) {
+        if (rest.difficulty != stop_marker) {
+            seen[rest.difficulty].fetch_add(1);
+        }
+    }
+    
+    for (int i = 0; i < producers * per_producer; i++) {
+        ASSERT_EQ(seen[i].load(), 1) << "index " << i;
+    }
+    
+    partial_queue_cleanup(&queue);
+}
+
+TEST_F(PoolTest, PartialWorkersBackpressure) {
+    partial_workers_t workers;
+    ASSERT_TRUE(partial_workers_start(&workers, 2, 4));
+    EXPECT_TRUE(partial_workers_is_running(&workers));
+    EXPECT_EQ(workers.thread_count, 2u);
+    
+    partial_t partial;
+    memset(&partial, 0, sizeof(partial_t));
+    
+    // Переполнение очереди не блокирует отправителя, а возвращает RATE_LIMITED
+    uint64_t accepted = 0, limited = 0;
+    for (int i = 0; i < 200; i++) {
+        partial_validation_result_t result = partial_workers_submit(&workers, &partial);
+        ASSERT_TRUE(result == VALIDATION_SUCCESS || result == VALIDATION_RATE_LIMITED);
+        if (result == VALIDATION_SUCCESS) {
+            accepted++;
+        } else {
+            limited++;
+        }
+    }
+    
+    partial_workers_stop(&workers);
+    EXPECT_FALSE(partial_workers_is_running(&workers));
+    
+    // Все принятые partials обработаны до завершения воркеров
+    EXPECT_EQ(workers.processed, accepted);
+    EXPECT_EQ(workers.rejected, limited);
+    EXPECT_EQ(partial_workers_submit(&workers, &partial), VALIDATION_INTERNAL_ERROR);
+}
+
+TEST_F(PoolTest, PartialWorkersAsyncCompletions) {
+    partial_workers_t workers;
+    ASSERT_TRUE(partial_workers_start(&workers, 2, 64));
+    
+    partial_t partial;
+    memset(&partial, 0, sizeof(partial_t));
+    partial.points = 7;
+    
+    // Номера выдаются сразу, результаты забираются опросом кольца
+    std::vector<uint64_t> tickets;
+    for (int i = 0; i < 48; i++) {
+        uint64_t ticket = 0;
+        ASSERT_EQ(partial_workers_submit_async(&workers, &partial, &ticket), VALIDATION_SUCCESS);
+        EXPECT_NE(ticket, 0u);
+        tickets.push_back(ticket);
+    }
+    
+    std::vector<uint64_t> completed;
+    partial_completion_t completions[16];
+    while (completed.size() < tickets.size()) {
+        size_t count = partial_completions_poll(completions, 16, 5000);
+        ASSERT_GT(count, 0u);
+        for (size_t i = 0; i < count; i++) {
+            EXPECT_EQ(completions[i].points, 7u);
+            EXPECT_NE(completions[i].result, VALIDATION_SUCCESS);
+            completed.push_back(completions[i].ticket);
+        }
+    }
+    
+    std::sort(completed.begin(), completed.end());
+    EXPECT_EQ(completed, tickets);
+    EXPECT_EQ(partial_completions_poll(completions, 16, 0), 0u);
+    
+    // Синхронная постановка завершений не порождает
+    ASSERT_EQ(partial_workers_submit(&workers, &partial), VALIDATION_SUCCESS);
+    partial_workers_stop(&workers);
+    EXPECT_EQ(partial_completions_poll(completions, 16, 100), 0u);
+    
+    uint64_t ticket = 1;
+    EXPECT_EQ(partial_workers_submit_async(&workers, &partial, &ticket), VALIDATION_INTERNAL_ERROR);
+    EXPECT_EQ(ticket, 0u);
+    partial_completions_cleanup();
+}
+
+static void async_collect(const partial_completion_t* completions, size_t count, void* user) {
+    (void)completions;
+    std::atomic<uint64_t>* delivered = (std::atomic<uint64_t>*)user;
+    *delivered += count;
+}
+
+TEST_F(PoolTest, PartialWorkersCompletionCallback) {
+    std::atomic<uint64_t> delivered(0);
+    partial_completions_set_callback(async_collect, &delivered);
+    
+    partial_workers_t workers;
+    ASSERT_TRUE(partial_workers_start(&workers, 2, 256));
+    
+    partial_t partial;
+    memset(&partial, 0, sizeof(partial_t));
+    uint64_t accepted = 0;
+    for (int i = 0; i < 200; i++) {
+        uint64_t ticket = 0;
+        if (partial_workers_submit_async(&workers, &partial, &ticket) == VALIDATION_SUCCESS) {
+            accepted++;
+        }
+    }
+    partial_workers_stop(&workers);
+    
+    // После остановки все принятые partials завершены через callback
+    EXPECT_EQ(delivered.load(), accepted);
+    partial_completion_t completion;
+    EXPECT_EQ(partial_completions_poll(&completion, 1, 0), 0u);
+    
+    partial_completions_set_callback(NULL, NULL);
+    partial_completions_cleanup();
+}
+
+TEST_F(PoolTest, PartialWorkersStopWaitsForReservation) {
+    partial_workers_t workers;
+    ASSERT_TRUE(partial_workers_start(&workers, 2, 16));
+    
+    partial_queue_reservation_t reservation;
+    partial_t* slot = partial_workers_reserve(&workers, &reservation);
+    ASSERT_NE(slot, nullptr);
+    memset(slot, 0, sizeof(partial_t));
+    
+    // Остановка закрывает прием, но ждет держателя резервирования
+    std::atomic<bool> stopped(false);
+    std::thread stopper([&]() {
+        partial_workers_stop(&workers);
+        stopped = true;
+    });
+    while (partial_workers_is_running(&workers)) {
+        std::this_thread::yield();
+    }
+    partial_queue_reservation_t late;
+    EXPECT_EQ(partial_workers_reserve(&workers, &late), nullptr);
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    EXPECT_FALSE(stopped.load());
+    
+    // Подтвержденный после начала остановки partial все равно обработан
+    EXPECT_EQ(partial_workers_commit(&workers, &reservation), VALIDATION_SUCCESS);
+    stopper.join();
+    EXPECT_TRUE(stopped.load());
+    EXPECT_EQ(workers.processed, 1u);
+    partial_completions_cleanup();
+}
+
+TEST_F(PoolTest, PartialQueueEdfOrdering) {
+    partial_queue_t queue;
+    ASSERT_TRUE(partial_queue_init_edf(&queue, 8, 28));
+    EXPECT_EQ(partial_queue_get_mode(&queue), PARTIAL_QUEUE_EDF);
+    
+    uint64_t now = time(NULL);
+    partial_t batch[4];
+    memset(batch, 0, sizeof(batch));
+    batch[0].timestamp = now + 20;
+    batch[1].timestamp = now;
+    batch[2].timestamp = now + 10;
+    batch[3].timestamp = now;
+    
+    EXPECT_EQ(partial_queue_push_batch(&queue, batch, 4), 4u);
+    EXPECT_EQ(partial_queue_size(&queue), 4u);
+    
+    // Ранний дедлайн извлекается первым, при равных - порядок поступления
+    partial_t popped[4];
+    EXPECT_EQ(partial_queue_pop_batch(&queue, popped, 4), 4u);
+    EXPECT_EQ(popped[0].timestamp, now);
+    EXPECT_EQ(popped[1].timestamp, now);
+    EXPECT_EQ(popped[2].timestamp, now + 10);
+    EXPECT_EQ(popped[3].timestamp, now + 20);
+    EXPECT_FALSE(partial_queue_try_pop(&queue, popped));
+    
+    partial_queue_close(&queue);
+    EXPECT_EQ(partial_queue_pop_batch(&queue, popped, 4), 0u);
+    partial_queue_cleanup(&queue);
+}
+
+TEST_F(PoolTest, PartialQueueEdfShedding) {
+    const uint32_t backlog = 5000;
+    partial_queue_t queue;
+    ASSERT_TRUE(partial_queue_init_edf(&queue, backlog + 2, 2));
+    
+    uint64_t now = time(NULL);
+    std::vector<partial_t> batch(backlog + 2);
+    memset(batch.data(), 0, batch.size() * sizeof(partial_t));
+    for (uint32_t i = 0; i < backlog; i++) {
+        batch[i].timestamp = now + 30;
+    }
+    
+    // Срочный partial за длинной очередью: в FIFO он не успел бы к дедлайну
+    batch[backlog].timestamp = now;
+    // Просроченный partial отбрасывается без валидации
+    batch[backlog + 1].timestamp = now - 100;
+    
+    EXPECT_EQ(partial_queue_push_batch(&queue, batch.data(), batch.size()), batch.size());
+    
+    partial_t popped;
+    ASSERT_TRUE(partial_queue_try_pop(&queue, &popped));
+    EXPECT_EQ(popped.timestamp, now);
+    
+    partial_edf_stats_t stats;
+    partial_edf_queue_get_stats(queue.edf, &stats);
+    EXPECT_EQ(stats.enqueued, backlog + 2u);
+    EXPECT_EQ(stats.dequeued, 1u);
+    EXPECT_EQ(stats.shed, 1u);
+    EXPECT_EQ(stats.saved, 1u);
+    EXPECT_EQ(stats.size, backlog);
+    
+    partial_queue_cleanup(&queue);
+}
+
+TEST_F(PoolTest, PartialQueueFairScheduling) {
+    partial_queue_t queue;
+    ASSERT_TRUE(partial_queue_init_fair(&queue, 256, 64));
+    EXPECT_EQ(partial_queue_get_mode(&queue), PARTIAL_QUEUE_FAIR);
+    
+    // Крупный фермер заполняет свою подочередь, остальные не блокируются
+    partial_t partial;
+    memset(&partial, 0, sizeof(partial_t));
+    partial.launcher_id[0] = 1;
+    partial.difficulty = 1;
+    for (int i = 0; i < 64; i++) {
+        ASSERT_TRUE(partial_queue_push(&queue, &partial));
+    }
+    EXPECT_FALSE(partial_queue_push(&queue, &partial));
+    
+    for (uint8_t farmer = 2; farmer <= 4; farmer++) {
+        partial.launcher_id[0] = farmer;
+        ASSERT_TRUE(partial_queue_push(&queue, &partial));
+    }
+    
+    // За первый раунд каждый фермер получает по одному partial
+    partial_t popped[4];
+    ASSERT_EQ(partial_queue_pop_batch(&queue, popped, 4), 4u);
+    for (int i = 0; i < 4; i++) {
+        EXPECT_EQ(popped[i].launcher_id[0], i + 1);
+    }
+    
+    partial_fair_stats_t stats;
+    partial_fair_queue_get_stats(queue.fair, &stats);
+    EXPECT_EQ(stats.flow_rejected, 1u);
+    EXPECT_EQ(stats.max_active_flows, 4u);
+    EXPECT_EQ(stats.active_flows, 1u);
+    EXPECT_EQ(stats.size, 63u);
+    
+    partial_queue_cleanup(&queue);
+}
+
+TEST_F(PoolTest, PartialQueueFairWeights) {
+    partial_queue_t queue;
+    ASSERT_TRUE(partial_queue_init_fair(&queue, 1024, 128));
+    
+    // Вес по сложности: фермер со сложностью 3 получает втрое больше partials
+    partial_t partial;
+    memset(&partial, 0, sizeof(partial_t));
+    for (int i = 0; i < 100; i++) {
+        partial.launcher_id[0] = 1;
+        partial.difficulty = 3;
+        ASSERT_TRUE(partial_queue_push(&queue, &partial));
+        partial.launcher_id[0] = 2;
+        partial.difficulty = 1;
+        ASSERT_TRUE(partial_queue_push(&queue, &partial));
+    }
+    
+    partial_t popped[40];
+    ASSERT_EQ(partial_queue_pop_batch(&queue, popped, 40), 40u);
+    int heavy = 0;
+    for (int i = 0; i < 40; i++) {
+        heavy += popped[i].launcher_id[0] == 1;
+    }
+    EXPECT_EQ(heavy, 30);
+    
+    // Многократное создание и удаление подочередей не теряет partials
+    partial_t drain[64];
+    while (partial_queue_try_pop(&queue, drain)) {
+    }
+    for (int round = 0; round < 20; round++) {
+        for (int farmer = 0; farmer < 300; farmer++) {
+            partial.launcher_id[0] = (uint8_t)farmer;
+            partial.launcher_id[1] = (uint8_t)(farmer >> 8);
+            partial.launcher_id[2] = (uint8_t)round;
+            ASSERT_TRUE(partial_queue_push(&queue, &partial));
+        }
+        size_t total = 0;
+        size_t n;
+        while ((n = partial_queue_pop_batch(&queue, drain, 64)) > 0 && total + n <= 300) {
+            total += n;
+            if (total == 300) {
+                break;
+            }
+        }
+        EXPECT_EQ(total, 300u);
+        EXPECT_EQ(partial_queue_size(&queue), 0u);
+    }
+    
+    partial_fair_stats_t stats;
+    partial_fair_queue_get_stats(queue.fair, &stats);
+    EXPECT_EQ(stats.active_flows, 0u);
+    EXPECT_EQ(stats.enqueued, stats.dequeued);
+    
+    partial_queue_cleanup(&queue);
+}
+
+TEST_F(PoolTest, MetricsShardedCounters) {
+    static metrics_counter_t counter;
+    static metrics_histogram_t histogram;
+    metrics_counter_reset(&counter);
+    metrics_histogram_reset(&histogram);
+    
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 24; t++) {
+        threads.push_back(std::thread([&]() {
+            for (uint64_t i = 1; i <= 1000; i++) {
+                metrics_counter_add(&counter, 1);
+                metrics_histogram_record(&histogram, i * 1000, 1);
+            }
+        }));
+    }
+    for (size_t i = 0; i < threads.size(); i++) {
+        threads[i].join();
+    }
+    
+    EXPECT_EQ(metrics_counter_read(&counter), 24000u);
+    
+    // Корзины HDR: точность 1/16 от значения
+    for (uint64_t value = 1; value < (1ULL << 36); value = value * 3 + 1) {
+        uint64_t floor = metrics_histogram_bucket_floor(metrics_histogram_bucket(value));
+        EXPECT_LE(floor, value);
+        EXPECT_GE(floor, value - value / 16);
+    }
+    
+    metrics_latency_summary_t summary;
+    metrics_histogram_summarize(&histogram, &summary);
+    EXPECT_EQ(summary.count, 24000u);
+    EXPECT_EQ(summary.max_ns, 1000000u);
+    EXPECT_EQ(summary.mean_ns, 500500u);
+    EXPECT_LE(summary.p50_ns, 500000u);
+    EXPECT_GE(summary.p50_ns, 500000u - 500000u / 16);
+    EXPECT_LE(summary.p99_ns, 990000u);
+    EXPECT_GE(summary.p99_ns, 990000u - 990000u / 16);
+}
+
+TEST_F(PoolTest, PartialLatencyStatistics) {
+    partials_reset_stats();
+    partial_pipeline_reset_stats();
+    
+    partial_t partial;
+    memset(&partial, 0, sizeof(partial_t));
+    partial.timestamp = 1; // Давно просроченный partial отклоняется этапом дедлайна
+    for (int i = 0; i < 5; i++) {
+        EXPECT_EQ(partial_validate(&partial), VALIDATION_TOO_LATE);
+    }
+    
+    uint64_t valid, invalid, total;
+    partials_get_stats(&valid, &invalid, &total);
+    EXPECT_EQ(total, 5u);
+    EXPECT_EQ(invalid, 5u);
+    EXPECT_EQ(valid, 0u);
+    
+    metrics_latency_summary_t latency;
+    ASSERT_TRUE(partials_get_latency(VALIDATION_TOO_LATE, &latency));
+    EXPECT_EQ(latency.count, 5u);
+    EXPECT_GE(latency.max_ns, latency.p50_ns);
+    ASSERT_TRUE(partials_get_latency(VALIDATION_SUCCESS, &latency));
+    EXPECT_EQ(latency.count, 0u);
+    
+    partial_stage_stats_t stage_stats;
+    ASSERT_TRUE(partial_pipeline_get_stage_stats(PARTIAL_STAGE_DEADLINE, &stage_stats));
+    EXPECT_EQ(stage_stats.executions, 5u);
+    EXPECT_EQ(stage_stats.rejections, 5u);
+    EXPECT_EQ(stage_stats.latency.count, 5u);
+    
+    pool_update_statistics();
+    EXPECT_EQ(pool_get_context()->stats.total_partials, 5u);
+    EXPECT_EQ(pool_get_context()->stats.invalid_partials, 5u);
+}
+
+TEST_F(PoolTest, VectorHexDecode) {
+    // Длины покрывают AVX2, SSE2 и скалярный хвост
+    const size_t lengths[] = {1, 7, 8, 15, 16, 31, 32, 96, 133};
+    for (size_t l = 0; l < sizeof(lengths) / sizeof(lengths[0]); l++) {
+        size_t len = lengths[l];
+        std::vector<uint8_t> expected(len), decoded(len);
+        std::string hex;
+        for (size_t i = 0; i < len; i++) {
+            expected[i] = (uint8_t)(i * 37 + 11);
+            char buf[3];
+            snprintf(buf, sizeof(buf), (i & 1) ? "%02X" : "%02x", expected[i]);
+            hex += buf;
+        }
+        
+        ASSERT_TRUE(vector_hex_decode(hex.c_str(), len, decoded.data()));
+        EXPECT_EQ(decoded, expected);
+        
+        // Любой не-hex символ в любой позиции отклоняется
+        const char bad[] = {'g', 'G', '/', ':', '@', '`', ' ', '\x80'};
+        for (size_t pos = 0; pos < hex.size(); pos += 5) {
+            std::string broken = hex;
+            broken[pos] = bad[pos % sizeof(bad)];
+            EXPECT_FALSE(vector_hex_decode(broken.c_str(), len, decoded.data()));
+        }
+    }
+}
+
+TEST_F(PoolTest, PartialQueueReserveCommit) {
+    partial_queue_t queue;
+    ASSERT_TRUE(partial_queue_init(&queue, 2));
+    
+    partial_queue_reservation_t first, second, third;
+    partial_t* slot1 = partial_queue_reserve(&queue, &first);
+    partial_t* slot2 = partial_queue_reserve(&queue, &second);
+    ASSERT_NE(slot1, nullptr);
+    ASSERT_NE(slot2, nullptr);
+    EXPECT_EQ(partial_queue_reserve(&queue, &third), nullptr);
+    
+    memset(slot1, 0, sizeof(partial_t));
+    slot1->difficulty = 1;
+    memset(slot2, 0, sizeof(partial_t));
+    slot2->difficulty = 2;
+    
+    // Неподтвержденный слот невидим для потребителей
+    partial_t popped;
+    EXPECT_TRUE(partial_queue_commit(&queue, &second));
+    EXPECT_FALSE(partial_queue_try_pop(&queue, &popped));
+    EXPECT_TRUE(partial_queue_commit(&queue, &first));
+    ASSERT_TRUE(partial_queue_try_pop(&queue, &popped));
+    EXPECT_EQ(popped.difficulty, 1u);
+    ASSERT_TRUE(partial_queue_try_pop(&queue, &popped));
+    EXPECT_EQ(popped.difficulty, 2u);
+    partial_queue_cleanup(&queue);
+    
+    // В режиме EDF запись идет через staging
+    ASSERT_TRUE(partial_queue_init_edf(&queue, 4, 28));
+    partial_t* staged = partial_queue_reserve(&queue, &first);
+    ASSERT_EQ(staged, &first.staging);
+    memset(staged, 0, sizeof(partial_t));
+    staged->timestamp = time(NULL);
+    EXPECT_TRUE(partial_queue_commit(&queue, &first));
+    EXPECT_EQ(partial_queue_size(&queue), 1u);
+    partial_queue_cleanup(&queue);
+}
+
+TEST_F(PoolTest, PartialQueueReserveAbort) {
+    partial_queue_t queue;
+    ASSERT_TRUE(partial_queue_init(&queue, 4));
+    
+    // Отмененный слот стоит перед подтвержденными и не должен их задерживать
+    partial_queue_reservation_t aborted, first, second;
+    ASSERT_NE(partial_queue_reserve(&queue, &aborted), nullptr);
+    partial_t* slot1 = partial_queue_reserve(&queue, &first);
+    partial_t* slot2 = partial_queue_reserve(&queue, &second);
+    ASSERT_NE(slot1, nullptr);
+    ASSERT_NE(slot2, nullptr);
+    memset(slot1, 0, sizeof(partial_t));
+    slot1->difficulty = 1;
+    memset(slot2, 0, sizeof(partial_t));
+    slot2->difficulty = 2;
+    EXPECT_TRUE(partial_queue_commit(&queue, &first));
+    EXPECT_TRUE(partial_queue_commit(&queue, &second));
+    
+    partial_t popped[4];
+    EXPECT_FALSE(partial_queue_try_pop(&queue, &popped[0]));
+    partial_queue_abort(&queue, &aborted);
+    EXPECT_EQ(aborted.partial, nullptr);
+    
+    ASSERT_EQ(partial_queue_pop_batch(&queue, popped, 4), 2u);
+    EXPECT_EQ(popped[0].difficulty, 1u);
+    EXPECT_EQ(popped[1].difficulty, 2u);
+    
+    // Слот пропуска возвращается в кольцо и снова принимает partials
+    for (int round = 0; round < 3; round++) {
+        partial_t* slot = partial_queue_reserve(&queue, &first);
+        ASSERT_NE(slot, nullptr);
+        memset(slot, 0, sizeof(partial_t));
+        slot->difficulty = 10 + round;
+        EXPECT_TRUE(partial_queue_commit(&queue, &first));
+        ASSERT_TRUE(partial_queue_try_pop(&queue, &popped[0]));
+        EXPECT_EQ(popped[0].difficulty, 10u + round);
+    }
+    partial_queue_cleanup(&queue);
+    
+    // Через пул воркеров: отмена освобождает и очередь, и остановку
+    partial_workers_t workers;
+    ASSERT_TRUE(partial_workers_start(&workers, 1, 8));
+    ASSERT_NE(partial_workers_reserve(&workers, &aborted), nullptr);
+    partial_t partial;
+    memset(&partial, 0, sizeof(partial_t));
+    for (int i = 0; i < 3; i++) {
+        ASSERT_EQ(partial_workers_submit(&workers, &partial), VALIDATION_SUCCESS);
+    }
+    partial_workers_abort(&workers, &aborted);
+    partial_workers_stop(&workers);
+    EXPECT_EQ(workers.processed, 3u);
+    partial_completions_cleanup();
+}
+
 TEST_F(PoolTest, PartialValidation) {
     partial_t partial;
     memset(&partial, 0, sizeof(partial_t));
@@ -131,6 +761,542 @@ TEST_F(PoolTest, PartialValidationLate) {
     EXPECT_EQ(result, PARTIAL_TOO_LATE);
 }
 
+TEST_F(PoolTest, PartialValidationBatch) {
+    partial_t partials[4];
+    memset(partials, 0, sizeof(partials));
+    
+    // Два свежих partial одного фермера и два просроченных
+    partials[0].timestamp = time(NULL);
+    partials[1].timestamp = time(NULL);
+    partials[2].timestamp = time(NULL) - 30;
+    partials[3].timestamp = time(NULL) - 60;
+    partials[3].launcher_id[0] = 0x42;
+    
+    const partial_t* batch[5] = {&partials[0], &partials[1], &partials[2], NULL, &partials[3]};
+    partial_validation_result_t results[5];
+    
+    size_t valid = partial_validate_batch(batch, 5, results);
+    
+    EXPECT_EQ(valid, 0u);
+    EXPECT_EQ(results[2], PARTIAL_TOO_LATE);
+    EXPECT_EQ(results[3], VALIDATION_INTERNAL_ERROR);
+    EXPECT_EQ(results[4], PARTIAL_TOO_LATE);
+    
+    // Результаты пакетного пути совпадают с одиночной валидацией
+    EXPECT_EQ(results[0], partial_validate(&partials[0]));
+    EXPECT_EQ(results[1], results[0]);
+    
+    EXPECT_EQ(partial_validate_batch(batch, 0, results), 0u);
+    EXPECT_EQ(partial_validate_batch(NULL, 5, results), 0u);
+}
+
+TEST_F(PoolTest, PartialValidationContext) {
+    partial_t partial;
+    memset(&partial, 0, sizeof(partial_t));
+    partial.timestamp = time(NULL);
+    partial.launcher_id[0] = 0x07;
+    partial.plot_size = 32;
+    
+    // Синглтон и точка сигнейджа переданы в контекст заранее:
+    // валидация не должна обращаться к ноде повторно
+    singleton_t singleton;
+    memset(&singleton, 0, sizeof(singleton_t));
+    memcpy(singleton.launcher_id, partial.launcher_id, 32);
+    singleton.is_pool_member = true;
+    
+    signage_point_t signage_point;
+    memset(&signage_point, 0, sizeof(signage_point_t));
+    memcpy(signage_point.challenge_hash, partial.challenge, 32);
+    
+    // Этапы, использующие синглтон и точку сигнейджа, выполняются первыми
+    ASSERT_TRUE(partial_pipeline_configure("singleton,signature,challenge", 28, 0));
+    
+    partial_validation_context_t ctx;
+    partial_context_init(&ctx, &partial);
+    partial_context_set_singleton(&ctx, &singleton, true);
+    partial_context_set_signage_point(&ctx, &signage_point);
+    
+    partial_validation_result_t result = partial_validate_ctx(&ctx);
+    
+    EXPECT_NE(result, VALIDATION_INVALID_SINGLETON);
+    EXPECT_NE(result, VALIDATION_INVALID_CHALLENGE);
+    EXPECT_TRUE(ctx.singleton_found);
+    EXPECT_TRUE(ctx.signature_message_ready);
+    EXPECT_EQ(memcmp(ctx.signature_message, partial.launcher_id, 32), 0);
+    EXPECT_EQ(partial_context_get_singleton(&ctx), &ctx.singleton);
+    
+    // Несуществующий синглтон запоминается и не запрашивается повторно
+    partial_context_init(&ctx, &partial);
+    partial_context_set_singleton(&ctx, NULL, false);
+    EXPECT_TRUE(partial_context_get_singleton(&ctx) == NULL);
+    EXPECT_EQ(partial_validate_ctx(&ctx), VALIDATION_INVALID_SINGLETON);
+    
+    ASSERT_TRUE(partial_pipeline_configure(NULL, 28, 0));
+}
+
+TEST_F(PoolTest, PartialPipelineOrder) {
+    partial_stage_id_t order[PARTIAL_STAGE_COUNT];
+    
+    // По умолчанию дешевые проверки выполняются раньше криптографии
+    ASSERT_TRUE(partial_pipeline_configure(NULL, 28, 0));
+    ASSERT_EQ(partial_pipeline_get_order(order, PARTIAL_STAGE_COUNT), (size_t)PARTIAL_STAGE_COUNT);
+    EXPECT_EQ(order[0], PARTIAL_STAGE_DEADLINE);
+    EXPECT_EQ(order[1], PARTIAL_STAGE_CHALLENGE);
+    EXPECT_EQ(order[2], PARTIAL_STAGE_DUPLICATE);
+    EXPECT_EQ(order[3], PARTIAL_STAGE_RATE_LIMIT);
+    EXPECT_EQ(order[PARTIAL_STAGE_COUNT - 1], PARTIAL_STAGE_SIGNATURE);
+    
+    // Явно заданные этапы идут первыми, остальные - по стоимости
+    ASSERT_TRUE(partial_pipeline_configure("signature, deadline", 28, 0));
+    ASSERT_EQ(partial_pipeline_get_order(order, PARTIAL_STAGE_COUNT), (size_t)PARTIAL_STAGE_COUNT);
+    EXPECT_EQ(order[0], PARTIAL_STAGE_SIGNATURE);
+    EXPECT_EQ(order[1], PARTIAL_STAGE_DEADLINE);
+    EXPECT_EQ(order[2], PARTIAL_STAGE_CHALLENGE);
+    
+    EXPECT_FALSE(partial_pipeline_configure("deadline,unknown", 28, 0));
+    ASSERT_TRUE(partial_pipeline_configure(NULL, 28, 0));
+}
+
+TEST_F(PoolTest, PartialPipelineEarlyRejection) {
+    ASSERT_TRUE(partial_pipeline_configure(NULL, 28, 0));
+    partial_pipeline_reset_stats();
+    
+    partial_t partial;
+    memset(&partial, 0, sizeof(partial_t));
+    partial.timestamp = time(NULL);
+    partial.challenge[0] = 0xff;
+    
+    // Challenge не совпадает с точкой сигнейджа: синглтон и подпись
+    // не должны запрашиваться
+    signage_point_t signage_point;
+    memset(&signage_point, 0, sizeof(signage_point_t));
+    
+    partial_validation_context_t ctx;
+    partial_context_init(&ctx, &partial);
+    partial_context_set_signage_point(&ctx, &signage_point);
+    
+    EXPECT_EQ(partial_validate_ctx(&ctx), VALIDATION_INVALID_CHALLENGE);
+    EXPECT_FALSE(ctx.singleton_resolved);
+    
+    partial_stage_stats_t stats;
+    ASSERT_TRUE(partial_pipeline_get_stage_stats(PARTIAL_STAGE_CHALLENGE, &stats));
+    EXPECT_EQ(stats.executions, 1u);
+    EXPECT_EQ(stats.rejections, 1u);
+    EXPECT_EQ(stats.position, 1u);
+    
+    ASSERT_TRUE(partial_pipeline_get_stage_stats(PARTIAL_STAGE_SINGLETON, &stats));
+    EXPECT_EQ(stats.executions, 0u);
+    ASSERT_TRUE(partial_pipeline_get_stage_stats(PARTIAL_STAGE_SIGNATURE, &stats));
+    EXPECT_EQ(stats.executions, 0u);
+    
+    // Лимит partials в минуту на фермера
+    ASSERT_TRUE(partial_pipeline_configure("rate_limit", 28, 2));
+    partial.launcher_id[0] = 0x5a;
+    partial.challenge[0] = 0;
+    for (int i = 0; i < 2; i++) {
+        partial_context_init(&ctx, &partial);
+        EXPECT_NE(partial_validate_ctx(&ctx), VALIDATION_RATE_LIMITED);
+    }
+    partial_context_init(&ctx, &partial);
+    EXPECT_EQ(partial_validate_ctx(&ctx), VALIDATION_RATE_LIMITED);
+    
+    auth_reset_rate_limit(partial.launcher_id);
+    ASSERT_TRUE(partial_pipeline_configure(NULL, 28, 0));
+}
+
+TEST_F(PoolTest, PartialDedupIndex) {
+    ASSERT_TRUE(partial_dedup_init(2, 64));
+    
+    uint8_t launcher_id[32] = {0x01};
+    uint8_t proof[264] = {0x02};
+    uint8_t proof_hash[PARTIAL_DEDUP_HASH_SIZE];
+    partial_dedup_hash_proof(proof, sizeof(proof), 33, proof_hash);
+    
+    uint64_t now = 1700000000;
+    partial_dedup_claim_t claim;
+    
+    EXPECT_FALSE(partial_dedup_check_and_insert(launcher_id, proof_hash, now, now, &claim));
+    EXPECT_NE(claim.slot, UINT64_MAX);
+    
+    // Повтор через минуту с новой временной меткой - тоже дубликат
+    EXPECT_TRUE(partial_dedup_check_and_insert(launcher_id, proof_hash, now, now, NULL));
+    EXPECT_TRUE(partial_dedup_check_and_insert(launcher_id, proof_hash, now + 60, now + 60, NULL));
+    
+    // Тот же proof от другого фермера не является дубликатом
+    uint8_t other_launcher[32] = {0x03};
+    EXPECT_FALSE(partial_dedup_check_and_insert(other_launcher, proof_hash, now, now, NULL));
+    
+    // Освобожденная запись невалидного partial не блокирует повторную отправку
+    partial_dedup_release(&claim);
+    EXPECT_FALSE(partial_dedup_check_and_insert(launcher_id, proof_hash, now, now, &claim));
+    
+    // После выхода из окна поколение переиспользуется
+    uint64_t later = now + 4 * 60;
+    EXPECT_FALSE(partial_dedup_check_and_insert(launcher_id, proof_hash, later, later, NULL));
+    
+    partial_dedup_stats_t stats;
+    partial_dedup_get_stats(&stats);
+    EXPECT_EQ(stats.lookups, 6u);
+    EXPECT_EQ(stats.duplicates, 2u);
+    EXPECT_EQ(stats.releases, 1u);
+    EXPECT_EQ(stats.memory_bytes, 3u * 64u * sizeof(uint64_t));
+    EXPECT_NEAR(stats.hit_rate, 2.0 / 6.0, 1e-9);
+    
+    partial_dedup_cleanup();
+    EXPECT_FALSE(partial_dedup_is_enabled());
+}
+
+TEST_F(PoolTest, PartialDedupIgnoresProofPadding) {
+    ASSERT_TRUE(partial_dedup_init(2, 64));
+    ASSERT_TRUE(partial_pipeline_configure("dedup", 28, 0));
+    
+    partial_t partial;
+    memset(&partial, 0, sizeof(partial_t));
+    partial.launcher_id[0] = 0x11;
+    partial.plot_size = 32;
+    partial.timestamp = time(NULL);
+    for (size_t i = 0; i < 256; i++) {
+        partial.proof[i] = (uint8_t)(i * 7 + 1);
+    }
+    
+    partial_validation_context_t ctx;
+    partial_context_init(&ctx, &partial);
+    EXPECT_FALSE(partial_dedup_check_and_insert(partial.launcher_id, partial_context_get_proof_hash(&ctx),
+                                                partial.timestamp, partial.timestamp, NULL));
+    
+    // Тот же proof k32 с другими байтами выравнивания - дубликат
+    partial_t resubmitted = partial;
+    memset(resubmitted.proof + 256, 0xA5, sizeof(resubmitted.proof) - 256);
+    partial_context_init(&ctx, &resubmitted);
+    EXPECT_EQ(partial_validate_ctx(&ctx), VALIDATION_DUPLICATE);
+    
+    // Другой размер плота меняет ключ
+    uint8_t hash_k32[PARTIAL_DEDUP_HASH_SIZE];
+    uint8_t hash_k33[PARTIAL_DEDUP_HASH_SIZE];
+    partial_dedup_hash_proof(partial.proof, sizeof(partial.proof), 32, hash_k32);
+    partial_dedup_hash_proof(partial.proof, sizeof(partial.proof), 33, hash_k33);
+    EXPECT_NE(memcmp(hash_k32, hash_k33, sizeof(hash_k32)), 0);
+    
+    ASSERT_TRUE(partial_pipeline_configure(NULL, 28, 0));
+    partial_dedup_cleanup();
+}
+
+TEST_F(PoolTest, PartialDedupConcurrentInsert) {
+    ASSERT_TRUE(partial_dedup_init(1, 4096));
+    
+    const int kThreads = 8;
+    const uint32_t kKeys = 1000;
+    const uint64_t now = 1700000000;
+    std::atomic<uint64_t> duplicates(0);
+    std::vector<std::thread> threads;
+    
+    // Все потоки отправляют одни и те же partials: каждый ключ
+    // должен быть принят ровно один раз
+    for (int t = 0; t < kThreads; t++) {
+        threads.push_back(std::thread([&]() {
+            uint8_t launcher_id[32] = {0};
+            uint8_t proof_hash[PARTIAL_DEDUP_HASH_SIZE] = {0};
+            for (uint32_t key = 0; key < kKeys; key++) {
+                memcpy(proof_hash, &key, sizeof(key));
+                if (partial_dedup_check_and_insert(launcher_id, proof_hash, now, now, NULL)) {
+                    duplicates++;
+                }
+            }
+        }));
+    }
+    
+    for (size_t t = 0; t < threads.size(); t++) {
+        threads[t].join();
+    }
+    
+    partial_dedup_stats_t stats;
+    partial_dedup_get_stats(&stats);
+    EXPECT_EQ(stats.inserts + stats.overflows, kKeys);
+    EXPECT_EQ(duplicates.load(), (uint64_t)(kThreads - 1) * kKeys);
+    
+    partial_dedup_cleanup();
+}
+
+struct JournalReplayState {
+    std::vector<uint64_t> sequences;
+    uint64_t points;
+};
+
+static void journal_collect(const partial_journal_entry_t* entry, void* user) {
+    JournalReplayState* state = (JournalReplayState*)user;
+    state->sequences.push_back(entry->sequence);
+    state->points += entry->points;
+}
+
+TEST_F(PoolTest, PartialJournalReplay) {
+    char directory[] = "/tmp/partial_journal_XXXXXX";
+    ASSERT_NE(mkdtemp(directory), nullptr);
+    
+    partial_journal_config_t config;
+    memset(&config, 0, sizeof(config));
+    config.directory = directory;
+    config.segment_records = 64;
+    config.sync_interval_ms = 1;
+    config.sync_records = 16;
+    
+    ASSERT_TRUE(partial_journal_open(&config, NULL, NULL));
+    
+    // 150 записей занимают три сегмента
+    uint64_t now = time(NULL);
+    uint64_t last = 0;
+    for (uint32_t i = 0; i < 150; i++) {
+        partial_journal_entry_t entry;
+        memset(&entry, 0, sizeof(entry));
+        entry.timestamp = now;
+        entry.points = i + 1;
+        memcpy(entry.proof_hash, &i, sizeof(i));
+        ASSERT_TRUE(partial_journal_append(&entry, &last));
+    }
+    EXPECT_EQ(last, 150u);
+    EXPECT_TRUE(partial_journal_wait_durable(last, 5000));
+    partial_journal_close();
+    
+    JournalReplayState state;
+    state.points = 0;
+    ASSERT_TRUE(partial_journal_open(&config, journal_collect, &state));
+    ASSERT_EQ(state.sequences.size(), 150u);
+    for (size_t i = 0; i < state.sequences.size(); i++) {
+        EXPECT_EQ(state.sequences[i], i + 1);
+    }
+    EXPECT_EQ(state.points, 150u * 151u / 2);
+    
+    // Нумерация продолжается после восстановления
+    partial_journal_entry_t entry;
+    memset(&entry, 0, sizeof(entry));
+    entry.timestamp = now;
+    ASSERT_TRUE(partial_journal_append(&entry, &last));
+    EXPECT_EQ(last, 151u);
+    ASSERT_TRUE(partial_journal_sync());
+    partial_journal_close();
+    
+    // Повреждение записи 151: восстановление сегмента останавливается на ней.
+    // Номера сегментов не обязаны совпадать с порядком записей, поэтому
+    // сегмент ищется по номеру первой записи.
+    bool corrupted = false;
+    for (uint64_t id = 1; id < 16 && !corrupted; id++) {
+        char path[600];
+        snprintf(path, sizeof(path), "%s/partials-%016llx.wal", directory, (unsigned long long)id);
+        FILE* file = fopen(path, "r+b");
+        if (!file) {
+            continue;
+        }
+        
+        uint64_t sequence = 0;
+        fseek(file, PARTIAL_JOURNAL_RECORD_SIZE + 8, SEEK_SET);
+        if (fread(&sequence, sizeof(sequence), 1, file) == 1 && sequence == 151) {
+            fseek(file, PARTIAL_JOURNAL_RECORD_SIZE + 40, SEEK_SET);
+            fputc(0xFF, file);
+            corrupted = true;
+        }
+        fclose(file);
+    }
+    ASSERT_TRUE(corrupted);
+    
+    state.sequences.clear();
+    state.points = 0;
+    ASSERT_TRUE(partial_journal_open(&config, journal_collect, &state));
+    EXPECT_EQ(state.sequences.size(), 150u);
+    
+    partial_journal_stats_t stats;
+    partial_journal_get_stats(&stats);
+    EXPECT_EQ(stats.replayed, 150u);
+    EXPECT_EQ(stats.durable_sequence, 150u);
+    partial_journal_close();
+    
+    std::string command = std::string("rm -rf ") + directory;
+    EXPECT_EQ(system(command.c_str()), 0);
+}
+
+TEST_F(PoolTest, PartialJournalTruncation) {
+    char directory[] = "/tmp/partial_journal_XXXXXX";
+    ASSERT_NE(mkdtemp(directory), nullptr);
+    
+    partial_journal_config_t config;
+    memset(&config, 0, sizeof(config));
+    config.directory = directory;
+    config.segment_records = 64;
+    config.retention_seconds = 3600;
+    
+    ASSERT_TRUE(partial_journal_open(&config, NULL, NULL));
+    
+    // Два полных сегмента вне окна и текущий сегмент в окне
+    uint64_t now = time(NULL);
+    for (uint32_t i = 0; i < 140; i++) {
+        partial_journal_entry_t entry;
+        memset(&entry, 0, sizeof(entry));
+        entry.timestamp = i < 128 ? now - 7200 : now;
+        entry.points = 1;
+        ASSERT_TRUE(partial_journal_append(&entry, NULL));
+    }
+    ASSERT_TRUE(partial_journal_sync());
+    
+    EXPECT_EQ(partial_journal_truncate(now), 2u);
+    EXPECT_EQ(partial_journal_truncate(now), 0u);
+    partial_journal_close();
+    
+    // Старые записи не восстанавливаются
+    JournalReplayState state;
+    state.points = 0;
+    ASSERT_TRUE(partial_journal_open(&config, journal_collect, &state));
+    EXPECT_EQ(state.sequences.size(), 12u);
+    EXPECT_EQ(state.sequences.front(), 129u);
+    partial_journal_close();
+    
+    std::string command = std::string("rm -rf ") + directory;
+    EXPECT_EQ(system(command.c_str()), 0);
+}
+
+TEST_F(PoolTest, PartialJournalConcurrentRollover) {
+    char directory[] = "/tmp/partial_journal_XXXXXX";
+    ASSERT_NE(mkdtemp(directory), nullptr);
+    
+    partial_journal_config_t config;
+    memset(&config, 0, sizeof(config));
+    config.directory = directory;
+    config.segment_records = 64;
+    config.sync_interval_ms = 1000;
+    config.sync_records = 1000000;
+    
+    ASSERT_TRUE(partial_journal_open(&config, NULL, NULL));
+    
+    // Запасной сегмент не успевает создаваться: смена сегмента
+    // создает файл сама, не блокируя остальные записи
+    const int threads = 4;
+    const int per_thread = 500;
+    std::atomic<int> failures(0);
+    std::vector<std::thread> writers;
+    uint64_t now = time(NULL);
+    for (int t = 0; t < threads; t++) {
+        writers.push_back(std::thread([&failures, now, per_thread]() {
+            for (int i = 0; i < per_thread; i++) {
+                partial_journal_entry_t entry;
+                memset(&entry, 0, sizeof(entry));
+                entry.timestamp = now;
+                entry.points = 1;
+                if (!partial_journal_append(&entry, NULL)) {
+                    failures++;
+                }
+            }
+        }));
+    }
+    for (size_t i = 0; i < writers.size(); i++) {
+        writers[i].join();
+    }
+    EXPECT_EQ(failures.load(), 0);
+    ASSERT_TRUE(partial_journal_sync());
+    partial_journal_close();
+    
+    JournalReplayState state;
+    state.points = 0;
+    ASSERT_TRUE(partial_journal_open(&config, journal_collect, &state));
+    ASSERT_EQ(state.sequences.size(), (size_t)(threads * per_thread));
+    for (size_t i = 0; i < state.sequences.size(); i++) {
+        EXPECT_EQ(state.sequences[i], i + 1);
+    }
+    partial_journal_close();
+    
+    std::string command = std::string("rm -rf ") + directory;
+    EXPECT_EQ(system(command.c_str()), 0);
+}
+
+TEST_F(PoolTest, PartialPointsWindow) {
+    ASSERT_TRUE(partial_points_init(3600));
+    
+    uint8_t launcher_a[32] = {0xA1};
+    uint8_t launcher_b[32] = {0xB2};
+    uint64_t now = (uint64_t)time(NULL) / 60 * 60;
+    uint64_t launcher_points = 0;
+    
+    // Две минуты начислений: вторая минута позже первой на 2 минуты
+    ASSERT_TRUE(partial_points_credit(launcher_a, 10, now - 3000, now, &launcher_points));
+    ASSERT_TRUE(partial_points_credit(launcher_a, 5, now - 3000, now, &launcher_points));
+    EXPECT_EQ(launcher_points, 15u);
+    ASSERT_TRUE(partial_points_credit(launcher_b, 4, now - 3000, now, NULL));
+    ASSERT_TRUE(partial_points_credit(launcher_a, 7, now - 2880, now, &launcher_points));
+    EXPECT_EQ(launcher_points, 22u);
+    
+    // Начисление старше окна не учитывается
+    ASSERT_TRUE(partial_points_credit(launcher_b, 100, now - 7200, now, NULL));
+    EXPECT_EQ(partial_points_get(launcher_b), 4u);
+    
+    partial_points_stats_t stats;
+    partial_points_get_stats(&stats);
+    EXPECT_EQ(stats.total_points, 26u);
+    EXPECT_EQ(stats.launchers, 2u);
+    EXPECT_EQ(stats.stale_credits, 1u);
+    
+    // Первая минута выходит из окна: очки вычитаются, фермер B удаляется
+    EXPECT_EQ(partial_points_expire(now + 660), 19u);
+    EXPECT_EQ(partial_points_get(launcher_a), 7u);
+    EXPECT_EQ(partial_points_get(launcher_b), 0u);
+    partial_points_get_stats(&stats);
+    EXPECT_EQ(stats.total_points, 7u);
+    EXPECT_EQ(stats.launchers, 1u);
+    
+    // Повторное начисление в корзину вышедшей минуты вытесняет ее
+    ASSERT_TRUE(partial_points_credit(launcher_b, 3, now + 780, now + 780, NULL));
+    EXPECT_EQ(partial_points_get(launcher_a), 0u);
+    EXPECT_EQ(partial_points_get(launcher_b), 3u);
+    partial_points_cleanup();
+}
+
+static void journal_credit(const partial_journal_entry_t* entry, void* user) {
+    (void)user;
+    partial_points_credit(entry->launcher_id, entry->points, entry->timestamp, (uint64_t)time(NULL), NULL);
+}
+
+TEST_F(PoolTest, PartialPointsJournalReplay) {
+    char directory[] = "/tmp/partial_journal_XXXXXX";
+    ASSERT_NE(mkdtemp(directory), nullptr);
+    
+    partial_journal_config_t config;
+    memset(&config, 0, sizeof(config));
+    config.directory = directory;
+    config.segment_records = 64;
+    config.retention_seconds = 3600;
+    
+    ASSERT_TRUE(partial_points_init(config.retention_seconds));
+    ASSERT_TRUE(partial_journal_open(&config, journal_credit, NULL));
+    
+    // Очки двух фермеров, часть записей вне окна PPLNS
+    uint64_t now = time(NULL);
+    for (uint32_t i = 0; i < 100; i++) {
+        partial_journal_entry_t entry;
+        memset(&entry, 0, sizeof(entry));
+        entry.timestamp = i < 20 ? now - 7200 : now;
+        entry.points = i + 1;
+        entry.launcher_id[0] = (uint8_t)(i % 2 + 1);
+        memcpy(entry.proof_hash, &i, sizeof(i));
+        ASSERT_TRUE(partial_journal_append(&entry, NULL));
+        ASSERT_TRUE(partial_points_credit(entry.launcher_id, entry.points, entry.timestamp, now, NULL));
+    }
+    ASSERT_TRUE(partial_journal_sync());
+    partial_journal_close();
+    
+    uint8_t launcher_1[32] = {1};
+    uint8_t launcher_2[32] = {2};
+    uint64_t points_1 = partial_points_get(launcher_1);
+    uint64_t points_2 = partial_points_get(launcher_2);
+    EXPECT_EQ(points_1 + points_2, 100u * 101u / 2 - 20u * 21u / 2);
+    partial_points_cleanup();
+    
+    // После перезапуска суммы фермеров восстанавливаются из журнала
+    ASSERT_TRUE(partial_points_init(config.retention_seconds));
+    ASSERT_TRUE(partial_journal_open(&config, journal_credit, NULL));
+    EXPECT_EQ(partial_points_get(launcher_1), points_1);
+    EXPECT_EQ(partial_points_get(launcher_2), points_2);
+    partial_journal_close();
+    partial_points_cleanup();
+    
+    std::string command = std::string("rm -rf ") + directory;
+    EXPECT_EQ(system(command.c_str()), 0);
+}
+
 TEST_F(PoolTest, SingletonInitialization) {
     uint8_t launcher_id[32] = {0x01, 0x02, 0x03};
     singleton_t singleton;
@@ -1,7 +1,16 @@
 #include <gtest/gtest.h>
 #include "security/auth.h"
 #include "security/proof_verification.h"
+#include "security/pos_verifier.h"
+#include "security/proof_cache.h"
+#include "security/bls.h"
+#include "security/bls_key_cache.h"
+#include "protocol/singleton.h"
+#include "blockchain/smart_coin.h"
+#include <cstdio>
 #include <cstring>
+#include <random>
+#include <vector>
 
 class SecurityTest : public ::testing::Test {
 protected:
@@ -12,43 +21,614 @@ protected:
         auth_init(&test_key);
         proof_verification_init();
     }
-
+    
     void TearDown() override {
         auth_cleanup();
         proof_verification_cleanup();
     }
 };
 
+// Доказательство k=18, полученное построением всех семи таблиц плота
+// по алгоритму chiapos, и ожидаемая строка качества
+#define POS_TEST_K 18
+static const char* kPosTestPlotId =
+    "2291d8cdc310411e7ec27378a661c935187c07e4d5636e9bc3c400b27244b8cd";
+static const char* kPosTestChallenge =
+    "49df416d07d4bedc51431193e6c3f3391a2b8f1ff1fd42a29755d4c13a902931";
+static const char* kPosTestProof =
+    "1303a4e97acc0c2edb74148399c5f3820c4863b9848389d1bcc0d937548465fa"
+    "8936b4075d37fbb909ce3c730a43901151ba5eb53df43b52409f9238c0a58c08"
+    "9bac18149682ed065cc2e266bcb21c94238ecba4db28a72ac3980a6ae391541b"
+    "3660c7c69c074ba9398edbaa8797bcfc1f761716e79efa59311f1f21077f6e52"
+    "5201892286267596a1489b880d86ee3c";
+static const char* kPosTestQuality =
+    "0c5c9b9e3994b7dea2ae9a670784d83de3b8ebba4705c0ba96580505d06f2e47";
+
+// k=32: полный плот здесь не построить, поэтому вектор - поддерево
+// таблицы 4 из 8 x (найдено перебором всех 2^32 x), повторенное 8 раз.
+// Проверка не сравнивает x между собой, и таблицы 2..4 сопоставляются,
+// а таблица 5 - нет: пара одинаковых y не проходит сопоставление.
+#define POS_K32_MATCHED_TABLES 4
+static const char* kPosK32PlotId =
+    "5d7e1b0421c2ef88b556731c39dac7e08dae4b741132dff8e586a34c690a37d0";
+static const char* kPosK32Subtree =
+    "0069014b5b5ee30c00a8ac292d73e5c50122754a5f13d0480001bfcae2122d2f";
+
+// k=25: полный плот, построенный по алгоритму chiapos, challenge_hash и
+// sp_hash, для которых плот проходит фильтр, и доказательство для
+// pos_challenge = SHA256(SHA256(plot_id || challenge_hash || sp_hash)).
+// kPosK25FilteredSp - точка сигнейджа, для которой плот не проходит фильтр,
+// хотя у плота есть доказательство kPosK25FilteredProof для ее pos_challenge.
+#define POS_K25_K 25
+static const char* kPosK25PlotId =
+    "ac6375b704bcd28541dd5b33beab0469433b905a7d56cae0b56c946d89102cc0";
+static const char* kPosK25ChallengeHash =
+    "cf65f790e94f0827f295d1e25f03ad1a0c345db3f6fc7a5b0cf99f26966c3ee3";
+static const char* kPosK25SpHash =
+    "7b7b6d353f94b6b0fa069848802b3e9cd6257dced46732fd739078d3f3fb0562";
+static const char* kPosK25Proof =
+    "c6896aadb9341666eb8e74ec9ee9f637cacd3aa0c2b4df0a5f787089cca6bdf2"
+    "a13546ec6e9160d86c221756214b7c82d38e4db43e71be401b55bf38bb6e9510"
+    "bf0175c69b096949ee044a7f15526c0a2865661d26414a8c708d3841275c5d8a"
+    "96dee77d33fdac5443b9950a5df6cf12bb42f47488eb71ed4a6f1ad55b4692a4"
+    "fad3319a16120e61210bb5f18aab89a0bd7f9a72e5ca69bf4c2986cd0111dcfa"
+    "22f319ae716806fa67d0d5b84551be7c2ef8e24bf7743f136b6162c12e130219"
+    "c096395801223fbc";
+static const char* kPosK25Quality =
+    "1b281a92dd39f8e52fba971731b554c2c2051abe365a8b8722e4244ee9fe43ab";
+#define POS_K25_ITERATIONS 544859339u
+static const char* kPosK25FilteredSp =
+    "6d4f7c95fb421ad9849f59e6d52c897cacfa9cb59ae6efdbe66b1642b3f1c449";
+static const char* kPosK25FilteredProof =
+    "1fd2e3be64da443cebd7e2c9ed830cbe4471c3f8532c1249acc7ed50bfa600da"
+    "8557ed9e4517daec2e5b9eacbf96891183b221dba4674bbcb6f942dbdf740a25"
+    "eb48cf00d16a0880c952b76079632dc516ea385cbc309b40867831ec673d382a"
+    "85d95f92a1dfe56954eac071f8db034e5f7adb72869677fe9e1432c9e7f08e3c"
+    "52c1069596ab6459d067d3a9ad4c076e3e64c84351513fe34eb5d7a52561ea16"
+    "b9f90b7d4575304cea34d08f330d11abd678a10577e418d8d581b3824eedae65"
+    "4320f4d3deecc5b5";
+
+static std::vector<uint8_t> hex_bytes(const char* hex) {
+    std::vector<uint8_t> bytes;
+    for (size_t i = 0; hex[i] && hex[i + 1]; i += 2) {
+        unsigned int value;
+        sscanf(hex + i, "%2x", &value);
+        bytes.push_back((uint8_t)value);
+    }
+    return bytes;
+}
+
+// Значения x доказательства k бит, упакованные big-endian
+static std::vector<uint64_t> proof_unpack_xs(const std::vector<uint8_t>& proof, uint32_t k) {
+    std::vector<uint64_t> xs(POS_PROOF_X_COUNT, 0);
+    for (uint32_t bit = 0; bit < POS_PROOF_X_COUNT * k; bit++) {
+        uint64_t value = (proof[bit / 8] >> (7 - bit % 8)) & 1;
+        xs[bit / k] = (xs[bit / k] << 1) | value;
+    }
+    return xs;
+}
+
+static std::vector<uint8_t> proof_pack_xs(const std::vector<uint64_t>& xs, uint32_t k) {
+    std::vector<uint8_t> proof(pos_proof_size(k), 0);
+    for (uint32_t bit = 0; bit < POS_PROOF_X_COUNT * k; bit++) {
+        uint64_t value = (xs[bit / k] >> (k - 1 - bit % k)) & 1;
+        proof[bit / 8] |= (uint8_t)(value << (7 - bit % 8));
+    }
+    return proof;
+}
+
+// Подписи AugSchemeMPL, полученные эталонной реализацией py_ecc
+// (G2MessageAugmentation): публичный ключ, сообщение, подпись
+struct BlsTestVector {
+    const char* public_key;
+    const char* message;
+    const char* signature;
+};
+
+static const BlsTestVector kBlsTestVectors[] = {
+    {"8530c1bdc4cd6b1408be0933c4a41ac3513350eef36850b804708e1f338932ce01b655a163344a4500b281c8750c461f",
+     "68656c6c6f",
+     "8d4a9f8654173f738035c3e264e33656edff0164322a8b9637f47424a60da290d5302583a5fcd7e98f8fa26233aad84c"
+     "08e2592dcfbdd8cc246bf8f14a6bfd8e38c6cb49d7b771fdc54d363dcc254820d3b09e16385a9e05d1f3ef792ae05f5f"},
+    {"b4cce10e73b487adb6b032d38b97b168898f90d60c3c3cd6928529a8f8ac9dc6702e7630d87dcba16c0db296e342c380",
+     "7061727469616c7061727469616c7061727469616c7061727469616c7061727469616c"
+     "7061727469616c7061727469616c7061727469616c7061727469616c7061727469616c",
+     "b062914bd968a447a28da0ccf42f7c786197c9d95ecd73b8457e1b0806352c963c7d0cfb58b9a445fce18b658e6405e0"
+     "15aefbbe4688097e9c1faba487712edbcc4988d83d7c926a8327f325654bc0213587be52b51ceb78c3e68acea91b0db8"},
+    {"acb8047ad1a5643a12252e450a90a3e5ea166cc0906ad4ebbbae1c82025b81f185788ace2da4aebfd36a077c977a5e7c",
+     "000102030405060708090a0b0c0d0e0f101112131415161718191a1b1c1d1e1f"
+     "202122232425262728292a2b2c2d2e2f303132333435363738393a3b3c3d3e3f",
+     "a3d9e6983de6f5363e351f7bdb82f97eb1af4d9a91db62319c254427b4f4a7d4c89bb24c1a7b46ec8b8d06eaefa51a31"
+     "0b5b61fdde2d581b878356e1dd238ca86437e2fc2030a12deb9951cc9f319373e35442ceb514542141e3ea8dc08f4083"},
+};
+#define BLS_TEST_VECTOR_COUNT (sizeof(kBlsTestVectors) / sizeof(kBlsTestVectors[0]))
+
 TEST_F(SecurityTest, BLSVerifySignature) {
+    for (size_t i = 0; i < BLS_TEST_VECTOR_COUNT; i++) {
+        std::vector<uint8_t> public_key = hex_bytes(kBlsTestVectors[i].public_key);
+        std::vector<uint8_t> message = hex_bytes(kBlsTestVectors[i].message);
+        std::vector<uint8_t> signature = hex_bytes(kBlsTestVectors[i].signature);
+        
+        EXPECT_TRUE(auth_bls_verify_signature(&public_key[0], &message[0], message.size(),
+                                              &signature[0])) << "вектор " << i;
+        
+        // Измененное сообщение
+        message[0] ^= 0x01;
+        EXPECT_FALSE(auth_bls_verify_signature(&public_key[0], &message[0], message.size(),
+                                               &signature[0])) << "вектор " << i;
+        message[0] ^= 0x01;
+        
+        // Подпись другого сообщения
+        std::vector<uint8_t> other_signature =
+            hex_bytes(kBlsTestVectors[(i + 1) % BLS_TEST_VECTOR_COUNT].signature);
+        EXPECT_FALSE(auth_bls_verify_signature(&public_key[0], &message[0], message.size(),
+                                               &other_signature[0])) << "вектор " << i;
+        
+        // Точка вне кривой
+        signature[BLS_SIGNATURE_SIZE - 1] ^= 0x01;
+        EXPECT_FALSE(auth_bls_verify_signature(&public_key[0], &message[0], message.size(),
+                                               &signature[0])) << "вектор " << i;
+    }
+    
+    // Нулевые байты не являются сжатой точкой
     uint8_t public_key[48] = {0};
     uint8_t message[32] = {0};
     uint8_t signature[96] = {0};
+    EXPECT_FALSE(auth_bls_verify_signature(public_key, message, sizeof(message), signature));
+}
+
+TEST_F(SecurityTest, BLSVerifyBatchMatchesSingle) {
+    // Валидные подписи вперемешку с неверными: результат пачки должен
+    // совпадать с поштучной проверкой при любом расположении неверных
+    const size_t count = 12;
+    std::vector<std::vector<uint8_t> > public_keys(count), messages(count), signatures(count);
+    for (size_t i = 0; i < count; i++) {
+        const BlsTestVector& vector = kBlsTestVectors[i % BLS_TEST_VECTOR_COUNT];
+        public_keys[i] = hex_bytes(vector.public_key);
+        messages[i] = hex_bytes(vector.message);
+        signatures[i] = hex_bytes(vector.signature);
+    }
+    messages[2][0] ^= 0x01;
+    signatures[5] = hex_bytes(kBlsTestVectors[0].signature);
+    public_keys[7][0] ^= 0x01;
+    messages[11][3] ^= 0x80;
+    
+    std::vector<const uint8_t*> public_key_ptrs(count), message_ptrs(count), signature_ptrs(count);
+    std::vector<size_t> message_lens(count);
+    for (size_t i = 0; i < count; i++) {
+        public_key_ptrs[i] = &public_keys[i][0];
+        message_ptrs[i] = &messages[i][0];
+        signature_ptrs[i] = &signatures[i][0];
+        message_lens[i] = messages[i].size();
+    }
     
-    // В реальном тесте здесь будут действительные данные
-    bool result = auth_bls_verify_signature(public_key, message, sizeof(message), signature);
+    bool results[count];
+    bls_verify_batch(&public_key_ptrs[0], &message_ptrs[0], &message_lens[0],
+                     &signature_ptrs[0], count, results);
     
-    // В тестовом режиме функция всегда возвращает true
-    EXPECT_TRUE(result);
+    size_t valid = 0;
+    for (size_t i = 0; i < count; i++) {
+        bool expected = bls_verify(public_key_ptrs[i], message_ptrs[i], message_lens[i],
+                                   signature_ptrs[i]);
+        EXPECT_EQ(expected, results[i]) << "подпись " << i;
+        if (results[i]) {
+            valid++;
+        }
+    }
+    EXPECT_EQ(count - 4, valid);
+    
+    // Пачка только из валидных подписей проходит одной проверкой
+    bls_verify_batch(&public_key_ptrs[0], &message_ptrs[0], &message_lens[0],
+                     &signature_ptrs[0], 2, results);
+    EXPECT_TRUE(results[0]);
+    EXPECT_TRUE(results[1]);
+}
+
+TEST_F(SecurityTest, BLSHashToG2) {
+    // Эталон: py_ecc hash_to_G2(b"abc", BLS_AUG_DST)
+    std::vector<uint8_t> expected = hex_bytes(
+        "8c57634a695c6d4933239fcdefcd5d92e85c59a07b3721cf1a865981a1ba9e439839d4ee0fa6195e0fa0381bfd667ce1"
+        "0f57e6a4a5fa46df6cf2319b6e4396364173868d519cbab87ea0b32eb9bf9d76612f13254bb0d904ede697820c34782d");
+    uint8_t out[BLS_SIGNATURE_SIZE];
+    
+    ASSERT_TRUE(bls_hash_to_g2((const uint8_t*)"abc", 3, (const uint8_t*)BLS_AUG_DST,
+                               strlen(BLS_AUG_DST), out));
+    EXPECT_EQ(0, memcmp(&expected[0], out, BLS_SIGNATURE_SIZE));
+    EXPECT_TRUE(bls_signature_is_valid(out));
+}
+
+TEST_F(SecurityTest, BLSHashToG2BatchMatchesSingle) {
+    // 19 сообщений: две полные группы по восемь и хвост, разные длины,
+    // включая пустое и многоблочные для SHA256
+    const size_t count = 19;
+    std::mt19937_64 rng(22);
+    std::vector<std::vector<uint8_t>> storage(count);
+    std::vector<const uint8_t*> messages(count);
+    std::vector<size_t> message_lens(count);
+    for (size_t i = 0; i < count; i++) {
+        storage[i].resize(i == 3 ? 0 : (size_t)(rng() % 200));
+        for (size_t j = 0; j < storage[i].size(); j++) {
+            storage[i][j] = (uint8_t)rng();
+        }
+    }
+    storage[10].assign((const uint8_t*)"abc", (const uint8_t*)"abc" + 3);
+    for (size_t i = 0; i < count; i++) {
+        messages[i] = storage[i].empty() ? NULL : &storage[i][0];
+        message_lens[i] = storage[i].size();
+    }
+    
+    std::vector<uint8_t> out(count * BLS_SIGNATURE_SIZE);
+    ASSERT_TRUE(bls_hash_to_g2_batch(&messages[0], &message_lens[0], count,
+                                     (const uint8_t*)BLS_AUG_DST, strlen(BLS_AUG_DST), &out[0]));
+    for (size_t i = 0; i < count; i++) {
+        uint8_t single[BLS_SIGNATURE_SIZE];
+        ASSERT_TRUE(bls_hash_to_g2(messages[i], message_lens[i], (const uint8_t*)BLS_AUG_DST,
+                                   strlen(BLS_AUG_DST), single));
+        EXPECT_EQ(0, memcmp(single, &out[i * BLS_SIGNATURE_SIZE], BLS_SIGNATURE_SIZE))
+            << "сообщение " << i;
+    }
+    
+    std::vector<uint8_t> expected = hex_bytes(
+        "8c57634a695c6d4933239fcdefcd5d92e85c59a07b3721cf1a865981a1ba9e439839d4ee0fa6195e0fa0381bfd667ce1"
+        "0f57e6a4a5fa46df6cf2319b6e4396364173868d519cbab87ea0b32eb9bf9d76612f13254bb0d904ede697820c34782d");
+    EXPECT_EQ(0, memcmp(&expected[0], &out[10 * BLS_SIGNATURE_SIZE], BLS_SIGNATURE_SIZE));
+}
+
+// Случайный элемент Fp: 381 бит с отбрасыванием значений >= p
+static void bls_random_fp(std::mt19937_64& rng, uint64_t* a) {
+    static const uint64_t p[6] = {
+        0xb9feffffffffaaab, 0x1eabfffeb153ffff, 0x6730d2a0f6b0f624,
+        0x64774b84f38512bf, 0x4b1ba7b6434bacd7, 0x1a0111ea397fe69a
+    };
+    for (;;) {
+        for (int i = 0; i < 6; i++) {
+            a[i] = rng();
+        }
+        a[5] &= 0x1fffffffffffffffULL;
+        int i = 5;
+        while (i > 0 && a[i] == p[i]) {
+            i--;
+        }
+        if (a[i] < p[i]) {
+            return;
+        }
+    }
+}
+
+TEST_F(SecurityTest, BLSFpKernelsMatchPortable) {
+    if (bls_fp_best_impl() != BLS_FP_MULX) {
+        GTEST_SKIP() << "Процессор без BMI2/ADX";
+    }
+    
+    // p - 1 и ноль: крайние значения для цепочек переносов и вычитания p
+    const uint64_t p_minus_1[6] = {
+        0xb9feffffffffaaaa, 0x1eabfffeb153ffff, 0x6730d2a0f6b0f624,
+        0x64774b84f38512bf, 0x4b1ba7b6434bacd7, 0x1a0111ea397fe69a
+    };
+    std::mt19937_64 rng(20);
+    for (int iteration = 0; iteration < 2000; iteration++) {
+        uint64_t a[12], b[12], t[12];
+        bls_random_fp(rng, a);
+        bls_random_fp(rng, a + 6);
+        bls_random_fp(rng, b);
+        bls_random_fp(rng, b + 6);
+        for (int i = 0; i < 6; i++) {
+            t[i] = rng();
+        }
+        bls_random_fp(rng, t + 6);
+        if (iteration % 4 == 1) {
+            memcpy(a, p_minus_1, sizeof(p_minus_1));
+            memcpy(t + 6, p_minus_1, sizeof(p_minus_1));
+        } else if (iteration % 4 == 2) {
+            memset(b, 0, 6 * sizeof(uint64_t));
+        }
+        
+        uint64_t expected[5][12], actual[5][12];
+        uint64_t (*out[2])[12] = {expected, actual};
+        for (int impl = 0; impl < 2; impl++) {
+            ASSERT_TRUE(bls_fp_set_impl(impl ? BLS_FP_MULX : BLS_FP_PORTABLE));
+            memset(out[impl], 0, sizeof(expected));
+            bls_fp_mont_mul(out[impl][0], a, b);
+            bls_fp_mont_sqr(out[impl][1], a);
+            bls_fp_mont_redc(out[impl][2], t);
+            bls_fp2_mont_mul(out[impl][3], a, b);
+            bls_fp2_mont_sqr(out[impl][4], a);
+        }
+        
+        const char* names[5] = {"mul", "sqr", "redc", "fp2_mul", "fp2_sqr"};
+        for (int k = 0; k < 5; k++) {
+            ASSERT_EQ(0, memcmp(expected[k], actual[k], sizeof(expected[k])))
+                << names[k] << ", итерация " << iteration;
+        }
+    }
+    
+    // Подписи проверяются одинаково обеими реализациями
+    std::vector<uint8_t> public_key = hex_bytes(kBlsTestVectors[0].public_key);
+    std::vector<uint8_t> message = hex_bytes(kBlsTestVectors[0].message);
+    std::vector<uint8_t> signature = hex_bytes(kBlsTestVectors[0].signature);
+    ASSERT_TRUE(bls_fp_set_impl(BLS_FP_PORTABLE));
+    EXPECT_TRUE(bls_verify(&public_key[0], &message[0], message.size(), &signature[0]));
+    ASSERT_TRUE(bls_fp_set_impl(BLS_FP_MULX));
+    EXPECT_TRUE(bls_verify(&public_key[0], &message[0], message.size(), &signature[0]));
 }
 
+TEST_F(SecurityTest, BLSPublicKeyCache) {
+    ASSERT_TRUE(bls_key_cache_init(64));
+    
+    std::vector<uint8_t> public_key = hex_bytes(kBlsTestVectors[1].public_key);
+    std::vector<uint8_t> message = hex_bytes(kBlsTestVectors[1].message);
+    std::vector<uint8_t> signature = hex_bytes(kBlsTestVectors[1].signature);
+    
+    // Первая проверка распаковывает ключ, вторая берет его из кеша
+    EXPECT_TRUE(bls_verify(&public_key[0], &message[0], message.size(), &signature[0]));
+    EXPECT_TRUE(bls_verify(&public_key[0], &message[0], message.size(), &signature[0]));
+    cache_stats_t stats = cache_get_stats(CACHE_TYPE_SIGNATURE_VERIFICATION);
+    EXPECT_EQ(stats.hits, 1u);
+    EXPECT_EQ(stats.misses, 1u);
+    EXPECT_GT(stats.memory_used, 0u);
+    EXPECT_GE(stats.max_memory, stats.memory_used);
+    
+    bls_public_key_t expected, cached;
+    ASSERT_TRUE(bls_public_key_decode(&public_key[0], &expected));
+    ASSERT_TRUE(bls_key_cache_lookup(&public_key[0], &cached));
+    EXPECT_EQ(0, memcmp(&expected, &cached, sizeof(expected)));
+    
+    // Из кеша берется только ключ: чужая подпись по-прежнему отклоняется
+    std::vector<uint8_t> other_signature = hex_bytes(kBlsTestVectors[0].signature);
+    EXPECT_FALSE(bls_verify(&public_key[0], &message[0], message.size(), &other_signature[0]));
+    
+    // Некорректный ключ не кешируется
+    std::vector<uint8_t> bad_key = public_key;
+    bad_key[BLS_PUBLIC_KEY_SIZE - 1] ^= 0x01;
+    EXPECT_FALSE(bls_public_key_is_valid(&bad_key[0]));
+    EXPECT_FALSE(bls_public_key_is_valid(&bad_key[0]));
+    EXPECT_FALSE(bls_key_cache_lookup(&bad_key[0], &cached));
+    
+    // Смена владельца синглтона удаляет прежний ключ
+    singleton_t singleton;
+    memset(&singleton, 0, sizeof(singleton));
+    memcpy(singleton.owner_public_key, &public_key[0], BLS_PUBLIC_KEY_SIZE);
+    std::vector<uint8_t> new_owner = hex_bytes(kBlsTestVectors[2].public_key);
+    ASSERT_TRUE(singleton_set_owner_public_key(&singleton, &new_owner[0]));
+    EXPECT_EQ(0, memcmp(singleton.owner_public_key, &new_owner[0], BLS_PUBLIC_KEY_SIZE));
+    EXPECT_FALSE(bls_key_cache_lookup(&public_key[0], &cached));
+    EXPECT_EQ(cache_get_stats(CACHE_TYPE_SIGNATURE_VERIFICATION).memory_used, 0u);
+    
+    bls_key_cache_cleanup();
+    EXPECT_FALSE(bls_key_cache_is_enabled());
+    EXPECT_TRUE(bls_verify(&public_key[0], &message[0], message.size(), &signature[0]));
+}
+
+// Точки на кривой вне подгруппы порядка r (кофакторы E1 и E2)
+TEST_F(SecurityTest, BLSSubgroupChecks) {
+    std::vector<uint8_t> g1_outside =
+        hex_bytes("888a8d4babd294b6d6753a85f7162feed90a297b3c6ae0371da15d8d502c8b37"
+                  "da9083db8cd3562d7455a9bec1f72d1e");
+    std::vector<uint8_t> g2_outside =
+        hex_bytes("94422ce805d51aa47a04f221c88ce9f332aeee505a46655713f5abbe894acfb1"
+                  "373a65addff0d4b2a358ce7892b17b8506706c45f3d41633149f5a2ba497716a"
+                  "94030d578f771ddf4740becec99d160bc5787ccede17b11cb328330f5a84d780");
+    
+    for (size_t i = 0; i < BLS_TEST_VECTOR_COUNT; i++) {
+        std::vector<uint8_t> public_key = hex_bytes(kBlsTestVectors[i].public_key);
+        std::vector<uint8_t> signature = hex_bytes(kBlsTestVectors[i].signature);
+        EXPECT_TRUE(bls_public_key_is_valid(&public_key[0]));
+        EXPECT_TRUE(bls_signature_is_valid(&signature[0]));
+    }
+    
+    // Кеш ключей хранит только точки, прошедшие проверку подгруппы
+    ASSERT_TRUE(bls_key_cache_init(64));
+    bls_public_key_t decoded;
+    EXPECT_FALSE(bls_public_key_decode(&g1_outside[0], &decoded));
+    EXPECT_FALSE(bls_public_key_is_valid(&g1_outside[0]));
+    EXPECT_FALSE(bls_key_cache_lookup(&g1_outside[0], &decoded));
+    EXPECT_FALSE(bls_signature_is_valid(&g2_outside[0]));
+    
+    std::vector<uint8_t> public_key = hex_bytes(kBlsTestVectors[0].public_key);
+    std::vector<uint8_t> message = hex_bytes(kBlsTestVectors[0].message);
+    EXPECT_FALSE(bls_verify(&public_key[0], &message[0], message.size(), &g2_outside[0]));
+    bls_key_cache_cleanup();
+}
+
+TEST_F(SecurityTest, BLSG1Multiexp) {
+    // Эталоны py_ecc: g1, [0x0123456789abcdef] g1 и 128-битный множитель
+    std::vector<uint8_t> generator = hex_bytes(
+        "97f1d3a73197d7942695638c4fa9ac0fc3688c4f9774b905a14e3a3f171bac586c55e83ff97a1aeffb3af00adb22c6bb");
+    std::vector<uint8_t> expected64 = hex_bytes(
+        "a962a4d151a6efe3b6cf23b93e8851f4c34be4c743ea13c778839e07b3694a1de87d3262ae5ddea3554eef3e86718929");
+    std::vector<uint8_t> expected128 = hex_bytes(
+        "b6bef385591928c8e4d359dcf40ecc8d8462df2b945fda5ba5df926c0222508dda2a5e5ee1297eb3dc3d2b62d09adfee");
+    bls_public_key_t g1;
+    ASSERT_TRUE(bls_public_key_decode(&generator[0], &g1));
+    
+    uint8_t out[BLS_PUBLIC_KEY_SIZE];
+    const uint64_t scalar128[2] = { 0x0123456789abcdefULL, 0xfedcba9876543210ULL };
+    ASSERT_TRUE(bls_g1_multiexp(&g1, scalar128, 1, 1, out));
+    EXPECT_EQ(0, memcmp(&expected64[0], out, BLS_PUBLIC_KEY_SIZE));
+    ASSERT_TRUE(bls_g1_multiexp(&g1, scalar128, 2, 1, out));
+    EXPECT_EQ(0, memcmp(&expected128[0], out, BLS_PUBLIC_KEY_SIZE));
+    
+    // Пустая сумма - бесконечность, скаляры длиннее 256 бит не принимаются
+    ASSERT_TRUE(bls_g1_multiexp(NULL, NULL, 1, 0, out));
+    EXPECT_EQ(0xc0, out[0]);
+    EXPECT_FALSE(bls_g1_multiexp(&g1, scalar128, 5, 1, out));
+    
+    // P_j = [j + 1] g1; 300 точек с повторами (аффинные корзины, удвоения
+    // и взаимно обратные точки в корзине) против [sum s_i (j_i + 1)] g1
+    const size_t distinct = 40;
+    const size_t count = 300;
+    std::vector<bls_public_key_t> base(distinct);
+    for (size_t j = 0; j < distinct; j++) {
+        uint64_t k = j + 1;
+        uint8_t encoded[BLS_PUBLIC_KEY_SIZE];
+        ASSERT_TRUE(bls_g1_multiexp(&g1, &k, 1, 1, encoded));
+        ASSERT_TRUE(bls_public_key_decode(encoded, &base[j]));
+    }
+    
+    std::mt19937_64 rng(23);
+    std::vector<bls_public_key_t> points(count);
+    std::vector<uint64_t> scalars(count);
+    unsigned __int128 total = 0;
+    for (size_t i = 0; i < count; i++) {
+        points[i] = base[i % distinct];
+        scalars[i] = i % 3 == 0 ? rng() % 4 : rng();
+        total += (unsigned __int128)scalars[i] * (i % distinct + 1);
+    }
+    const uint64_t total_words[2] = { (uint64_t)total, (uint64_t)(total >> 64) };
+    
+    uint8_t expected[BLS_PUBLIC_KEY_SIZE];
+    ASSERT_TRUE(bls_g1_multiexp(&g1, total_words, 2, 1, expected));
+    ASSERT_TRUE(bls_g1_multiexp(&points[0], &scalars[0], 1, count, out));
+    EXPECT_EQ(0, memcmp(expected, out, BLS_PUBLIC_KEY_SIZE));
+}
+
+// Подпись ключом 0x0102..20, сверенная с эталонной реализацией AugSchemeMPL;
+// нулевой ключ отклоняется
 TEST_F(SecurityTest, BLSSignMessage) {
-    uint8_t private_key[32] = {0};
+    std::vector<uint8_t> private_key =
+        hex_bytes("0102030405060708090a0b0c0d0e0f101112131415161718191a1b1c1d1e1f20");
+    std::vector<uint8_t> public_key =
+        hex_bytes("96a20bb9485ff6d8950955a629e8043a43775968ac133eb7b19c5f0389a22536"
+                  "76abdd6c86c7b68d38a1b7f6af8650e7");
+    std::vector<uint8_t> expected =
+        hex_bytes("9136b6414838435bf1ae28cb0e0dc47ae4bcada1442e3eeceed3d47cc1a3e26e"
+                  "aad3deb8c9e75edd0be443ba4ebf0565161a46be35d7004fb5035749ceb7994f"
+                  "ba9be4f3b315bc5d97679a58cd58528a704ed8945e08bfb3d794a2d8fa6324da");
     uint8_t message[32] = {0};
-    uint8_t signature[96] = {0};
+    uint8_t signature[BLS_SIGNATURE_SIZE] = {0};
     
-    bool result = auth_bls_sign_message(private_key, message, sizeof(message), signature);
+    ASSERT_TRUE(auth_bls_sign_message(private_key.data(), message, sizeof(message), signature));
+    EXPECT_EQ(0, memcmp(signature, expected.data(), BLS_SIGNATURE_SIZE));
+    EXPECT_TRUE(auth_bls_verify_signature(public_key.data(), message, sizeof(message),
+                                          signature));
     
-    EXPECT_TRUE(result);
+    uint8_t zero_key[32] = {0};
+    bls_signer_t signer;
+    EXPECT_FALSE(bls_signer_init(&signer, zero_key));
+    EXPECT_FALSE(auth_bls_sign_message(zero_key, message, sizeof(message), signature));
+}
+
+// Подпись AugSchemeMPL, сверенная с эталонной реализацией
+TEST_F(SecurityTest, BLSSignKnownVector) {
+    std::vector<uint8_t> private_key =
+        hex_bytes("263dbd792f5b1be47ed85f8938c0f29586af0d3ac7b977f21c278fe1462040e3");
+    std::vector<uint8_t> public_key =
+        hex_bytes("a491d1b0ecd9bb917989f0e74f0dea0422eac4a873e5e2644f368dffb9a6e20f"
+                  "d6e10c1b77654d067c0618f6e5a7f79a");
+    std::vector<uint8_t> expected =
+        hex_bytes("91f75b710438997fe06a485f05ebd7a411a7478236e29b6bd3a57f93e54f2fac"
+                  "94fcd920bdc1c25fddc7795c3bd420330b172a4a71dffe07398f9693b0405b55"
+                  "5f574997e20919b06e8c9b52f012a04ad8ce25eafd3b380691f88cd81c3f38d8");
+    const char* message = "pool payout";
+    
+    bls_signer_t signer;
+    ASSERT_TRUE(bls_signer_init(&signer, private_key.data()));
+    EXPECT_EQ(0, memcmp(signer.public_key, public_key.data(), BLS_PUBLIC_KEY_SIZE));
     
-    // Проверяем что подпись не нулевая
-    bool all_zeros = true;
-    for (int i = 0; i < 96; i++) {
-        if (signature[i] != 0) {
-            all_zeros = false;
-            break;
+    uint8_t signature[BLS_SIGNATURE_SIZE];
+    ASSERT_TRUE(bls_sign(&signer, (const uint8_t*)message, strlen(message), signature));
+    EXPECT_EQ(0, memcmp(signature, expected.data(), BLS_SIGNATURE_SIZE));
+    EXPECT_TRUE(bls_verify(public_key.data(), (const uint8_t*)message, strlen(message), signature));
+    
+    uint8_t auth_signature[BLS_SIGNATURE_SIZE];
+    ASSERT_TRUE(auth_bls_sign_message(private_key.data(), (const uint8_t*)message,
+                                      strlen(message), auth_signature));
+    EXPECT_EQ(0, memcmp(auth_signature, expected.data(), BLS_SIGNATURE_SIZE));
+    
+    // Ключ не меньше порядка подгруппы r отклоняется
+    std::vector<uint8_t> order =
+        hex_bytes("73eda753299d7d483339d80809a1d80553bda402fffe5bfeffffffff00000001");
+    EXPECT_FALSE(bls_signer_init(&signer, order.data()));
+    
+    // Крайние ключи знаковой гребенки: 1 и r - 1
+    std::vector<uint8_t> edge_keys[2] = {
+        hex_bytes("0000000000000000000000000000000000000000000000000000000000000001"),
+        hex_bytes("73eda753299d7d483339d80809a1d80553bda402fffe5bfeffffffff00000000")
+    };
+    for (int i = 0; i < 2; i++) {
+        ASSERT_TRUE(bls_signer_init(&signer, edge_keys[i].data()));
+        ASSERT_TRUE(bls_sign(&signer, (const uint8_t*)message, strlen(message), signature));
+        EXPECT_TRUE(bls_verify(signer.public_key, (const uint8_t*)message, strlen(message),
+                               signature));
+    }
+}
+
+TEST_F(SecurityTest, BLSSignBatchMatchesSingle) {
+    // Ключ пула подписывает готовой гребенкой из auth_init
+    bls_key_t pool_key;
+    memset(&pool_key, 0, sizeof(bls_key_t));
+    std::mt19937_64 rng(24);
+    for (int i = 0; i < 31; i++) {
+        pool_key.private_key[i + 1] = (uint8_t)rng();
+    }
+    ASSERT_TRUE(auth_init(&pool_key));
+    
+    bls_signer_t signer;
+    ASSERT_TRUE(bls_signer_init(&signer, pool_key.private_key));
+    
+    // Больше BLS_SIGN_THREAD_MIN и не кратно 8 полосам SHA256
+    const size_t count = 37;
+    std::vector<std::vector<uint8_t> > messages(count);
+    std::vector<const uint8_t*> message_ptrs(count);
+    std::vector<size_t> message_lens(count);
+    for (size_t i = 0; i < count; i++) {
+        messages[i].resize(1 + i * 7 % 90);
+        for (size_t j = 0; j < messages[i].size(); j++) {
+            messages[i][j] = (uint8_t)rng();
         }
+        message_ptrs[i] = messages[i].data();
+        message_lens[i] = messages[i].size();
+    }
+    
+    std::vector<uint8_t> signatures(count * BLS_SIGNATURE_SIZE);
+    ASSERT_TRUE(auth_bls_sign_messages(message_ptrs.data(), message_lens.data(), count,
+                                       signatures.data()));
+    
+    for (size_t i = 0; i < count; i++) {
+        uint8_t single[BLS_SIGNATURE_SIZE];
+        ASSERT_TRUE(auth_bls_sign_message(pool_key.private_key, message_ptrs[i],
+                                          message_lens[i], single));
+        EXPECT_EQ(0, memcmp(single, &signatures[i * BLS_SIGNATURE_SIZE], BLS_SIGNATURE_SIZE));
+        EXPECT_TRUE(bls_verify(signer.public_key, message_ptrs[i], message_lens[i], single));
+    }
+    
+    // Пакет поглощений подписывается ключом пула и совпадает с подписью по одной
+    const size_t absorbs = 5;
+    std::vector<absorb_transaction_t*> transactions(absorbs);
+    for (size_t i = 0; i < absorbs; i++) {
+        uint8_t launcher_id[32];
+        memset(launcher_id, (int)(i + 1), sizeof(launcher_id));
+        transactions[i] = smart_coin_create_absorb_transaction(launcher_id, 1750000000000ULL + i);
+        ASSERT_NE(transactions[i], nullptr);
+    }
+    ASSERT_TRUE(smart_coin_sign_absorb_transactions(transactions.data(), absorbs));
+    for (size_t i = 0; i < absorbs; i++) {
+        absorb_transaction_t single;
+        memcpy(&single, transactions[i], sizeof(single));
+        ASSERT_TRUE(smart_coin_sign_absorb_transaction(&single, pool_key.private_key));
+        EXPECT_EQ(0, memcmp(single.signature, transactions[i]->signature, BLS_SIGNATURE_SIZE));
+        EXPECT_EQ(single.transaction_size, transactions[i]->transaction_size);
+        free(transactions[i]);
+    }
+    
+    // Поглощение по синглтонам: баланс обнуляется только у синглтонов с балансом
+    singleton_t singletons[3];
+    singleton_t* singleton_ptrs[3];
+    for (int i = 0; i < 3; i++) {
+        memset(&singletons[i], 0, sizeof(singleton_t));
+        memset(singletons[i].launcher_id, 0x40 + i, sizeof(singletons[i].launcher_id));
+        singletons[i].balance = i == 1 ? 0 : 1000000000ULL * (i + 1);
+        singleton_ptrs[i] = &singletons[i];
     }
-    EXPECT_FALSE(all_zeros);
+    ASSERT_TRUE(singleton_absorb_rewards_batch(singleton_ptrs, 3));
+    for (int i = 0; i < 3; i++) {
+        EXPECT_EQ(singletons[i].balance, 0u);
+    }
+    
+    // Без ключа пула пакет не подписывается
+    auth_cleanup();
+    EXPECT_FALSE(auth_bls_sign_messages(message_ptrs.data(), message_lens.data(), count,
+                                        signatures.data()));
 }
 
 TEST_F(SecurityTest, CreateAndValidateSession) {
@@ -92,12 +672,11 @@ TEST_F(SecurityTest, GenerateAndValidateToken) {
     EXPECT_GT(token->expiry_time, token->issue_time);
     EXPECT_EQ(memcmp(token->farmer_public_key, farmer_public_key, 48), 0);
     
-    // Проверяем токен с подписью
+    // Нулевая подпись не проходит проверку BLS
     uint8_t signature[96] = {0};
     auth_result_t result = auth_validate_token(token, signature);
     
-    // В тестовом режиме ожидаем успех
-    EXPECT_EQ(result, AUTH_SUCCESS);
+    EXPECT_EQ(result, AUTH_INVALID_SIGNATURE);
     
     free(token);
 }
@@ -124,21 +703,482 @@ TEST_F(SecurityTest, RateLimiting) {
 }
 
 TEST_F(SecurityTest, ProofVerificationValid) {
-    uint8_t proof_data[368] = {0};
+    std::vector<uint8_t> plot_id = hex_bytes(kPosTestPlotId);
+    std::vector<uint8_t> challenge = hex_bytes(kPosTestChallenge);
+    std::vector<uint8_t> proof = hex_bytes(kPosTestProof);
+    std::vector<uint8_t> expected_quality = hex_bytes(kPosTestQuality);
+    ASSERT_EQ(proof.size(), pos_proof_size(POS_TEST_K));
+    
+    uint8_t quality_string[POS_QUALITY_STRING_SIZE];
+    EXPECT_TRUE(pos_verify_proof(&plot_id[0], POS_TEST_K, &challenge[0],
+                                 &proof[0], proof.size(), quality_string));
+    EXPECT_EQ(memcmp(quality_string, &expected_quality[0], POS_QUALITY_STRING_SIZE), 0);
+}
+
+TEST_F(SecurityTest, ProofVerificationRejectsInvalidProof) {
+    std::vector<uint8_t> plot_id = hex_bytes(kPosTestPlotId);
+    std::vector<uint8_t> challenge = hex_bytes(kPosTestChallenge);
+    std::vector<uint8_t> proof = hex_bytes(kPosTestProof);
+    
+    // Измененный x ломает сопоставление таблиц
+    proof[10] ^= 0x04;
+    EXPECT_FALSE(pos_verify_proof(&plot_id[0], POS_TEST_K, &challenge[0],
+                                  &proof[0], proof.size(), NULL));
+    proof[10] ^= 0x04;
+    
+    // Доказательство другого плота или другого challenge
+    plot_id[0] ^= 0x01;
+    EXPECT_FALSE(pos_verify_proof(&plot_id[0], POS_TEST_K, &challenge[0],
+                                  &proof[0], proof.size(), NULL));
+    plot_id[0] ^= 0x01;
+    challenge[0] ^= 0x80;
+    EXPECT_FALSE(pos_verify_proof(&plot_id[0], POS_TEST_K, &challenge[0],
+                                  &proof[0], proof.size(), NULL));
+    challenge[0] ^= 0x80;
+    
+    // Длина доказательства должна быть ровно 8 * k
+    EXPECT_FALSE(pos_verify_proof(&plot_id[0], POS_TEST_K, &challenge[0],
+                                  &proof[0], proof.size() - 1, NULL));
+    EXPECT_TRUE(pos_verify_proof(&plot_id[0], POS_TEST_K, &challenge[0],
+                                 &proof[0], proof.size(), NULL));
+    
+    // Нулевое доказательство k=32 проходит проверку формата, но не таблиц
+    uint8_t zero_proof[256] = {0};
     proof_verification_params_t params = {
         .challenge = 123456789,
         .k_size = 32,
         .sub_slot_iters = 37600000000ULL,
         .difficulty = 1000,
-        .required_iterations = 0
+        .required_iterations = 0,
+        .plot_id = &plot_id[0],
+        .challenge_hash = &challenge[0],
+        .sp_hash = NULL
     };
+    proof_metadata_t metadata;
+    EXPECT_EQ(proof_verify_space(zero_proof, sizeof(zero_proof), &params, &metadata),
+              PROOF_INVALID_QUALITY);
+    EXPECT_EQ(proof_verify_space(zero_proof, sizeof(zero_proof) - 8, &params, &metadata),
+              PROOF_INVALID_FORMAT);
+}
+
+TEST_F(SecurityTest, ProofVerificationCache) {
+    std::vector<uint8_t> plot_id = hex_bytes(kPosTestPlotId);
+    std::vector<uint8_t> challenge = hex_bytes(kPosTestChallenge);
+    ASSERT_TRUE(proof_cache_init(1024, 300, 256, 30));
     
+    uint8_t zero_proof[256] = {0};
+    proof_verification_params_t params = {
+        .challenge = 123456789,
+        .k_size = 32,
+        .sub_slot_iters = 37600000000ULL,
+        .difficulty = 1000,
+        .required_iterations = 0,
+        .plot_id = &plot_id[0],
+        .challenge_hash = &challenge[0],
+        .sp_hash = NULL
+    };
     proof_metadata_t metadata;
-    proof_verification_result_t result = proof_verify_space(
-        proof_data, sizeof(proof_data), &params, &metadata);
     
-    // В тестовом режиме ожидаем валидный результат
-    EXPECT_EQ(result, PROOF_VALID);
+    // Отклоненное доказательство попадает в отрицательный кеш
+    EXPECT_EQ(proof_verify_space(zero_proof, sizeof(zero_proof), &params, &metadata),
+              PROOF_INVALID_QUALITY);
+    EXPECT_EQ(proof_verify_space(zero_proof, sizeof(zero_proof), &params, &metadata),
+              PROOF_INVALID_QUALITY);
+    cache_stats_t negative = cache_get_stats(CACHE_TYPE_PROOF_NEGATIVE);
+    EXPECT_EQ(negative.hits, 1u);
+    
+    // Принятое доказательство возвращается с сохраненным качеством,
+    // итерации пересчитываются по текущей сложности
+    uint8_t proof[256];
+    memset(proof, 0x5a, sizeof(proof));
+    uint8_t digest[PROOF_CACHE_DIGEST_SIZE];
+    proof_cache_digest(proof, sizeof(proof), &params, digest);
+    proof_metadata_t stored;
+    memset(&stored, 0, sizeof(stored));
+    stored.quality = 0x123456789abcULL;
+    stored.proof_size = sizeof(proof);
+    memset(stored.quality_string, 0x01, sizeof(stored.quality_string));
+    proof_cache_store(digest, &stored);
+    
+    params.difficulty = 1;
+    memset(&metadata, 0, sizeof(metadata));
+    EXPECT_EQ(proof_verify_space(proof, sizeof(proof), &params, &metadata), PROOF_VALID);
+    EXPECT_EQ(metadata.quality, stored.quality);
+    EXPECT_EQ(metadata.quality_string[0], 0x01);
+    EXPECT_EQ(memcmp(metadata.plot_id, &plot_id[0], sizeof(metadata.plot_id)), 0);
+    EXPECT_EQ(metadata.iterations, 187107956u);
+    params.difficulty = 1000;
+    EXPECT_EQ(proof_verify_space(proof, sizeof(proof), &params, &metadata),
+              PROOF_INVALID_ITERATIONS);
+    EXPECT_EQ(cache_get_stats(CACHE_TYPE_PROOF_VERIFICATION).hits, 2u);
+    
+    // Другой challenge - другой ключ
+    challenge[0] ^= 0x01;
+    EXPECT_EQ(proof_verify_space(proof, sizeof(proof), &params, &metadata),
+              PROOF_INVALID_QUALITY);
+    challenge[0] ^= 0x01;
+    
+    // Нулевой TTL отключает отрицательный кеш
+    proof_cache_cleanup();
+    ASSERT_TRUE(proof_cache_init(1024, 300, 256, 0));
+    EXPECT_EQ(proof_verify_space(zero_proof, sizeof(zero_proof), &params, &metadata),
+              PROOF_INVALID_QUALITY);
+    EXPECT_EQ(proof_verify_space(zero_proof, sizeof(zero_proof), &params, &metadata),
+              PROOF_INVALID_QUALITY);
+    EXPECT_EQ(cache_get_stats(CACHE_TYPE_PROOF_NEGATIVE).hits, 0u);
+    
+    proof_cache_cleanup();
+    EXPECT_FALSE(proof_cache_is_enabled());
+}
+
+TEST_F(SecurityTest, ProofKernelsMatchScalar) {
+    pos_isa_t saved = pos_verifier_get_isa();
+    
+    // ChaCha8 с нулевым ключом, блок 0 (эталонный вектор eSTREAM)
+    std::vector<uint8_t> chacha_expected = hex_bytes(
+        "3e00ef2f895f40d67f5bb8e81f09a5a12c840ec3ce9a7f3b181be188ef711a1e"
+        "984ce172b9216f419f445367456d5619314a42a3da86b001387bfdb80e0cfe42");
+    // BLAKE3("abc")
+    std::vector<uint8_t> blake3_expected = hex_bytes(
+        "6437b3ac38465133ffb63b75273a8db548c558465d79db03fd359c6cd5bd9d85");
+    
+    uint8_t key[32];
+    uint64_t counters[37];
+    uint8_t inputs[37][64];
+    for (int i = 0; i < 32; i++) {
+        key[i] = (uint8_t)(i * 7 + 1);
+    }
+    for (int i = 0; i < 37; i++) {
+        counters[i] = (uint64_t)i * 0x100000001ULL;
+        for (int j = 0; j < 64; j++) {
+            inputs[i][j] = (uint8_t)(i * 31 + j);
+        }
+    }
+    
+    std::vector<uint8_t> chacha_scalar(37 * 64), blake3_scalar(37 * 32);
+    ASSERT_TRUE(pos_verifier_set_isa(POS_ISA_SCALAR));
+    pos_chacha8_blocks(key, counters, 37, &chacha_scalar[0]);
+    pos_blake3_blocks(inputs[0], 64, 57, 37, &blake3_scalar[0]);
+    
+    // Каждая доступная реализация совпадает со скалярной, включая
+    // хвосты, не кратные ширине вектора
+    std::vector<uint8_t> plot_id = hex_bytes(kPosTestPlotId);
+    std::vector<uint8_t> challenge = hex_bytes(kPosTestChallenge);
+    std::vector<uint8_t> proof = hex_bytes(kPosTestProof);
+    for (int isa = POS_ISA_SCALAR; isa <= (int)pos_verifier_best_isa(); isa++) {
+        ASSERT_TRUE(pos_verifier_set_isa((pos_isa_t)isa));
+        
+        uint8_t zero_key[32] = {0};
+        uint64_t zero_counter = 0;
+        uint8_t block[64];
+        pos_chacha8_blocks(zero_key, &zero_counter, 1, block);
+        EXPECT_EQ(memcmp(block, &chacha_expected[0], 64), 0) << pos_isa_name((pos_isa_t)isa);
+        
+        uint8_t hash[32];
+        pos_blake3_blocks((const uint8_t*)"abc", 3, 3, 1, hash);
+        EXPECT_EQ(memcmp(hash, &blake3_expected[0], 32), 0) << pos_isa_name((pos_isa_t)isa);
+        
+        std::vector<uint8_t> chacha_out(37 * 64), blake3_out(37 * 32);
+        pos_chacha8_blocks(key, counters, 37, &chacha_out[0]);
+        pos_blake3_blocks(inputs[0], 64, 57, 37, &blake3_out[0]);
+        EXPECT_EQ(chacha_out, chacha_scalar) << pos_isa_name((pos_isa_t)isa);
+        EXPECT_EQ(blake3_out, blake3_scalar) << pos_isa_name((pos_isa_t)isa);
+        
+        EXPECT_TRUE(pos_verify_proof(&plot_id[0], POS_TEST_K, &challenge[0],
+                                     &proof[0], proof.size(), NULL));
+    }
+    
+    pos_verifier_set_isa(saved);
+}
+
+TEST_F(SecurityTest, ProofVerifierDispatch) {
+    for (uint32_t k = 32; k <= 35; k++) {
+        EXPECT_TRUE(pos_verifier_is_specialized(k));
+    }
+    EXPECT_FALSE(pos_verifier_is_specialized(POS_TEST_K));
+    EXPECT_FALSE(pos_verifier_is_specialized(36));
+    EXPECT_FALSE(pos_verifier_precompute(POS_MAX_K + 1));
+    
+    // Обобщенная реализация через таблицу выбора и в обход нее
+    std::vector<uint8_t> plot_id = hex_bytes(kPosTestPlotId);
+    std::vector<uint8_t> challenge = hex_bytes(kPosTestChallenge);
+    std::vector<uint8_t> proof = hex_bytes(kPosTestProof);
+    std::vector<uint8_t> expected_quality = hex_bytes(kPosTestQuality);
+    ASSERT_TRUE(pos_verifier_precompute(POS_TEST_K));
+    uint8_t quality_string[POS_QUALITY_STRING_SIZE];
+    EXPECT_TRUE(pos_verify_proof(&plot_id[0], POS_TEST_K, &challenge[0],
+                                 &proof[0], proof.size(), quality_string));
+    EXPECT_EQ(memcmp(quality_string, &expected_quality[0], POS_QUALITY_STRING_SIZE), 0);
+    EXPECT_TRUE(pos_verify_proof_generic(&plot_id[0], POS_TEST_K, &challenge[0],
+                                         &proof[0], proof.size(), NULL));
+    EXPECT_EQ(pos_verify_proof_depth(&plot_id[0], POS_TEST_K, &challenge[0], &proof[0],
+                                     proof.size(), false), (uint32_t)POS_VERIFY_DEPTH_VALID);
+    EXPECT_EQ(pos_verify_proof_depth(&plot_id[0], POS_TEST_K, &challenge[0], &proof[0],
+                                     proof.size(), true), (uint32_t)POS_VERIFY_DEPTH_VALID);
+    
+    // k=32 через специализированное ядро: f1 и таблицы 2..4 на настоящих
+    // совпадениях, глубина та же, что у обобщенной реализации
+    std::vector<uint8_t> k32_plot_id = hex_bytes(kPosK32PlotId);
+    std::vector<uint8_t> k32_proof;
+    for (int copy = 0; copy < 8; copy++) {
+        std::vector<uint8_t> subtree = hex_bytes(kPosK32Subtree);
+        k32_proof.insert(k32_proof.end(), subtree.begin(), subtree.end());
+    }
+    ASSERT_EQ(k32_proof.size(), pos_proof_size(32));
+    ASSERT_TRUE(pos_verifier_precompute(32));
+    EXPECT_EQ(pos_verify_proof_depth(&k32_plot_id[0], 32, &challenge[0], &k32_proof[0],
+                                     k32_proof.size(), false), (uint32_t)POS_K32_MATCHED_TABLES);
+    EXPECT_EQ(pos_verify_proof_depth(&k32_plot_id[0], 32, &challenge[0], &k32_proof[0],
+                                     k32_proof.size(), true), (uint32_t)POS_K32_MATCHED_TABLES);
+    EXPECT_FALSE(pos_verify_proof(&k32_plot_id[0], 32, &challenge[0], &k32_proof[0],
+                                  k32_proof.size(), NULL));
+    EXPECT_FALSE(pos_verify_proof_generic(&k32_plot_id[0], 32, &challenge[0], &k32_proof[0],
+                                          k32_proof.size(), NULL));
+    
+    // Порча одного x обрывает сопоставление уже на таблице 2
+    k32_proof[3] ^= 0x01;
+    EXPECT_EQ(pos_verify_proof_depth(&k32_plot_id[0], 32, &challenge[0], &k32_proof[0],
+                                     k32_proof.size(), false), 1u);
+    EXPECT_EQ(pos_verify_proof_depth(&k32_plot_id[0], 32, &challenge[0], &k32_proof[0],
+                                     k32_proof.size(), true), 1u);
+    
+    // Специализированные k согласуются с обобщенной реализацией
+    uint32_t seed = 12345;
+    std::vector<uint8_t> random_proof(POS_MAX_PROOF_SIZE);
+    for (uint32_t k = 30; k <= 37; k++) {
+        ASSERT_TRUE(pos_verifier_precompute(k));
+        for (int round = 0; round < 16; round++) {
+            for (size_t i = 0; i < random_proof.size(); i++) {
+                seed = seed * 1103515245u + 12345u;
+                random_proof[i] = (uint8_t)(seed >> 16);
+            }
+            EXPECT_EQ(pos_verify_proof(&plot_id[0], k, &challenge[0], &random_proof[0],
+                                       pos_proof_size(k), NULL),
+                      pos_verify_proof_generic(&plot_id[0], k, &challenge[0], &random_proof[0],
+                                               pos_proof_size(k), NULL));
+        }
+        EXPECT_FALSE(pos_verify_proof(&plot_id[0], k, &challenge[0], &random_proof[0],
+                                      pos_proof_size(k) - 1, NULL));
+    }
+}
+
+TEST_F(SecurityTest, ProofViewReadsPackedXs) {
+    std::vector<uint8_t> valid_proof = hex_bytes(kPosTestProof);
+    pos_proof_view_t view;
+    EXPECT_FALSE(pos_proof_view_init(&view, &valid_proof[0], valid_proof.size() - 1, POS_TEST_K));
+    EXPECT_FALSE(pos_proof_view_init(&view, &valid_proof[0], valid_proof.size(), POS_TEST_K + 1));
+    EXPECT_FALSE(pos_proof_view_init(&view, NULL, valid_proof.size(), POS_TEST_K));
+    
+    // Каждый k с буфером ровно pos_proof_size(k): последние x читаются
+    // без выхода за конец данных, BMI2 и сдвиги дают одно и то же
+    pos_isa_t saved = pos_verifier_get_isa();
+    uint64_t seed = 0x9e3779b97f4a7c15ULL;
+    for (uint32_t k = POS_MIN_K; k <= POS_MAX_K; k++) {
+        std::vector<uint8_t> proof(pos_proof_size(k));
+        for (size_t i = 0; i < proof.size(); i++) {
+            seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+            proof[i] = (uint8_t)(seed >> 56);
+        }
+        std::vector<uint64_t> expected = proof_unpack_xs(proof, k);
+        
+        uint8_t* data = new uint8_t[proof.size()];
+        memcpy(data, &proof[0], proof.size());
+        ASSERT_TRUE(pos_proof_view_init(&view, data, proof.size(), k));
+        
+        for (int n = 0; n < 2; n++) {
+            ASSERT_TRUE(pos_verifier_set_isa(n == 0 ? POS_ISA_SCALAR : pos_verifier_best_isa()));
+            uint64_t xs[POS_PROOF_X_COUNT];
+            pos_proof_view_xs(&view, xs);
+            for (uint32_t i = 0; i < POS_PROOF_X_COUNT; i++) {
+                EXPECT_EQ(xs[i], expected[i]) << "k=" << k << " x" << i;
+                EXPECT_EQ(pos_proof_view_x(&view, i), expected[i]);
+            }
+        }
+        delete[] data;
+    }
+    pos_verifier_set_isa(saved);
+}
+
+TEST_F(SecurityTest, ProofBatchMatchesScalar) {
+    std::vector<uint8_t> valid_plot_id = hex_bytes(kPosTestPlotId);
+    std::vector<uint8_t> valid_challenge = hex_bytes(kPosTestChallenge);
+    std::vector<uint8_t> valid_proof = hex_bytes(kPosTestProof);
+    std::vector<uint64_t> valid_xs = proof_unpack_xs(valid_proof, POS_TEST_K);
+    ASSERT_TRUE(pos_verifier_precompute(32));
+    
+    struct item_t {
+        std::vector<uint8_t> plot_id;
+        std::vector<uint8_t> challenge;
+        std::vector<uint8_t> proof;
+        uint32_t k;
+        size_t length;
+    };
+    std::vector<item_t> items;
+    
+    // Валидное доказательство, обмен поддеревьев размера 2^level (ломает
+    // сопоставление таблицы level + 2), измененные x, challenge и plot_id,
+    // случайные доказательства разных k и неверная длина
+    uint64_t seed = 0x2545f4914f6cdd1dULL;
+    for (int round = 0; round < 6; round++) {
+        item_t item = { valid_plot_id, valid_challenge, valid_proof, POS_TEST_K,
+                        valid_proof.size() };
+        items.push_back(item);
+        
+        for (int level = 0; level < 6; level++) {
+            std::vector<uint64_t> xs = valid_xs;
+            size_t size = (size_t)1 << level;
+            size_t base = (size_t)(round * 2 * size) % POS_PROOF_X_COUNT;
+            for (size_t i = 0; i < size; i++) {
+                std::swap(xs[base + i], xs[base + size + i]);
+            }
+            item.proof = proof_pack_xs(xs, POS_TEST_K);
+            items.push_back(item);
+        }
+        item.proof = valid_proof;
+        
+        item.proof[round * 7] ^= 0x10;
+        items.push_back(item);
+        item.proof = valid_proof;
+        
+        item.challenge[31] ^= (uint8_t)(round + 1);
+        items.push_back(item);
+        item.challenge[0] ^= 0x80;
+        items.push_back(item);
+        item.challenge = valid_challenge;
+        
+        item.plot_id[round] ^= 0x01;
+        items.push_back(item);
+        item.plot_id = valid_plot_id;
+        
+        for (int r = 0; r < 4; r++) {
+            seed ^= seed << 13;
+            seed ^= seed >> 7;
+            seed ^= seed << 17;
+            item.k = r == 0 ? 32 : POS_MIN_K + (uint32_t)(seed % (POS_MAX_K - POS_MIN_K + 1));
+            item.proof.assign(POS_MAX_PROOF_SIZE, 0);
+            for (size_t i = 0; i < item.proof.size(); i++) {
+                item.proof[i] = (uint8_t)(seed >> (8 * (i % 8))) ^ (uint8_t)i;
+            }
+            item.length = pos_proof_size(item.k) - (r == 3 ? 8 : 0);
+            items.push_back(item);
+        }
+    }
+    
+    // Перемешивание, чтобы доказательства разных k и исходов чередовались
+    for (size_t i = items.size() - 1; i > 0; i--) {
+        seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+        std::swap(items[i], items[(size_t)(seed >> 33) % (i + 1)]);
+    }
+    
+    size_t count = items.size();
+    std::vector<const uint8_t*> plot_ids(count), challenges(count), proofs(count);
+    std::vector<uint32_t> ks(count);
+    std::vector<size_t> lengths(count);
+    for (size_t i = 0; i < count; i++) {
+        plot_ids[i] = &items[i].plot_id[0];
+        challenges[i] = &items[i].challenge[0];
+        proofs[i] = &items[i].proof[0];
+        ks[i] = items[i].k;
+        lengths[i] = items[i].length;
+    }
+    
+    // Эталон - одиночная проверка на скалярных ядрах
+    pos_isa_t saved = pos_verifier_get_isa();
+    ASSERT_TRUE(pos_verifier_set_isa(POS_ISA_SCALAR));
+    std::vector<bool> expected(count);
+    std::vector<uint8_t> expected_quality(count * POS_QUALITY_STRING_SIZE, 0);
+    size_t valid_count = 0;
+    for (size_t i = 0; i < count; i++) {
+        expected[i] = pos_verify_proof(plot_ids[i], ks[i], challenges[i], proofs[i], lengths[i],
+                                       &expected_quality[i * POS_QUALITY_STRING_SIZE]);
+        valid_count += expected[i] ? 1 : 0;
+    }
+    EXPECT_EQ(valid_count, 12u);
+    
+    const pos_isa_t isas[3] = { POS_ISA_SCALAR, POS_ISA_AVX2, POS_ISA_AVX512 };
+    for (int n = 0; n < 3; n++) {
+        if (isas[n] > pos_verifier_best_isa()) {
+            continue;
+        }
+        ASSERT_TRUE(pos_verifier_set_isa(isas[n]));
+        
+        bool* results = new bool[count];
+        std::vector<uint8_t> quality(count * POS_QUALITY_STRING_SIZE, 0);
+        pos_verify_proofs_batch(&plot_ids[0], &ks[0], &challenges[0], &proofs[0], &lengths[0],
+                                count, (uint8_t (*)[POS_QUALITY_STRING_SIZE])&quality[0], results);
+        for (size_t i = 0; i < count; i++) {
+            EXPECT_EQ(results[i], expected[i]) << pos_isa_name(isas[n]) << " #" << i;
+            if (expected[i]) {
+                EXPECT_EQ(memcmp(&quality[i * POS_QUALITY_STRING_SIZE],
+                                 &expected_quality[i * POS_QUALITY_STRING_SIZE],
+                                 POS_QUALITY_STRING_SIZE), 0) << pos_isa_name(isas[n]);
+            }
+        }
+        delete[] results;
+    }
+    pos_verifier_set_isa(saved);
+}
+
+TEST_F(SecurityTest, ProofVerifySpaceBatch) {
+    std::vector<uint8_t> plot_id = hex_bytes(kPosTestPlotId);
+    std::vector<uint8_t> challenge = hex_bytes(kPosTestChallenge);
+    ASSERT_TRUE(proof_cache_init(1024, 300, 256, 30));
+    
+    // Принятое доказательство из кеша: проходит при сложности 1 и не
+    // проходит по итерациям при 1000
+    uint8_t cached_proof[256];
+    memset(cached_proof, 0x5a, sizeof(cached_proof));
+    uint8_t zero_proof[256] = {0};
+    
+    proof_verification_params_t base = {
+        .challenge = 123456789,
+        .k_size = 32,
+        .sub_slot_iters = 37600000000ULL,
+        .difficulty = 1,
+        .required_iterations = 0,
+        .plot_id = &plot_id[0],
+        .challenge_hash = &challenge[0],
+        .sp_hash = NULL
+    };
+    uint8_t digest[PROOF_CACHE_DIGEST_SIZE];
+    proof_cache_digest(cached_proof, sizeof(cached_proof), &base, digest);
+    proof_metadata_t stored;
+    memset(&stored, 0, sizeof(stored));
+    memset(stored.quality_string, 0x01, sizeof(stored.quality_string));
+    proof_cache_store(digest, &stored);
+    
+    const size_t count = 8;
+    const uint8_t* proofs[count] = { cached_proof, cached_proof, zero_proof, zero_proof,
+                                     zero_proof, zero_proof, NULL, zero_proof };
+    size_t lengths[count] = { 256, 256, 256, 256, 248, 256, 256, 256 };
+    proof_verification_params_t params[count];
+    for (size_t i = 0; i < count; i++) {
+        params[i] = base;
+    }
+    params[1].difficulty = 1000;
+    params[3].k_size = 20;
+    params[5].plot_id = NULL;
+    params[7].k_size = 33;
+    lengths[7] = pos_proof_size(33);
+    
+    proof_metadata_t metadata[count];
+    proof_verification_result_t results[count];
+    proof_verify_space_batch(proofs, lengths, params, count, metadata, results);
+    
+    const proof_verification_result_t expected[count] = {
+        PROOF_VALID, PROOF_INVALID_ITERATIONS, PROOF_INVALID_QUALITY, PROOF_INVALID_K_SIZE,
+        PROOF_INVALID_FORMAT, PROOF_INVALID_FORMAT, PROOF_INTERNAL_ERROR, PROOF_INVALID_QUALITY
+    };
+    for (size_t i = 0; i < count; i++) {
+        EXPECT_EQ(results[i], expected[i]) << "#" << i;
+        
+        proof_metadata_t single;
+        EXPECT_EQ(proof_verify_space(proofs[i], lengths[i], &params[i], &single), results[i]);
+    }
+    EXPECT_EQ(metadata[0].iterations, 187107956u);
+    EXPECT_EQ(memcmp(metadata[0].plot_id, &plot_id[0], 32), 0);
+    
+    proof_cache_cleanup();
 }
 
 TEST_F(SecurityTest, ProofVerificationInvalidKSize) {
@@ -148,7 +1188,10 @@ TEST_F(SecurityTest, ProofVerificationInvalidKSize) {
         .k_size = 20, // Невалидный k-size
         .sub_slot_iters = 37600000000ULL,
         .difficulty = 1000,
-        .required_iterations = 0
+        .required_iterations = 0,
+        .plot_id = NULL,
+        .challenge_hash = NULL,
+        .sp_hash = NULL
     };
     
     proof_metadata_t metadata;
@@ -159,27 +1202,181 @@ TEST_F(SecurityTest, ProofVerificationInvalidKSize) {
 }
 
 TEST_F(SecurityTest, ProofQualityValidation) {
-    uint8_t proof_data[368] = {0};
-    uint32_t k_size = 32;
-    uint64_t challenge = 123456789;
-    uint64_t quality;
+    std::vector<uint8_t> plot_id = hex_bytes(kPosK25PlotId);
+    std::vector<uint8_t> challenge_hash = hex_bytes(kPosK25ChallengeHash);
+    std::vector<uint8_t> sp_hash = hex_bytes(kPosK25SpHash);
+    std::vector<uint8_t> proof = hex_bytes(kPosK25Proof);
+    std::vector<uint8_t> expected_quality = hex_bytes(kPosK25Quality);
+    
+    proof_verification_params_t params = {
+        .challenge = 123456789,
+        .k_size = POS_K25_K,
+        .sub_slot_iters = 37600000000ULL,
+        .difficulty = 1000,
+        .required_iterations = 0,
+        .plot_id = &plot_id[0],
+        .challenge_hash = &challenge_hash[0],
+        .sp_hash = &sp_hash[0]
+    };
     
-    bool result = proof_validate_quality(proof_data, k_size, challenge, &quality);
+    uint8_t quality_string[POS_QUALITY_STRING_SIZE];
+    uint64_t quality;
+    bool result = proof_validate_quality(&proof[0], proof.size(), &params,
+                                         quality_string, &quality);
     
     EXPECT_TRUE(result);
     EXPECT_GT(quality, 0);
+    EXPECT_EQ(memcmp(quality_string, &expected_quality[0], sizeof(quality_string)), 0);
+    
+    // Качество - старшие 8 байт строки качества
+    uint64_t expected = 0;
+    for (int i = 0; i < 8; i++) {
+        expected = (expected << 8) | expected_quality[i];
+    }
+    EXPECT_EQ(quality, expected);
+}
+
+TEST_F(SecurityTest, ProofPlotFilter) {
+    std::vector<uint8_t> plot_id = hex_bytes(kPosK25PlotId);
+    std::vector<uint8_t> challenge_hash = hex_bytes(kPosK25ChallengeHash);
+    std::vector<uint8_t> sp_hash = hex_bytes(kPosK25SpHash);
+    std::vector<uint8_t> filtered_sp = hex_bytes(kPosK25FilteredSp);
+    std::vector<uint8_t> proof = hex_bytes(kPosK25Proof);
+    std::vector<uint8_t> filtered_proof = hex_bytes(kPosK25FilteredProof);
+    std::vector<uint8_t> expected_quality = hex_bytes(kPosK25Quality);
+    ASSERT_EQ(proof.size(), pos_proof_size(POS_K25_K));
+    
+    // Доказательство отвечает на pos_challenge, а не на challenge_hash
+    uint8_t pos_challenge[POS_CHALLENGE_SIZE];
+    EXPECT_TRUE(proof_calculate_pos_challenge(&plot_id[0], &challenge_hash[0], &sp_hash[0],
+                                              pos_challenge));
+    EXPECT_TRUE(pos_verify_proof(&plot_id[0], POS_K25_K, pos_challenge, &proof[0],
+                                 proof.size(), NULL));
+    EXPECT_FALSE(pos_verify_proof(&plot_id[0], POS_K25_K, &challenge_hash[0], &proof[0],
+                                  proof.size(), NULL));
+    
+    // Для kPosK25FilteredSp доказательство есть, но плот не проходит фильтр
+    uint8_t filtered_challenge[POS_CHALLENGE_SIZE];
+    EXPECT_FALSE(proof_calculate_pos_challenge(&plot_id[0], &challenge_hash[0], &filtered_sp[0],
+                                               filtered_challenge));
+    EXPECT_TRUE(pos_verify_proof(&plot_id[0], POS_K25_K, filtered_challenge, &filtered_proof[0],
+                                 filtered_proof.size(), NULL));
+    
+    // Одиночный путь: sp_hash входит и в фильтр, и в ключ кеша
+    ASSERT_TRUE(proof_cache_init(1024, 300, 256, 30));
+    proof_verification_params_t params = {
+        .challenge = 123456789,
+        .k_size = POS_K25_K,
+        .sub_slot_iters = 37600000000ULL,
+        .difficulty = 1,
+        .required_iterations = 0,
+        .plot_id = &plot_id[0],
+        .challenge_hash = &challenge_hash[0],
+        .sp_hash = &sp_hash[0]
+    };
+    proof_metadata_t metadata;
+    for (int pass = 0; pass < 2; pass++) {
+        memset(&metadata, 0, sizeof(metadata));
+        EXPECT_EQ(proof_verify_space(&proof[0], proof.size(), &params, &metadata), PROOF_VALID);
+        EXPECT_EQ(memcmp(metadata.quality_string, &expected_quality[0], 32), 0);
+        EXPECT_EQ(metadata.iterations, POS_K25_ITERATIONS);
+    }
+    
+    proof_verification_params_t filtered = params;
+    filtered.sp_hash = &filtered_sp[0];
+    EXPECT_EQ(proof_verify_space(&proof[0], proof.size(), &filtered, &metadata),
+              PROOF_INVALID_QUALITY);
+    EXPECT_EQ(proof_verify_space(&filtered_proof[0], filtered_proof.size(), &filtered, &metadata),
+              PROOF_INVALID_QUALITY);
+    
+    // Пакетный путь дает те же результаты
+    proof_cache_cleanup();
+    const size_t count = 4;
+    const uint8_t* proofs[count] = { &proof[0], &filtered_proof[0], &proof[0], &proof[0] };
+    size_t lengths[count] = { proof.size(), filtered_proof.size(), proof.size(), proof.size() };
+    proof_verification_params_t batch_params[count] = { params, filtered, filtered, params };
+    batch_params[3].sp_hash = NULL;
+    proof_metadata_t batch_metadata[count];
+    proof_verification_result_t results[count];
+    proof_verify_space_batch(proofs, lengths, batch_params, count, batch_metadata, results);
+    
+    const proof_verification_result_t expected[count] = {
+        PROOF_VALID, PROOF_INVALID_QUALITY, PROOF_INVALID_QUALITY, PROOF_INVALID_QUALITY
+    };
+    for (size_t i = 0; i < count; i++) {
+        EXPECT_EQ(results[i], expected[i]) << "#" << i;
+        
+        proof_metadata_t single;
+        EXPECT_EQ(proof_verify_space(proofs[i], lengths[i], &batch_params[i], &single), results[i]);
+    }
+    EXPECT_EQ(memcmp(batch_metadata[0].quality_string, &expected_quality[0], 32), 0);
+    EXPECT_EQ(batch_metadata[0].iterations, POS_K25_ITERATIONS);
 }
 
 TEST_F(SecurityTest, ProofIterationsValidation) {
-    uint64_t quality = 1000000;
-    uint64_t difficulty = 1000;
+    std::vector<uint8_t> quality_string = hex_bytes(kPosTestQuality);
+    uint8_t sp_hash[32];
+    for (int i = 0; i < 32; i++) {
+        sp_hash[i] = (uint8_t)i;
+    }
     uint64_t sub_slot_iters = 37600000000ULL;
     uint64_t iterations;
     
-    bool result = proof_validate_iterations(quality, difficulty, sub_slot_iters, &iterations);
+    // Значения по консенсусной формуле, посчитанные на целых произвольной длины
+    EXPECT_EQ(calculate_iterations_quality(PROOF_DIFFICULTY_CONSTANT_FACTOR, &quality_string[0],
+                                           32, 1, sp_hash), 195081070u);
+    EXPECT_EQ(calculate_iterations_quality(PROOF_DIFFICULTY_CONSTANT_FACTOR, &quality_string[0],
+                                           32, 1000, sp_hash), 195081070732u);
+    EXPECT_EQ(calculate_iterations_quality(PROOF_DIFFICULTY_CONSTANT_FACTOR, &quality_string[0],
+                                           35, 123456789, sp_hash), 2756101000315797u);
+    EXPECT_EQ(calculate_iterations_quality(PROOF_DIFFICULTY_CONSTANT_FACTOR, &quality_string[0],
+                                           50, 7, sp_hash), 3352u);
+    EXPECT_EQ(calculate_iterations_quality(PROOF_DIFFICULTY_CONSTANT_FACTOR, &quality_string[0],
+                                           25, 1ULL << 63, sp_hash), UINT64_MAX);
+    EXPECT_EQ(calculate_iterations_quality(PROOF_DIFFICULTY_CONSTANT_FACTOR, &quality_string[0],
+                                           32, 0, sp_hash), 1u);
     
-    EXPECT_TRUE(result);
-    EXPECT_GT(iterations, 0);
+    // Допустимы итерации меньше интервала точки сигнейджа
+    EXPECT_TRUE(proof_validate_iterations(&quality_string[0], sp_hash, 32, 1,
+                                          sub_slot_iters, &iterations));
+    EXPECT_EQ(iterations, 195081070u);
+    EXPECT_FALSE(proof_validate_iterations(&quality_string[0], sp_hash, 32, 1000,
+                                           sub_slot_iters, &iterations));
+    EXPECT_FALSE(proof_validate_iterations(&quality_string[0], sp_hash, 32, 0,
+                                           sub_slot_iters, &iterations));
+}
+
+TEST_F(SecurityTest, ProofIterationsBatchMatchesScalar) {
+    const size_t count = 37;
+    std::vector<uint8_t> quality_strings(count * 32);
+    std::vector<uint8_t> sp_hashes(count * 32);
+    std::vector<uint32_t> k_sizes(count);
+    std::vector<uint64_t> difficulties(count);
+    
+    uint64_t seed = 0x9e3779b97f4a7c15ULL;
+    for (size_t i = 0; i < count * 32; i++) {
+        seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+        quality_strings[i] = (uint8_t)(seed >> 56);
+        sp_hashes[i] = (uint8_t)(seed >> 48);
+    }
+    for (size_t i = 0; i < count; i++) {
+        seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+        k_sizes[i] = PROOF_MIN_K_SIZE + (uint32_t)(i % (PROOF_MAX_K_SIZE - PROOF_MIN_K_SIZE + 1));
+        difficulties[i] = i % 3 == 0 ? seed : (seed >> (i % 64));
+    }
+    
+    std::vector<uint64_t> iterations(count);
+    calculate_iterations_quality_batch(PROOF_DIFFICULTY_CONSTANT_FACTOR,
+                                       (const uint8_t (*)[32])&quality_strings[0],
+                                       (const uint8_t (*)[32])&sp_hashes[0],
+                                       &k_sizes[0], &difficulties[0], count, &iterations[0]);
+    
+    for (size_t i = 0; i < count; i++) {
+        EXPECT_EQ(iterations[i],
+                  calculate_iterations_quality(PROOF_DIFFICULTY_CONSTANT_FACTOR,
+                                               &quality_strings[i * 32], k_sizes[i],
+                                               difficulties[i], &sp_hashes[i * 32]));
+    }
 }
 
 TEST_F(SecurityTest, ProofPointsCalculation) {